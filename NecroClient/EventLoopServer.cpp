@@ -0,0 +1,720 @@
+#include "EventLoopServer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+
+#ifdef __linux__
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+std::string HttpRequest::GetParam(std::string_view name) const
+{
+    std::string_view rest = query;
+    while (!rest.empty())
+    {
+        const std::size_t end = std::min(rest.find('&'), rest.size());
+        const std::string_view pair = rest.substr(0, end);
+        rest.remove_prefix(std::min(end + 1, rest.size()));
+
+        const std::size_t equals = pair.find('=');
+        if (pair.substr(0, equals) == name)
+            return equals == std::string_view::npos ? std::string() : std::string(pair.substr(equals + 1));
+    }
+    return std::string();
+}
+
+#ifdef __linux__
+
+namespace
+{
+    using IdleClock = std::chrono::steady_clock;
+
+    const char* ReasonPhrase(int status)
+    {
+        switch (status)
+        {
+        case 200: return "OK";
+        case 204: return "No Content";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 413: return "Payload Too Large";
+        case 431: return "Request Header Fields Too Large";
+        case 500: return "Internal Server Error";
+        case 501: return "Not Implemented";
+        case 503: return "Service Unavailable";
+        default:  return "Unknown";
+        }
+    }
+
+    void SerializeResponse(const HttpResponse& response, bool keepAlive, std::string& out)
+    {
+        out += "HTTP/1.1 ";
+        out += std::to_string(response.status);
+        out += ' ';
+        out += ReasonPhrase(response.status);
+        out += "\r\n";
+        if (!response.contentType.empty())
+        {
+            out += "Content-Type: ";
+            out += response.contentType;
+            out += "\r\n";
+        }
+        for (const auto& [name, value] : response.headers)
+        {
+            out += name;
+            out += ": ";
+            out += value;
+            out += "\r\n";
+        }
+        out += "Content-Length: ";
+        out += std::to_string(response.body.size());
+        out += keepAlive ? "\r\nConnection: keep-alive\r\n\r\n" : "\r\nConnection: close\r\n\r\n";
+        out += response.body;
+    }
+
+    bool EqualsIgnoreCase(std::string_view a, std::string_view b)
+    {
+        return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](char x, char y)
+            {
+                return (x | 0x20) == (y | 0x20);
+            });
+    }
+
+    std::string_view Trim(std::string_view text)
+    {
+        while (!text.empty() && (text.front() == ' ' || text.front() == '\t'))
+            text.remove_prefix(1);
+        while (!text.empty() && (text.back() == ' ' || text.back() == '\t'))
+            text.remove_suffix(1);
+        return text;
+    }
+
+    enum class ParseStatus
+    {
+        Incomplete,
+        Complete,
+        Error
+    };
+
+    struct ParseResult
+    {
+        ParseStatus status = ParseStatus::Incomplete;
+        // Bytes of input the request took up
+        std::size_t consumed = 0;
+        bool keepAlive = true;
+        // HTTP status to answer with on Error
+        int errorStatus = 400;
+    };
+
+    // scanned is how much of input is known not to hold the end of the headers, so
+    // a request arriving in many small reads is searched once rather than per read
+    ParseResult ParseRequest(const std::string& input, std::size_t& scanned, const EventLoopServerConfig& config, HttpRequest& request)
+    {
+        ParseResult result;
+        const std::size_t headerEnd = input.find("\r\n\r\n", scanned < 3 ? 0 : scanned - 3);
+        scanned = headerEnd == std::string::npos ? input.size() : headerEnd;
+        if (headerEnd == std::string::npos)
+        {
+            if (input.size() > config.maxHeaderBytes)
+            {
+                result.status = ParseStatus::Error;
+                result.errorStatus = 431;
+            }
+            return result;
+        }
+
+        result.status = ParseStatus::Error;
+        std::string_view head(input.data(), headerEnd);
+        const std::size_t lineEnd = std::min(head.find("\r\n"), head.size());
+        const std::string_view requestLine = head.substr(0, lineEnd);
+        head.remove_prefix(std::min(lineEnd + 2, head.size()));
+
+        const std::size_t methodEnd = requestLine.find(' ');
+        const std::size_t targetEnd = requestLine.rfind(' ');
+        if (methodEnd == std::string_view::npos || targetEnd <= methodEnd)
+            return result;
+        const std::string_view target = requestLine.substr(methodEnd + 1, targetEnd - methodEnd - 1);
+        const std::string_view version = requestLine.substr(targetEnd + 1);
+        if (version.substr(0, 7) != "HTTP/1." || target.empty())
+            return result;
+
+        const std::size_t queryStart = std::min(target.find('?'), target.size());
+        request.method.assign(requestLine.substr(0, methodEnd));
+        request.path.assign(target.substr(0, queryStart));
+        request.query.assign(target.substr(std::min(queryStart + 1, target.size())));
+        request.contentType.clear();
+        result.keepAlive = version != "HTTP/1.0";
+
+        std::size_t contentLength = 0;
+        while (!head.empty())
+        {
+            const std::size_t end = std::min(head.find("\r\n"), head.size());
+            const std::string_view line = head.substr(0, end);
+            head.remove_prefix(std::min(end + 2, head.size()));
+
+            const std::size_t colon = line.find(':');
+            if (colon == std::string_view::npos)
+                return result;
+            const std::string_view name = line.substr(0, colon);
+            const std::string_view value = Trim(line.substr(colon + 1));
+
+            if (EqualsIgnoreCase(name, "Content-Length"))
+            {
+                if (value.empty() || value.size() > 9 || !std::all_of(value.begin(), value.end(), [](char c) { return c >= '0' && c <= '9'; }))
+                    return result;
+                contentLength = static_cast<std::size_t>(std::stoul(std::string(value)));
+            }
+            else if (EqualsIgnoreCase(name, "Content-Type"))
+            {
+                request.contentType.assign(value);
+            }
+            else if (EqualsIgnoreCase(name, "Connection"))
+            {
+                if (EqualsIgnoreCase(value, "close"))
+                    result.keepAlive = false;
+                else if (EqualsIgnoreCase(value, "keep-alive"))
+                    result.keepAlive = true;
+            }
+            else if (EqualsIgnoreCase(name, "Transfer-Encoding"))
+            {
+                result.errorStatus = 501;
+                return result;
+            }
+        }
+
+        if (contentLength > config.maxBodyBytes)
+        {
+            result.errorStatus = 413;
+            return result;
+        }
+
+        const std::size_t total = headerEnd + 4 + contentLength;
+        if (input.size() < total)
+        {
+            result.status = ParseStatus::Incomplete;
+            return result;
+        }
+        request.body.assign(input, headerEnd + 4, contentLength);
+        result.status = ParseStatus::Complete;
+        result.consumed = total;
+        return result;
+    }
+}
+
+namespace
+{
+    // epoll user data for the two descriptors every loop has; connections count up from here
+    constexpr std::uint64_t kListenerId = 0;
+    constexpr std::uint64_t kWakeId = 1;
+
+    struct Connection
+    {
+        int fd = -1;
+        std::string input;
+        std::string output;
+        std::size_t written = 0;
+        // Bytes of input already searched for the end of the headers
+        std::size_t scanned = 0;
+        // A request is with the workers; nothing else is parsed until it is answered
+        bool busy = false;
+        bool closeAfterWrite = false;
+        bool watchingWrites = false;
+        // The client shut down its sending side; requests it already sent are still answered
+        bool peerClosed = false;
+        IdleClock::time_point lastActive;
+    };
+
+    struct Completion
+    {
+        std::uint64_t connectionId;
+        std::string bytes;
+        bool keepAlive;
+    };
+}
+
+struct EventLoopServer::Loop
+{
+    int epoll = -1;
+    int listener = -1;
+    int wake = -1;
+
+    // Finished responses from the workers, guarded by mutex
+    std::mutex mutex;
+    std::vector<Completion> completed;
+
+    // Only touched by the loop's own thread
+    std::unordered_map<std::uint64_t, Connection> connections;
+    std::uint64_t nextId = kWakeId + 1;
+
+    ~Loop()
+    {
+        for (auto& [id, connection] : connections)
+            ::close(connection.fd);
+        for (int fd : { listener, wake, epoll })
+        {
+            if (fd >= 0)
+                ::close(fd);
+        }
+    }
+
+    void Signal()
+    {
+        const std::uint64_t one = 1;
+        [[maybe_unused]] const ssize_t written = ::write(wake, &one, sizeof(one));
+    }
+};
+
+namespace
+{
+    int OpenListener(int port)
+    {
+        const int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+            return -1;
+
+        // Every I/O thread binds the same port and the kernel spreads new connections over them
+        const int yes = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+        ::setsockopt(fd, SOL_SOCKET, SO_REUSEPORT, &yes, sizeof(yes));
+
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons(static_cast<std::uint16_t>(port));
+        if (::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || ::listen(fd, SOMAXCONN) != 0)
+        {
+            ::close(fd);
+            return -1;
+        }
+        return fd;
+    }
+
+    bool Watch(int epoll, int operation, int fd, std::uint32_t events, std::uint64_t id)
+    {
+        epoll_event event{};
+        event.events = events;
+        event.data.u64 = id;
+        return ::epoll_ctl(epoll, operation, fd, &event) == 0;
+    }
+
+    // Lets one process hold enough sockets for every connection we accept
+    void RaiseDescriptorLimit(std::size_t wanted)
+    {
+        rlimit limit{};
+        if (::getrlimit(RLIMIT_NOFILE, &limit) != 0 || limit.rlim_cur >= wanted)
+            return;
+        limit.rlim_cur = std::min<rlim_t>(limit.rlim_max, static_cast<rlim_t>(wanted));
+        ::setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+EventLoopServer::EventLoopServer(EventLoopServerConfig config, HttpHandler handler)
+    : m_Config(std::move(config))
+    , m_Handler(std::move(handler))
+{
+}
+
+EventLoopServer::EventLoopServer(EventLoopServerConfig config, AsyncHttpHandler handler)
+    : m_Config(std::move(config))
+    , m_AsyncHandler(std::move(handler))
+{
+}
+
+EventLoopServer::~EventLoopServer()
+{
+    Stop();
+    Wait();
+}
+
+bool EventLoopServer::Start()
+{
+    RaiseDescriptorLimit(m_Config.maxConnections + 64);
+
+    const unsigned ioThreads = std::max(1u, m_Config.ioThreads);
+    for (unsigned i = 0; i < ioThreads; ++i)
+    {
+        auto loop = std::make_unique<Loop>();
+        loop->epoll = ::epoll_create1(EPOLL_CLOEXEC);
+        loop->wake = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        loop->listener = OpenListener(m_Config.port);
+        if (loop->epoll < 0 || loop->wake < 0 || loop->listener < 0
+            || !Watch(loop->epoll, EPOLL_CTL_ADD, loop->listener, EPOLLIN, kListenerId)
+            || !Watch(loop->epoll, EPOLL_CTL_ADD, loop->wake, EPOLLIN, kWakeId))
+        {
+            std::cerr << "[EventLoopServer] Cannot listen on port " << m_Config.port << ": " << std::strerror(errno) << "\n";
+            m_Loops.clear();
+            return false;
+        }
+        m_Loops.push_back(std::move(loop));
+    }
+
+    m_Stop = false;
+    const unsigned workers = m_AsyncHandler ? 0 : m_Config.workerThreads > 0 ? m_Config.workerThreads : std::max(1u, std::thread::hardware_concurrency()) * 4;
+    for (unsigned i = 0; i < workers; ++i)
+    {
+        m_Workers.emplace_back([this]() { RunWorker(); });
+    }
+    for (auto& loop : m_Loops)
+    {
+        m_IoThreads.emplace_back([this, raw = loop.get()]() { RunLoop(*raw); });
+    }
+    return true;
+}
+
+void EventLoopServer::Stop()
+{
+    m_Stop = true;
+    for (auto& loop : m_Loops)
+    {
+        loop->Signal();
+    }
+    m_TaskReady.notify_all();
+}
+
+void EventLoopServer::Wait()
+{
+    for (std::thread& thread : m_IoThreads)
+    {
+        if (thread.joinable())
+            thread.join();
+    }
+    m_IoThreads.clear();
+
+    // The loops are gone, so nothing queues more work
+    m_Stop = true;
+    m_TaskReady.notify_all();
+    for (std::thread& thread : m_Workers)
+    {
+        if (thread.joinable())
+            thread.join();
+    }
+    m_Workers.clear();
+    // The loops stay until destruction: answers from an AsyncHttpHandler may still arrive
+}
+
+void EventLoopServer::RunWorker()
+{
+    std::unique_lock lock(m_TaskMutex);
+    while (true)
+    {
+        m_TaskReady.wait(lock, [this]() { return !m_Tasks.empty() || m_Stop; });
+        if (m_Tasks.empty())
+            return;
+        std::function<void()> task = std::move(m_Tasks.front());
+        m_Tasks.pop_front();
+        lock.unlock();
+        task();
+        lock.lock();
+    }
+}
+
+void EventLoopServer::RunLoop(Loop& loop)
+{
+    auto close = [&](std::uint64_t id)
+        {
+            auto it = loop.connections.find(id);
+            if (it == loop.connections.end())
+                return;
+            ::epoll_ctl(loop.epoll, EPOLL_CTL_DEL, it->second.fd, nullptr);
+            ::close(it->second.fd);
+            loop.connections.erase(it);
+            --m_Connections;
+        };
+
+    std::function<void(std::uint64_t, Connection&)> processInput;
+
+    // Once the peer has closed its side there is nothing more to read, and leaving
+    // EPOLLIN armed would report the hangup on every wait
+    auto watch = [&](std::uint64_t id, Connection& connection)
+        {
+            const std::uint32_t events = (connection.peerClosed ? 0u : static_cast<std::uint32_t>(EPOLLIN | EPOLLRDHUP))
+                | (connection.watchingWrites ? static_cast<std::uint32_t>(EPOLLOUT) : 0u);
+            Watch(loop.epoll, EPOLL_CTL_MOD, connection.fd, events, id);
+        };
+
+    // Writes what it can; the rest goes out when epoll says the socket has room
+    auto flush = [&](std::uint64_t id, Connection& connection)
+        {
+            while (connection.written < connection.output.size())
+            {
+                const ssize_t sent = ::send(connection.fd, connection.output.data() + connection.written,
+                    connection.output.size() - connection.written, MSG_NOSIGNAL);
+                if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                {
+                    if (!connection.watchingWrites)
+                    {
+                        connection.watchingWrites = true;
+                        watch(id, connection);
+                    }
+                    return;
+                }
+                if (sent <= 0)
+                {
+                    close(id);
+                    return;
+                }
+                connection.written += static_cast<std::size_t>(sent);
+            }
+
+            connection.output.clear();
+            connection.written = 0;
+            if (connection.closeAfterWrite)
+            {
+                close(id);
+                return;
+            }
+            if (connection.watchingWrites)
+            {
+                connection.watchingWrites = false;
+                watch(id, connection);
+            }
+            // A pipelined request may already be waiting
+            processInput(id, connection);
+        };
+
+    processInput = [&](std::uint64_t id, Connection& connection)
+        {
+            if (connection.busy || !connection.output.empty())
+                return;
+
+            HttpRequest request;
+            const ParseResult parsed = connection.input.empty() ? ParseResult{}
+                : ParseRequest(connection.input, connection.scanned, m_Config, request);
+            if (parsed.status == ParseStatus::Incomplete)
+            {
+                // Whatever is left of a half-closed connection can never complete
+                if (connection.peerClosed)
+                    close(id);
+                return;
+            }
+            if (parsed.status == ParseStatus::Error)
+            {
+                HttpResponse response;
+                response.status = parsed.errorStatus;
+                SerializeResponse(response, false, connection.output);
+                connection.closeAfterWrite = true;
+                connection.input.clear();
+                connection.scanned = 0;
+                flush(id, connection);
+                return;
+            }
+
+            connection.input.erase(0, parsed.consumed);
+            connection.scanned = 0;
+            connection.busy = true;
+
+            HttpResponder respond = [&loop, id, keepAlive = parsed.keepAlive](HttpResponse&& response)
+                {
+                    Completion completion{ id, std::string(), keepAlive };
+                    SerializeResponse(response, keepAlive, completion.bytes);
+                    {
+                        std::lock_guard completedLock(loop.mutex);
+                        loop.completed.push_back(std::move(completion));
+                    }
+                    loop.Signal();
+                };
+
+            if (m_AsyncHandler)
+            {
+                m_AsyncHandler(std::move(request), std::move(respond));
+                return;
+            }
+
+            {
+                std::lock_guard lock(m_TaskMutex);
+                m_Tasks.emplace_back([this, respond = std::move(respond), request = std::move(request)]()
+                    {
+                        HttpResponse response;
+                        m_Handler(request, response);
+                        respond(std::move(response));
+                    });
+            }
+            m_TaskReady.notify_one();
+        };
+
+    std::vector<epoll_event> events(256);
+    std::vector<Completion> completed;
+    char buffer[16 * 1024];
+    IdleClock::time_point lastSweep = IdleClock::now();
+
+    while (!m_Stop)
+    {
+        const int count = ::epoll_wait(loop.epoll, events.data(), static_cast<int>(events.size()), 1000);
+        const IdleClock::time_point now = IdleClock::now();
+
+        for (int i = 0; i < count; ++i)
+        {
+            const std::uint64_t id = events[static_cast<std::size_t>(i)].data.u64;
+            const std::uint32_t flags = events[static_cast<std::size_t>(i)].events;
+
+            if (id == kListenerId)
+            {
+                while (true)
+                {
+                    const int fd = ::accept4(loop.listener, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+                    if (fd < 0)
+                        break;
+                    if (m_Connections >= m_Config.maxConnections)
+                    {
+                        ::close(fd);
+                        continue;
+                    }
+                    const int yes = 1;
+                    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+
+                    const std::uint64_t connectionId = loop.nextId++;
+                    if (!Watch(loop.epoll, EPOLL_CTL_ADD, fd, EPOLLIN | EPOLLRDHUP, connectionId))
+                    {
+                        ::close(fd);
+                        continue;
+                    }
+                    Connection& connection = loop.connections[connectionId];
+                    connection.fd = fd;
+                    connection.lastActive = now;
+                    ++m_Connections;
+                }
+                continue;
+            }
+
+            if (id == kWakeId)
+            {
+                std::uint64_t signals = 0;
+                [[maybe_unused]] const ssize_t drained = ::read(loop.wake, &signals, sizeof(signals));
+                {
+                    std::lock_guard lock(loop.mutex);
+                    completed.swap(loop.completed);
+                }
+                for (Completion& completion : completed)
+                {
+                    auto it = loop.connections.find(completion.connectionId);
+                    if (it == loop.connections.end())
+                        continue; // The client went away while the handler ran
+                    Connection& connection = it->second;
+                    connection.busy = false;
+                    connection.closeAfterWrite = !completion.keepAlive;
+                    connection.output = std::move(completion.bytes);
+                    connection.written = 0;
+                    connection.lastActive = now;
+                    flush(completion.connectionId, connection);
+                }
+                completed.clear();
+                continue;
+            }
+
+            auto it = loop.connections.find(id);
+            if (it == loop.connections.end())
+                continue;
+            Connection& connection = it->second;
+            connection.lastActive = now;
+
+            if (flags & (EPOLLERR | EPOLLHUP))
+            {
+                close(id);
+                continue;
+            }
+
+            if (flags & EPOLLOUT)
+            {
+                flush(id, connection);
+                if (loop.connections.find(id) == loop.connections.end())
+                    continue;
+            }
+
+            if (flags & (EPOLLIN | EPOLLRDHUP))
+            {
+                bool open = true;
+                while (true)
+                {
+                    const ssize_t received = ::recv(connection.fd, buffer, sizeof(buffer), 0);
+                    if (received > 0)
+                    {
+                        connection.input.append(buffer, static_cast<std::size_t>(received));
+                        if (connection.input.size() > m_Config.maxHeaderBytes + m_Config.maxBodyBytes)
+                        {
+                            open = false;
+                            break;
+                        }
+                        continue;
+                    }
+                    // Zero is an orderly shutdown of the client's side only; it may still be
+                    // waiting for answers to what it sent
+                    if (received == 0)
+                    {
+                        connection.peerClosed = true;
+                        watch(id, connection);
+                    }
+                    else if (errno != EAGAIN && errno != EWOULDBLOCK)
+                    {
+                        open = false;
+                    }
+                    break;
+                }
+                if (!open)
+                {
+                    close(id);
+                    continue;
+                }
+                processInput(id, connection);
+            }
+        }
+
+        if (now - lastSweep >= std::chrono::seconds(1))
+        {
+            lastSweep = now;
+            std::vector<std::uint64_t> idle;
+            for (const auto& [id, connection] : loop.connections)
+            {
+                if (!connection.busy && connection.output.empty() && now - connection.lastActive > m_Config.idleTimeout)
+                    idle.push_back(id);
+            }
+            for (std::uint64_t id : idle)
+            {
+                close(id);
+            }
+        }
+    }
+}
+
+#else
+
+struct EventLoopServer::Loop
+{
+};
+
+EventLoopServer::EventLoopServer(EventLoopServerConfig config, HttpHandler handler)
+    : m_Config(std::move(config))
+    , m_Handler(std::move(handler))
+{
+}
+
+EventLoopServer::EventLoopServer(EventLoopServerConfig config, AsyncHttpHandler handler)
+    : m_Config(std::move(config))
+    , m_AsyncHandler(std::move(handler))
+{
+}
+
+EventLoopServer::~EventLoopServer() = default;
+
+bool EventLoopServer::Start()
+{
+    std::cerr << "[EventLoopServer] The event-loop server needs epoll and is only available on Linux\n";
+    return false;
+}
+
+void EventLoopServer::Wait() {}
+void EventLoopServer::Stop() {}
+void EventLoopServer::RunLoop(Loop&) {}
+void EventLoopServer::RunWorker() {}
+
+#endif
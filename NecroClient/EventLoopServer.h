@@ -0,0 +1,109 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+struct HttpRequest
+{
+    std::string method;
+    std::string path;
+    std::string query;
+    std::string contentType;
+    std::string body;
+
+    // Value of `name` in the query string, or empty; no percent-decoding
+    std::string GetParam(std::string_view name) const;
+};
+
+struct HttpResponse
+{
+    int status = 200;
+    std::string contentType;
+    std::string body;
+    std::vector<std::pair<std::string, std::string>> headers;
+};
+
+using HttpHandler = std::function<void(const HttpRequest&, HttpResponse&)>;
+// Call exactly once, from any thread
+using HttpResponder = std::function<void(HttpResponse&& response)>;
+// Runs on the I/O thread and must not block; it passes the request on and answers later
+using AsyncHttpHandler = std::function<void(HttpRequest&& request, HttpResponder respond)>;
+
+struct EventLoopServerConfig
+{
+    int port = 8080;
+    // Threads that only move bytes; each has its own listening socket and epoll set
+    unsigned ioThreads = 2;
+    // Threads that run handlers; zero uses four per core, since turns wait on log syncs
+    unsigned workerThreads = 0;
+    std::size_t maxConnections = 20000;
+    std::size_t maxHeaderBytes = 16 * 1024;
+    std::size_t maxBodyBytes = 1024 * 1024;
+    // Keep-alive connections with no request in flight are closed after this long
+    std::chrono::seconds idleTimeout{ 60 };
+};
+
+// HTTP/1.1 front end for many mostly idle keep-alive clients.
+//
+// A few I/O threads own every connection: they accept, read and parse with
+// non-blocking sockets under epoll, and never run a handler. Each complete
+// request goes to a separate worker pool; the finished response comes back
+// to the connection's I/O thread through a queue and an eventfd. An idle
+// connection therefore costs a buffer and an epoll registration instead of
+// a blocked thread. Requests on one connection are handled one at a time;
+// chunked bodies are not supported.
+//
+// With an AsyncHttpHandler there is no worker pool: the handler forwards
+// each request wherever it is served and answers through the responder.
+//
+// Linux only; Start fails elsewhere.
+class EventLoopServer
+{
+public:
+    EventLoopServer(EventLoopServerConfig config, HttpHandler handler);
+    EventLoopServer(EventLoopServerConfig config, AsyncHttpHandler handler);
+    ~EventLoopServer();
+
+    EventLoopServer(const EventLoopServer&) = delete;
+    EventLoopServer& operator=(const EventLoopServer&) = delete;
+
+    bool Start();
+    // Blocks until Stop is called from another thread or a signal handler
+    void Wait();
+    void Stop();
+
+    std::size_t GetConnectionCount() const { return m_Connections.load(); }
+
+private:
+    struct Loop;
+
+    void RunLoop(Loop& loop);
+    void RunWorker();
+
+    EventLoopServerConfig m_Config;
+    HttpHandler m_Handler;
+    AsyncHttpHandler m_AsyncHandler;
+
+    std::vector<std::unique_ptr<Loop>> m_Loops;
+    std::vector<std::thread> m_IoThreads;
+    std::vector<std::thread> m_Workers;
+
+    std::mutex m_TaskMutex;
+    std::condition_variable m_TaskReady;
+    std::deque<std::function<void()>> m_Tasks;
+
+    std::atomic<bool> m_Stop{ false };
+    std::atomic<std::size_t> m_Connections{ 0 };
+};
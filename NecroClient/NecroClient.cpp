@@ -1,42 +1,505 @@
 #include <iostream>
 #include <string>
+#include <cstdint>
+#include <random>
 
 #include "httplib.h"
 #include "Game.h"
 #include "CommandSerialization.h"
+#include "WireProtocol.h"
+#include "JsonRequest.h"
+#include "SessionStore.h"
+#include "JsonWriter.h"
+#include "WriteAheadLog.h"
+#include "SessionRecovery.h"
+#include "EventLoopServer.h"
+#include "SessionCores.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 using namespace NecroCore;
 
-std::unordered_map<std::string, std::unique_ptr<Game>> g_sessions;
+// Upper bound on AI work per /turn; hostiles that miss it act next turn
+constexpr std::chrono::milliseconds kTurnBudget{ 50 };
+
+// Idle games are compacted in memory after a few minutes and archived to disk after
+// a few hours, or sooner once sessions outgrow the memory budget
+constexpr std::chrono::minutes kSessionCompactAfter{ 5 };
+constexpr std::chrono::hours kSessionIdleTimeout{ 2 };
+constexpr std::size_t kSessionMemoryBudget = std::size_t{ 1 } << 30;
+constexpr const char* kSessionArchivePath = "sessions.archive";
+constexpr const char* kCoreArchivePath = "sessions.cores.archive";
+
+SessionStoreConfig MakeSessionConfig()
+{
+    SessionStoreConfig config;
+    config.compactAfter = kSessionCompactAfter;
+    config.idleTimeout = kSessionIdleTimeout;
+    config.memoryBudget = kSessionMemoryBudget;
+    config.archivePath = kSessionArchivePath;
+    return config;
+}
+
+SessionStore g_sessions{ MakeSessionConfig() };
+
+// --per-core keeps every session on one pinned core instead, chosen by id hash, and
+// forwards its requests there; g_sessions then stays empty. The cores apply the same
+// limits, with their own archive file.
+std::unique_ptr<SessionCores> g_cores;
+
+// Every new game and turn is logged before it is acknowledged. Syncs are shared by
+// all turns logged within one flush interval, and a periodic checkpoint snapshots
+// the sessions so a restart only replays the turns since then.
+constexpr const char* kWalDirectory = "wal";
+constexpr std::chrono::milliseconds kWalFlushInterval{ 2 };
+constexpr std::chrono::minutes kCheckpointInterval{ 5 };
+
+// --event-loop serves the same routes from a few epoll threads instead of a thread per connection
+constexpr unsigned kEventLoopIoThreads = 4;
+constexpr std::size_t kEventLoopMaxConnections = 20000;
+
+WriteAheadLog g_wal{ kWalDirectory, kWalFlushInterval };
+
+std::mutex g_checkpointMutex;
+std::condition_variable g_checkpointWake;
+bool g_checkpointStop = false;
+std::thread g_checkpoints;
+
+long long CheckpointSessions()
+{
+    if (g_cores)
+        return SessionRecovery::Checkpoint(g_wal, [](const SessionRecovery::ImageVisitor& visit) { return g_cores->VisitImages(visit); });
+    return SessionRecovery::Checkpoint(g_wal, g_sessions);
+}
+
+void RunCheckpoints()
+{
+    std::unique_lock lock(g_checkpointMutex);
+    while (!g_checkpointWake.wait_for(lock, kCheckpointInterval, []() { return g_checkpointStop; }))
+    {
+        lock.unlock();
+        const long long sessions = CheckpointSessions();
+        if (sessions >= 0)
+            std::cout << "Checkpointed " << sessions << " sessions\n";
+        lock.lock();
+    }
+}
+
+// Stops everything that can still touch a session or answer a request; safe to call twice
+void StopBackgroundWork()
+{
+    g_sessions.StopReaper();
+    {
+        std::lock_guard lock(g_checkpointMutex);
+        g_checkpointStop = true;
+    }
+    g_checkpointWake.notify_all();
+    if (g_checkpoints.joinable())
+        g_checkpoints.join();
+    if (g_cores)
+        g_cores->Stop();
+    g_wal.Close();
+}
+
+// One generator per request thread or core, so ids and seeds never race.
+Random& ThreadRandom()
+{
+    thread_local Random rng{ (static_cast<std::uint64_t>(std::random_device{}()) << 32) ^ std::random_device{}() };
+    return rng;
+}
 
 std::string GenerateSessionId()
 {
-    static std::mt19937_64 rng{ std::random_device{}() };
     static const char chars[] =
         "0123456789"
         "abcdefghijklmnopqrstuvwxyz"
         "ABCDEFGHIJKLMNOPQRSTUVWXYZ";
 
-    std::uniform_int_distribution<> pick(0, static_cast<int>(sizeof(chars) - 2));
+    Random& rng = ThreadRandom();
 
     std::string id;
     id.reserve(16);
     for (int i = 0; i < 16; ++i)
     {
-        id.push_back(chars[pick(rng)]);
+        id.push_back(chars[rng.NextBelow(static_cast<std::uint32_t>(sizeof(chars) - 1))]);
     }
     return id;
 }
 
-Game* GetOrNull(const std::string& sessionId)
+// Per-system latency in the standard Server-Timing format, so it shows up in browser dev tools
+std::string TurnStatsToServerTiming(const TurnStats& stats)
+{
+    std::string header;
+    for (std::size_t i = 0; i < stats.systems.size(); ++i)
+    {
+        const SystemTiming& timing = stats.systems[i];
+        if (!header.empty())
+            header += ", ";
+        header += TurnSystemToString(static_cast<TurnSystem>(i));
+        header += ";dur=" + std::to_string(timing.elapsed.count() / 1000.0);
+        header += ";desc=\"" + std::to_string(timing.processed) + " run, " + std::to_string(timing.deferred) + " deferred\"";
+    }
+    return header;
+}
+
+// Errors go back in the format the request came in
+void SendError(HttpResponse& res, bool wire, int status, const std::string& message)
+{
+    res.status = status;
+    res.body.clear();
+    if (wire)
+    {
+        WireProtocol::EncodeError(res.body, status, message);
+        res.contentType = WireProtocol::ContentType;
+        return;
+    }
+    res.body = "{\"error\":\"" + message + "\"}";
+    res.contentType = "application/json";
+}
+
+struct NewGameRequest
+{
+    bool wire = false;
+    std::string playerName;
+    std::string mapName;
+    std::uint64_t seed = 0;
+};
+
+// False with the error already in `res` if the request is unusable
+bool ParseNewGame(const HttpRequest& req, HttpResponse& res, NewGameRequest& out)
+{
+    const bool wire = WireProtocol::IsWireContentType(req.contentType);
+    const std::string& body = req.body;
+    std::string playerName;
+    std::string mapName;
+    std::uint64_t seed = 0;
+    bool hasSeed = false;
+
+    if (wire)
+    {
+        WireProtocol::NewGameRequest request;
+        if (!WireProtocol::DecodeNewGameRequest(body, request))
+        {
+            SendError(res, wire, 400, "Malformed request");
+            return false;
+        }
+        playerName = std::move(request.playerName);
+        mapName = std::move(request.mapName);
+        seed = request.seed;
+        hasSeed = request.hasSeed;
+    }
+    else
+    {
+        JsonRequest request;
+        const JsonRequestError error = JsonRequestParser::Parse(body, request);
+        if (error != JsonRequestError::None)
+        {
+            SendError(res, wire, 400, JsonRequestErrorToString(error));
+            return false;
+        }
+        playerName = request.playerName.View();
+        mapName = request.mapName.View();
+        seed = request.seed;
+        hasSeed = request.hasSeed;
+    }
+
+    if (!hasSeed)
+    {
+        // Keep generated seeds within 53 bits so JavaScript clients can echo them back exactly
+        seed = ThreadRandom().NextU64() >> 11;
+    }
+
+    if (playerName.empty())
+    {
+        playerName = "TestPlayer123";
+    }
+    if (mapName.empty())
+    {
+        mapName = "map1";
+    }
+
+    if (!Game::IsKnownMap(mapName))
+    {
+        SendError(res, wire, 400, "Unknown 'mapName'");
+        return false;
+    }
+
+    out.wire = wire;
+    out.playerName = std::move(playerName);
+    out.mapName = std::move(mapName);
+    out.seed = seed;
+    return true;
+}
+
+void WriteNewGameResponse(HttpResponse& res, bool wire, const std::string& sessionId, std::uint64_t seed)
+{
+    if (wire)
+    {
+        std::string bytes;
+        WireProtocol::EncodeNewGameResponse(bytes, sessionId, seed);
+        res.contentType = WireProtocol::ContentType;
+        res.body = std::move(bytes);
+        return;
+    }
+
+    std::string json = R"({"sessionId":")" + sessionId + R"(","seed":)" + std::to_string(seed) + "}";
+    res.contentType = "application/json";
+    res.body = std::move(json);
+}
+
+void HandleNewGame(const HttpRequest& req, HttpResponse& res)
 {
-    auto it = g_sessions.find(sessionId);
-    if (it == g_sessions.end())
-        return nullptr;
-    return it->second.get();
+    NewGameRequest request;
+    if (!ParseNewGame(req, res, request))
+        return;
+
+    auto game = std::make_unique<Game>(request.playerName, request.mapName, request.seed);
+    game->StartRecording();
+    std::string sessionId = GenerateSessionId();
+    while (!g_sessions.Insert(sessionId, std::move(game)))
+    {
+        sessionId = GenerateSessionId();
+    }
+
+    // Logged after the insert, so a checkpoint either snapshots the game or keeps this record
+    if (!g_wal.WaitDurable(g_wal.AppendCreate(sessionId, request.playerName, request.mapName, request.seed)))
+    {
+        g_sessions.Erase(sessionId);
+        SendError(res, request.wire, 500, "Could not persist game");
+        return;
+    }
+
+    WriteNewGameResponse(res, request.wire, sessionId, request.seed);
 }
 
-int main()
+struct TurnRequest
+{
+    bool wire = false;
+    std::string sessionId;
+    std::string command;
+};
+
+bool ParseTurn(const HttpRequest& req, HttpResponse& res, TurnRequest& out)
+{
+    const bool wire = WireProtocol::IsWireContentType(req.contentType);
+    const std::string& body = req.body;
+    std::string command;
+    std::string sessionId;
+
+    if (wire)
+    {
+        // Wire commands arrive as opcodes and are replayed as their canonical text
+        WireProtocol::TurnRequest request;
+        if (!WireProtocol::DecodeTurnRequest(body, request))
+        {
+            SendError(res, wire, 400, "Malformed request");
+            return false;
+        }
+        sessionId = std::move(request.sessionId);
+        command = std::move(request.command);
+    }
+    else
+    {
+        JsonRequest request;
+        const JsonRequestError error = JsonRequestParser::Parse(body, request);
+        if (error != JsonRequestError::None)
+        {
+            SendError(res, wire, 400, JsonRequestErrorToString(error));
+            return false;
+        }
+        sessionId = request.sessionId.View();
+        command = request.command.View();
+    }
+
+    if (sessionId.empty())
+    {
+        SendError(res, wire, 400, "Missing 'sessionId' field");
+        return false;
+    }
+    if (command.empty())
+    {
+        SendError(res, wire, 400, "Missing 'command' field");
+        return false;
+    }
+
+    out.wire = wire;
+    out.sessionId = std::move(sessionId);
+    out.command = std::move(command);
+    return true;
+}
+
+// Applies and logs one turn, encodes the result into `buffer` and returns the log
+// record's LSN. The caller must have the game to itself.
+std::uint64_t RunTurn(Game& game, const TurnRequest& request, std::string& buffer, HttpResponse& res)
+{
+    const std::size_t sequence = game.GetReplayLog().GetTurnCount();
+    CommandResult result = game.ApplyTurn(request.command, kTurnBudget);
+    const std::uint64_t lsn = g_wal.AppendTurn(request.sessionId, sequence, request.command, game.GetReplayLog().GetStateHash(sequence),
+        game.GetLastTurnStats().deferredHostiles);
+
+    if (request.wire)
+        WireProtocol::EncodeTurnResponse(buffer, result);
+    else
+        WriteCommandResultJson(buffer, result);
+    res.headers.emplace_back("Server-Timing", TurnStatsToServerTiming(game.GetLastTurnStats()));
+    return lsn;
+}
+
+void HandleTurn(const HttpRequest& req, HttpResponse& res)
+{
+    TurnRequest request;
+    if (!ParseTurn(req, res, request))
+        return;
+
+    // Reused across requests on this worker, so it stops growing after the largest turn
+    thread_local std::string buffer;
+    buffer.clear();
+    std::uint64_t lsn = 0;
+    {
+        // Held until the turn is logged and encoded, so turns for one game never overlap
+        SessionStore::Lease game = g_sessions.Acquire(request.sessionId);
+        if (!game)
+        {
+            SendError(res, request.wire, 404, "Unknown sessionId");
+            return;
+        }
+        lsn = RunTurn(*game, request, buffer, res);
+    }
+
+    // Other turns for this game can run while we wait for the shared sync
+    if (!g_wal.WaitDurable(lsn))
+    {
+        SendError(res, request.wire, 500, "Could not persist turn");
+        return;
+    }
+    res.contentType = request.wire ? WireProtocol::ContentType : "application/json";
+    res.body = buffer;
+}
+
+void HandleSessionLog(const HttpRequest& req, HttpResponse& res)
+{
+    const std::string sessionId = req.GetParam("sessionId");
+    SessionStore::Lease game = g_sessions.Acquire(sessionId);
+    if (!game)
+    {
+        SendError(res, false, 404, "Unknown sessionId");
+        return;
+    }
+
+    const std::vector<std::uint8_t> bytes = game->GetReplayLog().Serialize();
+    res.contentType = "application/octet-stream";
+    res.body.assign(bytes.begin(), bytes.end());
+}
+
+void HandleMetrics(const HttpRequest&, HttpResponse& res)
+{
+    const SessionStoreMetrics metrics = g_cores ? g_cores->GetMetrics() : g_sessions.GetMetrics();
+    std::string json;
+    JsonWriter writer(json);
+    writer.BeginObject();
+    if (g_cores)
+    {
+        writer.Field("cores", static_cast<std::uint64_t>(g_cores->GetCoreCount()));
+        writer.Field("coreSessions", static_cast<std::uint64_t>(g_cores->Size()));
+    }
+    writer.Field("hotSessions", static_cast<std::uint64_t>(metrics.hot));
+    writer.Field("compactSessions", static_cast<std::uint64_t>(metrics.compact));
+    writer.Field("archivedSessions", static_cast<std::uint64_t>(metrics.archived));
+    writer.Field("residentBytes", static_cast<std::uint64_t>(metrics.residentBytes));
+    writer.Field("archiveBytes", static_cast<std::uint64_t>(metrics.archiveBytes));
+    writer.Field("compacted", metrics.compacted);
+    writer.Field("evicted", metrics.evicted);
+    writer.Field("expired", metrics.expired);
+    writer.Field("restored", metrics.restored);
+    writer.Field("restoreFailures", metrics.restoreFailures);
+    writer.EndObject();
+    res.contentType = "application/json";
+    res.body = std::move(json);
+}
+
+void HandleHealth(const HttpRequest&, HttpResponse& res)
+{
+    res.contentType = "application/json";
+    res.body = R"({"status":"ok"})";
+}
+
+void AddCorsHeaders(HttpResponse& res)
+{
+    res.headers.emplace_back("Access-Control-Allow-Origin", "*");
+    res.headers.emplace_back("Access-Control-Allow-Methods", "POST, GET, OPTIONS");
+    res.headers.emplace_back("Access-Control-Allow-Headers", "Content-Type");
+    res.headers.emplace_back("Timing-Allow-Origin", "*");
+}
+
+// The route table for the event-loop server; httplib registers the same handlers itself
+void Route(const HttpRequest& req, HttpResponse& res)
+{
+    AddCorsHeaders(res);
+    if (req.method == "OPTIONS")
+    {
+        res.status = 204;
+        return;
+    }
+
+    struct RouteEntry
+    {
+        const char* method;
+        const char* path;
+        void (*handler)(const HttpRequest&, HttpResponse&);
+    };
+    static const RouteEntry routes[] = {
+        { "GET", "/health", HandleHealth },
+        { "POST", "/new-game", HandleNewGame },
+        { "POST", "/turn", HandleTurn },
+        { "GET", "/session-log", HandleSessionLog },
+        { "GET", "/metrics", HandleMetrics },
+    };
+
+    bool pathMatched = false;
+    for (const RouteEntry& route : routes)
+    {
+        if (req.path != route.path)
+            continue;
+        pathMatched = true;
+        if (req.method == route.method)
+        {
+            route.handler(req, res);
+            return;
+        }
+    }
+    SendError(res, false, pathMatched ? 405 : 404, pathMatched ? "Method not allowed" : "Not found");
+}
+
+// Runs one of the handlers above behind httplib
+httplib::Server::Handler ServeWithHttplib(void (*handler)(const HttpRequest&, HttpResponse&))
+{
+    return [handler](const httplib::Request& req, httplib::Response& res) {
+        HttpRequest request;
+        request.method = req.method;
+        request.path = req.path;
+        request.contentType = req.get_header_value("Content-Type");
+        request.body = req.body;
+        for (const auto& [name, value] : req.params)
+        {
+            if (!request.query.empty())
+                request.query += '&';
+            request.query += name + "=" + value;
+        }
+
+        HttpResponse response;
+        handler(request, response);
+        res.status = response.status;
+        for (const auto& [name, value] : response.headers)
+        {
+            res.set_header(name, value);
+        }
+        res.set_content(std::move(response.body), response.contentType);
+    };
+}
+
+int RunHttplibServer()
 {
     httplib::Server svr;
 
@@ -44,6 +507,7 @@ int main()
         res.set_header("Access-Control-Allow-Origin", "*");
         res.set_header("Access-Control-Allow-Methods", "POST, GET, OPTIONS");
         res.set_header("Access-Control-Allow-Headers", "Content-Type");
+        res.set_header("Timing-Allow-Origin", "*");
         if (req.method == "OPTIONS")
         {
             res.status = 204;
@@ -52,91 +516,206 @@ int main()
         return httplib::Server::HandlerResponse::Unhandled;
         });
 
-    svr.Get("/health", [](const httplib::Request&, httplib::Response& res) {
-        res.set_content(R"({"status":"ok"})", "application/json");
-        });
+    svr.Get("/health", ServeWithHttplib(HandleHealth));
+    svr.Post("/new-game", ServeWithHttplib(HandleNewGame));
+    svr.Post("/turn", ServeWithHttplib(HandleTurn));
+    // Binary replay log (seed, map, commands and per-turn state hashes) for incident triage
+    svr.Get("/session-log", ServeWithHttplib(HandleSessionLog));
+    svr.Get("/metrics", ServeWithHttplib(HandleMetrics));
 
-    svr.Post("/new-game", [](const httplib::Request& req, httplib::Response& res) {
-        const std::string& body = req.body;
-        std::string playerName;
-        std::string mapName;
-
-        auto extractField = [&](const std::string& key, std::string& out) {
-            const std::string pattern = "\"" + key + "\":\"";
-            auto pos = body.find(pattern);
-            if (pos == std::string::npos) return;
-            pos += pattern.size();
-            auto end = body.find("\"", pos);
-            if (end == std::string::npos) return;
-            out = body.substr(pos, end - pos);
-            };
-
-        extractField("playerName", playerName);
-        extractField("mapName", mapName);
-
-        if (playerName.empty())
+    std::cout << "Server listening on http://localhost:8080\n";
+    svr.listen("0.0.0.0", 8080);
+    return 0;
+}
+
+// `mayWait` is false when called from a core, which must never block on a full queue
+void ServeNewGameOnCore(NewGameRequest request, HttpResponder respond, bool mayWait = true)
+{
+    const std::string sessionId = GenerateSessionId();
+    SessionCores::Task task = [request = std::move(request), respond = std::move(respond), sessionId](SessionCore& core) mutable {
+        auto game = std::make_unique<Game>(request.playerName, request.mapName, request.seed);
+        game->StartRecording();
+        if (!core.Insert(sessionId, std::move(game)))
         {
-            playerName = "TestPlayer123";
+            // Taken; a fresh id most likely belongs to another core, which this one must not wait on
+            ServeNewGameOnCore(std::move(request), std::move(respond), false);
+            return;
         }
-        if (mapName.empty())
+
+        const std::uint64_t lsn = g_wal.AppendCreate(sessionId, request.playerName, request.mapName, request.seed);
+        g_wal.WhenDurable(lsn, [request, respond, sessionId](bool durable) {
+            HttpResponse res;
+            AddCorsHeaders(res);
+            if (durable)
+            {
+                WriteNewGameResponse(res, request.wire, sessionId, request.seed);
+            }
+            else
+            {
+                // On the flusher thread, which every pending turn is waiting on
+                g_cores->PostOrQueue(sessionId, [sessionId](SessionCore& owner) { owner.Erase(sessionId); });
+                SendError(res, request.wire, 500, "Could not persist game");
+            }
+            respond(std::move(res));
+            });
+        };
+    if (mayWait)
+        g_cores->Post(sessionId, std::move(task));
+    else
+        g_cores->PostOrQueue(sessionId, std::move(task));
+}
+
+void ServeTurnOnCore(TurnRequest request, HttpResponder respond)
+{
+    const std::size_t owner = g_cores->CoreIndex(request.sessionId);
+    g_cores->PostTo(owner, [request = std::move(request), respond = std::move(respond)](SessionCore& core) {
+        HttpResponse res;
+        AddCorsHeaders(res);
+        Game* game = core.Find(request.sessionId);
+        if (!game)
         {
-            mapName = "map1";
+            SendError(res, request.wire, 404, "Unknown sessionId");
+            respond(std::move(res));
+            return;
         }
 
-        std::string sessionId = GenerateSessionId();
-        g_sessions[sessionId] = std::make_unique<Game>(playerName, mapName);
+        std::string& buffer = core.GetScratch();
+        const std::uint64_t lsn = RunTurn(*game, request, buffer, res);
+        res.contentType = request.wire ? WireProtocol::ContentType : "application/json";
+        res.body = buffer;
 
-        std::string json = R"({"sessionId":")" + sessionId + R"("})";
-        res.set_content(json, "application/json");
+        // The core moves on to its next turn; the answer goes out once the log has synced
+        g_wal.WhenDurable(lsn, [wire = request.wire, res = std::move(res), respond](bool durable) mutable {
+            if (!durable)
+                SendError(res, wire, 500, "Could not persist turn");
+            respond(std::move(res));
+            });
         });
+}
 
-    svr.Post("/turn", [](const httplib::Request& req, httplib::Response& res) {
-        const std::string& body = req.body;
-        std::string command;
-        std::string sessionId;
-
-        auto extractField = [&](const std::string& key, std::string& out) {
-            const std::string pattern = "\"" + key + "\":\"";
-            auto pos = body.find(pattern);
-            if (pos == std::string::npos) return;
-            pos += pattern.size();
-            auto end = body.find("\"", pos);
-            if (end == std::string::npos) return;
-            out = body.substr(pos, end - pos);
-            };
-
-        extractField("sessionId", sessionId);
-        extractField("command", command);
-
-        if (sessionId.empty())
+void ServeSessionLogOnCore(std::string sessionId, HttpResponder respond)
+{
+    g_cores->Post(sessionId, [sessionId, respond = std::move(respond)](SessionCore& core) {
+        HttpResponse res;
+        AddCorsHeaders(res);
+        Game* game = core.Find(sessionId);
+        if (!game)
         {
-            res.status = 400;
-            res.set_content(R"({"error":"Missing 'sessionId' field"})", "application/json");
-            return;
+            SendError(res, false, 404, "Unknown sessionId");
         }
-        if (command.empty())
+        else
         {
-            res.status = 400;
-            res.set_content(R"({"error":"Missing 'command' field"})", "application/json");
-            return;
+            const std::vector<std::uint8_t> bytes = game->GetReplayLog().Serialize();
+            res.contentType = "application/octet-stream";
+            res.body.assign(bytes.begin(), bytes.end());
         }
+        respond(std::move(res));
+        });
+}
 
-        Game* game = GetOrNull(sessionId);
-        if (!game)
-        {
-            res.status = 404;
-            res.set_content(R"({"error":"Unknown sessionId"})", "application/json");
-            return;
-        }
+// The route table for --per-core: requests are parsed on the I/O thread, then anything
+// touching a game runs on the core that owns it
+void RouteToCores(HttpRequest&& req, HttpResponder respond)
+{
+    HttpResponse res;
+    AddCorsHeaders(res);
+    if (req.method == "POST" && req.path == "/new-game")
+    {
+        NewGameRequest request;
+        if (ParseNewGame(req, res, request))
+            ServeNewGameOnCore(std::move(request), std::move(respond));
+        else
+            respond(std::move(res));
+        return;
+    }
+    if (req.method == "POST" && req.path == "/turn")
+    {
+        TurnRequest request;
+        if (ParseTurn(req, res, request))
+            ServeTurnOnCore(std::move(request), std::move(respond));
+        else
+            respond(std::move(res));
+        return;
+    }
+    if (req.method == "GET" && req.path == "/session-log")
+    {
+        ServeSessionLogOnCore(req.GetParam("sessionId"), std::move(respond));
+        return;
+    }
 
-        CommandResult result = game->ApplyTurn(command);
-        std::string json = CommandResultToJson(result);
+    // Everything else never touches a game
+    HttpResponse other;
+    Route(req, other);
+    respond(std::move(other));
+}
 
-        res.set_content(json, "application/json");
-    });
+// Thousands of idle keep-alive clients cost a buffer each instead of a thread each
+int RunEventLoopServer()
+{
+    EventLoopServerConfig config;
+    config.port = 8080;
+    config.ioThreads = kEventLoopIoThreads;
+    config.maxConnections = kEventLoopMaxConnections;
 
-    std::cout << "Server listening on http://localhost:8080\n";
-    svr.listen("0.0.0.0", 8080);
+    std::unique_ptr<EventLoopServer> server = g_cores
+        ? std::make_unique<EventLoopServer>(config, AsyncHttpHandler(RouteToCores))
+        : std::make_unique<EventLoopServer>(config, HttpHandler(Route));
+    if (!server->Start())
+        return 1;
+    std::cout << (g_cores ? "Per-core" : "Event-loop") << " server listening on http://localhost:8080\n";
+    server->Wait();
 
+    // Answers still on their way back from the cores and the log need the server's loops
+    StopBackgroundWork();
     return 0;
-}
\ No newline at end of file
+}
+
+int main(int argc, char** argv)
+{
+    bool eventLoop = false;
+    bool perCore = false;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string_view arg = argv[i];
+        if (arg == "--event-loop")
+            eventLoop = true;
+        else if (arg == "--per-core")
+            perCore = true;
+    }
+
+    SessionRecoveryReport recovery;
+    if (perCore)
+    {
+        SessionStoreConfig tiers = MakeSessionConfig();
+        tiers.archivePath = kCoreArchivePath;
+        g_cores = std::make_unique<SessionCores>(0, true, SessionCores::DefaultQueueCapacity, std::move(tiers));
+        g_cores->Start();
+        recovery = SessionRecovery::Recover(kWalDirectory, [](const std::string& sessionId, std::unique_ptr<Game>&& game) {
+            g_cores->Adopt(sessionId, std::move(game));
+            return true;
+            });
+        // Lets every core take in the games handed to it
+        g_cores->RunOnEachCore([](SessionCore&) {});
+    }
+    else
+    {
+        recovery = SessionRecovery::Recover(kWalDirectory, g_sessions);
+    }
+    std::cout << "Recovered " << (g_cores ? g_cores->Size() : g_sessions.Size()) << " sessions (" << recovery.turnsReplayed << " turns replayed, "
+        << recovery.turnsDiverged << " diverged) in " << recovery.elapsed.count() / 1000 << " ms\n";
+    if (!g_wal.Open())
+    {
+        std::cerr << "Cannot open write-ahead log in " << kWalDirectory << "\n";
+        return 1;
+    }
+    // Folds the replayed turns into a snapshot so the next start does not replay them again
+    CheckpointSessions();
+    g_checkpoints = std::thread(RunCheckpoints);
+
+    g_sessions.StartReaper();
+
+    const int status = eventLoop || perCore ? RunEventLoopServer() : RunHttplibServer();
+
+    StopBackgroundWork();
+    return status;
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include "Game.h"
+
+using namespace NecroCore;
+
+namespace
+{
+	Game MakeGameWithPlayerInCorner()
+	{
+		Game game("Ares");
+		game.GetPlayer().x = 1;
+		game.GetPlayer().y = 1;
+		return game;
+	}
+}
+
+TEST(ActivationTest, DistantHostileSleeps)
+{
+	Game game = MakeGameWithPlayerInCorner();
+	game.SpawnHostileAt(13, 5);
+	const int id = game.GetEntities().back().id;
+
+	game.ApplyTurn("wait");
+
+	EXPECT_TRUE(game.GetActivation().IsSleeping(id));
+	EXPECT_EQ(game.GetActivation().GetActiveCount(), 0u);
+	EXPECT_EQ(game.GetEntities().back().x, 13);
+}
+TEST(ActivationTest, PlayerEnteringAggroRangeWakesHostileSameTurn)
+{
+	Game game = MakeGameWithPlayerInCorner();
+	game.SpawnHostileAt(13, 5);
+	const int id = game.GetEntities().back().id;
+	game.ApplyTurn("wait");
+	ASSERT_TRUE(game.GetActivation().IsSleeping(id));
+
+	game.GetPlayer().x = 9;
+	game.GetPlayer().y = 5;
+	game.ApplyTurn("wait");
+
+	EXPECT_FALSE(game.GetActivation().IsSleeping(id));
+	EXPECT_EQ(game.GetEntities().back().x, 12);
+}
+TEST(ActivationTest, SpellNoiseWakesSleeper)
+{
+	Game game = MakeGameWithPlayerInCorner();
+	game.SpawnHostileAt(8, 1);
+	const int id = game.GetEntities().back().id;
+	game.ApplyTurn("wait");
+	ASSERT_TRUE(game.GetActivation().IsSleeping(id));
+
+	game.ApplyTurn("cast water east");
+
+	EXPECT_FALSE(game.GetActivation().IsSleeping(id));
+}
+TEST(ActivationTest, IdleHostileFallsBackAsleep)
+{
+	Game game = MakeGameWithPlayerInCorner();
+	game.SpawnHostileAt(8, 1);
+	const int id = game.GetEntities().back().id;
+	game.ApplyTurn("wait");
+	game.ApplyTurn("cast water east");
+	ASSERT_FALSE(game.GetActivation().IsSleeping(id));
+
+	for (int i = 0; i < ActivationSystem::IdleTurnsBeforeSleep; ++i)
+	{
+		game.ApplyTurn("wait");
+	}
+
+	EXPECT_TRUE(game.GetActivation().IsSleeping(id));
+	EXPECT_EQ(game.GetEntities().back().x, 8);
+}
+TEST(ActivationTest, SleepingDoesNotChangeOutcome)
+{
+	Game game("Ares", "map1", 5);
+	Game reference("Ares", "map1", 5);
+	const char* commands[] = { "summon skeleton", "move east", "move east", "wait", "move south", "wait" };
+
+	for (const char* command : commands)
+	{
+		game.ApplyTurn(command);
+		// Invalidating every turn wakes everything in range from scratch
+		reference.GetActivation().Invalidate();
+		reference.ApplyTurn(command);
+		EXPECT_EQ(game.ComputeStateHash(), reference.ComputeStateHash());
+	}
+}
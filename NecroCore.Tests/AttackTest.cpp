@@ -16,10 +16,9 @@ TEST(CommandTests, AttackCommandParsesAndReturnsSuccessOnHit)
 
 	EXPECT_TRUE(command.success);
 	EXPECT_EQ(command.action, CommandAction::Attack);
-	auto it = command.args.find("direction");
-	ASSERT_NE(it, command.args.end());
-	EXPECT_TRUE(std::holds_alternative<std::string>(it->second));
-	EXPECT_EQ(std::get<std::string>(it->second), "north");
+	const AttackCmd* attack = std::get_if<AttackCmd>(&command.command);
+	ASSERT_NE(attack, nullptr);
+	EXPECT_EQ(attack->direction.word.View(), "north");
 	EXPECT_NE(std::string::npos, command.description.find("You deal a blow and hear a grunt north."));
 }
 
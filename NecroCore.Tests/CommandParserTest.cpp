@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "Game.h"
+#include "Map.h"
+#include "Command.h"
+#include "CommandParser.h"
+#include "Spell.h"
+
+#include <string_view>
+
+using namespace NecroCore;
+
+TEST(CommandParserTest, TokenizerSplitsOnAnyWhitespace)
+{
+	CommandTokenizer tokens("  cast\tfire \r\n cone  north-east 4 ");
+	std::string_view word;
+	ASSERT_TRUE(tokens.Next(word));
+	EXPECT_EQ(word, "cast");
+	ASSERT_TRUE(tokens.Next(word));
+	EXPECT_EQ(word, "fire");
+	ASSERT_TRUE(tokens.Next(word));
+	EXPECT_EQ(word, "cone");
+	ASSERT_TRUE(tokens.Next(word));
+	EXPECT_EQ(word, "north-east");
+	int size = 0;
+	ASSERT_TRUE(tokens.NextInt(size));
+	EXPECT_EQ(size, 4);
+	EXPECT_FALSE(tokens.Next(word));
+	EXPECT_FALSE(tokens.NextInt(size));
+
+	CommandTokenizer numbers("12abc nope");
+	int value = 0;
+	EXPECT_TRUE(numbers.NextInt(value));
+	EXPECT_EQ(value, 12);
+	EXPECT_FALSE(numbers.NextInt(value));
+}
+
+TEST(CommandParserTest, KeywordsResolveThroughThePerfectHash)
+{
+	EXPECT_EQ(CommandKeywords::FindVerb("summon"), CommandVerb::Summon);
+	EXPECT_EQ(CommandKeywords::FindVerb("help"), CommandVerb::Help);
+	EXPECT_FALSE(CommandKeywords::FindVerb("dance").has_value());
+	EXPECT_FALSE(CommandKeywords::FindVerb("").has_value());
+
+	for (std::size_t i = 0; i < std::size(Map::dirs); ++i)
+	{
+		EXPECT_EQ(CommandKeywords::FindDirection(Map::dirs[i].name), static_cast<int>(i));
+	}
+	EXPECT_EQ(CommandKeywords::FindDirection("self"), DirectionArg::Self);
+	EXPECT_EQ(CommandKeywords::FindDirection("upward"), DirectionArg::Unknown);
+
+	EXPECT_EQ(CommandKeywords::FindShape("radius"), AreaShape::Radius);
+	EXPECT_FALSE(CommandKeywords::FindShape("north").has_value());
+	EXPECT_EQ(CommandKeywords::FindOrder("guard"), SummonOrder::Guard);
+	EXPECT_EQ(CommandKeywords::FindOrder("defend"), SummonOrder::Unknown);
+}
+
+TEST(CommandParserTest, ParseProducesTypedCommands)
+{
+	Game game("Ares");
+
+	CommandResult cast = game.ParseCommand("cast water cone west 2");
+	ASSERT_TRUE(cast.success);
+	const CastCmd* castCmd = std::get_if<CastCmd>(&cast.command);
+	ASSERT_NE(castCmd, nullptr);
+	EXPECT_EQ(castCmd->spell, SpellRegistry::Find("water"));
+	EXPECT_EQ(castCmd->shape, AreaShape::Cone);
+	EXPECT_EQ(castCmd->size, 2);
+	EXPECT_EQ(std::string_view(Map::dirs[castCmd->direction.index].name), "west");
+
+	CommandResult unknown = game.ParseCommand("cast lightning east");
+	ASSERT_TRUE(unknown.success);
+	EXPECT_EQ(std::get<CastCmd>(unknown.command).spell, nullptr);
+	EXPECT_EQ(game.ExecuteCommand(unknown).description, "The arcane forces reject your unknown element: lightning.");
+
+	CommandResult wait = game.ParseCommand("wait");
+	EXPECT_TRUE(std::holds_alternative<WaitCmd>(wait.command));
+	EXPECT_EQ(game.ExecuteCommand(wait).description, "You wait for a moment.");
+
+	CommandResult verb = game.ParseCommand("dance wildly");
+	EXPECT_FALSE(verb.success);
+	EXPECT_EQ(verb.description, "Unknown command: dance");
+}
+
+TEST(CommandParserTest, LongWordsAreCutButStillRejected)
+{
+	Game game("Ares");
+	const std::string longDirection(64, 'n');
+	CommandResult move = game.ApplyCommand("move " + longDirection);
+	EXPECT_FALSE(move.success);
+	const MoveCmd* moveCmd = std::get_if<MoveCmd>(&move.command);
+	ASSERT_NE(moveCmd, nullptr);
+	EXPECT_EQ(moveCmd->direction.word.View(), std::string_view(longDirection).substr(0, CommandWord::Capacity));
+	EXPECT_FALSE(moveCmd->direction.IsKnown());
+}
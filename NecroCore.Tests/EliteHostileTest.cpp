@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+#include "Game.h"
+#include "HostilePlanner.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace NecroCore;
+
+namespace
+{
+	// Iteration-bound search so results do not depend on machine speed
+	void UseDeterministicPlanner(Game& game)
+	{
+		PlannerConfig& config = game.GetPlannerConfig();
+		config.threads = 2;
+		config.maxIterationsPerThread = 1500;
+		config.timeBudget = std::chrono::seconds(10);
+	}
+}
+
+TEST(EliteHostileTest, EliteClawsAdjacentPlayer)
+{
+	Game game("Ares");
+	UseDeterministicPlanner(game);
+	Player& player = game.GetPlayer();
+	game.SpawnEliteHostileAt(player.x + 1, player.y);
+	const int hpBefore = player.hp;
+
+	CommandResult result = game.ApplyTurn("wait");
+
+	EXPECT_EQ(player.hp, hpBefore - 2);
+	EXPECT_NE(std::string::npos, result.description.find("A hostile claws at you from the east."));
+}
+TEST(EliteHostileTest, EliteStepsAroundTrapInsteadOfThroughIt)
+{
+	Game game("Ares");
+	UseDeterministicPlanner(game);
+	const Player& player = game.GetPlayer();
+	const int eliteX = player.x + 3;
+	const int eliteY = player.y;
+	game.SpawnTrapAt(eliteX - 1, eliteY, StatusEffect::Poisoned);
+	game.SpawnEliteHostileAt(eliteX, eliteY);
+
+	game.ApplyTurn("wait");
+
+	const Entity& elite = game.GetEntities().back();
+	EXPECT_EQ(elite.x, eliteX - 1);
+	EXPECT_NE(elite.y, eliteY);
+	EXPECT_FALSE(HasStatus(elite.status, StatusEffect::Poisoned));
+	EXPECT_TRUE(game.GetMap().IsTrap(eliteX - 1, eliteY));
+}
+TEST(EliteHostileTest, EliteOutOfRangeStaysDormant)
+{
+	Game game("Ares");
+	game.GetPlayer().x = 1;
+	game.GetPlayer().y = 1;
+	game.SpawnEliteHostileAt(13, 5);
+
+	game.ApplyTurn("wait");
+
+	EXPECT_EQ(game.GetEntities().back().x, 13);
+	EXPECT_EQ(game.GetEntities().back().y, 5);
+}
+TEST(EliteHostileTest, PlannerIsDeterministicWithIterationBudget)
+{
+	Game game("Ares");
+	const Player& player = game.GetPlayer();
+	game.SpawnFriendlyAt(player.x - 1, player.y);
+	game.SpawnEliteHostileAt(player.x + 3, player.y + 1);
+
+	PlannerConfig config;
+	config.threads = 3;
+	config.maxIterationsPerThread = 800;
+	config.timeBudget = std::chrono::seconds(10);
+
+	const Entity& elite = game.GetEntities().back();
+	PlannedAction first = HostilePlanner::Plan(game, elite, config, 1234);
+	PlannedAction second = HostilePlanner::Plan(game, elite, config, 1234);
+
+	EXPECT_EQ(first.dx, second.dx);
+	EXPECT_EQ(first.dy, second.dy);
+	EXPECT_EQ(first.iterations, 3 * 800);
+}
+TEST(EliteHostileTest, ConcurrentPlansShareTheSearchThreads)
+{
+	Game game("Ares");
+	const Player& player = game.GetPlayer();
+	game.SpawnFriendlyAt(player.x - 1, player.y);
+	game.SpawnEliteHostileAt(player.x + 3, player.y + 1);
+
+	PlannerConfig config;
+	config.threads = 3;
+	config.maxIterationsPerThread = 500;
+	config.timeBudget = std::chrono::seconds(10);
+
+	const Entity& elite = game.GetEntities().back();
+	const PlannedAction alone = HostilePlanner::Plan(game, elite, config, 99);
+
+	// Several games planning at once queue on the same workers and get the same answers
+	std::vector<PlannedAction> planned(6);
+	std::vector<std::thread> callers;
+	for (PlannedAction& action : planned)
+	{
+		callers.emplace_back([&]() { action = HostilePlanner::Plan(game, elite, config, 99); });
+	}
+	for (std::thread& caller : callers)
+	{
+		caller.join();
+	}
+	for (const PlannedAction& action : planned)
+	{
+		EXPECT_EQ(action.dx, alone.dx);
+		EXPECT_EQ(action.dy, alone.dy);
+		EXPECT_EQ(action.iterations, 3 * 500);
+	}
+}
+TEST(EliteHostileTest, PlannerRespectsTimeBudget)
+{
+	Game game("Ares", "map1", 8);
+	const Player& player = game.GetPlayer();
+	game.SpawnEliteHostileAt(player.x + 1, player.y - 1);
+
+	PlannerConfig config;
+	config.threads = 2;
+	config.maxIterationsPerThread = 100000000;
+	config.timeBudget = std::chrono::milliseconds(5);
+
+	const auto start = std::chrono::steady_clock::now();
+	PlannedAction action = HostilePlanner::Plan(game, game.GetEntities().back(), config, 1);
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+
+	EXPECT_GT(action.iterations, 0);
+	EXPECT_LT(elapsed, std::chrono::milliseconds(200));
+}
+TEST(EliteHostileTest, DefaultPlannerIsDeterministicWithoutABudget)
+{
+	std::vector<std::uint64_t> hashes;
+	std::vector<std::pair<int, int>> positions;
+	for (int run = 0; run < 2; ++run)
+	{
+		// Default config: the search is bound by iterations, never by time
+		Game game("Ares", "map1", 21);
+		const Player& player = game.GetPlayer();
+		game.SpawnFriendlyAt(player.x, player.y - 1);
+		game.SpawnEliteHostileAt(player.x + 2, player.y);
+		for (const char* command : { "wait", "wait" })
+		{
+			game.ApplyTurn(command);
+		}
+		hashes.push_back(game.ComputeStateHash());
+		positions.push_back({ game.GetEntities().back().x, game.GetEntities().back().y });
+	}
+	EXPECT_EQ(hashes[0], hashes[1]);
+	EXPECT_EQ(positions[0], positions[1]);
+}
+TEST(EliteHostileTest, SearchCutShortDefersTheElite)
+{
+	Game game("Ares");
+	Player& player = game.GetPlayer();
+	game.SpawnEliteHostileAt(player.x + 1, player.y);
+	PlannerConfig& config = game.GetPlannerConfig();
+	config.maxIterationsPerThread = 100000000;
+	config.timeBudget = std::chrono::microseconds(200);
+	const int id = game.GetEntities().back().id;
+	const int hpBefore = player.hp;
+	const std::uint64_t randomBefore = game.GetRandom().GetState()[0];
+
+	game.ApplyTurn("wait", std::chrono::seconds(10));
+
+	const TurnStats& stats = game.GetLastTurnStats();
+	EXPECT_EQ(stats.Get(TurnSystem::Hostiles).deferred, 1);
+	ASSERT_EQ(stats.deferredHostiles.size(), 1u);
+	EXPECT_EQ(stats.deferredHostiles[0], id);
+	EXPECT_EQ(player.hp, hpBefore);
+	EXPECT_EQ(game.GetActivation().GetDeferredTurns(id), 1);
+	// Nothing drawn from the game's random stream for a plan it did not use
+	EXPECT_EQ(game.GetRandom().GetState()[0], randomBefore);
+}
@@ -332,4 +332,43 @@ TEST(EnvironmentTest, PoisonedStatusHostileCanKill)
 
     EXPECT_NE(std::string::npos,
         cmd.description.find("A Skeleton succumbs to the poison and collapses."));
-}
\ No newline at end of file
+}
+
+TEST(EnvironmentTest, StatusTableIsIndexedByBit)
+{
+    ASSERT_EQ(StatusEffectCount, 3u);
+    EXPECT_EQ(StatusIndex(StatusEffect::OnFire), 0u);
+    EXPECT_EQ(StatusIndex(StatusEffect::Wet), 2u);
+    EXPECT_EQ(GetStatusDescriptor(StatusEffect::Poisoned)->damagePerTurn, 2);
+    EXPECT_EQ(GetStatusDescriptor(StatusEffect::Normal), nullptr);
+    EXPECT_EQ(GetStatusDescriptor(StatusEffect::OnFire | StatusEffect::Wet), nullptr);
+}
+
+TEST(EnvironmentTest, OnlyEntitiesWithStatusesAreTicked)
+{
+    Game game("Ares");
+    CommandResult result{};
+    result.success = true;
+
+    Map& map = game.GetMap();
+    const int ex = map.spawnX + 1;
+    const int ey = map.spawnY;
+    game.SpawnHostileAt(ex, ey);
+    game.SpawnHostileAt(ex + 2, ey);
+    const int burningId = game.GetEntities()[game.GetEntities().size() - 2].id;
+
+    map.SetTileState(ex, ey, StatusEffect::OnFire);
+    ApplyEnvironmentTurn(game, result);
+    map.SetTileState(ex, ey, StatusEffect::Normal);
+
+    EXPECT_TRUE(HasStatus(game.GetEntityById(burningId)->status, StatusEffect::OnFire));
+    EXPECT_EQ(game.GetPendingTimerCount(), 1u);
+
+    for (int turn = 0; turn < 3; ++turn)
+    {
+        ApplyEnvironmentTurn(game, result);
+    }
+
+    EXPECT_EQ(game.GetPendingTimerCount(), 0u);
+    EXPECT_EQ(game.GetEntities().back().hp, game.GetEntities().back().maxHp);
+}
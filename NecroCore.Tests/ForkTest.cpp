@@ -0,0 +1,76 @@
+#include <gtest/gtest.h>
+#include "Game.h"
+
+using namespace NecroCore;
+
+TEST(ForkTest, ForkSharesMapUntilWritten)
+{
+	Game game("Ares", "map1", 11);
+	Game fork = game.Fork();
+
+	EXPECT_TRUE(fork.GetMap().SharesTilesWith(game.GetMap()));
+	EXPECT_TRUE(fork.GetMap().SharesTileStatesWith(game.GetMap()));
+
+	const Player& player = fork.GetPlayer();
+	fork.SpawnFireplaceAt(player.x + 1, player.y, true);
+
+	EXPECT_FALSE(fork.GetMap().SharesTilesWith(game.GetMap()));
+	EXPECT_TRUE(fork.GetMap().IsFireplace(player.x + 1, player.y));
+	EXPECT_FALSE(game.GetMap().IsFireplace(player.x + 1, player.y));
+}
+TEST(ForkTest, ForkedTurnsDoNotAffectOriginal)
+{
+	Game game("Ares");
+	game.SpawnHostileAt(game.GetPlayer().x + 3, game.GetPlayer().y);
+	const std::uint64_t before = game.ComputeStateHash();
+
+	Game fork = game.Fork();
+	fork.ApplyTurn("summon skeleton");
+	fork.ApplyTurn("move north");
+
+	EXPECT_EQ(game.ComputeStateHash(), before);
+	EXPECT_TRUE(game.GetEntities().size() == 1);
+	EXPECT_EQ(fork.GetEntities().size(), 2u);
+}
+TEST(ForkTest, ForkMatchesOriginalWhenPlayedIdentically)
+{
+	Game game("Ares", "map1", 21);
+	game.ApplyTurn("summon skeleton");
+
+	Game fork = game.Fork();
+	EXPECT_EQ(fork.ComputeStateHash(), game.ComputeStateHash());
+
+	game.ApplyTurn("pulse");
+	fork.ApplyTurn("pulse");
+	EXPECT_EQ(fork.ComputeStateHash(), game.ComputeStateHash());
+}
+TEST(ForkTest, ForkHasNoJournalOrRecording)
+{
+	Game game("Ares");
+	game.StartRecording();
+	game.ApplyTurn("wait");
+
+	Game fork = game.Fork();
+	fork.ApplyTurn("move north");
+
+	EXPECT_FALSE(fork.IsRecording());
+	EXPECT_FALSE(fork.GetJournal().IsEnabled());
+	EXPECT_EQ(fork.Undo(1), 0);
+	EXPECT_EQ(game.GetReplayLog().GetTurnCount(), 1u);
+}
+TEST(ForkTest, ForkMidTurnStopsTrackingTileChanges)
+{
+	Game game("Ares");
+	const Player& player = game.GetPlayer();
+	// As during a turn, when the journal has tracking on
+	game.GetMap().SetChangeTracking(true);
+	game.GetMap().SetTileState(player.x + 1, player.y, StatusEffect::OnFire);
+	ASSERT_EQ(game.GetMap().GetTileChanges().size(), 1u);
+
+	Game fork = game.Fork();
+	EXPECT_TRUE(fork.GetMap().GetTileChanges().empty());
+
+	fork.GetMap().SetTileState(player.x - 1, player.y, StatusEffect::OnFire);
+	fork.ApplyTurn("wait");
+	EXPECT_TRUE(fork.GetMap().GetTileChanges().empty());
+}
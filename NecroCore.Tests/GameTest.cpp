@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include "Game.h"
+#include "Random.h"
+
+using namespace NecroCore;
+
+TEST(GameTest, SameSeedProducesSameTrapLayout)
+{
+	Game first("Ares", "map1", 1234);
+	Game second("Ares", "map1", 1234);
+
+	const Map& a = first.GetMap();
+	const Map& b = second.GetMap();
+	for (int y = 0; y < a.GetHeight(); ++y)
+	{
+		for (int x = 0; x < a.GetWidth(); ++x)
+		{
+			EXPECT_EQ(a.GetTileState(x, y), b.GetTileState(x, y));
+		}
+	}
+	EXPECT_EQ(first.GetSeed(), 1234u);
+}
+TEST(GameTest, SameSeedProducesSameRandomStream)
+{
+	Game first("Ares", "test_box", 42);
+	Game second("Ares", "test_box", 42);
+
+	for (int i = 0; i < 100; ++i)
+	{
+		EXPECT_EQ(first.GetRandom().NextU64(), second.GetRandom().NextU64());
+	}
+}
+TEST(GameTest, DifferentSeedsDiverge)
+{
+	Game first("Ares", "test_box", 1);
+	Game second("Ares", "test_box", 2);
+
+	bool anyDifferent = false;
+	for (int i = 0; i < 8; ++i)
+	{
+		if (first.GetRandom().NextU64() != second.GetRandom().NextU64())
+			anyDifferent = true;
+	}
+	EXPECT_TRUE(anyDifferent);
+}
+TEST(GameTest, RandomNextIntStaysInRange)
+{
+	Random random(7);
+	for (int i = 0; i < 1000; ++i)
+	{
+		const int value = random.NextInt(-2, 3);
+		EXPECT_GE(value, -2);
+		EXPECT_LE(value, 3);
+	}
+}
@@ -0,0 +1,83 @@
+#include <gtest/gtest.h>
+#include "JsonRequest.h"
+
+#include <string>
+
+using namespace NecroCore;
+
+TEST(JsonRequestTest, ReadsKnownFieldsInAnyOrderAndSkipsTheRest)
+{
+	JsonRequest request;
+	const std::string body = R"( {
+		"extra": {"nested": [1, 2.5e3, -0.5, true, false, null, "x\"y"]},
+		"command" : "cast fire cone north",
+		"sessionIdx": "not this one",
+		"sessionId":"abc123",
+		"seed": 18446744073709551615
+	} )";
+	ASSERT_EQ(JsonRequestParser::Parse(body, request), JsonRequestError::None);
+	EXPECT_EQ(request.sessionId.View(), "abc123");
+	EXPECT_EQ(request.command.View(), "cast fire cone north");
+	EXPECT_FALSE(request.playerName.present);
+	EXPECT_FALSE(request.mapName.present);
+	EXPECT_TRUE(request.hasSeed);
+	EXPECT_EQ(request.seed, 18446744073709551615ull);
+
+	// Null counts as absent
+	ASSERT_EQ(JsonRequestParser::Parse(R"({"playerName":null,"seed":null})", request), JsonRequestError::None);
+	EXPECT_FALSE(request.playerName.present);
+	EXPECT_FALSE(request.hasSeed);
+
+	ASSERT_EQ(JsonRequestParser::Parse("{}", request), JsonRequestError::None);
+	EXPECT_FALSE(request.sessionId.present);
+}
+
+TEST(JsonRequestTest, DecodesEscapes)
+{
+	JsonRequest request;
+	const std::string body = R"({"playerName":"Qu\"oted\\ \/ \t\n \u00e9 \u20AC \uD83D\uDE00","mapName":"map2"})";
+	ASSERT_EQ(JsonRequestParser::Parse(body, request), JsonRequestError::None);
+	EXPECT_EQ(request.playerName.View(), "Qu\"oted\\ / \t\n \xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80");
+	EXPECT_EQ(request.mapName.View(), "map2");
+}
+
+TEST(JsonRequestTest, RejectsMalformedInput)
+{
+	JsonRequest request;
+	EXPECT_EQ(JsonRequestParser::Parse("", request), JsonRequestError::Syntax);
+	EXPECT_EQ(JsonRequestParser::Parse("[1]", request), JsonRequestError::NotAnObject);
+	EXPECT_EQ(JsonRequestParser::Parse(R"({"sessionId":"abc")", request), JsonRequestError::Syntax);
+	EXPECT_EQ(JsonRequestParser::Parse(R"({"sessionId":"abc",})", request), JsonRequestError::Syntax);
+	EXPECT_EQ(JsonRequestParser::Parse(R"({"sessionId" "abc"})", request), JsonRequestError::Syntax);
+	EXPECT_EQ(JsonRequestParser::Parse(R"({"sessionId":"abc"} x)", request), JsonRequestError::Syntax);
+	EXPECT_EQ(JsonRequestParser::Parse("{\"sessionId\":\"a\nb\"}", request), JsonRequestError::Syntax);
+	EXPECT_EQ(JsonRequestParser::Parse(R"({"sessionId":"\x"})", request), JsonRequestError::Syntax);
+	EXPECT_EQ(JsonRequestParser::Parse(R"({"sessionId":"\uD83D"})", request), JsonRequestError::Syntax);
+	EXPECT_EQ(JsonRequestParser::Parse(R"({"other":01})", request), JsonRequestError::Syntax);
+	EXPECT_EQ(JsonRequestParser::Parse(R"({"other":tru})", request), JsonRequestError::Syntax);
+
+	EXPECT_EQ(JsonRequestParser::Parse(R"({"sessionId":42})", request), JsonRequestError::WrongType);
+	EXPECT_EQ(JsonRequestParser::Parse(R"({"seed":"42"})", request), JsonRequestError::WrongType);
+	EXPECT_EQ(JsonRequestParser::Parse(R"({"seed":-1})", request), JsonRequestError::WrongType);
+	EXPECT_EQ(JsonRequestParser::Parse(R"({"seed":1.5})", request), JsonRequestError::WrongType);
+	EXPECT_EQ(JsonRequestParser::Parse(R"({"seed":18446744073709551616})", request), JsonRequestError::WrongType);
+	EXPECT_EQ(JsonRequestParser::Parse(R"({"command":"wait","command":"help"})", request), JsonRequestError::DuplicateField);
+}
+
+TEST(JsonRequestTest, BoundsFieldLengthAndNesting)
+{
+	JsonRequest request;
+	const std::string fits(request.sessionId.text.size(), 'a');
+	ASSERT_EQ(JsonRequestParser::Parse("{\"sessionId\":\"" + fits + "\"}", request), JsonRequestError::None);
+	EXPECT_EQ(request.sessionId.View(), fits);
+	EXPECT_EQ(JsonRequestParser::Parse("{\"sessionId\":\"" + fits + "a\"}", request), JsonRequestError::TooLong);
+
+	// Unknown fields may be any length
+	const std::string longText(4096, 'z');
+	EXPECT_EQ(JsonRequestParser::Parse("{\"" + longText + "\":\"" + longText + "\"}", request), JsonRequestError::None);
+
+	std::string deep = "{\"x\":";
+	for (int i = 0; i <= JsonRequestParser::MaxDepth; ++i)
+		deep += '[';
+	EXPECT_EQ(JsonRequestParser::Parse(deep, request), JsonRequestError::TooDeep);
+}
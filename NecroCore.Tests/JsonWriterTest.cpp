@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+#include "JsonWriter.h"
+#include "CommandSerialization.h"
+#include "Game.h"
+
+#include <string>
+
+using namespace NecroCore;
+
+namespace
+{
+	std::string Escape(std::string_view text)
+	{
+		std::string out;
+		JsonWriter::AppendEscaped(out, text);
+		return out;
+	}
+}
+
+TEST(JsonWriterTest, EscapesQuotesBackslashesAndControlBytes)
+{
+	EXPECT_EQ(Escape("plain text"), "plain text");
+	EXPECT_EQ(Escape("say \"hi\"\\now"), "say \\\"hi\\\"\\\\now");
+	EXPECT_EQ(Escape("a\nb\tc\rd\be\ff"), "a\\nb\\tc\\rd\\be\\ff");
+	EXPECT_EQ(Escape(std::string_view("\x01\x1F", 2)), "\\u0001\\u001F");
+	// Bytes above 0x7F are UTF-8 and pass through untouched
+	EXPECT_EQ(Escape("caf\xC3\xA9"), "caf\xC3\xA9");
+	EXPECT_EQ(Escape(std::string_view("\0", 1)), "\\u0000");
+}
+
+TEST(JsonWriterTest, SimdAndScalarEscapingAgree)
+{
+	// Every escapable byte at every offset around the 16 and 32 byte strides
+	std::string text;
+	for (int i = 0; i < 200; ++i)
+	{
+		const int pick = (i * 37) % 11;
+		text += pick == 0 ? '"' : pick == 1 ? '\\' : pick == 2 ? '\n' : pick == 3 ? static_cast<char>(0x07)
+			: pick == 4 ? static_cast<char>(0xE2) : static_cast<char>('a' + pick);
+	}
+
+	for (std::size_t length = 0; length <= text.size(); ++length)
+	{
+		const std::string_view slice(text.data(), length);
+		JsonWriter::SetSimdEnabled(false);
+		const std::string scalar = Escape(slice);
+		JsonWriter::SetSimdEnabled(true);
+		ASSERT_EQ(Escape(slice), scalar) << "length " << length;
+	}
+}
+
+TEST(JsonWriterTest, WriterPlacesCommasAndNests)
+{
+	std::string out;
+	JsonWriter json(out);
+	json.BeginObject();
+	json.Field("a", 1);
+	json.Key("list");
+	json.BeginArray();
+	json.Int(-2);
+	json.BeginObject();
+	json.EndObject();
+	json.Bool(false);
+	json.Null();
+	json.EndArray();
+	json.Field("name", "x\"y");
+	json.Field("big", std::uint64_t{ 18446744073709551615ull });
+	json.EndObject();
+	EXPECT_EQ(out, R"({"a":1,"list":[-2,{},false,null],"name":"x\"y","big":18446744073709551615})");
+}
+
+TEST(JsonWriterTest, CommandResultAppendsIntoReusedBuffer)
+{
+	Game game("Ares");
+	CommandResult result = game.ApplyTurn("move east");
+
+	std::string buffer;
+	WriteCommandResultJson(buffer, result);
+	const std::string first = buffer;
+	EXPECT_EQ(first, CommandResultToJson(result));
+	EXPECT_NE(std::string::npos, first.find(R"("action":"move")"));
+	EXPECT_NE(std::string::npos, first.find(R"("args":{"direction":"east"})"));
+	EXPECT_NE(std::string::npos, first.find(R"("payload":{"type":"move","oldX":)"));
+
+	const std::size_t capacity = buffer.capacity();
+	buffer.clear();
+	WriteCommandResultJson(buffer, result);
+	EXPECT_EQ(buffer, first);
+	EXPECT_EQ(buffer.capacity(), capacity);
+}
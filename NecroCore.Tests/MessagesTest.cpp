@@ -0,0 +1,67 @@
+#include <gtest/gtest.h>
+#include "Game.h"
+#include "Messages.h"
+
+#include <string>
+
+using namespace NecroCore;
+
+TEST(MessagesTest, RendersStatusTemplatesFromTheStatusTable)
+{
+	std::string out = "Before.";
+	Messages::Append(out, StatusMessageId(StatusIndex(StatusEffect::OnFire), StatusMessage::EntityTick), { "Skeleton" });
+	EXPECT_EQ(out, "Before.A Skeleton writhes in fire.");
+}
+TEST(MessagesTest, StepsAndAllyExpandToSubPhrases)
+{
+	std::string out;
+	MessageArgs args;
+	args.direction = "north";
+	for (int distance : { 1, 2, 5 })
+	{
+		args.distance = distance;
+		Messages::Append(out, Message::PulseDoor, args);
+		out += '|';
+	}
+	EXPECT_EQ(out,
+		"There is a door right next to you to the north.|"
+		"There is a door 1 step away to the north.|"
+		"There is a door 5 steps away to the north.|");
+
+	out.clear();
+	Messages::Append(out, Message::AllyStrikes);
+	out += '|';
+	Messages::Append(out, Message::AllyStrikes, { "skeleton#3" });
+	EXPECT_EQ(out, "Your summoned ally strikes at a foe.|Your summoned ally (skeleton#3) strikes at a foe.");
+}
+TEST(MessagesTest, InstalledPhraseTableReplacesEveryLine)
+{
+	PhraseTable phrases = Messages::GetDefaultPhrases();
+	phrases[static_cast<std::size_t>(Message::StepsMany)] = "a {distance} pas";
+	phrases[static_cast<std::size_t>(Message::PulseHostile)] = "Une presence hostile {steps}, vers {direction} {unknown}.";
+	Messages::SetPhrases(phrases);
+
+	std::string out;
+	MessageArgs args;
+	args.direction = "le nord";
+	args.distance = 4;
+	Messages::Append(out, Message::PulseHostile, args);
+
+	Messages::SetPhrases(Messages::GetDefaultPhrases());
+	EXPECT_EQ(out, "Une presence hostile a 4 pas, vers le nord {unknown}.");
+
+	out.clear();
+	Messages::Append(out, Message::PulseHostile, args);
+	EXPECT_EQ(out, "You sense a hostile presence 4 steps away to the le nord.");
+}
+TEST(MessagesTest, TurnNarrationUsesTemplates)
+{
+	Game game("Ares");
+	const Player& player = game.GetPlayer();
+	game.SpawnTrapAt(player.x + 1, player.y, StatusEffect::Poisoned);
+
+	const CommandResult result = game.ApplyTurn("move east");
+
+	EXPECT_NE(result.description.find("You move east.\nA hidden poison trap is sprung beneath Ares!"), std::string::npos);
+	EXPECT_NE(result.description.find("The poison courses through your veins"), std::string::npos);
+}
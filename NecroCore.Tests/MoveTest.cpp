@@ -21,10 +21,9 @@ TEST(MoveTest, MoveCommandReturnsCorrectArgs)
 {
 	Game game("Ares");
 	auto command = game.ApplyCommand("move south");
-	auto it = command.args.find("direction");
-	ASSERT_NE(it, command.args.end());
-	EXPECT_TRUE(std::holds_alternative<std::string>(it->second));
-	EXPECT_EQ(std::get<std::string>(it->second), "south");
+	const MoveCmd* move = std::get_if<MoveCmd>(&command.command);
+	ASSERT_NE(move, nullptr);
+	EXPECT_EQ(move->direction.word.View(), "south");
 }
 TEST(MoveTest, MoveCommandReturnsFalseOnInvalidDirection)
 {
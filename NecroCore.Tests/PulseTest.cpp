@@ -21,10 +21,9 @@ TEST(PulseTest, PulseCommandReturnsCorrectArgs)
 {
 	Game game("Ares");
 	auto command = game.ApplyCommand("pulse 15");
-	auto it = command.args.find("radius");
-	ASSERT_NE(it, command.args.end());
-	EXPECT_TRUE(std::holds_alternative<int>(it->second));
-	EXPECT_EQ(std::get<int>(it->second), 15);
+	const PulseCmd* pulse = std::get_if<PulseCmd>(&command.command);
+	ASSERT_NE(pulse, nullptr);
+	EXPECT_EQ(pulse->radius, 15);
 }
 TEST(PulseTest, PulseCommandReturnsFalse)
 {
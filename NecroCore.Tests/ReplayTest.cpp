@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include "Game.h"
+#include "ReplayLog.h"
+
+#include <cstdio>
+#include <cstring>
+
+using namespace NecroCore;
+
+namespace
+{
+	const char* kSession[] = {
+		"pulse 5",
+		"summon skeleton",
+		"move north",
+		"move east",
+		"command all attack",
+		"cast fire west",
+		"dance",
+		"wait",
+		"move south",
+		"cast water west",
+		"attack north",
+		"wait",
+	};
+
+	Game RecordSession(std::uint64_t seed)
+	{
+		Game game("Ares", "map1", seed);
+		game.StartRecording();
+		for (const char* command : kSession)
+		{
+			game.ApplyTurn(command);
+		}
+		return game;
+	}
+}
+
+TEST(ReplayTest, RecordsSeedMapAndEveryCommand)
+{
+	Game game = RecordSession(77);
+	const ReplayLog& log = game.GetReplayLog();
+
+	EXPECT_EQ(log.GetSeed(), 77u);
+	EXPECT_EQ(log.GetMapName(), "map1");
+	EXPECT_EQ(log.GetPlayerName(), "Ares");
+	ASSERT_EQ(log.GetTurnCount(), std::size(kSession));
+	EXPECT_EQ(log.GetCommand(6), "dance");
+	EXPECT_EQ(log.GetStateHash(log.GetTurnCount() - 1), game.ComputeStateHash());
+}
+TEST(ReplayTest, ReplayMatchesRecordedHashes)
+{
+	Game game = RecordSession(77);
+
+	ReplayReport report = ReplayRunner::Run(game.GetReplayLog());
+
+	EXPECT_TRUE(report.loaded);
+	EXPECT_TRUE(report.matched);
+	EXPECT_EQ(report.turnsReplayed, std::size(kSession));
+}
+TEST(ReplayTest, ReplayDetectsDivergence)
+{
+	Game game = RecordSession(77);
+	ReplayLog tampered;
+	const ReplayLog& log = game.GetReplayLog();
+	tampered.Reset(log.GetPlayerName(), log.GetMapName(), log.GetSeed());
+	for (std::size_t i = 0; i < log.GetTurnCount(); ++i)
+	{
+		tampered.AppendTurn(i == 1 ? std::string_view("wait") : log.GetCommand(i), log.GetStateHash(i));
+	}
+
+	ReplayReport report = ReplayRunner::Run(tampered);
+
+	EXPECT_FALSE(report.matched);
+	EXPECT_EQ(report.firstMismatchTurn, 1u);
+	EXPECT_EQ(report.turnsReplayed, 2u);
+}
+TEST(ReplayTest, ReplayIncludesUndo)
+{
+	Game game("Ares", "map1", 3);
+	game.StartRecording();
+	game.ApplyTurn("move north");
+	game.ApplyTurn("summon skeleton");
+	game.Undo(2);
+	game.ApplyTurn("move east");
+
+	ASSERT_EQ(game.GetReplayLog().GetKind(2), ReplayEntryKind::Undo);
+	ReplayReport report = ReplayRunner::Run(game.GetReplayLog());
+	EXPECT_TRUE(report.matched);
+	EXPECT_EQ(report.turnsReplayed, 4u);
+}
+TEST(ReplayTest, LogSurvivesFileRoundTrip)
+{
+	Game game = RecordSession(5);
+	const std::string path = ::testing::TempDir() + "necro_replay_test.bin";
+	ASSERT_TRUE(game.GetReplayLog().SaveToFile(path));
+
+	ReplayLog loaded;
+	ASSERT_TRUE(loaded.LoadFromFile(path));
+	std::remove(path.c_str());
+
+	EXPECT_EQ(loaded.GetTurnCount(), std::size(kSession));
+	EXPECT_EQ(loaded.GetCommand(0), "pulse 5");
+	EXPECT_TRUE(ReplayRunner::Run(loaded).matched);
+}
+TEST(ReplayTest, UnknownMapIsNotReplayed)
+{
+	ReplayLog log;
+	log.Reset("Ares", "no_such_map", 1);
+	log.AppendTurn("wait", 0);
+
+	ReplayReport report = ReplayRunner::Run(log);
+	EXPECT_FALSE(report.loaded);
+	EXPECT_EQ(report.turnsReplayed, 0u);
+}
+TEST(ReplayTest, LongCommandsSurviveSerialization)
+{
+	ReplayLog log;
+	log.Reset(std::string(70000, 'p'), "map1", 9);
+	const std::string command(70000, 'x');
+	log.AppendTurn(command, 42);
+
+	const std::vector<std::uint8_t> bytes = log.Serialize();
+	ReplayLog loaded;
+	ASSERT_TRUE(loaded.Deserialize(bytes.data(), bytes.size()));
+	EXPECT_EQ(loaded.GetPlayerName().size(), 70000u);
+	ASSERT_EQ(loaded.GetTurnCount(), 1u);
+	EXPECT_EQ(loaded.GetCommand(0), command);
+	EXPECT_EQ(loaded.GetStateHash(0), 42u);
+}
+TEST(ReplayTest, VersionOneLogsStillLoad)
+{
+	// Magic, version 1, reserved, seed, 16-bit name lengths, then one "wait" turn
+	std::vector<std::uint8_t> bytes = { 'B', 'N', 'R', 'L', 1, 0, 0, 0, 7, 0, 0, 0, 0, 0, 0, 0, 4, 0, 4, 0, 1, 0, 0, 0 };
+	for (char c : std::string("Aresmap1"))
+		bytes.push_back(static_cast<std::uint8_t>(c));
+	bytes.insert(bytes.end(), { static_cast<std::uint8_t>(ReplayEntryKind::Command), 4, 0, 'w', 'a', 'i', 't', 5, 0, 0, 0, 0, 0, 0, 0 });
+
+	ReplayLog log;
+	ASSERT_TRUE(log.Deserialize(bytes.data(), bytes.size()));
+	EXPECT_EQ(log.GetPlayerName(), "Ares");
+	EXPECT_EQ(log.GetMapName(), "map1");
+	EXPECT_EQ(log.GetSeed(), 7u);
+	ASSERT_EQ(log.GetTurnCount(), 1u);
+	EXPECT_EQ(log.GetCommand(0), "wait");
+	EXPECT_EQ(log.GetStateHash(0), 5u);
+}
+TEST(ReplayTest, ReplayKeepsDeferredHostilesDeferred)
+{
+	Game game("Ares", "map1", 7);
+	game.StartRecording();
+	// Out of the start room and towards the hostile west of the corridor
+	const std::vector<std::string> commands = { "move west", "move west", "move north", "move north",
+		"move east", "move east", "move east", "move east", "wait", "wait", "wait", "wait" };
+	std::size_t deferred = 0;
+	for (std::size_t i = 0; i < commands.size(); ++i)
+	{
+		// Every other turn runs out of time before any hostile moves
+		game.ApplyTurn(commands[i], std::chrono::microseconds(i % 2 == 0 ? 0 : 10'000'000));
+		deferred += game.GetLastTurnStats().deferredHostiles.size();
+	}
+	ASSERT_GT(deferred, 0u);
+
+	const std::vector<std::uint8_t> bytes = game.GetReplayLog().Serialize();
+	ReplayLog loaded;
+	ASSERT_TRUE(loaded.Deserialize(bytes.data(), bytes.size()));
+	std::size_t loadedDeferred = 0;
+	for (std::size_t i = 0; i < loaded.GetTurnCount(); ++i)
+		loadedDeferred += loaded.GetDeferredHostiles(i).size();
+	EXPECT_EQ(loadedDeferred, deferred);
+
+	ReplayReport report = ReplayRunner::Run(loaded);
+	EXPECT_TRUE(report.matched);
+	EXPECT_EQ(report.turnsReplayed, commands.size());
+}
+TEST(ReplayTest, TurnCountBeyondTheDataIsRejected)
+{
+	ReplayLog log;
+	log.Reset("Ares", "map1", 9);
+	log.AppendTurn("wait", 1);
+	std::vector<std::uint8_t> bytes = log.Serialize();
+	// Turn count sits after magic, version, reserved, seed and both name lengths
+	const std::uint32_t huge = 0xFFFFFFFF;
+	std::memcpy(bytes.data() + 24, &huge, sizeof(huge));
+
+	ReplayLog loaded;
+	EXPECT_FALSE(loaded.Deserialize(bytes.data(), bytes.size()));
+}
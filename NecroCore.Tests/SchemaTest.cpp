@@ -0,0 +1,142 @@
+#include <gtest/gtest.h>
+#include "CommandSerialization.h"
+#include "ResultSchema.h"
+#include "Game.h"
+
+#include <string>
+
+using namespace NecroCore;
+
+namespace
+{
+	std::string PayloadJson(const CommandPayload& payload)
+	{
+		std::string out;
+		JsonWriter json(out);
+		WriteCommandPayloadJson(json, payload);
+		return out;
+	}
+}
+
+TEST(SchemaTest, EveryPayloadTypeIsWrittenAsJson)
+{
+	PulseResult pulse;
+	pulse.detectedHostileCount = 2;
+	pulse.detectedTrapCount = 3;
+	EXPECT_EQ(PayloadJson(pulse), R"({"type":"pulse","detectedHostileCount":2,"detectedFriendlyCount":0,"detectedTrapCount":3})");
+
+	AttackResult attack;
+	attack.hit = true;
+	attack.targetEntityId = 4;
+	attack.targetX = 5;
+	attack.targetY = -1;
+	attack.damageDealt = 1;
+	EXPECT_EQ(PayloadJson(attack),
+		R"({"type":"attack","hit":true,"targetEntityId":4,"targetX":5,"targetY":-1,"damageDealt":1,"targetDied":false})");
+
+	CastResult cast;
+	cast.description = "narration stays out of the payload";
+	cast.tilesAffected = 7;
+	EXPECT_EQ(PayloadJson(cast), R"({"type":"cast","tilesAffected":7,"actorsAffected":0})");
+
+	SummonCommandResult order;
+	order.success = true;
+	order.creature = "all";
+	order.order = "guard";
+	order.alliesOrdered = 2;
+	EXPECT_EQ(PayloadJson(order), R"({"type":"command","success":true,"target":"all","order":"guard","alliesOrdered":2})");
+
+	SummonResult summon;
+	summon.summonedEntity.id = 9;
+	summon.summonedEntity.faction = Faction::Friendly;
+	summon.summonedDirection = "north";
+	EXPECT_NE(std::string::npos, PayloadJson(summon).find(R"({"type":"summon","entityId":9,"x":)"));
+	EXPECT_NE(std::string::npos, PayloadJson(summon).find(R"("faction":0,)"));
+	EXPECT_NE(std::string::npos, PayloadJson(summon).find(R"("direction":"north"})"));
+
+	EXPECT_EQ(PayloadJson(std::monostate{}), R"({"type":"none"})");
+}
+
+TEST(SchemaTest, BinaryPayloadsRoundTrip)
+{
+	SummonResult summon;
+	summon.summonedEntity.id = 300;
+	summon.summonedEntity.x = -7;
+	summon.summonedEntity.faction = Faction::Hostile;
+	summon.summonedDirection = "south-west";
+
+	SummonCommandResult order;
+	order.creature = "skeleton#1";
+	order.order = "move";
+	order.alliesOrdered = 1;
+
+	const CommandPayload payloads[] = { std::monostate{}, PulseResult{ 1, 2, 3, {} }, MoveResult{ 4, 5, 6, 7, true },
+		summon, AttackResult{ true, 8, 9, 10, 1, true }, order, CastResult{ {}, 11, 12 } };
+
+	std::string bytes;
+	for (const CommandPayload& payload : payloads)
+	{
+		WriteCommandPayloadBinary(bytes, payload);
+	}
+
+	SchemaReader reader(bytes);
+	for (const CommandPayload& expected : payloads)
+	{
+		CommandPayload decoded;
+		ASSERT_TRUE(ReadCommandPayloadBinary(reader, decoded));
+		ASSERT_EQ(decoded.index(), expected.index());
+		// Re-encoding shows every schema field survived
+		std::string again;
+		WriteCommandPayloadBinary(again, decoded);
+		std::string original;
+		WriteCommandPayloadBinary(original, expected);
+		EXPECT_EQ(again, original);
+	}
+	EXPECT_TRUE(reader.AtEnd());
+}
+
+TEST(SchemaTest, TruncatedBinaryIsRejected)
+{
+	AttackResult attack{ true, 1000, 1, 2, 3, false };
+	std::string bytes;
+	WriteCommandPayloadBinary(bytes, attack);
+
+	for (std::size_t length = 0; length < bytes.size(); ++length)
+	{
+		SchemaReader reader(std::string_view(bytes.data(), length));
+		CommandPayload decoded;
+		EXPECT_FALSE(ReadCommandPayloadBinary(reader, decoded)) << "length " << length;
+	}
+
+	const std::string unknownType(1, static_cast<char>(100));
+	SchemaReader reader(unknownType);
+	CommandPayload decoded;
+	EXPECT_FALSE(ReadCommandPayloadBinary(reader, decoded));
+}
+
+TEST(SchemaTest, TurnsCarryStructuredPayloads)
+{
+	Game game("Ares");
+	const Player& player = game.GetPlayer();
+	game.SpawnHostileWithStatsForTest(player.x, player.y - 1, 1, 1, "Skeleton");
+
+	CommandResult attack = game.ApplyCommand("attack north");
+	ASSERT_TRUE(attack.success);
+	const AttackResult& hit = std::get<AttackResult>(attack.payload);
+	EXPECT_TRUE(hit.hit);
+	EXPECT_TRUE(hit.targetDied);
+	EXPECT_EQ(hit.targetY, player.y - 1);
+
+	const std::string json = CommandResultToJson(attack);
+	EXPECT_NE(std::string::npos, json.find(R"("action":"attack")"));
+	EXPECT_NE(std::string::npos, json.find(R"("type":"attack","hit":true)"));
+
+	EXPECT_NE(std::string::npos, CommandResultToJson(game.ApplyCommand("cast fire east")).find(R"("action":"cast")"));
+	EXPECT_NE(std::string::npos, CommandResultToJson(game.ApplyCommand("help")).find(R"("action":"help")"));
+
+	game.SpawnFriendlyWithStatsForTest(player.x + 1, player.y, 5, 1, "Bones");
+	CommandResult order = game.ApplyCommand("command all follow");
+	ASSERT_TRUE(order.success);
+	EXPECT_EQ(std::get<SummonCommandResult>(order.payload).alliesOrdered, 1);
+	EXPECT_NE(std::string::npos, CommandResultToJson(order).find(R"("action":"command")"));
+}
@@ -0,0 +1,315 @@
+#include <gtest/gtest.h>
+#include "SessionCores.h"
+#include "SessionRecovery.h"
+#include "WriteAheadLog.h"
+#include "Game.h"
+
+#include <atomic>
+#include <filesystem>
+#include <future>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace NecroCore;
+
+namespace
+{
+	std::string FreshDirectory(const std::string& name)
+	{
+		const std::filesystem::path path = std::filesystem::path(::testing::TempDir()) / name;
+		std::filesystem::remove_all(path);
+		return path.string();
+	}
+
+	// Runs `task` on the session's core and waits for its result
+	template<typename Result>
+	Result RunOn(SessionCores& cores, const std::string& id, const std::function<Result(SessionCore&)>& task)
+	{
+		std::promise<Result> result;
+		cores.Post(id, [&](SessionCore& core) { result.set_value(task(core)); });
+		return result.get_future().get();
+	}
+}
+
+TEST(SessionCoresTest, LockFreeQueueDeliversEveryItemOnce)
+{
+	LockFreeQueue<int> queue(64);
+	EXPECT_EQ(queue.GetCapacity(), 64u);
+
+	constexpr int kProducers = 4;
+	constexpr int kItemsEach = 20000;
+	std::atomic<int> consumed{ 0 };
+	std::atomic<long long> sum{ 0 };
+	std::vector<std::thread> threads;
+	for (int p = 0; p < kProducers; ++p)
+	{
+		threads.emplace_back([&queue, p]()
+			{
+				for (int i = 1; i <= kItemsEach; ++i)
+				{
+					int value = p * kItemsEach + i;
+					while (!queue.TryPush(value))
+						std::this_thread::yield();
+				}
+			});
+	}
+	for (int c = 0; c < 2; ++c)
+	{
+		threads.emplace_back([&]()
+			{
+				int value = 0;
+				while (consumed < kProducers * kItemsEach)
+				{
+					if (queue.TryPop(value))
+					{
+						sum += value;
+						++consumed;
+					}
+				}
+			});
+	}
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	const long long n = static_cast<long long>(kProducers) * kItemsEach;
+	EXPECT_EQ(consumed.load(), n);
+	EXPECT_EQ(sum.load(), n * (n + 1) / 2);
+
+	// A full ring refuses instead of blocking, and leaves the value alone
+	LockFreeQueue<int> small(2);
+	int a = 1, b = 2, c = 3;
+	EXPECT_TRUE(small.TryPush(a));
+	EXPECT_TRUE(small.TryPush(b));
+	EXPECT_FALSE(small.TryPush(c));
+	EXPECT_EQ(c, 3);
+}
+
+TEST(SessionCoresTest, SessionsLiveOnTheCoreTheirIdHashesTo)
+{
+	SessionCores cores(4, false);
+	cores.Start();
+
+	std::vector<std::string> ids;
+	for (int i = 0; i < 40; ++i)
+	{
+		ids.push_back("session" + std::to_string(i));
+		cores.Adopt(ids.back(), std::make_unique<Game>("Tester", "map1", static_cast<std::uint64_t>(i)));
+	}
+
+	std::set<std::size_t> used;
+	for (const std::string& id : ids)
+	{
+		const std::size_t index = RunOn<std::size_t>(cores, id, [&](SessionCore& core)
+			{
+				EXPECT_NE(core.Find(id), nullptr);
+				return core.GetIndex();
+			});
+		EXPECT_EQ(index, cores.CoreIndex(id));
+		used.insert(index);
+	}
+	EXPECT_GT(used.size(), 1u);
+	EXPECT_EQ(cores.Size(), ids.size());
+
+	EXPECT_TRUE(RunOn<bool>(cores, ids[0], [&](SessionCore& core) { return core.Erase(ids[0]); }));
+	EXPECT_EQ(cores.Size(), ids.size() - 1);
+	cores.Stop();
+}
+
+TEST(SessionCoresTest, TurnsPostedFromManyThreadsRunOneAtATime)
+{
+	SessionCores cores(2, false);
+	cores.Start();
+	cores.Adopt("shared", std::make_unique<Game>("Tester", "map1", 3));
+
+	constexpr int kThreads = 8;
+	constexpr int kTurnsEach = 25;
+	std::atomic<int> inside{ 0 };
+	std::atomic<bool> overlapped{ false };
+	std::vector<std::thread> threads;
+	for (int t = 0; t < kThreads; ++t)
+	{
+		threads.emplace_back([&]()
+			{
+				for (int i = 0; i < kTurnsEach; ++i)
+				{
+					cores.Post("shared", [&](SessionCore& core)
+						{
+							if (inside.fetch_add(1) != 0)
+								overlapped = true;
+							core.Find("shared")->ApplyTurn("wait");
+							inside.fetch_sub(1);
+						});
+				}
+			});
+	}
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	const std::uint64_t turns = RunOn<std::uint64_t>(cores, "shared", [](SessionCore& core) { return core.Find("shared")->GetTurn(); });
+	EXPECT_EQ(turns, static_cast<std::uint64_t>(kThreads * kTurnsEach));
+	EXPECT_FALSE(overlapped);
+	cores.Stop();
+}
+
+TEST(SessionCoresTest, CheckpointAndRecoveryGoThroughTheCores)
+{
+	const std::string directory = FreshDirectory("necro_cores_recovery");
+	std::vector<std::string> ids = { "alpha", "beta", "gamma" };
+	std::vector<std::uint64_t> hashes;
+	{
+		SessionCores cores(2, false);
+		cores.Start();
+		WriteAheadLog log(directory);
+		ASSERT_TRUE(log.Open());
+
+		// The same steps the per-core server takes; nothing on a core waits for the disk
+		std::vector<std::future<bool>> acknowledged;
+		auto turn = [&](const std::string& id, const std::string& command)
+			{
+				auto done = std::make_shared<std::promise<bool>>();
+				acknowledged.push_back(done->get_future());
+				cores.Post(id, [&log, id, command, done](SessionCore& core)
+					{
+						Game* game = core.Find(id);
+						const std::size_t sequence = game->GetReplayLog().GetTurnCount();
+						game->ApplyTurn(command);
+						log.WhenDurable(log.AppendTurn(id, sequence, command, game->GetReplayLog().GetStateHash(sequence)),
+							[done](bool durable) { done->set_value(durable); });
+					});
+			};
+
+		for (std::size_t i = 0; i < ids.size(); ++i)
+		{
+			auto game = std::make_unique<Game>("Tester", "map1", 40 + i);
+			game->StartRecording();
+			cores.Adopt(ids[i], std::move(game));
+			ASSERT_TRUE(log.WaitDurable(log.AppendCreate(ids[i], "Tester", "map1", 40 + i)));
+			turn(ids[i], "move east");
+		}
+		for (auto& ack : acknowledged)
+			EXPECT_TRUE(ack.get());
+
+		EXPECT_EQ(SessionRecovery::Checkpoint(log, [&cores](const SessionRecovery::ImageVisitor& visit) { return cores.VisitImages(visit); }), 3);
+
+		acknowledged.clear();
+		turn("alpha", "wait");
+		turn("gamma", "pulse 2");
+		for (auto& ack : acknowledged)
+			EXPECT_TRUE(ack.get());
+
+		for (const std::string& id : ids)
+			hashes.push_back(RunOn<std::uint64_t>(cores, id, [&](SessionCore& core) { return core.Find(id)->ComputeStateHash(); }));
+		cores.Stop();
+	}
+
+	SessionCores cores(3, false);
+	cores.Start();
+	const SessionRecoveryReport report = SessionRecovery::Recover(directory, [&cores](const std::string& id, std::unique_ptr<Game>&& game)
+		{
+			cores.Adopt(id, std::move(game));
+			return true;
+		});
+	EXPECT_EQ(report.fromSnapshot, 3u);
+	EXPECT_EQ(report.turnsReplayed, 2u);
+	for (std::size_t i = 0; i < ids.size(); ++i)
+	{
+		const std::string& id = ids[i];
+		EXPECT_EQ(RunOn<std::uint64_t>(cores, id, [&](SessionCore& core) { return core.Find(id)->ComputeStateHash(); }), hashes[i]) << id;
+	}
+	cores.Stop();
+}
+
+TEST(SessionCoresTest, IdleSessionsMoveDownTiersOnTheirCore)
+{
+	SessionStoreConfig tiers;
+	tiers.compactAfter = std::chrono::seconds(10);
+	tiers.idleTimeout = std::chrono::seconds(20);
+	tiers.archivePath = FreshDirectory("necro_cores.archive");
+	SessionCores cores(2, false, SessionCores::DefaultQueueCapacity, tiers);
+	cores.Start();
+
+	const std::vector<std::string> ids = { "north", "south", "east", "west" };
+	std::vector<std::uint64_t> hashes;
+	for (std::size_t i = 0; i < ids.size(); ++i)
+	{
+		auto game = std::make_unique<Game>("Tester", "map1", 70 + i);
+		game->ApplyTurn("move east");
+		hashes.push_back(game->ComputeStateHash());
+		cores.Adopt(ids[i], std::move(game));
+	}
+
+	const SessionClock::time_point now = SessionClock::now();
+	EXPECT_EQ(cores.Reap(now), 0u);
+	EXPECT_EQ(cores.Reap(now + std::chrono::seconds(15)), ids.size());
+	EXPECT_EQ(cores.GetMetrics().compact, ids.size());
+	EXPECT_EQ(cores.Reap(now + std::chrono::seconds(25)), ids.size());
+
+	SessionStoreMetrics metrics = cores.GetMetrics();
+	EXPECT_EQ(metrics.hot, 0u);
+	EXPECT_EQ(metrics.archived, ids.size());
+	EXPECT_EQ(metrics.expired, ids.size());
+	EXPECT_GT(metrics.archiveBytes, 0u);
+	EXPECT_EQ(cores.Size(), ids.size());
+
+	// Found straight from the archive, on the same core, as they were
+	for (std::size_t i = 0; i < ids.size(); ++i)
+	{
+		const std::string& id = ids[i];
+		EXPECT_EQ(RunOn<std::uint64_t>(cores, id, [&](SessionCore& core) { return core.Find(id)->ComputeStateHash(); }), hashes[i]) << id;
+	}
+	metrics = cores.GetMetrics();
+	EXPECT_EQ(metrics.hot, ids.size());
+	EXPECT_EQ(metrics.restored, ids.size());
+	cores.Stop();
+}
+
+TEST(SessionCoresTest, MemoryBudgetIsSplitBetweenCores)
+{
+	SessionStoreConfig tiers;
+	tiers.memoryBudget = 1;
+	SessionCores cores(2, false, SessionCores::DefaultQueueCapacity, tiers);
+	cores.Start();
+	for (int i = 0; i < 6; ++i)
+	{
+		cores.Adopt("budget" + std::to_string(i), std::make_unique<Game>("Tester", "map1", static_cast<std::uint64_t>(i)));
+	}
+
+	// With no archive, sessions that cannot fit even compacted are dropped
+	cores.Reap();
+	EXPECT_EQ(cores.Size(), 0u);
+	EXPECT_EQ(cores.GetMetrics().evicted, 6u);
+	cores.Stop();
+}
+
+TEST(SessionCoresTest, PostOrQueueNeverWaitsOnAFullQueue)
+{
+	SessionCores cores(1, false, 2);
+	std::atomic<int> ran{ 0 };
+	auto count = [&ran](SessionCore&) { ++ran; };
+
+	// Not started, so nothing drains the queue
+	for (int i = 0; i < 2; ++i)
+	{
+		SessionCores::Task task = count;
+		EXPECT_TRUE(cores.TryPost("id", task));
+	}
+	SessionCores::Task refused = count;
+	EXPECT_FALSE(cores.TryPost("id", refused));
+	EXPECT_TRUE(refused);
+	for (int i = 0; i < 3; ++i)
+	{
+		cores.PostOrQueue("id", count);
+	}
+
+	// Stopping runs everything still queued, overflow included
+	cores.Start();
+	cores.Stop();
+	EXPECT_EQ(ran.load(), 5);
+}
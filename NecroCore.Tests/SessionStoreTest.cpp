@@ -0,0 +1,282 @@
+#include <gtest/gtest.h>
+#include "SessionStore.h"
+#include "SessionImage.h"
+
+#include <atomic>
+#include <filesystem>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace NecroCore;
+
+TEST(SessionStoreTest, InsertAcquireAndErase)
+{
+	SessionStore store;
+	auto game = std::make_unique<Game>("Tester", "map1", 7);
+	Game* raw = game.get();
+	ASSERT_TRUE(store.Insert("abc", std::move(game)));
+	EXPECT_EQ(store.Size(), 1u);
+	EXPECT_TRUE(store.Contains("abc"));
+
+	// A taken id leaves the caller's game alone
+	auto other = std::make_unique<Game>("Tester", "map1", 8);
+	EXPECT_FALSE(store.Insert("abc", std::move(other)));
+	EXPECT_NE(other, nullptr);
+
+	{
+		SessionStore::Lease lease = store.Acquire("abc");
+		ASSERT_TRUE(lease);
+		EXPECT_EQ(lease.Get(), raw);
+		EXPECT_FALSE(store.Acquire("missing"));
+
+		// Erasing while leased is safe; the lease keeps the game alive
+		EXPECT_TRUE(store.Erase("abc"));
+		EXPECT_FALSE(store.Contains("abc"));
+		lease->ApplyTurn("wait");
+		EXPECT_EQ(lease->GetTurn(), 1u);
+	}
+	EXPECT_FALSE(store.Erase("abc"));
+	EXPECT_EQ(store.Size(), 0u);
+}
+
+TEST(SessionStoreTest, TurnsForOneSessionAreSerialized)
+{
+	SessionStore store;
+	ASSERT_TRUE(store.Insert("shared", std::make_unique<Game>("Tester", "map1", 11)));
+
+	constexpr int kThreads = 8;
+	constexpr int kTurnsEach = 25;
+	std::atomic<int> inside{ 0 };
+	std::atomic<bool> overlapped{ false };
+	std::vector<std::thread> threads;
+	for (int t = 0; t < kThreads; ++t)
+	{
+		threads.emplace_back([&]()
+			{
+				for (int i = 0; i < kTurnsEach; ++i)
+				{
+					SessionStore::Lease lease = store.Acquire("shared");
+					if (inside.fetch_add(1) != 0)
+						overlapped = true;
+					lease->ApplyTurn("wait");
+					inside.fetch_sub(1);
+				}
+			});
+	}
+	for (std::thread& thread : threads)
+		thread.join();
+
+	EXPECT_FALSE(overlapped);
+	EXPECT_EQ(store.Acquire("shared")->GetTurn(), static_cast<std::uint64_t>(kThreads * kTurnsEach));
+}
+
+TEST(SessionStoreTest, SessionsInOtherShardsAreNotBlocked)
+{
+	SessionStore store;
+	std::string first = "session-0";
+	std::string second;
+	for (int i = 1; second.empty(); ++i)
+	{
+		const std::string id = "session-" + std::to_string(i);
+		if (SessionStore::ShardIndex(id) != SessionStore::ShardIndex(first))
+			second = id;
+	}
+	ASSERT_TRUE(store.Insert(first, std::make_unique<Game>("Tester", "map1", 1)));
+	ASSERT_TRUE(store.Insert(second, std::make_unique<Game>("Tester", "map1", 2)));
+
+	// With one session leased, another thread can still create and play others
+	SessionStore::Lease held = store.Acquire(first);
+	std::thread other([&]()
+		{
+			EXPECT_TRUE(store.Insert("session-new", std::make_unique<Game>("Tester", "map1", 3)));
+			SessionStore::Lease lease = store.Acquire(second);
+			ASSERT_TRUE(lease);
+			lease->ApplyTurn("wait");
+		});
+	other.join();
+	EXPECT_EQ(store.Size(), 3u);
+	EXPECT_EQ(held->GetTurn(), 0u);
+}
+
+namespace
+{
+	std::string FreshPath(const std::string& name)
+	{
+		const std::filesystem::path path = std::filesystem::path(::testing::TempDir()) / name;
+		std::filesystem::remove(path);
+		return path.string();
+	}
+}
+
+TEST(SessionStoreTest, IdleSessionsExpire)
+{
+	SessionStoreConfig config;
+	config.idleTimeout = std::chrono::seconds(60);
+	SessionStore store(config);
+	ASSERT_TRUE(store.Insert("old", std::make_unique<Game>("Tester", "map1", 1)));
+	ASSERT_TRUE(store.Insert("new", std::make_unique<Game>("Tester", "map1", 2)));
+
+	const SessionClock::time_point now = SessionClock::now();
+	EXPECT_EQ(store.Reap(now), 0u);
+
+	// With no archive, expired sessions are dropped
+	EXPECT_EQ(store.Reap(now + std::chrono::seconds(61)), 2u);
+	EXPECT_EQ(store.Size(), 0u);
+	EXPECT_FALSE(store.Acquire("old"));
+
+	const SessionStoreMetrics metrics = store.GetMetrics();
+	EXPECT_EQ(metrics.evicted, 2u);
+	EXPECT_EQ(metrics.expired, 2u);
+	EXPECT_EQ(metrics.restored, 0u);
+}
+
+TEST(SessionStoreTest, IdleSessionsAreCompactedAndRestored)
+{
+	SessionStoreConfig config;
+	config.compactAfter = std::chrono::seconds(60);
+	SessionStore store(config);
+
+	auto game = std::make_unique<Game>("Tester", "map1", 3);
+	game->StartRecording();
+	game->ApplyTurn("summon skeleton");
+	const std::uint64_t hash = game->ComputeStateHash();
+	ASSERT_TRUE(store.Insert("idle", std::move(game)));
+	store.Reap();
+	const std::size_t liveBytes = store.GetMetrics().residentBytes;
+
+	EXPECT_EQ(store.Reap(SessionClock::now() + std::chrono::seconds(61)), 1u);
+	SessionStoreMetrics metrics = store.GetMetrics();
+	EXPECT_EQ(metrics.hot, 0u);
+	EXPECT_EQ(metrics.compact, 1u);
+	EXPECT_EQ(metrics.compacted, 1u);
+	EXPECT_LT(metrics.residentBytes * 2, liveBytes);
+
+	{
+		SessionStore::Lease lease = store.Acquire("idle");
+		ASSERT_TRUE(lease);
+		EXPECT_EQ(lease->ComputeStateHash(), hash);
+		EXPECT_EQ(lease->GetReplayLog().GetTurnCount(), 1u);
+		lease->ApplyTurn("wait");
+	}
+	metrics = store.GetMetrics();
+	EXPECT_EQ(metrics.hot, 1u);
+	EXPECT_EQ(metrics.restored, 1u);
+}
+
+TEST(SessionStoreTest, MemoryBudgetCompactsLeastRecentlyUsedFirst)
+{
+	const std::size_t oneGame = SessionImage::EstimateResidentBytes(Game("Tester", "map1", 4));
+
+	// Room for two live games out of three
+	SessionStoreConfig config;
+	config.memoryBudget = 2 * oneGame + oneGame / 2;
+	SessionStore store(config);
+	for (const char* id : { "a", "b", "c" })
+	{
+		ASSERT_TRUE(store.Insert(id, std::make_unique<Game>("Tester", "map1", 4)));
+		std::this_thread::sleep_for(std::chrono::milliseconds(2));
+	}
+	store.Acquire("a");
+
+	EXPECT_EQ(store.Reap(), 1u);
+	SessionStoreMetrics metrics = store.GetMetrics();
+	EXPECT_EQ(metrics.hot, 2u);
+	EXPECT_EQ(metrics.compact, 1u);
+	EXPECT_EQ(metrics.expired, 0u);
+	EXPECT_LE(metrics.residentBytes, config.memoryBudget);
+
+	// "b" was the least recently used; taking it back costs a restore
+	ASSERT_TRUE(store.Acquire("b"));
+	EXPECT_EQ(store.GetMetrics().restored, 1u);
+
+	// A busy session is skipped rather than waited on, even when it is the oldest.
+	// Without an archive, sessions that cannot fit even compacted are dropped.
+	SessionStoreConfig tight;
+	tight.memoryBudget = 1;
+	SessionStore small(tight);
+	ASSERT_TRUE(small.Insert("busy", std::make_unique<Game>("Tester", "map1", 5)));
+	ASSERT_TRUE(small.Insert("idle", std::make_unique<Game>("Tester", "map1", 6)));
+	std::promise<void> leased;
+	std::promise<void> release;
+	std::thread holder([&]()
+		{
+			SessionStore::Lease held = small.Acquire("busy");
+			leased.set_value();
+			release.get_future().wait();
+		});
+	leased.get_future().wait();
+	EXPECT_EQ(small.Reap(), 2u);
+	EXPECT_TRUE(small.Contains("busy"));
+	EXPECT_FALSE(small.Contains("idle"));
+	release.set_value();
+	holder.join();
+}
+
+TEST(SessionStoreTest, EvictedSessionsAreRestoredFromTheArchive)
+{
+	SessionStoreConfig config;
+	config.compactAfter = std::chrono::seconds(1);
+	config.idleTimeout = std::chrono::seconds(10);
+	config.archivePath = FreshPath("necro_session_store.archive");
+	SessionStore store(config);
+
+	auto game = std::make_unique<Game>("Tester", "map1", 5);
+	game->StartRecording();
+	game->ApplyTurn("summon skeleton");
+	const std::uint64_t hash = game->ComputeStateHash();
+	ASSERT_TRUE(store.Insert("archived", std::move(game)));
+
+	const SessionClock::time_point now = SessionClock::now();
+	EXPECT_EQ(store.Reap(now + std::chrono::seconds(5)), 1u);
+	EXPECT_EQ(store.Reap(now + std::chrono::seconds(15)), 1u);
+	SessionStoreMetrics metrics = store.GetMetrics();
+	EXPECT_EQ(metrics.archived, 1u);
+	EXPECT_EQ(metrics.evicted, 1u);
+	EXPECT_GT(metrics.archiveBytes, 0u);
+	EXPECT_TRUE(store.Contains("archived"));
+	// Ids are only ever handed out once, even while archived
+	EXPECT_FALSE(store.Insert("archived", std::make_unique<Game>("Tester", "map1", 6)));
+
+	{
+		SessionStore::Lease lease = store.Acquire("archived");
+		ASSERT_TRUE(lease);
+		EXPECT_EQ(lease->ComputeStateHash(), hash);
+		EXPECT_EQ(lease->GetReplayLog().GetTurnCount(), 1u);
+		lease->ApplyTurn("wait");
+	}
+
+	metrics = store.GetMetrics();
+	EXPECT_EQ(metrics.hot, 1u);
+	EXPECT_EQ(metrics.archived, 0u);
+	EXPECT_EQ(metrics.restored, 1u);
+}
+
+TEST(SessionStoreTest, ArchiveCompactsDeadRecords)
+{
+	SessionArchive archive(FreshPath("necro_archive_test.archive"));
+	ASSERT_TRUE(archive.IsOpen());
+
+	const std::vector<std::uint8_t> first(1000, 1);
+	const std::vector<std::uint8_t> second(500, 2);
+	ASSERT_TRUE(archive.Put("a", first));
+	ASSERT_TRUE(archive.Put("b", first));
+	ASSERT_TRUE(archive.Put("a", second));
+	EXPECT_EQ(archive.GetCount(), 2u);
+	EXPECT_GT(archive.GetDeadBytes(), 1000u);
+
+	std::vector<std::uint8_t> image;
+	ASSERT_TRUE(archive.Take("b", image));
+	EXPECT_EQ(image, first);
+	EXPECT_FALSE(archive.Take("b", image));
+	EXPECT_FALSE(archive.Contains("b"));
+
+	// Only "a" is live now, so the dead records get rewritten away
+	EXPECT_FALSE(archive.Compact());
+	ASSERT_TRUE(archive.Compact(0));
+	EXPECT_EQ(archive.GetDeadBytes(), 0u);
+	EXPECT_LT(archive.GetFileBytes(), 600u);
+	ASSERT_TRUE(archive.Take("a", image));
+	EXPECT_EQ(image, second);
+}
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include "Game.h"
+#include "GameSnapshot.h"
+#include "SessionImage.h"
+
+#include <cstdio>
+
+using namespace NecroCore;
+
+namespace
+{
+	void ExpectSameGame(Game& a, Game& b)
+	{
+		const Map& mapA = a.GetMap();
+		const Map& mapB = b.GetMap();
+		ASSERT_EQ(mapA.GetWidth(), mapB.GetWidth());
+		ASSERT_EQ(mapA.GetHeight(), mapB.GetHeight());
+		for (int y = 0; y < mapA.GetHeight(); ++y)
+		{
+			for (int x = 0; x < mapA.GetWidth(); ++x)
+			{
+				EXPECT_EQ(mapA.GetTile(x, y), mapB.GetTile(x, y));
+				EXPECT_EQ(mapA.GetTileState(x, y), mapB.GetTileState(x, y));
+			}
+		}
+
+		EXPECT_EQ(a.GetPlayerName(), b.GetPlayerName());
+		EXPECT_EQ(a.GetPlayer().x, b.GetPlayer().x);
+		EXPECT_EQ(a.GetPlayer().y, b.GetPlayer().y);
+		EXPECT_EQ(a.GetPlayer().hp, b.GetPlayer().hp);
+		EXPECT_EQ(a.GetPlayer().status, b.GetPlayer().status);
+		EXPECT_EQ(a.GetPlayer().statusDurations, b.GetPlayer().statusDurations);
+
+		ASSERT_EQ(a.GetEntities().size(), b.GetEntities().size());
+		for (std::size_t i = 0; i < a.GetEntities().size(); ++i)
+		{
+			const Entity& ea = a.GetEntities()[i];
+			const Entity& eb = b.GetEntities()[i];
+			EXPECT_EQ(ea.id, eb.id);
+			EXPECT_EQ(ea.name, eb.name);
+			EXPECT_EQ(ea.x, eb.x);
+			EXPECT_EQ(ea.y, eb.y);
+			EXPECT_EQ(ea.hp, eb.hp);
+			EXPECT_EQ(ea.faction, eb.faction);
+			EXPECT_EQ(ea.aiState, eb.aiState);
+			EXPECT_EQ(ea.statusDurations, eb.statusDurations);
+		}
+
+		EXPECT_EQ(a.GetRandom().NextU64(), b.GetRandom().NextU64());
+	}
+}
+
+TEST(SnapshotTest, RoundTripRestoresMap1Session)
+{
+	Game original("Ares", "map1", 99);
+	original.ApplyTurn("summon skeleton");
+	original.ApplyTurn("move north");
+	original.GetPlayer().AddStatus(StatusEffect::Poisoned);
+
+	std::vector<std::uint8_t> image = GameSnapshot::Save(original);
+	EXPECT_EQ(image.size(), GameSnapshot::GetSize(original));
+
+	Game restored("Someone", "test_box");
+	ASSERT_TRUE(GameSnapshot::Load(restored, image.data(), image.size()));
+
+	ExpectSameGame(original, restored);
+}
+TEST(SnapshotTest, RestoredGameKeepsAllocatingIdsAfterSnapshot)
+{
+	Game original("Ares");
+	original.SpawnFriendlyAt(1, 1);
+	original.SpawnFriendlyAt(2, 1);
+
+	std::vector<std::uint8_t> image = GameSnapshot::Save(original);
+	Game restored("Ares");
+	ASSERT_TRUE(GameSnapshot::Load(restored, image.data(), image.size()));
+
+	SummonResult summon = restored.SummonFriendlyNextToPlayer();
+	EXPECT_EQ(summon.summonedEntity.id, 3);
+}
+TEST(SnapshotTest, LongActorNamesRoundTrip)
+{
+	Game original(std::string(70000, 'a'), "map1", 4);
+	original.SpawnFriendlyAt(1, 1);
+	std::vector<std::uint8_t> image = GameSnapshot::Save(original);
+	EXPECT_EQ(image.size(), GameSnapshot::GetSize(original));
+
+	Game restored("Ares");
+	ASSERT_TRUE(GameSnapshot::Load(restored, image.data(), image.size()));
+	EXPECT_EQ(restored.GetPlayer().name.size(), 70000u);
+	ExpectSameGame(original, restored);
+}
+TEST(SnapshotTest, RejectsTruncatedAndCorruptImages)
+{
+	Game original("Ares", "map1", 5);
+	std::vector<std::uint8_t> image = GameSnapshot::Save(original);
+
+	Game target("Ares");
+	const int widthBefore = target.GetMap().GetWidth();
+
+	EXPECT_FALSE(GameSnapshot::Load(target, image.data(), image.size() - 1));
+
+	std::vector<std::uint8_t> corrupt = image;
+	corrupt[0] ^= 0xFF;
+	EXPECT_FALSE(GameSnapshot::Load(target, corrupt.data(), corrupt.size()));
+
+	EXPECT_EQ(target.GetMap().GetWidth(), widthBefore);
+}
+TEST(SnapshotTest, WriteFailsWhenBufferTooSmall)
+{
+	Game game("Ares");
+	std::vector<std::uint8_t> buffer(GameSnapshot::GetSize(game) - 1);
+	EXPECT_EQ(GameSnapshot::Write(game, buffer.data(), buffer.size()), 0u);
+}
+TEST(SnapshotTest, FileRoundTripThroughMappedLoad)
+{
+	Game original("Ares", "map1", 17);
+	original.ApplyTurn("move east");
+
+	const std::string path = ::testing::TempDir() + "necro_snapshot_test.bin";
+	ASSERT_TRUE(GameSnapshot::SaveToFile(original, path));
+
+	Game restored("Ares");
+	ASSERT_TRUE(GameSnapshot::LoadFromFile(restored, path));
+	std::remove(path.c_str());
+
+	ExpectSameGame(original, restored);
+}
+TEST(SnapshotTest, SessionImageKeepsMapNameAndReplayLog)
+{
+	Game original("Ares", "map1", 23);
+	original.StartRecording();
+	original.ApplyTurn("summon skeleton");
+	original.ApplyTurn("move east");
+
+	const std::vector<std::uint8_t> image = SessionImage::Save(original);
+	std::unique_ptr<Game> restored = SessionImage::Load(image.data(), image.size());
+	ASSERT_NE(restored, nullptr);
+	EXPECT_EQ(restored->GetMapName(), "map1");
+	EXPECT_EQ(restored->ComputeStateHash(), original.ComputeStateHash());
+	ASSERT_TRUE(restored->IsRecording());
+	EXPECT_EQ(restored->GetReplayLog().GetTurnCount(), 2u);
+
+	// Both keep playing the same game, and the restored log still replays
+	original.ApplyTurn("wait");
+	restored->ApplyTurn("wait");
+	EXPECT_EQ(restored->ComputeStateHash(), original.ComputeStateHash());
+	EXPECT_TRUE(ReplayRunner::Run(restored->GetReplayLog()).matched);
+
+	EXPECT_EQ(SessionImage::Load(image.data(), image.size() - 1), nullptr);
+	ExpectSameGame(original, *restored);
+}
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include "Game.h"
+#include "Map.h"
+#include "Status.h"
+#include "SpellArea.h"
+#include "TileSimulation.h"
+#include "CastResult.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace NecroCore;
+
+namespace
+{
+	int DirectionIndex(const char* name)
+	{
+		for (std::size_t i = 0; i < std::size(Map::dirs); ++i)
+		{
+			if (std::string(Map::dirs[i].name) == name)
+				return static_cast<int>(i);
+		}
+		return -1;
+	}
+
+	bool Contains(const std::vector<AreaTile>& tiles, int x, int y)
+	{
+		return std::any_of(tiles.begin(), tiles.end(), [&](const AreaTile& t) { return t.x == x && t.y == y; });
+	}
+}
+
+TEST(SpellAreaTest, StencilsHaveTheExpectedShape)
+{
+	const auto& line = SpellArea::GetStencil(AreaShape::Line, DirectionIndex("east"), 3);
+	ASSERT_EQ(line.size(), 3u);
+	for (int i = 0; i < 3; ++i)
+	{
+		EXPECT_EQ(line[static_cast<std::size_t>(i)].dx, i + 1);
+		EXPECT_EQ(line[static_cast<std::size_t>(i)].dy, 0);
+	}
+
+	EXPECT_EQ(SpellArea::GetStencil(AreaShape::Radius, 0, 1).size(), 8u);
+	EXPECT_EQ(SpellArea::GetStencil(AreaShape::Cone, DirectionIndex("east"), 2).size(), 8u);
+	// Diagonal cones cover as much as straight ones
+	EXPECT_EQ(SpellArea::GetStencil(AreaShape::Cone, DirectionIndex("north-east"), 2).size(), 8u);
+
+	// Every offset past the first ring hangs off an offset one ring closer to the caster
+	for (int size = 1; size <= SpellArea::MaxSize; ++size)
+	{
+		const auto& cone = SpellArea::GetStencil(AreaShape::Cone, DirectionIndex("south-west"), size);
+		for (const SpellArea::Offset& offset : cone)
+		{
+			const int reach = std::max(std::abs(offset.dx), std::abs(offset.dy));
+			if (reach == 1)
+			{
+				EXPECT_EQ(offset.parent, -1);
+				continue;
+			}
+			ASSERT_GE(offset.parent, 0);
+			const SpellArea::Offset& parent = cone[static_cast<std::size_t>(offset.parent)];
+			EXPECT_EQ(std::max(std::abs(parent.dx), std::abs(parent.dy)), reach - 1);
+		}
+	}
+}
+
+TEST(SpellAreaTest, WallsShadowTheTilesBehindThem)
+{
+	Game game("Ares");
+	Player& player = game.GetPlayer();
+	Map& map = game.GetMap();
+	map.convertTile(player.x + 2, player.y, TileType::Wall);
+
+	std::vector<AreaTile> tiles;
+	SpellArea::Resolve(map, AreaShape::Line, DirectionIndex("east"), 5, player.x, player.y, tiles);
+	ASSERT_EQ(tiles.size(), 1u);
+	EXPECT_TRUE(Contains(tiles, player.x + 1, player.y));
+
+	SpellArea::Resolve(map, AreaShape::Cone, DirectionIndex("east"), 3, player.x, player.y, tiles);
+	EXPECT_TRUE(Contains(tiles, player.x + 1, player.y));
+	EXPECT_FALSE(Contains(tiles, player.x + 2, player.y));
+	EXPECT_FALSE(Contains(tiles, player.x + 3, player.y));
+	EXPECT_TRUE(Contains(tiles, player.x + 2, player.y + 1));
+}
+
+TEST(SpellAreaTest, FireConeIgnitesFloorAndCatchesEntities)
+{
+	Game game("Ares");
+	Player& player = game.GetPlayer();
+	Map& map = game.GetMap();
+	game.SpawnHostileWithStatsForTest(player.x + 2, player.y + 1, 20, 1, "Skeleton");
+	game.SpawnHostileWithStatsForTest(player.x - 2, player.y, 20, 1, "Bystander");
+
+	CommandResult cmd = game.ApplyCommand("cast fire cone east 2");
+	ASSERT_TRUE(cmd.success);
+
+	EXPECT_TRUE(HasStatus(map.GetTileState(player.x + 1, player.y), StatusEffect::OnFire));
+	EXPECT_TRUE(HasStatus(map.GetTileState(player.x + 2, player.y - 2), StatusEffect::OnFire));
+	EXPECT_FALSE(HasStatus(map.GetTileState(player.x - 1, player.y), StatusEffect::OnFire));
+	EXPECT_FALSE(HasStatus(player.status, StatusEffect::OnFire));
+
+	EXPECT_TRUE(HasStatus(game.GetEntityByName("Skeleton")->status, StatusEffect::OnFire));
+	EXPECT_FALSE(HasStatus(game.GetEntityByName("Bystander")->status, StatusEffect::OnFire));
+
+	const CastResult& cast = std::get<CastResult>(cmd.payload);
+	EXPECT_EQ(cast.tilesAffected, 8);
+	EXPECT_EQ(cast.actorsAffected, 1);
+	EXPECT_NE(std::string::npos, cmd.description.find("A cone of fire fans out to the east, setting 8 tiles alight."));
+	EXPECT_NE(std::string::npos, cmd.description.find("A Skeleton catches fire."));
+}
+
+TEST(SpellAreaTest, WaterRadiusDousesTilesAndActors)
+{
+	Game game("Ares");
+	Player& player = game.GetPlayer();
+	Map& map = game.GetMap();
+	game.SpawnHostileWithStatsForTest(player.x - 1, player.y, 20, 1, "Torch");
+	game.GetEntityByName("Torch")->AddStatus(StatusEffect::OnFire);
+	ASSERT_TRUE(TileSimulation::Ignite(map, player.x + 1, player.y, 3));
+
+	CommandResult cmd = game.ApplyCommand("cast water radius 1");
+	ASSERT_TRUE(cmd.success);
+
+	EXPECT_FALSE(HasStatus(map.GetTileState(player.x + 1, player.y), StatusEffect::OnFire));
+	EXPECT_TRUE(HasStatus(map.GetTileState(player.x + 1, player.y), StatusEffect::Wet));
+	EXPECT_FALSE(HasStatus(game.GetEntityByName("Torch")->status, StatusEffect::OnFire));
+	// The caster's own tile is not part of the ring
+	EXPECT_EQ(map.GetTileState(player.x, player.y), StatusEffect::Normal);
+
+	const CastResult& cast = std::get<CastResult>(cmd.payload);
+	EXPECT_EQ(cast.tilesAffected, 8);
+	EXPECT_EQ(cast.actorsAffected, 1);
+	EXPECT_NE(std::string::npos, cmd.description.find("The flames on a Torch hiss out."));
+}
+
+TEST(SpellAreaTest, AreaCastsAreValidatedAndUndoable)
+{
+	Game game("Ares");
+	EXPECT_FALSE(game.ApplyCommand("cast fire line north 11").success);
+	EXPECT_FALSE(game.ApplyCommand("cast fire cone self").success);
+	EXPECT_FALSE(game.ApplyCommand("cast fire line").success);
+
+	const Game fork = game.Fork();
+	const std::uint64_t before = game.ComputeStateHash();
+	CommandResult cmd = game.ApplyTurn("cast fire radius 2");
+	ASSERT_TRUE(cmd.success);
+	EXPECT_NE(game.ComputeStateHash(), before);
+	// The bulk write clones the shared layers instead of writing through them
+	EXPECT_EQ(fork.GetMap().GetTileState(game.GetPlayer().x + 1, game.GetPlayer().y), StatusEffect::Normal);
+
+	EXPECT_EQ(game.Undo(1), 1);
+	EXPECT_EQ(game.ComputeStateHash(), before);
+}
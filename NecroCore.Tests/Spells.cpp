@@ -2,6 +2,8 @@
 #include "Game.h"
 #include "Map.h"
 #include "Status.h"
+#include "Spell.h"
+#include "CastResult.h"
 
 using namespace NecroCore;
 
@@ -125,4 +127,55 @@ TEST(SpellsTest, FireSpellOnAlreadyBurningFireplaceDoesNothingSpecial)
     EXPECT_TRUE(HasStatus(map.GetTileState(tx, ty), StatusEffect::OnFire));
 
     EXPECT_TRUE(cmd.success);
-}
\ No newline at end of file
+}
+
+namespace
+{
+    class ChillSpell : public ISpell
+    {
+    public:
+        const char* GetName() const override { return "chill"; }
+        StatusEffect GetElement() const override { return StatusEffect::Wet; }
+        CastResult Cast(Game&, int, int, const std::string& direction) const override
+        {
+            CastResult result{};
+            result.description = "A chill runs " + direction + ".";
+            return result;
+        }
+    };
+}
+
+TEST(SpellsTest, RegistryHoldsEveryBuiltInSpell)
+{
+    ASSERT_NE(SpellRegistry::Find("fire"), nullptr);
+    EXPECT_EQ(SpellRegistry::Find("fire")->GetElement(), StatusEffect::OnFire);
+    EXPECT_EQ(SpellRegistry::Find("water")->GetElement(), StatusEffect::Wet);
+    EXPECT_EQ(StatusEffectFromSpell("poison"), StatusEffect::Poisoned);
+    EXPECT_EQ(SpellRegistry::Find("rock"), nullptr);
+    EXPECT_EQ(SpellRegistry::Find(""), nullptr);
+    EXPECT_EQ(SpellRegistry::Find("fir"), nullptr);
+}
+
+TEST(SpellsTest, RegisteredSpellIsCastableAndListed)
+{
+    static const ChillSpell chill;
+    SpellRegistry::Register(chill);
+
+    EXPECT_EQ(SpellRegistry::Find("chill"), &chill);
+    EXPECT_NE(SpellRegistry::GetElementList().find("chill"), std::string::npos);
+    for (const ISpell* spell : SpellRegistry::GetSpells())
+    {
+        EXPECT_EQ(SpellRegistry::Find(spell->GetName()), spell);
+    }
+
+    Game game("Ares");
+    CommandResult cmd = game.ApplyTurn("cast chill east");
+    EXPECT_TRUE(cmd.success);
+    EXPECT_NE(cmd.description.find("A chill runs east."), std::string::npos);
+
+    // The registry is shared by every test; leave it as the built-in spells
+    SpellRegistry::Unregister("chill");
+    EXPECT_EQ(SpellRegistry::Find("chill"), nullptr);
+    EXPECT_EQ(SpellRegistry::GetElementList().find("chill"), std::string::npos);
+    EXPECT_FALSE(game.ApplyTurn("cast chill east").success);
+}
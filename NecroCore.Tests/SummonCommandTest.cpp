@@ -116,14 +116,11 @@ TEST(SummonCommandTest, SummonCommandReturnsCorrectArgs)
 	Game game("Ares");
 	game.SpawnFriendlyWithStatsForTest(game.GetPlayer().x + 1, game.GetPlayer().y, 1, 1, "friendly undead");
 	auto command = game.ApplyCommand("command all attack");
-	auto itTarget = command.args.find("target");
-	ASSERT_NE(itTarget, command.args.end());
-	EXPECT_TRUE(std::holds_alternative<std::string>(itTarget->second));
-	EXPECT_EQ(std::get<std::string>(itTarget->second), "all");
-	auto itOrder = command.args.find("order");
-	ASSERT_NE(itOrder, command.args.end());
-	EXPECT_TRUE(std::holds_alternative<std::string>(itOrder->second));
-	EXPECT_EQ(std::get<std::string>(itOrder->second), "attack");
+	const SummonOrderCmd* order = std::get_if<SummonOrderCmd>(&command.command);
+	ASSERT_NE(order, nullptr);
+	EXPECT_EQ(order->target.View(), "all");
+	EXPECT_EQ(order->order, SummonOrder::Attack);
+	EXPECT_EQ(order->orderWord.View(), "attack");
 }
 TEST(SummonCommandTest, SummonAttacksWhenSpawned)
 {
@@ -58,10 +58,9 @@ TEST(SummonTest, SummonCommandReturnsCorrectArgs)
 	Game game("Ares");
 	auto command = game.ApplyCommand("summon skeleton");
 
-	auto it = command.args.find("creature");
-	ASSERT_NE(it, command.args.end());
-	EXPECT_TRUE(std::holds_alternative<std::string>(it->second));
-	EXPECT_EQ(std::get<std::string>(it->second), "skeleton");
+	const SummonCmd* summon = std::get_if<SummonCmd>(&command.command);
+	ASSERT_NE(summon, nullptr);
+	EXPECT_EQ(summon->creature.View(), "skeleton");
 }
 
 TEST(SummonTest, SummonCommandPopulatesPayload)
@@ -0,0 +1,152 @@
+#include <gtest/gtest.h>
+#include "Game.h"
+#include "Map.h"
+#include "Random.h"
+#include "TileSimulation.h"
+
+using namespace NecroCore;
+
+namespace
+{
+	Map MakeOpenMap(int width, int height)
+	{
+		std::vector<std::string> rows(static_cast<std::size_t>(height), std::string(static_cast<std::size_t>(width), '.'));
+		for (int x = 0; x < width; ++x)
+		{
+			rows.front()[static_cast<std::size_t>(x)] = '#';
+			rows.back()[static_cast<std::size_t>(x)] = '#';
+		}
+		for (std::string& row : rows)
+		{
+			row.front() = '#';
+			row.back() = '#';
+		}
+		Map map;
+		map.LoadFromAscii(rows);
+		return map;
+	}
+
+	void StepUntilSettled(Map& map)
+	{
+		for (int i = 0; i < 64 && map.HasDirtyBlocks(); ++i)
+		{
+			TileSimulation::Step(map);
+		}
+	}
+}
+
+TEST(TileSimulationTest, FireSpreadsThenBurnsOut)
+{
+	Map map = MakeOpenMap(20, 20);
+	ASSERT_TRUE(TileSimulation::Ignite(map, 10, 10, 3));
+
+	TileSimulation::Step(map);
+
+	EXPECT_EQ(map.GetTileLevel(10, 10), 2);
+	EXPECT_TRUE(HasStatus(map.GetTileState(11, 10), StatusEffect::OnFire));
+	EXPECT_EQ(map.GetTileLevel(11, 10), 2);
+	EXPECT_FALSE(HasStatus(map.GetTileState(11, 11), StatusEffect::OnFire));
+
+	StepUntilSettled(map);
+
+	EXPECT_FALSE(map.HasDirtyBlocks());
+	EXPECT_EQ(map.GetTileState(10, 10), StatusEffect::Normal);
+	EXPECT_EQ(map.GetTileLevel(10, 10), Map::ScorchedLevel);
+	EXPECT_EQ(map.GetTileLevel(12, 10), Map::ScorchedLevel);
+	EXPECT_EQ(map.GetTileLevel(13, 10), 0);
+	EXPECT_FALSE(TileSimulation::Ignite(map, 10, 10, 3));
+}
+TEST(TileSimulationTest, WaterPoolsAndPutsOutFire)
+{
+	Map map = MakeOpenMap(20, 20);
+	ASSERT_TRUE(TileSimulation::Ignite(map, 8, 5, 5));
+	ASSERT_TRUE(TileSimulation::Flood(map, 6, 5, 3));
+
+	StepUntilSettled(map);
+
+	EXPECT_EQ(map.GetTileState(6, 5), StatusEffect::Wet);
+	EXPECT_EQ(map.GetTileLevel(6, 5), 3);
+	EXPECT_EQ(map.GetTileLevel(7, 5), 2);
+	EXPECT_EQ(map.GetTileLevel(8, 5), 1);
+	EXPECT_EQ(map.GetTileState(8, 5), StatusEffect::Wet);
+	EXPECT_EQ(map.GetTileState(9, 5), StatusEffect::Normal);
+}
+TEST(TileSimulationTest, HearthsAndHandPlacedStatesStayPut)
+{
+	Game game("Ares");
+	Map& map = game.GetMap();
+	const Player& player = game.GetPlayer();
+	game.SpawnFireplaceAt(player.x + 2, player.y, true);
+	map.SetTileState(player.x - 2, player.y, StatusEffect::OnFire);
+
+	for (int i = 0; i < 4; ++i)
+	{
+		game.ApplyTurn("wait");
+	}
+
+	EXPECT_TRUE(HasStatus(map.GetTileState(player.x + 2, player.y), StatusEffect::OnFire));
+	EXPECT_TRUE(HasStatus(map.GetTileState(player.x - 2, player.y), StatusEffect::OnFire));
+	EXPECT_EQ(map.GetTileState(player.x + 3, player.y), StatusEffect::Normal);
+	EXPECT_EQ(map.GetTileState(player.x - 3, player.y), StatusEffect::Normal);
+}
+TEST(TileSimulationTest, SprungFireTrapSpreadsAndUndoRestoresIt)
+{
+	Game game("Ares");
+	Map& map = game.GetMap();
+	Player& player = game.GetPlayer();
+	const int trapX = player.x + 1;
+	const int trapY = player.y;
+	game.SpawnTrapAt(trapX, trapY, StatusEffect::OnFire);
+
+	game.ApplyTurn("move east");
+
+	EXPECT_TRUE(HasStatus(map.GetTileState(trapX, trapY - 1), StatusEffect::OnFire));
+	EXPECT_EQ(map.GetTileLevel(trapX, trapY), TileSimulation::TrapFireIntensity - 1);
+
+	game.Undo(1);
+
+	EXPECT_TRUE(map.IsTrap(trapX, trapY));
+	EXPECT_EQ(map.GetTileLevel(trapX, trapY), 0);
+	EXPECT_EQ(map.GetTileState(trapX, trapY - 1), StatusEffect::Normal);
+}
+TEST(TileSimulationTest, SettledMapCostsNothing)
+{
+	Map map = MakeOpenMap(64, 64);
+	TileSimulation::Flood(map, 5, 5, 2);
+	StepUntilSettled(map);
+
+	const TileSimulation::StepStats stats = TileSimulation::Step(map);
+
+	EXPECT_EQ(stats.blocksStepped, 0);
+	EXPECT_EQ(stats.tilesChanged, 0);
+}
+TEST(TileSimulationTest, SimdAndScalarStepsAgree)
+{
+	if (!TileSimulation::IsSimdAvailable())
+		GTEST_SKIP() << "No SIMD path on this target";
+
+	Map simd = MakeOpenMap(70, 45);
+	Random random(42);
+	for (int i = 0; i < 60; ++i)
+	{
+		const int x = random.NextInt(1, 68);
+		const int y = random.NextInt(1, 43);
+		const std::uint8_t level = static_cast<std::uint8_t>(random.NextInt(1, 6));
+		if (random.NextBool())
+			TileSimulation::Ignite(simd, x, y, level);
+		else
+			TileSimulation::Flood(simd, x, y, level);
+	}
+	Map scalar = simd;
+
+	for (int step = 0; step < 8; ++step)
+	{
+		TileSimulation::SetSimdEnabled(true);
+		TileSimulation::Step(simd);
+		TileSimulation::SetSimdEnabled(false);
+		TileSimulation::Step(scalar);
+		TileSimulation::SetSimdEnabled(true);
+
+		ASSERT_EQ(simd.ComputeHash(0), scalar.ComputeHash(0)) << "diverged at step " << step;
+	}
+}
@@ -0,0 +1,133 @@
+#include <gtest/gtest.h>
+#include "Game.h"
+#include "GameSnapshot.h"
+#include "Random.h"
+#include "TimingWheel.h"
+
+#include <vector>
+
+using namespace NecroCore;
+
+TEST(TimingWheelTest, ThousandsOfTimersFireOnTheirTurn)
+{
+	TimingWheel wheel;
+	wheel.Reset(0);
+
+	Random random(7);
+	const int count = 5000;
+	for (int id = 0; id < count; ++id)
+	{
+		// Spread over all three lower levels
+		wheel.Schedule({ static_cast<std::uint64_t>(random.NextInt(1, 300000)), TimerKind::WorldEvent, id });
+	}
+	ASSERT_EQ(wheel.GetCount(), static_cast<std::size_t>(count));
+
+	std::vector<TimerEvent> due;
+	int fired = 0;
+	for (std::uint64_t turn = 1; turn <= 300000; ++turn)
+	{
+		due.clear();
+		wheel.Advance(turn, due);
+		for (const TimerEvent& event : due)
+		{
+			ASSERT_EQ(event.due, turn) << "timer " << event.id;
+		}
+		fired += static_cast<int>(due.size());
+	}
+
+	EXPECT_EQ(fired, count);
+	EXPECT_EQ(wheel.GetCount(), 0u);
+}
+TEST(TimingWheelTest, OverflowAndOverdueTimers)
+{
+	TimingWheel wheel;
+	const std::uint64_t horizon = std::uint64_t{ 1 } << (TimingWheel::SlotBits * TimingWheel::LevelCount);
+	wheel.Reset(horizon - 10);
+
+	wheel.Schedule({ horizon + 5, TimerKind::WorldEvent, 1 });
+	wheel.Schedule({ horizon - 20, TimerKind::WorldEvent, 2 });
+
+	std::vector<TimerEvent> due;
+	wheel.Advance(horizon - 9, due);
+	ASSERT_EQ(due.size(), 1u);
+	EXPECT_EQ(due[0].id, 2);
+
+	due.clear();
+	wheel.Advance(horizon + 4, due);
+	EXPECT_TRUE(due.empty());
+	wheel.Advance(horizon + 5, due);
+	ASSERT_EQ(due.size(), 1u);
+	EXPECT_EQ(due[0].id, 1);
+}
+TEST(TimingWheelTest, DelayedExplosionGoesOffOnTime)
+{
+	Game game("Ares");
+	const Player& player = game.GetPlayer();
+	game.SpawnHostileWithStatsForTest(player.x + 1, player.y + 1, 10, 0, "Skeleton");
+	const int hostileId = game.GetEntities().back().id;
+	game.ScheduleWorldEvent(WorldEvent::Explosion(player.x, player.y, 1, 3), 2);
+
+	CommandResult first = game.ApplyTurn("wait");
+	EXPECT_EQ(first.description.find("explosion"), std::string::npos);
+	EXPECT_EQ(game.GetPlayer().hp, game.GetPlayer().maxHp);
+
+	CommandResult second = game.ApplyTurn("wait");
+	EXPECT_NE(second.description.find("You are caught in the blast."), std::string::npos);
+	EXPECT_EQ(game.GetPlayer().hp, game.GetPlayer().maxHp - 3);
+	EXPECT_TRUE(game.GetWorldEvents().empty());
+	EXPECT_NE(second.description.find("A Skeleton is caught in the blast."), std::string::npos);
+	EXPECT_EQ(game.GetEntityById(hostileId)->hp, 7);
+
+	game.Undo(1);
+	ASSERT_EQ(game.GetWorldEvents().size(), 1u);
+	EXPECT_EQ(game.GetPlayer().hp, game.GetPlayer().maxHp);
+
+	CommandResult again = game.ApplyTurn("wait");
+	EXPECT_NE(again.description.find("You are caught in the blast."), std::string::npos);
+}
+TEST(TimingWheelTest, SprungTrapRearms)
+{
+	Game game("Ares");
+	Map& map = game.GetMap();
+	const int trapX = game.GetPlayer().x + 1;
+	const int trapY = game.GetPlayer().y;
+	game.SpawnTrapAt(trapX, trapY, StatusEffect::Poisoned);
+
+	game.ApplyTurn("move east");
+	ASSERT_FALSE(map.IsTrap(trapX, trapY));
+	game.ApplyTurn("move west");
+	game.ScheduleWorldEvent(WorldEvent::RearmTrap(trapX, trapY, StatusEffect::Poisoned), 3);
+
+	game.ApplyTurn("wait");
+	game.ApplyTurn("wait");
+	EXPECT_FALSE(map.IsTrap(trapX, trapY));
+	game.ApplyTurn("wait");
+	EXPECT_TRUE(map.IsTrap(trapX, trapY));
+	EXPECT_EQ(map.GetTileState(trapX, trapY), StatusEffect::Poisoned);
+}
+TEST(TimingWheelTest, PendingEventsSurviveSnapshotAndFork)
+{
+	Game game("Ares");
+	game.ApplyTurn("wait");
+	game.ScheduleWorldEvent(WorldEvent::Explosion(1, 1, 0, 1), 4);
+
+	Game loaded("Someone");
+	const std::vector<std::uint8_t> image = GameSnapshot::Save(game);
+	ASSERT_TRUE(GameSnapshot::Load(loaded, image.data(), image.size()));
+	EXPECT_EQ(loaded.GetTurn(), game.GetTurn());
+	ASSERT_EQ(loaded.GetWorldEvents().size(), 1u);
+	EXPECT_EQ(loaded.GetWorldEvents()[0].dueTurn, game.GetWorldEvents()[0].dueTurn);
+	EXPECT_EQ(loaded.ComputeStateHash(), game.ComputeStateHash());
+
+	Game fork = game.Fork();
+	for (int i = 0; i < 4; ++i)
+	{
+		game.ApplyTurn("wait");
+		loaded.ApplyTurn("wait");
+		fork.ApplyTurn("wait");
+	}
+	EXPECT_TRUE(game.GetWorldEvents().empty());
+	EXPECT_TRUE(loaded.GetWorldEvents().empty());
+	EXPECT_TRUE(fork.GetWorldEvents().empty());
+	EXPECT_EQ(loaded.ComputeStateHash(), game.ComputeStateHash());
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include "Game.h"
+
+using namespace NecroCore;
+
+TEST(TurnBudgetTest, UnlimitedTurnReportsEverySystem)
+{
+	Game game("Ares");
+	const Player& player = game.GetPlayer();
+	game.SpawnHostileAt(player.x + 2, player.y);
+	game.SpawnFriendlyAt(player.x - 1, player.y);
+
+	game.ApplyTurn("wait");
+
+	const TurnStats& stats = game.GetLastTurnStats();
+	EXPECT_FALSE(stats.budgeted);
+	EXPECT_FALSE(stats.overBudget);
+	EXPECT_EQ(stats.Get(TurnSystem::Command).processed, 1);
+	EXPECT_EQ(stats.Get(TurnSystem::Summons).processed, 1);
+	EXPECT_EQ(stats.Get(TurnSystem::Hostiles).processed, 1);
+	EXPECT_EQ(stats.Get(TurnSystem::Hostiles).deferred, 0);
+	EXPECT_GE(stats.total, stats.Get(TurnSystem::Hostiles).elapsed);
+}
+TEST(TurnBudgetTest, ExhaustedBudgetDefersHostilesToNextTurn)
+{
+	Game game("Ares");
+	Player& player = game.GetPlayer();
+	game.SpawnHostileAt(player.x + 1, player.y);
+	game.SpawnHostileAt(player.x - 1, player.y);
+	const int hpBefore = player.hp;
+
+	game.ApplyTurn("wait", std::chrono::microseconds(0));
+
+	const TurnStats& stats = game.GetLastTurnStats();
+	EXPECT_TRUE(stats.budgeted);
+	EXPECT_TRUE(stats.overBudget);
+	EXPECT_EQ(stats.Get(TurnSystem::Hostiles).processed, 0);
+	EXPECT_EQ(stats.Get(TurnSystem::Hostiles).deferred, 2);
+	EXPECT_EQ(player.hp, hpBefore);
+	EXPECT_EQ(game.GetActivation().GetDeferredTurns(game.GetEntities().front().id), 1);
+
+	game.ApplyTurn("wait", std::chrono::seconds(10));
+
+	EXPECT_EQ(game.GetLastTurnStats().Get(TurnSystem::Hostiles).processed, 2);
+	EXPECT_EQ(player.hp, hpBefore - 2);
+	EXPECT_EQ(game.GetActivation().GetDeferredTurns(game.GetEntities().front().id), 0);
+}
+TEST(TurnBudgetTest, DeferredHostilesStayAwake)
+{
+	Game game("Ares");
+	game.GetPlayer().x = 1;
+	game.GetPlayer().y = 1;
+	game.SpawnHostileAt(5, 1);
+	const int id = game.GetEntities().back().id;
+
+	for (int i = 0; i < ActivationSystem::IdleTurnsBeforeSleep + 1; ++i)
+	{
+		game.ApplyTurn("wait", std::chrono::microseconds(0));
+	}
+
+	EXPECT_FALSE(game.GetActivation().IsSleeping(id));
+	EXPECT_EQ(game.GetEntities().back().x, 5);
+}
+TEST(TurnBudgetTest, GenerousBudgetMatchesUnlimitedTurn)
+{
+	Game budgeted("Ares", "map1", 3);
+	Game unlimited("Ares", "map1", 3);
+	budgeted.SpawnHostileAt(budgeted.GetPlayer().x + 2, budgeted.GetPlayer().y);
+	unlimited.SpawnHostileAt(unlimited.GetPlayer().x + 2, unlimited.GetPlayer().y);
+
+	for (const char* command : { "summon skeleton", "wait", "wait" })
+	{
+		budgeted.ApplyTurn(command, std::chrono::seconds(10));
+		unlimited.ApplyTurn(command);
+	}
+
+	EXPECT_EQ(budgeted.ComputeStateHash(), unlimited.ComputeStateHash());
+}
+TEST(TurnBudgetTest, GenerousBudgetKeepsIdOrder)
+{
+	Game budgeted("Ares", "map1", 5);
+	Game unlimited("Ares", "map1", 5);
+	for (Game* game : { &budgeted, &unlimited })
+	{
+		const Player& player = game->GetPlayer();
+		game->SpawnHostileAt(player.x + 4, player.y);
+		game->SpawnHostileAt(player.x, player.y + 3);
+		game->SpawnHostileAt(player.x - 1, player.y);
+	}
+
+	for (const char* command : { "wait", "summon skeleton", "wait", "wait" })
+	{
+		const CommandResult fromBudgeted = budgeted.ApplyTurn(command, std::chrono::seconds(10));
+		const CommandResult fromUnlimited = unlimited.ApplyTurn(command);
+		EXPECT_EQ(fromBudgeted.description, fromUnlimited.description);
+	}
+
+	EXPECT_EQ(budgeted.ComputeStateHash(), unlimited.ComputeStateHash());
+}
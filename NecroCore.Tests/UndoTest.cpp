@@ -0,0 +1,104 @@
+#include <gtest/gtest.h>
+#include "Game.h"
+#include "TurnJournal.h"
+
+using namespace NecroCore;
+
+TEST(UndoTest, UndoRestoresPlayerPosition)
+{
+	Game game("Ares");
+	const Player& player = game.GetPlayer();
+	const int startX = player.x;
+	const int startY = player.y;
+
+	game.ApplyTurn("move north");
+	game.ApplyTurn("move east");
+
+	EXPECT_EQ(game.Undo(1), 1);
+	EXPECT_EQ(player.x, startX);
+	EXPECT_EQ(player.y, startY - 1);
+
+	EXPECT_EQ(game.Undo(1), 1);
+	EXPECT_EQ(player.x, startX);
+	EXPECT_EQ(player.y, startY);
+}
+TEST(UndoTest, UndoRearmsTrapAndClearsStatus)
+{
+	Game game("Ares");
+	Player& player = game.GetPlayer();
+	const int trapX = player.x + 1;
+	const int trapY = player.y;
+	game.SpawnTrapAt(trapX, trapY, StatusEffect::Poisoned);
+	const int hpBefore = player.hp;
+
+	game.ApplyTurn("move east");
+	EXPECT_TRUE(HasStatus(player.status, StatusEffect::Poisoned));
+	EXPECT_FALSE(game.GetMap().IsTrap(trapX, trapY));
+
+	EXPECT_EQ(game.Undo(1), 1);
+	EXPECT_TRUE(game.GetMap().IsTrap(trapX, trapY));
+	EXPECT_EQ(game.GetMap().GetTileState(trapX, trapY), StatusEffect::Poisoned);
+	EXPECT_EQ(player.status, StatusEffect::Normal);
+	EXPECT_EQ(player.GetStatusDuration(StatusEffect::Poisoned), 0);
+	EXPECT_EQ(player.hp, hpBefore);
+}
+TEST(UndoTest, UndoBringsBackSlainHostileInPlace)
+{
+	Game game("Ares");
+	const Player& player = game.GetPlayer();
+	game.SpawnHostileWithStatsForTest(1, 1, 5, 1, "Far");
+	game.SpawnHostileWithStatsForTest(player.x, player.y - 1, 1, 1, "Weak");
+	game.SpawnHostileWithStatsForTest(13, 5, 5, 1, "Other");
+
+	game.ApplyTurn("attack north");
+	ASSERT_EQ(game.GetEntityByName("Weak"), nullptr);
+
+	EXPECT_EQ(game.Undo(1), 1);
+	ASSERT_EQ(game.GetEntities().size(), 3u);
+	EXPECT_EQ(game.GetEntities()[0].name, "Far");
+	EXPECT_EQ(game.GetEntities()[1].name, "Weak");
+	EXPECT_EQ(game.GetEntities()[1].hp, 1);
+	EXPECT_EQ(game.GetEntities()[2].name, "Other");
+}
+TEST(UndoTest, UndoRemovesSummonAndReusesItsId)
+{
+	Game game("Ares");
+
+	game.ApplyTurn("summon skeleton");
+	ASSERT_EQ(game.GetEntities().size(), 1u);
+	const int firstId = game.GetEntities()[0].id;
+
+	EXPECT_EQ(game.Undo(1), 1);
+	EXPECT_TRUE(game.GetEntities().empty());
+
+	game.ApplyTurn("summon skeleton");
+	ASSERT_EQ(game.GetEntities().size(), 1u);
+	EXPECT_EQ(game.GetEntities()[0].id, firstId);
+}
+TEST(UndoTest, FailedCommandIsNotATurn)
+{
+	Game game("Ares");
+	const Player& player = game.GetPlayer();
+	const int startY = player.y;
+
+	game.ApplyTurn("move north");
+	game.ApplyTurn("dance");
+
+	EXPECT_EQ(game.GetJournal().GetDepth(), 1u);
+	EXPECT_EQ(game.Undo(1), 1);
+	EXPECT_EQ(player.y, startY);
+}
+TEST(UndoTest, JournalIsBoundedRing)
+{
+	Game game("Ares");
+	const std::size_t capacity = game.GetJournal().GetCapacity();
+
+	for (std::size_t i = 0; i < capacity + 10; ++i)
+	{
+		game.ApplyTurn("wait");
+	}
+
+	EXPECT_EQ(game.GetJournal().GetDepth(), capacity);
+	EXPECT_EQ(game.Undo(static_cast<int>(capacity) + 10), static_cast<int>(capacity));
+	EXPECT_EQ(game.Undo(1), 0);
+}
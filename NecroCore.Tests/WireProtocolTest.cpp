@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+#include "WireProtocol.h"
+#include "Schema.h"
+
+#include <string>
+
+using namespace NecroCore;
+
+namespace
+{
+	std::string RoundTripCommand(const std::string& text)
+	{
+		std::string bytes;
+		if (!WireProtocol::EncodeCommand(bytes, text))
+			return "<encode failed>";
+		SchemaReader reader(bytes);
+		std::string decoded;
+		if (!WireProtocol::DecodeCommand(reader, decoded) || !reader.AtEnd())
+			return "<decode failed>";
+		return decoded;
+	}
+}
+
+TEST(WireProtocolTest, CommandsDecodeToCanonicalText)
+{
+	EXPECT_EQ(RoundTripCommand("wait"), "wait");
+	EXPECT_EQ(RoundTripCommand("  help "), "help");
+	EXPECT_EQ(RoundTripCommand("pulse"), "pulse 5");
+	EXPECT_EQ(RoundTripCommand("pulse 8"), "pulse 8");
+	EXPECT_EQ(RoundTripCommand("move north"), "move north");
+	EXPECT_EQ(RoundTripCommand("attack  west"), "attack west");
+	EXPECT_EQ(RoundTripCommand("cast fire east"), "cast fire east");
+	EXPECT_EQ(RoundTripCommand("cast water self"), "cast water self");
+	EXPECT_EQ(RoundTripCommand("cast fire cone south"), "cast fire cone south 3");
+	EXPECT_EQ(RoundTripCommand("cast water line east 5"), "cast water line east 5");
+	EXPECT_EQ(RoundTripCommand("cast fire radius 2"), "cast fire radius 2");
+	EXPECT_EQ(RoundTripCommand("summon skeleton"), "summon skeleton");
+	EXPECT_EQ(RoundTripCommand("command all guard"), "command all guard");
+	EXPECT_EQ(RoundTripCommand("command skeleton move north"), "command skeleton move north");
+
+	// Opcodes are far smaller than the text they stand for
+	std::string bytes;
+	ASSERT_TRUE(WireProtocol::EncodeCommand(bytes, "move north"));
+	EXPECT_EQ(bytes.size(), 2u);
+}
+
+TEST(WireProtocolTest, CommandsTheParserCannotResolveAreRejected)
+{
+	std::string bytes;
+	EXPECT_FALSE(WireProtocol::EncodeCommand(bytes, ""));
+	EXPECT_FALSE(WireProtocol::EncodeCommand(bytes, "dance"));
+	EXPECT_FALSE(WireProtocol::EncodeCommand(bytes, "move sideways"));
+	EXPECT_FALSE(WireProtocol::EncodeCommand(bytes, "move self"));
+	EXPECT_FALSE(WireProtocol::EncodeCommand(bytes, "cast fire line"));
+	EXPECT_FALSE(WireProtocol::EncodeCommand(bytes, "command all dance"));
+	EXPECT_FALSE(WireProtocol::EncodeTurnRequest(bytes, "session", "command all move"));
+	// A failed encode leaves nothing behind
+	EXPECT_TRUE(bytes.empty());
+
+	// Out-of-range enum bytes never reach the game
+	std::string bad;
+	bad += static_cast<char>(WireProtocol::Opcode::Move);
+	bad += static_cast<char>(200);
+	SchemaReader reader(bad);
+	std::string text;
+	EXPECT_FALSE(WireProtocol::DecodeCommand(reader, text));
+}
+
+TEST(WireProtocolTest, RequestsAndResponsesRoundTrip)
+{
+	WireProtocol::NewGameRequest newGame;
+	newGame.playerName = "Mira";
+	newGame.mapName = "map2";
+	newGame.hasSeed = true;
+	newGame.seed = 123456789012345ull;
+	std::string bytes;
+	WireProtocol::EncodeNewGameRequest(bytes, newGame);
+	WireProtocol::NewGameRequest newGameBack;
+	ASSERT_TRUE(WireProtocol::DecodeNewGameRequest(bytes, newGameBack));
+	EXPECT_EQ(newGameBack.playerName, "Mira");
+	EXPECT_EQ(newGameBack.mapName, "map2");
+	EXPECT_TRUE(newGameBack.hasSeed);
+	EXPECT_EQ(newGameBack.seed, 123456789012345ull);
+
+	bytes.clear();
+	WireProtocol::EncodeNewGameResponse(bytes, "abc123", 42);
+	WireProtocol::NewGameResponse created;
+	ASSERT_TRUE(WireProtocol::DecodeNewGameResponse(bytes, created));
+	EXPECT_EQ(created.sessionId, "abc123");
+	EXPECT_EQ(created.seed, 42u);
+	// Each decoder only accepts its own message type
+	EXPECT_FALSE(WireProtocol::DecodeNewGameRequest(bytes, newGameBack));
+
+	bytes.clear();
+	ASSERT_TRUE(WireProtocol::EncodeTurnRequest(bytes, "abc123", "cast fire cone north 4"));
+	WireProtocol::TurnRequest turn;
+	ASSERT_TRUE(WireProtocol::DecodeTurnRequest(bytes, turn));
+	EXPECT_EQ(turn.sessionId, "abc123");
+	EXPECT_EQ(turn.command, "cast fire cone north 4");
+
+	bytes.clear();
+	WireProtocol::EncodeError(bytes, 404, "Unknown sessionId");
+	WireProtocol::ErrorResponse error;
+	ASSERT_TRUE(WireProtocol::DecodeError(bytes, error));
+	EXPECT_EQ(error.status, 404);
+	EXPECT_EQ(error.message, "Unknown sessionId");
+
+	EXPECT_TRUE(WireProtocol::IsWireContentType("application/x-necro-wire"));
+	EXPECT_TRUE(WireProtocol::IsWireContentType("application/x-necro-wire; charset=binary"));
+	EXPECT_FALSE(WireProtocol::IsWireContentType("application/json"));
+}
+
+TEST(WireProtocolTest, TurnResponsesShareRepeatedLinesAndRejectTruncation)
+{
+	CommandResult result;
+	result.success = true;
+	result.action = CommandAction::Pulse;
+	result.description = "The skeleton strikes you.\nThe skeleton strikes you.\nYou feel weaker.\nThe skeleton strikes you.";
+	PulseResult pulse;
+	pulse.detectedHostileCount = 3;
+	result.payload = pulse;
+
+	std::string bytes;
+	WireProtocol::EncodeTurnResponse(bytes, result);
+	// The repeated line is stored once
+	EXPECT_EQ(bytes.find("strikes"), bytes.rfind("strikes"));
+
+	WireProtocol::TurnResponse decoded;
+	ASSERT_TRUE(WireProtocol::DecodeTurnResponse(bytes, decoded));
+	EXPECT_TRUE(decoded.success);
+	EXPECT_FALSE(decoded.gameOver);
+	EXPECT_EQ(decoded.action, CommandAction::Pulse);
+	EXPECT_EQ(decoded.description, result.description);
+	ASSERT_TRUE(std::holds_alternative<PulseResult>(decoded.payload));
+	EXPECT_EQ(std::get<PulseResult>(decoded.payload).detectedHostileCount, 3);
+
+	for (std::size_t length = 0; length < bytes.size(); ++length)
+	{
+		EXPECT_FALSE(WireProtocol::DecodeTurnResponse(std::string_view(bytes).substr(0, length), decoded)) << length;
+	}
+	EXPECT_FALSE(WireProtocol::DecodeTurnResponse(bytes + '\0', decoded));
+}
+
+TEST(WireProtocolTest, OversizedStringsAreRejected)
+{
+	const std::string longest(WireProtocol::MaxNameLength, 'a');
+	const std::string tooLong(WireProtocol::MaxNameLength + 1, 'a');
+
+	std::string bytes;
+	WireProtocol::NewGameRequest request;
+	request.playerName = longest;
+	request.mapName = longest;
+	WireProtocol::EncodeNewGameRequest(bytes, request);
+	WireProtocol::NewGameRequest decoded;
+	EXPECT_TRUE(WireProtocol::DecodeNewGameRequest(bytes, decoded));
+
+	for (bool player : { true, false })
+	{
+		bytes.clear();
+		request.playerName = player ? tooLong : longest;
+		request.mapName = player ? longest : tooLong;
+		WireProtocol::EncodeNewGameRequest(bytes, request);
+		EXPECT_FALSE(WireProtocol::DecodeNewGameRequest(bytes, decoded)) << player;
+	}
+
+	bytes.clear();
+	ASSERT_TRUE(WireProtocol::EncodeTurnRequest(bytes, std::string(WireProtocol::MaxSessionIdLength + 1, 's'), "wait"));
+	WireProtocol::TurnRequest turn;
+	EXPECT_FALSE(WireProtocol::DecodeTurnRequest(bytes, turn));
+}
+
+TEST(WireProtocolTest, LongNarrationStaysWithinTheStringTable)
+{
+	CommandResult result;
+	result.action = CommandAction::Pulse;
+	for (int i = 0; i < 3000; ++i)
+	{
+		if (i > 0)
+			result.description += '\n';
+		result.description += "Line " + std::to_string(i % 2000);
+	}
+
+	std::string bytes;
+	WireProtocol::EncodeTurnResponse(bytes, result);
+	WireProtocol::TurnResponse decoded;
+	ASSERT_TRUE(WireProtocol::DecodeTurnResponse(bytes, decoded));
+	EXPECT_EQ(decoded.description, result.description);
+}
@@ -0,0 +1,252 @@
+#include <gtest/gtest.h>
+#include "WriteAheadLog.h"
+#include "SessionRecovery.h"
+#include "SessionStore.h"
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace NecroCore;
+
+namespace
+{
+	std::string FreshDirectory(const std::string& name)
+	{
+		const std::filesystem::path path = std::filesystem::path(::testing::TempDir()) / name;
+		std::filesystem::remove_all(path);
+		return path.string();
+	}
+
+	// What the server does for /new-game and /turn
+	void LoggedNewGame(WriteAheadLog& log, SessionStore& store, const std::string& id, std::uint64_t seed)
+	{
+		auto game = std::make_unique<Game>("Tester", "map1", seed);
+		game->StartRecording();
+		ASSERT_TRUE(store.Insert(id, std::move(game)));
+		ASSERT_TRUE(log.WaitDurable(log.AppendCreate(id, "Tester", "map1", seed)));
+	}
+
+	void LoggedTurn(WriteAheadLog& log, SessionStore& store, const std::string& id, const std::string& command)
+	{
+		std::uint64_t lsn = 0;
+		{
+			SessionStore::Lease game = store.Acquire(id);
+			ASSERT_TRUE(game);
+			const std::size_t sequence = game->GetReplayLog().GetTurnCount();
+			game->ApplyTurn(command);
+			lsn = log.AppendTurn(id, sequence, command, game->GetReplayLog().GetStateHash(sequence));
+		}
+		ASSERT_TRUE(log.WaitDurable(lsn));
+	}
+
+	std::uint64_t StateHash(SessionStore& store, const std::string& id)
+	{
+		SessionStore::Lease game = store.Acquire(id);
+		return game ? game->ComputeStateHash() : 0;
+	}
+
+	const std::vector<std::string> kCommands = { "move east", "wait", "move south", "pulse 2", "move west", "wait" };
+}
+
+TEST(WriteAheadLogTest, ConcurrentAppendsShareSyncs)
+{
+	const std::string directory = FreshDirectory("necro_wal_group");
+	WriteAheadLog log(directory, std::chrono::milliseconds(5));
+	ASSERT_TRUE(log.Open());
+
+	constexpr int kThreads = 8;
+	constexpr int kTurnsEach = 20;
+	std::vector<std::thread> threads;
+	for (int t = 0; t < kThreads; ++t)
+	{
+		threads.emplace_back([&log, t]()
+			{
+				const std::string id = "session" + std::to_string(t);
+				for (int i = 0; i < kTurnsEach; ++i)
+				{
+					EXPECT_TRUE(log.WaitDurable(log.AppendTurn(id, static_cast<std::uint64_t>(i), "wait", 0)));
+				}
+			});
+	}
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+	EXPECT_EQ(log.GetDurableLsn(), static_cast<std::uint64_t>(kThreads * kTurnsEach));
+	EXPECT_LT(log.GetSyncCount(), static_cast<std::uint64_t>(kThreads * kTurnsEach));
+	log.Close();
+
+	std::vector<std::uint64_t> nextSequence(kThreads, 0);
+	std::size_t records = 0;
+	for (std::uint32_t segment : WriteAheadLog::ListSegments(directory))
+	{
+		EXPECT_TRUE(WriteAheadLog::ReadSegment(WriteAheadLog::SegmentPath(directory, segment), [&](WalRecord&& record)
+			{
+				ASSERT_EQ(record.type, WalRecordType::Turn);
+				const int thread = std::stoi(record.sessionId.substr(7));
+				// Each session's turns reach the log in the order they were appended
+				EXPECT_EQ(record.sequence, nextSequence[thread]++);
+				EXPECT_EQ(record.command, "wait");
+				++records;
+			}));
+	}
+	EXPECT_EQ(records, static_cast<std::size_t>(kThreads * kTurnsEach));
+}
+
+TEST(WriteAheadLogTest, RecoveryReplaysLoggedTurns)
+{
+	const std::string directory = FreshDirectory("necro_wal_replay");
+	SessionStore before;
+	{
+		WriteAheadLog log(directory);
+		ASSERT_TRUE(log.Open());
+		for (int s = 0; s < 4; ++s)
+		{
+			const std::string id = "game" + std::to_string(s);
+			LoggedNewGame(log, before, id, 100 + s);
+			for (int i = 0; i <= s; ++i)
+			{
+				LoggedTurn(log, before, id, kCommands[static_cast<std::size_t>(i)]);
+			}
+		}
+	}
+
+	SessionStore after;
+	const SessionRecoveryReport report = SessionRecovery::Recover(directory, after, 3);
+	EXPECT_EQ(report.created, 4u);
+	EXPECT_EQ(report.turnsReplayed, 10u);
+	EXPECT_EQ(report.turnsDiverged, 0u);
+	EXPECT_FALSE(report.damagedLog);
+	ASSERT_EQ(after.Size(), 4u);
+	for (int s = 0; s < 4; ++s)
+	{
+		const std::string id = "game" + std::to_string(s);
+		EXPECT_EQ(StateHash(after, id), StateHash(before, id)) << id;
+	}
+}
+
+TEST(WriteAheadLogTest, CheckpointDropsOldSegmentsAndRecoveryAppliesEachTurnOnce)
+{
+	const std::string directory = FreshDirectory("necro_wal_checkpoint");
+	SessionStore before;
+	{
+		WriteAheadLog log(directory);
+		ASSERT_TRUE(log.Open());
+		LoggedNewGame(log, before, "kept", 5);
+		LoggedNewGame(log, before, "later", 6);
+		for (std::size_t i = 0; i < 3; ++i)
+		{
+			LoggedTurn(log, before, "kept", kCommands[i]);
+		}
+
+		EXPECT_EQ(SessionRecovery::Checkpoint(log, before), 2);
+		EXPECT_EQ(WriteAheadLog::ListSegments(directory).size(), 1u);
+
+		for (std::size_t i = 3; i < kCommands.size(); ++i)
+		{
+			LoggedTurn(log, before, "kept", kCommands[i]);
+		}
+		LoggedTurn(log, before, "later", "wait");
+	}
+
+	SessionStore after;
+	const SessionRecoveryReport report = SessionRecovery::Recover(directory, after);
+	EXPECT_EQ(report.fromSnapshot, 2u);
+	EXPECT_EQ(report.created, 0u);
+	EXPECT_EQ(report.turnsReplayed, kCommands.size() - 3 + 1);
+	EXPECT_EQ(report.turnsSkipped, 0u);
+	EXPECT_EQ(StateHash(after, "kept"), StateHash(before, "kept"));
+	EXPECT_EQ(StateHash(after, "later"), StateHash(before, "later"));
+
+	SessionStore::Lease kept = after.Acquire("kept");
+	ASSERT_TRUE(kept);
+	EXPECT_EQ(kept->GetReplayLog().GetTurnCount(), kCommands.size());
+}
+
+TEST(WriteAheadLogTest, TornTailIsIgnored)
+{
+	const std::string directory = FreshDirectory("necro_wal_torn");
+	SessionStore before;
+	{
+		WriteAheadLog log(directory);
+		ASSERT_TRUE(log.Open());
+		LoggedNewGame(log, before, "torn", 9);
+		LoggedTurn(log, before, "torn", "move east");
+		LoggedTurn(log, before, "torn", "wait");
+	}
+
+	// A crash in the middle of writing the next record
+	const std::vector<std::uint32_t> segments = WriteAheadLog::ListSegments(directory);
+	ASSERT_EQ(segments.size(), 1u);
+	{
+		std::ofstream out(WriteAheadLog::SegmentPath(directory, segments.front()), std::ios::binary | std::ios::app);
+		out.write("\x20\x00\x00\x00\x01\x02", 6);
+	}
+
+	SessionStore after;
+	const SessionRecoveryReport report = SessionRecovery::Recover(directory, after);
+	EXPECT_TRUE(report.damagedLog);
+	EXPECT_EQ(report.turnsReplayed, 2u);
+	EXPECT_EQ(StateHash(after, "torn"), StateHash(before, "torn"));
+
+	// The next run starts a fresh segment instead of appending after the damage
+	WriteAheadLog log(directory);
+	ASSERT_TRUE(log.Open());
+	EXPECT_TRUE(log.WaitDurable(log.AppendTurn("torn", 2, "wait", 0)));
+	log.Close();
+	EXPECT_EQ(WriteAheadLog::ListSegments(directory).back(), segments.front() + 1);
+}
+
+TEST(WriteAheadLogTest, RecoveryRepeatsDeferredHostiles)
+{
+	const std::string directory = FreshDirectory("necro_wal_deferred");
+	SessionStore before;
+	std::size_t deferred = 0;
+	{
+		WriteAheadLog log(directory);
+		ASSERT_TRUE(log.Open());
+		LoggedNewGame(log, before, "budgeted", 7);
+		// Out of the start room and towards the hostile west of the corridor
+		const std::vector<std::string> commands = { "move west", "move west", "move north", "move north",
+			"move east", "move east", "move east", "move east", "wait", "wait", "wait", "wait" };
+		for (std::size_t i = 0; i < commands.size(); ++i)
+		{
+			SessionStore::Lease game = before.Acquire("budgeted");
+			ASSERT_TRUE(game);
+			const std::size_t sequence = game->GetReplayLog().GetTurnCount();
+			// Every other turn runs out of time before any hostile moves
+			game->ApplyTurn(commands[i], std::chrono::microseconds(i % 2 == 0 ? 0 : 10'000'000));
+			const std::vector<int>& deferredHostiles = game->GetLastTurnStats().deferredHostiles;
+			deferred += deferredHostiles.size();
+			log.AppendTurn("budgeted", sequence, commands[i], game->GetReplayLog().GetStateHash(sequence), deferredHostiles);
+		}
+	}
+	ASSERT_GT(deferred, 0u);
+
+	SessionStore after;
+	const SessionRecoveryReport report = SessionRecovery::Recover(directory, after, 1);
+	EXPECT_EQ(report.turnsReplayed, 12u);
+	EXPECT_EQ(report.turnsDiverged, 0u);
+	EXPECT_EQ(report.failedSessions, 0u);
+	EXPECT_EQ(StateHash(after, "budgeted"), StateHash(before, "budgeted"));
+}
+
+TEST(WriteAheadLogTest, DivergedSessionIsNotRecovered)
+{
+	const std::string directory = FreshDirectory("necro_wal_diverged");
+	{
+		WriteAheadLog log(directory);
+		ASSERT_TRUE(log.Open());
+		ASSERT_TRUE(log.WaitDurable(log.AppendCreate("diverged", "Tester", "map1", 1)));
+		ASSERT_TRUE(log.WaitDurable(log.AppendTurn("diverged", 0, "wait", 0)));
+	}
+
+	SessionStore after;
+	const SessionRecoveryReport report = SessionRecovery::Recover(directory, after, 1);
+	EXPECT_EQ(report.turnsDiverged, 1u);
+	EXPECT_EQ(report.failedSessions, 1u);
+	EXPECT_EQ(after.Size(), 0u);
+}
@@ -0,0 +1,263 @@
+#include "ActivationSystem.h"
+#include "Game.h"
+#include "Entity.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace NecroCore
+{
+	static int FindEntityIndex(const std::vector<Entity>& entities, int id)
+	{
+		auto it = std::lower_bound(entities.begin(), entities.end(), id,
+			[](const Entity& e, int value) { return e.id < value; });
+		if (it == entities.end() || it->id != id)
+			return -1;
+		return static_cast<int>(it - entities.begin());
+	}
+
+	ActivationSystem::Slot* ActivationSystem::FindSlot(int entityId)
+	{
+		if (entityId <= 0 || static_cast<std::size_t>(entityId) >= m_Slots.size())
+			return nullptr;
+		Slot& slot = m_Slots[static_cast<std::size_t>(entityId)];
+		return slot.tracked ? &slot : nullptr;
+	}
+
+	const ActivationSystem::Slot* ActivationSystem::FindSlot(int entityId) const
+	{
+		return const_cast<ActivationSystem*>(this)->FindSlot(entityId);
+	}
+
+	bool ActivationSystem::IsSleeping(int entityId) const
+	{
+		const Slot* slot = FindSlot(entityId);
+		return slot && slot->sleeping;
+	}
+
+	void ActivationSystem::Rebuild(Game& game)
+	{
+		const Map& map = game.GetMap();
+		m_CellsX = std::max(1, (map.GetWidth() + CellSize - 1) / CellSize);
+		m_CellsY = std::max(1, (map.GetHeight() + CellSize - 1) / CellSize);
+		m_Cells.assign(static_cast<std::size_t>(m_CellsX * m_CellsY), {});
+
+		m_Slots.clear();
+		m_Active.clear();
+		m_Woken.clear();
+		m_SleepingCount = 0;
+
+		const std::vector<Entity>& entities = game.GetEntities();
+		m_Slots.resize(entities.empty() ? 1 : static_cast<std::size_t>(entities.back().id) + 1);
+
+		// Everything starts asleep; the wake pass right after picks out the ones in range
+		for (const Entity& entity : entities)
+		{
+			if (entity.faction != Faction::Hostile)
+				continue;
+			m_Slots[static_cast<std::size_t>(entity.id)].tracked = true;
+			Sleep(entity.id, entity.x, entity.y, entity.aggroRange);
+		}
+		m_Valid = true;
+	}
+
+	void ActivationSystem::Sleep(int entityId, int x, int y, int aggroRange)
+	{
+		Slot& slot = m_Slots[static_cast<std::size_t>(entityId)];
+		slot.sleeping = true;
+		slot.idleTurns = 0;
+		slot.x = x;
+		slot.y = y;
+		slot.aggroRange = aggroRange;
+		slot.cellMinX = static_cast<std::int16_t>(std::clamp((x - aggroRange) / CellSize, 0, m_CellsX - 1));
+		slot.cellMinY = static_cast<std::int16_t>(std::clamp((y - aggroRange) / CellSize, 0, m_CellsY - 1));
+		slot.cellMaxX = static_cast<std::int16_t>(std::clamp((x + aggroRange) / CellSize, 0, m_CellsX - 1));
+		slot.cellMaxY = static_cast<std::int16_t>(std::clamp((y + aggroRange) / CellSize, 0, m_CellsY - 1));
+
+		for (int cy = slot.cellMinY; cy <= slot.cellMaxY; ++cy)
+		{
+			for (int cx = slot.cellMinX; cx <= slot.cellMaxX; ++cx)
+			{
+				Cell(cx, cy).push_back(entityId);
+			}
+		}
+		++m_SleepingCount;
+	}
+
+	void ActivationSystem::WakeSlot(int entityId)
+	{
+		Slot& slot = m_Slots[static_cast<std::size_t>(entityId)];
+		for (int cy = slot.cellMinY; cy <= slot.cellMaxY; ++cy)
+		{
+			for (int cx = slot.cellMinX; cx <= slot.cellMaxX; ++cx)
+			{
+				std::vector<int>& cell = Cell(cx, cy);
+				auto it = std::find(cell.begin(), cell.end(), entityId);
+				if (it != cell.end())
+				{
+					*it = cell.back();
+					cell.pop_back();
+				}
+			}
+		}
+		slot.sleeping = false;
+		slot.idleTurns = 0;
+		slot.deferredTurns = 0;
+		--m_SleepingCount;
+		m_Woken.push_back(entityId);
+	}
+
+	void ActivationSystem::Wake(int entityId)
+	{
+		if (!m_Valid)
+			return;
+		Slot* slot = FindSlot(entityId);
+		if (slot && slot->sleeping)
+		{
+			WakeSlot(entityId);
+		}
+	}
+
+	void ActivationSystem::EmitNoise(int x, int y, int radius)
+	{
+		if (!m_Valid || radius < 0)
+			return;
+
+		const int minX = std::clamp((x - radius) / CellSize, 0, m_CellsX - 1);
+		const int minY = std::clamp((y - radius) / CellSize, 0, m_CellsY - 1);
+		const int maxX = std::clamp((x + radius) / CellSize, 0, m_CellsX - 1);
+		const int maxY = std::clamp((y + radius) / CellSize, 0, m_CellsY - 1);
+
+		for (int cy = minY; cy <= maxY; ++cy)
+		{
+			for (int cx = minX; cx <= maxX; ++cx)
+			{
+				std::vector<int>& cell = Cell(cx, cy);
+				// WakeSlot edits this cell, so walk it backwards
+				for (std::size_t i = cell.size(); i-- > 0;)
+				{
+					const int id = cell[i];
+					const Slot& slot = m_Slots[static_cast<std::size_t>(id)];
+					if (std::abs(slot.x - x) + std::abs(slot.y - y) <= radius)
+					{
+						WakeSlot(id);
+					}
+				}
+			}
+		}
+	}
+
+	void ActivationSystem::BeginHostileTurn(Game& game)
+	{
+		if (!m_Valid)
+		{
+			Rebuild(game);
+		}
+
+		const std::vector<Entity>& entities = game.GetEntities();
+		const Player& player = game.GetPlayer();
+
+		m_Targets.clear();
+		// The hostile AI measures distance to the player whether or not they are alive
+		m_Targets.push_back({ player.x, player.y, -1 });
+		for (std::size_t i = 0; i < entities.size(); ++i)
+		{
+			const Entity& entity = entities[i];
+			if (entity.faction == Faction::Friendly && entity.hp > 0)
+			{
+				m_Targets.push_back({ entity.x, entity.y, static_cast<int>(i) });
+			}
+		}
+
+		for (const Target& target : m_Targets)
+		{
+			if (target.x < 0 || target.y < 0)
+				continue;
+			const int cx = std::min(target.x / CellSize, m_CellsX - 1);
+			const int cy = std::min(target.y / CellSize, m_CellsY - 1);
+			std::vector<int>& cell = Cell(cx, cy);
+			for (std::size_t i = cell.size(); i-- > 0;)
+			{
+				const int id = cell[i];
+				const Slot& slot = m_Slots[static_cast<std::size_t>(id)];
+				if (std::abs(slot.x - target.x) + std::abs(slot.y - target.y) <= slot.aggroRange)
+				{
+					WakeSlot(id);
+				}
+			}
+		}
+
+		if (!m_Woken.empty())
+		{
+			std::sort(m_Woken.begin(), m_Woken.end());
+			const std::size_t mid = m_Active.size();
+			m_Active.insert(m_Active.end(), m_Woken.begin(), m_Woken.end());
+			std::inplace_merge(m_Active.begin(), m_Active.begin() + static_cast<std::ptrdiff_t>(mid), m_Active.end());
+			m_Woken.clear();
+		}
+
+		for (int id : m_Active)
+		{
+			m_Slots[static_cast<std::size_t>(id)].actedThisTurn = false;
+		}
+
+		NECRO_TRACE("[Activation] " << m_Active.size() << " awake, " << m_SleepingCount << " asleep.\n");
+	}
+
+	void ActivationSystem::ReportActivity(int entityId, bool acted)
+	{
+		if (Slot* slot = FindSlot(entityId))
+		{
+			slot->actedThisTurn = slot->actedThisTurn || acted;
+			slot->deferredTurns = 0;
+		}
+	}
+
+	void ActivationSystem::ReportDeferred(int entityId)
+	{
+		if (Slot* slot = FindSlot(entityId))
+		{
+			// Not having run says nothing about being idle
+			slot->actedThisTurn = true;
+			if (slot->deferredTurns < 255)
+				++slot->deferredTurns;
+		}
+	}
+
+	int ActivationSystem::GetDeferredTurns(int entityId) const
+	{
+		const Slot* slot = FindSlot(entityId);
+		return slot ? slot->deferredTurns : 0;
+	}
+
+	void ActivationSystem::EndHostileTurn(Game& game)
+	{
+		if (!m_Valid)
+			return;
+
+		const std::vector<Entity>& entities = game.GetEntities();
+		std::size_t kept = 0;
+		for (std::size_t i = 0; i < m_Active.size(); ++i)
+		{
+			const int id = m_Active[i];
+			Slot& slot = m_Slots[static_cast<std::size_t>(id)];
+			const int index = FindEntityIndex(entities, id);
+			if (index < 0)
+			{
+				slot.tracked = false;
+				continue;
+			}
+
+			slot.idleTurns = slot.actedThisTurn ? 0 : static_cast<std::uint8_t>(slot.idleTurns + 1);
+			if (slot.idleTurns >= IdleTurnsBeforeSleep)
+			{
+				const Entity& entity = entities[static_cast<std::size_t>(index)];
+				Sleep(id, entity.x, entity.y, entity.aggroRange);
+				continue;
+			}
+			m_Active[kept++] = id;
+		}
+		m_Active.resize(kept);
+	}
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+namespace NecroCore
+{
+	class Game;
+
+	// Tracks which hostiles need an AI update. Hostiles with nothing inside their
+	// aggro range sleep in a coarse spatial grid (registered in every cell their
+	// aggro diamond overlaps), so the per-turn wake check only looks at the cells
+	// under the player and live summons. Noise and damage wake sleepers directly.
+	//
+	// A hostile only ever acts on a target inside its aggro range, and every such
+	// sleeper is woken before the hostile pass, so sleeping never changes what
+	// happens in a turn - it only skips work.
+	class ActivationSystem
+	{
+	public:
+		static constexpr int CellSize = 8;
+		// Awake hostiles that go this many turns without acting fall asleep again
+		static constexpr int IdleTurnsBeforeSleep = 3;
+		static constexpr int CombatNoiseRadius = 4;
+		static constexpr int SpellNoiseRadius = 6;
+
+		struct Target
+		{
+			int x;
+			int y;
+			// Index into Game::GetEntities(), or -1 for the player
+			int entityIndex;
+		};
+
+		// Forget everything and rebuild from the entity list on the next turn.
+		// Needed whenever entities change outside a turn (spawns, undo, snapshot load).
+		void Invalidate() { m_Valid = false; }
+
+		void Wake(int entityId);
+		void EmitNoise(int x, int y, int radius);
+
+		// Wakes every sleeper with a target in its aggro range and collects the
+		// targets (player first, then live summons) for the hostile pass.
+		void BeginHostileTurn(Game& game);
+		// Puts hostiles that stayed idle long enough back to sleep.
+		void EndHostileTurn(Game& game);
+
+		// Awake hostile ids in ascending order, which is also entity list order.
+		const std::vector<int>& GetActiveHostiles() const { return m_Active; }
+		const std::vector<Target>& GetTargets() const { return m_Targets; }
+		void ReportActivity(int entityId, bool acted);
+		// The hostile ran out of turn budget; it stays awake and gains priority.
+		void ReportDeferred(int entityId);
+		int GetDeferredTurns(int entityId) const;
+
+		std::size_t GetActiveCount() const { return m_Active.size(); }
+		std::size_t GetSleepingCount() const { return m_SleepingCount; }
+		bool IsSleeping(int entityId) const;
+
+	private:
+		struct Slot
+		{
+			bool tracked = false;
+			bool sleeping = false;
+			bool actedThisTurn = false;
+			std::uint8_t idleTurns = 0;
+			std::uint8_t deferredTurns = 0;
+			// Aggro box registered in the grid while sleeping, in cell coordinates
+			std::int16_t cellMinX = 0;
+			std::int16_t cellMinY = 0;
+			std::int16_t cellMaxX = 0;
+			std::int16_t cellMaxY = 0;
+			int x = 0;
+			int y = 0;
+			int aggroRange = 0;
+		};
+
+		void Rebuild(Game& game);
+		void Sleep(int entityId, int x, int y, int aggroRange);
+		void WakeSlot(int entityId);
+		Slot* FindSlot(int entityId);
+		const Slot* FindSlot(int entityId) const;
+		std::vector<int>& Cell(int cellX, int cellY) { return m_Cells[static_cast<std::size_t>(cellY * m_CellsX + cellX)]; }
+
+		bool m_Valid = false;
+		int m_CellsX = 0;
+		int m_CellsY = 0;
+		std::vector<std::vector<int>> m_Cells;
+		std::vector<Slot> m_Slots;
+		std::vector<int> m_Active;
+		std::vector<int> m_Woken;
+		std::vector<Target> m_Targets;
+		std::size_t m_SleepingCount = 0;
+	};
+}
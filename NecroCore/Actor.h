@@ -2,14 +2,14 @@
 
 #include "Entity.h"
 #include "Status.h"
-#include <unordered_map>
+#include <array>
 #include <string>
 
 namespace NecroCore
 {
     struct Actor
     {
-        int id;
+        int id = 0;
         std::string name;
         int x = 0;
         int y = 0;
@@ -18,7 +18,8 @@ namespace NecroCore
         int attackDamage = 1;
 
 		StatusEffect status = StatusEffect::Normal;
-        std::unordered_map<StatusEffect, int> statusDurations;
+        // Turns left per status bit (see kStatusTable); only meaningful while the bit is set in status
+        std::array<int, StatusEffectCount> statusDurations{};
 
         static bool IsAdjacent(int x1, int y1, int x2, int y2)
         {
@@ -52,22 +53,27 @@ namespace NecroCore
         void AddStatus(StatusEffect s, int duration = -1)
         {
             status |= s;
-            if (duration < 0)
-            {
-                if (auto desc = GetStatusDescriptor(s))
-                    duration = desc->defaultDuration;
-                else
-                    duration = 1;
-            }
-            statusDurations[s] = duration;
+            ForEachStatusIndex(s, [&](std::size_t index)
+                {
+                    statusDurations[index] = duration < 0 ? kStatusTable[index].defaultDuration : duration;
+                });
         }
 
         void ClearStatus(StatusEffect s)
         {
-            auto mask = static_cast<unsigned char>(status);
-            mask &= ~static_cast<unsigned char>(s);
+            auto mask = static_cast<StatusMask>(status);
+            mask &= static_cast<StatusMask>(~static_cast<StatusMask>(s));
             status = static_cast<StatusEffect>(mask);
-            statusDurations.erase(s);
+            ForEachStatusIndex(s, [&](std::size_t index)
+                {
+                    statusDurations[index] = 0;
+                });
+        }
+
+        int GetStatusDuration(StatusEffect s) const
+        {
+            const std::size_t index = StatusIndex(s);
+            return (index < StatusEffectCount && HasStatus(status, s)) ? statusDurations[index] : 0;
         }
     };
 }
\ No newline at end of file
@@ -7,5 +7,8 @@ namespace NecroCore
 	struct CastResult
 	{
 		std::string description;
+		// Area casts only: tiles the spell changed and actors it affected
+		int tilesAffected = 0;
+		int actorsAffected = 0;
 	};
 }
\ No newline at end of file
@@ -6,9 +6,13 @@
 #include "SummonResult.h"
 #include "AttackResult.h"
 #include "SummonCommandResult.h"
+#include "Log.h"
+#include "Spell.h"
+#include "CommandParser.h"
 
 #include <iostream>
-#include <sstream>
+#include <optional>
+#include <string_view>
 
 namespace NecroCore
 {
@@ -26,95 +30,129 @@ namespace NecroCore
 	{
 		CommandResult result;
 
-		std::istringstream iss(command);
-		std::string verb;
-		if (!(iss >> verb))
+		CommandTokenizer tokens(command);
+		std::string_view verbWord;
+		if (!tokens.Next(verbWord))
 		{
 			result.description = "Your words have no meaning.";
 			result.success = false;
 			return result;
 		}
 
-		if (verb == "pulse")
+		const std::optional<CommandVerb> verb = CommandKeywords::FindVerb(verbWord);
+		if (!verb)
 		{
-			result.action = CommandAction::Pulse;
+			result.action = CommandAction::Unknown;
+			result.description = "Unknown command: " + std::string(verbWord);
+			result.success = false;
+			return result;
+		}
 
-			int radius = 5;
+		// Successful parses leave the description to ExecuteCommand
+		switch (*verb)
+		{
+		case CommandVerb::Pulse:
+		{
+			result.action = CommandAction::Pulse;
 
-			if (!(iss >> radius))
+			PulseCmd pulse;
+			if (!tokens.NextInt(pulse.radius))
 			{
-				radius = 5;
+				pulse.radius = 5;
 			}
 
-			result.args["radius"] = radius;
-			result.description = "Pulse command parsed.";
+			result.command = pulse;
 			result.success = true;
+			break;
 		}
-		else if (verb == "cast")
+		case CommandVerb::Cast:
 		{
 			result.action = CommandAction::Cast;
-			std::string element;
-			std::string direction;
-			if (!(iss >> element >> direction))
+			std::string_view element;
+			std::string_view direction;
+			if (!tokens.Next(element) || !tokens.Next(direction))
 			{
 				result.description = "Cast what, and in which direction?";
 				result.success = false;
 				return result;
 			}
-			result.args["element"] = element; // "fire" | "water"
-			result.args["direction"] = direction;
-			result.description = "Cast command parsed.";
+
+			CastCmd cast;
+			cast.spell = SpellRegistry::Find(element); // null for an unknown element
+			cast.element = CommandWord::From(element);
+
+			// cast <element> line|cone <direction> [size], or cast <element> radius [size]
+			if (const std::optional<AreaShape> shape = CommandKeywords::FindShape(direction))
+			{
+				cast.shape = *shape;
+				direction = "around";
+				if (*shape != AreaShape::Radius && !tokens.Next(direction))
+				{
+					result.description = "Cast what, and in which direction?";
+					result.success = false;
+					return result;
+				}
+
+				if (!tokens.NextInt(cast.size))
+				{
+					cast.size = SpellArea::DefaultSize;
+				}
+			}
+			cast.direction = CommandKeywords::MakeDirection(direction);
+
+			result.command = cast;
 			result.success = true;
+			break;
 		}
-		else if (verb == "move")
+		case CommandVerb::Move:
 		{
 			result.action = CommandAction::Move;
 
-			std::string direction;
-			if (!(iss >> direction))
+			std::string_view direction;
+			if (!tokens.Next(direction))
 			{
 				result.description = "Move where?";
 				result.success = false;
 				return result;
 			}
 
-			result.args["direction"] = direction;
-			result.description = "Move command parsed.";
+			result.command = MoveCmd{ CommandKeywords::MakeDirection(direction) };
 			result.success = true;
+			break;
 		}
-		else if (verb == "summon")
+		case CommandVerb::Summon:
 		{
 			result.action = CommandAction::Summon;
 
-			std::string creature;
-			if (!(iss >> creature))
+			std::string_view creature;
+			if (!tokens.Next(creature))
 			{
 				result.description = "Summon what?";
 				result.success = false;
 				return result;
 			}
 
-			result.args["creature"] = creature;
-			result.description = "Summon command parsed.";
+			result.command = SummonCmd{ CommandWord::From(creature) };
 			result.success = true;
+			break;
 		}
-		else if (verb == "attack")
+		case CommandVerb::Attack:
 		{
 			result.action = CommandAction::Attack;
 
-			std::string direction;
-			if (!(iss >> direction))
+			std::string_view direction;
+			if (!tokens.Next(direction))
 			{
 				result.description = "You lash out blindly at the darkness.";
 				result.success = false;
 				return result;
 			}
 
-			result.args["direction"] = direction;
-			result.description = "Attack command parsed.";
+			result.command = AttackCmd{ CommandKeywords::MakeDirection(direction) };
 			result.success = true;
+			break;
 		}
-		else if (verb == "command")
+		case CommandVerb::Command:
 		{
 			result.action = CommandAction::SummonCommand;
 
@@ -135,48 +173,47 @@ namespace NecroCore
 				return result;
 			}
 
-			std::string target;
-			std::string order;
-			if (!(iss >> target >> order))
+			std::string_view target;
+			std::string_view order;
+			if (!tokens.Next(target) || !tokens.Next(order))
 			{
 				result.description = "Your will is unclear; your minions hesitate.";
 				result.success = false;
 				return result;
 			}
 
-			std::string direction;
-			if (order == "move" && !(iss >> direction))
+			SummonOrderCmd summonOrder;
+			summonOrder.target = CommandWord::From(target);
+			summonOrder.order = CommandKeywords::FindOrder(order);
+			summonOrder.orderWord = CommandWord::From(order);
+
+			std::string_view direction;
+			if (summonOrder.order == SummonOrder::Move && !tokens.Next(direction))
 			{
 				result.description = "Move where?";
 				result.success = false;
 				return result;
 			}
-			else {
-				result.args["direction"] = direction;
-			}
+			summonOrder.direction = CommandKeywords::MakeDirection(direction);
 
-			result.args["target"] = target; // "all" | "skeleton#1"
-			result.args["order"] = order;  // "follow" | "guard" | "attack" | "move"
-			result.description = "Command parsed.";
+			result.command = summonOrder;
 			result.success = true;
+			break;
 		}
-		else if (verb == "wait")
+		case CommandVerb::Wait:
 		{
 			result.action = CommandAction::Unknown;
-			result.description = "You wait for a moment.";
+			result.command = WaitCmd{};
 			result.success = true;
+			break;
 		}
-		else if (verb == "help")
+		case CommandVerb::Help:
 		{
 			result.action = CommandAction::Help;
-			result.description = "Help command parsed.";
+			result.command = HelpCmd{};
 			result.success = true;
+			break;
 		}
-		else
-		{
-			result.action = CommandAction::Unknown;
-			result.description = "Unknown command: " + verb;
-			result.success = false;
 		}
 
 		return result;
@@ -190,14 +227,8 @@ namespace NecroCore
 		{
 			case CommandAction::Pulse:
 			{
-				int radius = 5;
-
-				auto it = command.args.find("radius");
-				if (it != command.args.end() && std::holds_alternative<int>(it->second))
-				{
-					radius = std::get<int>(it->second);
-				}
-				PulseResult pulseResult = Pulse(radius);
+				const PulseCmd* pulse = std::get_if<PulseCmd>(&command.command);
+				PulseResult pulseResult = Pulse(pulse ? pulse->radius : 5);
 
 				finalResult.payload = pulseResult;
 				finalResult.description = "Your senses extend outward." + pulseResult.description;
@@ -206,30 +237,33 @@ namespace NecroCore
 			}
 			case CommandAction::Cast:
 			{
-				auto itElement = command.args.find("element");
-				auto itDirection = command.args.find("direction");
-				if (itElement == command.args.end() || !std::holds_alternative<std::string>(itElement->second) ||
-					itDirection == command.args.end() || !std::holds_alternative<std::string>(itDirection->second))
+				const CastCmd* cast = std::get_if<CastCmd>(&command.command);
+				if (!cast)
 				{
 					finalResult.description = "Your incantation falters, lacking clarity of purpose.";
 					finalResult.success = false;
 					break;
 				}
-				const std::string& element = std::get<std::string>(itElement->second);
-				const std::string& direction = std::get<std::string>(itDirection->second);
-				if (!StatusEffectFromSpell(element))
+				if (!cast->spell)
+				{
+					finalResult.description = "The arcane forces reject your unknown element: " + std::string(cast->element.View()) + ".";
+					finalResult.success = false;
+					break;
+				}
+				if (cast->shape != AreaShape::Radius && !cast->direction.IsKnown() &&
+					(!cast->direction.IsSelf() || cast->shape != AreaShape::Single))
 				{
-					finalResult.description = "The arcane forces reject your unknown element: " + element + ".";
+					finalResult.description = "The arcane forces reject your unknown direction: " + std::string(cast->direction.word.View()) + ".";
 					finalResult.success = false;
 					break;
 				}
-				if (!m_Map.DirectionExists(direction) && direction != "self")
+				if (cast->size < 1 || cast->size > SpellArea::MaxSize)
 				{
-					finalResult.description = "The arcane forces reject your unknown direction: " + direction + ".";
+					finalResult.description = "The arcane forces cannot reach that far: " + std::to_string(cast->size) + ".";
 					finalResult.success = false;
 					break;
 				}
-				CastResult castResult = CastSpell(element, direction);
+				CastResult castResult = CastResolved(*cast->spell, cast->direction.index, cast->shape, cast->size);
 				finalResult.payload = castResult;
 				finalResult.description = castResult.description;
 				finalResult.success = true;
@@ -237,59 +271,51 @@ namespace NecroCore
 			}
 			case CommandAction::Move:
 			{
-				std::string direction;
-
-				auto it = command.args.find("direction");
-				if (it == command.args.end() || !std::holds_alternative<std::string>(it->second))
+				const MoveCmd* move = std::get_if<MoveCmd>(&command.command);
+				if (!move)
 				{
 					finalResult.description = "You stumble in place.";
 					finalResult.success = false;
 					break;
 				}
 
-				direction = std::get<std::string>(it->second);
-
-				int dx = 0;
-				int dy = 0;
-
-				if (!m_Map.DirectionFromString(direction, dx, dy))
+				if (!move->direction.IsKnown())
 				{
 					finalResult.description = "You try to move, but the direction confuses you.";
 					finalResult.success = false;
 					break;
 				}
 
-				MoveResult moveResult = MovePlayer(dx, dy);
+				const Map::Dir& dir = Map::dirs[move->direction.index];
+				MoveResult moveResult = MovePlayer(dir.dx, dir.dy);
 				if (moveResult.newX == moveResult.oldX && moveResult.newY == moveResult.oldY)
 				{
-					finalResult.description = "You bump into an obstacle and cannot move " + direction + ".";
+					finalResult.description = "You bump into an obstacle and cannot move ";
+					finalResult.description += dir.name;
+					finalResult.description += '.';
 					finalResult.success = false;
 					break;
 				}
 
 				finalResult.payload = moveResult;
-				finalResult.description = "You move " + direction + ".";
+				finalResult.description = "You move ";
+				finalResult.description += dir.name;
+				finalResult.description += '.';
 				finalResult.success = true;
-				const std::string trapMsg = HandleTrapOnActor(m_Player);
-				if (!trapMsg.empty())
-				{
-					finalResult.description += "\n" + trapMsg;
-				}
+				HandleTrapOnActor(m_Player, finalResult.description);
 				break;
 			}
 			case CommandAction::Summon:
 			{
-				auto it = command.args.find("creature");
-				if (it == command.args.end() || !std::holds_alternative<std::string>(it->second))
+				const SummonCmd* summon = std::get_if<SummonCmd>(&command.command);
+				if (!summon)
 				{
 					finalResult.description = "You mutter nonsense; nothing answers.";
 					finalResult.success = false;
 					break;
 				}
 
-				const std::string& creature = std::get<std::string>(it->second);
-
-				if (creature != "skeleton")
+				if (!(summon->creature == "skeleton"))
 				{
 					finalResult.description = "Your invocation falters: such a creature does not heed your call.";
 					finalResult.success = false;
@@ -315,30 +341,29 @@ namespace NecroCore
 			}
 			case CommandAction::Attack:
 			{
-				std::string direction;
-
-				auto it = command.args.find("direction");
-				if (it == command.args.end() || !std::holds_alternative<std::string>(it->second))
+				const AttackCmd* attack = std::get_if<AttackCmd>(&command.command);
+				if (!attack)
 				{
 					finalResult.description = "You lash out blindly at the darkness.";
 					finalResult.success = false;
 					break;
 				}
 
-				direction = std::get<std::string>(it->second);
-
-				int dx = 0;
-				int dy = 0;
-
-				if (!m_Map.DirectionFromString(direction, dx, dy))
+				if (!attack->direction.IsKnown())
 				{
-					finalResult.description = "You swing " + direction + ", but the notion of that direction escapes this realm.";
+					finalResult.description = "You swing " + std::string(attack->direction.word.View()) + ", but the notion of that direction escapes this realm.";
 					finalResult.success = false;
 					break;
 				}
 
-				const int targetX = m_Player.x + dx;
-				const int targetY = m_Player.y + dy;
+				const Map::Dir& dir = Map::dirs[attack->direction.index];
+				const std::string direction = dir.name;
+				const int targetX = m_Player.x + dir.dx;
+				const int targetY = m_Player.y + dir.dy;
+
+				AttackResult attackResult;
+				attackResult.targetX = targetX;
+				attackResult.targetY = targetY;
 
 				bool hit = false;
 
@@ -351,6 +376,12 @@ namespace NecroCore
 						hit = true;
 						const int kPlayerDamage = 1;
 						entity.hp -= kPlayerDamage;
+						attackResult.hit = true;
+						attackResult.targetEntityId = entity.id;
+						attackResult.damageDealt = kPlayerDamage;
+						attackResult.targetDied = entity.hp <= 0;
+						m_Activation.Wake(entity.id);
+						m_Activation.EmitNoise(targetX, targetY, ActivationSystem::CombatNoiseRadius);
 
 						if (entity.hp <= 0)
 						{
@@ -370,6 +401,7 @@ namespace NecroCore
 					}
 				}
 
+				finalResult.payload = attackResult;
 				if (!hit)
 				{
 					finalResult.description = "You strike " + direction + " but hit nothing.";
@@ -384,55 +416,46 @@ namespace NecroCore
 			}
 			case CommandAction::SummonCommand:
 			{
-				auto itTarget = command.args.find("target");
-				auto itOrder = command.args.find("order");
-				if (itTarget == command.args.end() || itOrder == command.args.end() ||
-					!std::holds_alternative<std::string>(itTarget->second) ||
-					!std::holds_alternative<std::string>(itOrder->second))
+				const SummonOrderCmd* summonOrder = std::get_if<SummonOrderCmd>(&command.command);
+				if (!summonOrder)
 				{
 					finalResult.description = "Your will is fractured; no clear order is given.";
 					finalResult.success = false;
 					break;
 				}
 
-				const std::string& target = std::get<std::string>(itTarget->second);
-				const std::string& order = std::get<std::string>(itOrder->second);
-
 				EntityState newState;
-				if (order == "follow")
+				if (summonOrder->order == SummonOrder::Follow)
 				{
 					newState = EntityState::FollowPlayer;
 				}
-				else if (order == "guard")
+				else if (summonOrder->order == SummonOrder::Guard)
 				{
 					newState = EntityState::Guard;
 				}
-				else if (order == "attack")
+				else if (summonOrder->order == SummonOrder::Attack)
 				{
 					newState = EntityState::Attack;
 				}
-				else if (order == "move")
+				else if (summonOrder->order == SummonOrder::Move)
 				{
-					auto itDirection = command.args.find("direction");
-					std::cout << "Looking for direction argument in move order...\n";
-					if (itDirection == command.args.end() || !std::holds_alternative<std::string>(itDirection->second))
+					const DirectionArg& directionArg = summonOrder->direction;
+					if (directionArg.word.length == 0)
 					{
 						finalResult.description = "Move where?";
 						finalResult.success = false;
 						break;
 					}
-					const std::string& direction = std::get<std::string>(itDirection->second);
-					int dx = 0;
-					int dy = 0;
-
-					if (!m_Map.DirectionFromString(direction, dx, dy))
+					if (!directionArg.IsKnown())
 					{
-						finalResult.description = "The direction '" + direction + "' is unknown to your minion.";
+						finalResult.description = "The direction '" + std::string(directionArg.word.View()) + "' is unknown to your minion.";
 						finalResult.success = false;
 						break;
 					}
-					Entity* targetEntity = GetEntityByName(target);
-					MoveResult moveResult = MoveEntity(*targetEntity, dx, dy);
+					const Map::Dir& dir = Map::dirs[directionArg.index];
+					const std::string direction = dir.name;
+					Entity* targetEntity = GetEntityByName(summonOrder->target.View());
+					MoveResult moveResult = MoveEntity(*targetEntity, dir.dx, dir.dy);
 					if (!moveResult.success)
 					{
 						finalResult.description = "Your " + targetEntity->name + " tries to move " + direction + ", but was blocked.";
@@ -443,6 +466,13 @@ namespace NecroCore
 						finalResult.description = "Your " + targetEntity->name + " moves " + direction + ".";
 						targetEntity->aiState = EntityState::Guard;
 						finalResult.success = true;
+
+						SummonCommandResult orderResult;
+						orderResult.success = true;
+						orderResult.creature = summonOrder->target.View();
+						orderResult.order = summonOrder->orderWord.View();
+						orderResult.alliesOrdered = 1;
+						finalResult.payload = orderResult;
 					}
 					break;
 				}
@@ -453,6 +483,7 @@ namespace NecroCore
 					break;
 				}
 
+				SummonCommandResult orderResult;
 				for (Entity& e : m_Entities)
 				{
 					if (e.faction != Faction::Friendly)
@@ -464,30 +495,43 @@ namespace NecroCore
 						e.guardX = e.x;
 						e.guardY = e.y;
 					}
+					++orderResult.alliesOrdered;
 				}
 
+				orderResult.success = true;
+				orderResult.creature = summonOrder->target.View();
+				orderResult.order = summonOrder->orderWord.View();
+				finalResult.payload = orderResult;
 				finalResult.description = "Your will ripples through the ranks of your summoned allies.";
 				finalResult.success = true;
 				break;
 			}
 			case CommandAction::Help:
 			{
-				finalResult.description =
+				// The spell list comes from the registry, which is complete once static initialization is over
+				static const std::string helpText =
 					"Commands:\n"
 					"  help\n"
 					"  pulse [radius]\n"
 					"  move [direction]\n"
 					"  attack [direction]\n"
-					"  cast <fire|water> [direction|self]\n"
+					"  cast <" + SpellRegistry::GetElementList() + "> [direction|self]\n"
+					"  cast <" + SpellRegistry::GetElementList() + "> [line|cone] [direction] [1-" + std::to_string(SpellArea::MaxSize) + "]\n"
+					"  cast <" + SpellRegistry::GetElementList() + "> radius [1-" + std::to_string(SpellArea::MaxSize) + "]\n"
 					"  summon skeleton\n"
 					"  command <target> (all) <follow|guard|attack|move> [direction]\n"
 					"  wait\n"
 					"  directions: north, south, east, west, north-east, north-west, south-east, south-west";
+				finalResult.description = helpText;
 				finalResult.success = true;
 				break;
 			}
 			case CommandAction::Unknown:
 			{
+				if (std::holds_alternative<WaitCmd>(command.command))
+				{
+					finalResult.description = "You wait for a moment.";
+				}
 				break;
 			}
 			default:
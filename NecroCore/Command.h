@@ -1,7 +1,9 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <variant>
 #include "PulseResult.h"
 #include "MoveResult.h"
@@ -9,9 +11,11 @@
 #include "AttackResult.h"
 #include "CastResult.h"
 #include "SummonCommandResult.h"
+#include "SpellArea.h"
 
 namespace NecroCore
 {
+	class ISpell;
 
 	enum class CommandAction {
 		Unknown,
@@ -24,8 +28,98 @@ namespace NecroCore
 		Help
 	};
 
-	using ArgValue = std::variant<int, float, std::string, bool>;
-	using ArgMap = std::unordered_map<std::string, ArgValue>;
+	// A word of command text kept inline, so parsed commands never allocate.
+	// Longer words are cut at Capacity.
+	struct CommandWord
+	{
+		static constexpr std::size_t Capacity = 31;
+
+		std::array<char, Capacity + 1> text{};
+		std::uint8_t length = 0;
+
+		static CommandWord From(std::string_view word)
+		{
+			CommandWord result;
+			result.length = static_cast<std::uint8_t>(word.size() < Capacity ? word.size() : Capacity);
+			word.copy(result.text.data(), result.length);
+			return result;
+		}
+
+		std::string_view View() const { return std::string_view(text.data(), length); }
+		bool operator==(std::string_view other) const { return View() == other; }
+	};
+
+	struct DirectionArg
+	{
+		static constexpr int Unknown = -1;
+		static constexpr int Self = -2;
+
+		// Index into Map::dirs, or Unknown / Self
+		int index = Unknown;
+		// As typed, for narration
+		CommandWord word;
+
+		bool IsKnown() const { return index >= 0; }
+		bool IsSelf() const { return index == Self; }
+	};
+
+	enum class SummonOrder : std::uint8_t
+	{
+		Unknown,
+		Follow,
+		Guard,
+		Attack,
+		Move
+	};
+
+	struct PulseCmd
+	{
+		int radius = 5;
+	};
+
+	struct MoveCmd
+	{
+		DirectionArg direction;
+	};
+
+	struct SummonCmd
+	{
+		CommandWord creature;
+	};
+
+	struct AttackCmd
+	{
+		DirectionArg direction;
+	};
+
+	struct SummonOrderCmd
+	{
+		CommandWord target; // "all" | "skeleton#1"
+		SummonOrder order = SummonOrder::Unknown;
+		CommandWord orderWord;
+		DirectionArg direction; // move orders only
+	};
+
+	struct CastCmd
+	{
+		// Resolved while parsing; null for an unknown element
+		const ISpell* spell = nullptr;
+		CommandWord element;
+		DirectionArg direction;
+		AreaShape shape = AreaShape::Single;
+		int size = SpellArea::DefaultSize;
+	};
+
+	struct WaitCmd
+	{
+	};
+
+	struct HelpCmd
+	{
+	};
+
+	// What ParseCommand understood, with every argument already in its final type
+	using TypedCommand = std::variant<std::monostate, PulseCmd, MoveCmd, SummonCmd, AttackCmd, SummonOrderCmd, CastCmd, WaitCmd, HelpCmd>;
 
 	using CommandPayload = std::variant<std::monostate, PulseResult, MoveResult, SummonResult, AttackResult, SummonCommandResult, CastResult>;
 
@@ -34,7 +128,7 @@ namespace NecroCore
 		CommandAction action = CommandAction::Unknown;
 		std::string description;
 
-		ArgMap args;
+		TypedCommand command;
 
 		CommandPayload payload;
 
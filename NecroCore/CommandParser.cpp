@@ -0,0 +1,115 @@
+#include "CommandParser.h"
+#include "KeywordTable.h"
+#include "Map.h"
+
+#include <charconv>
+
+namespace NecroCore
+{
+	namespace
+	{
+		using VerbTable = KeywordTable<CommandVerb, 16>;
+		constexpr VerbTable kVerbs = VerbTable::Build({
+			{ "pulse", CommandVerb::Pulse },
+			{ "cast", CommandVerb::Cast },
+			{ "move", CommandVerb::Move },
+			{ "summon", CommandVerb::Summon },
+			{ "attack", CommandVerb::Attack },
+			{ "command", CommandVerb::Command },
+			{ "wait", CommandVerb::Wait },
+			{ "help", CommandVerb::Help },
+		});
+
+		template <std::size_t... I>
+		constexpr auto MakeDirectionTable(std::index_sequence<I...>)
+		{
+			using Table = KeywordTable<int, 16>;
+			return Table::Build({
+				{ Map::dirs[I].name, static_cast<int>(I) }...,
+				{ "self", DirectionArg::Self },
+			});
+		}
+		constexpr auto kDirections = MakeDirectionTable(std::make_index_sequence<std::size(Map::dirs)>{});
+
+		using ShapeTable = KeywordTable<AreaShape, 8>;
+		constexpr ShapeTable kShapes = ShapeTable::Build({
+			{ "single", AreaShape::Single },
+			{ "line", AreaShape::Line },
+			{ "cone", AreaShape::Cone },
+			{ "radius", AreaShape::Radius },
+		});
+
+		using OrderTable = KeywordTable<SummonOrder, 8>;
+		constexpr OrderTable kOrders = OrderTable::Build({
+			{ "follow", SummonOrder::Follow },
+			{ "guard", SummonOrder::Guard },
+			{ "attack", SummonOrder::Attack },
+			{ "move", SummonOrder::Move },
+		});
+
+		constexpr bool IsSpace(char c)
+		{
+			return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+		}
+	}
+
+	bool CommandTokenizer::Next(std::string_view& word)
+	{
+		std::size_t start = 0;
+		while (start < m_Rest.size() && IsSpace(m_Rest[start]))
+			++start;
+		if (start == m_Rest.size())
+		{
+			m_Rest = {};
+			return false;
+		}
+
+		std::size_t end = start;
+		while (end < m_Rest.size() && !IsSpace(m_Rest[end]))
+			++end;
+
+		word = m_Rest.substr(start, end - start);
+		m_Rest.remove_prefix(end);
+		return true;
+	}
+
+	bool CommandTokenizer::NextInt(int& value)
+	{
+		std::string_view word;
+		if (!Next(word))
+			return false;
+		if (!word.empty() && word.front() == '+')
+			word.remove_prefix(1);
+
+		int parsed = 0;
+		const auto result = std::from_chars(word.data(), word.data() + word.size(), parsed);
+		if (result.ec != std::errc())
+			return false;
+		value = parsed;
+		return true;
+	}
+
+	std::optional<CommandVerb> CommandKeywords::FindVerb(std::string_view word)
+	{
+		const CommandVerb* verb = kVerbs.Find(word);
+		return verb ? std::optional<CommandVerb>(*verb) : std::nullopt;
+	}
+
+	int CommandKeywords::FindDirection(std::string_view word)
+	{
+		const int* index = kDirections.Find(word);
+		return index ? *index : DirectionArg::Unknown;
+	}
+
+	std::optional<AreaShape> CommandKeywords::FindShape(std::string_view word)
+	{
+		const AreaShape* shape = kShapes.Find(word);
+		return shape ? std::optional<AreaShape>(*shape) : std::nullopt;
+	}
+
+	SummonOrder CommandKeywords::FindOrder(std::string_view word)
+	{
+		const SummonOrder* order = kOrders.Find(word);
+		return order ? *order : SummonOrder::Unknown;
+	}
+}
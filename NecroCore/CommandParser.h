@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Command.h"
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace NecroCore
+{
+	enum class CommandVerb : std::uint8_t
+	{
+		Pulse,
+		Cast,
+		Move,
+		Summon,
+		Attack,
+		Command,
+		Wait,
+		Help
+	};
+
+	// Splits a command line into whitespace-separated words in place; the
+	// words point into the original text.
+	class CommandTokenizer
+	{
+	public:
+		explicit CommandTokenizer(std::string_view text) : m_Rest(text) {}
+
+		bool Next(std::string_view& word);
+		// Reads the next word as a number, accepting a numeric prefix like
+		// stream extraction does. The word is consumed either way.
+		bool NextInt(int& value);
+
+	private:
+		std::string_view m_Rest;
+	};
+
+	// Compile-time perfect-hash lookups for every keyword the parser knows.
+	class CommandKeywords
+	{
+	public:
+		static std::optional<CommandVerb> FindVerb(std::string_view word);
+		// Index into Map::dirs, DirectionArg::Self, or DirectionArg::Unknown
+		static int FindDirection(std::string_view word);
+		static std::optional<AreaShape> FindShape(std::string_view word);
+		static SummonOrder FindOrder(std::string_view word);
+
+		static DirectionArg MakeDirection(std::string_view word)
+		{
+			DirectionArg direction;
+			direction.index = FindDirection(word);
+			direction.word = CommandWord::From(word);
+			return direction;
+		}
+	};
+}
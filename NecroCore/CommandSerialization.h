@@ -1,133 +1,169 @@
 #pragma once
 
 #include "Command.h"
-#include "PulseResult.h"
-#include "MoveResult.h"
-#include "SummonResult.h"
+#include "JsonWriter.h"
+#include "ResultSchema.h"
 
 #include <string>
-#include <sstream>
+#include <string_view>
 #include <variant>
 
 namespace NecroCore
 {
     inline std::string EscapeJsonString(const std::string& input)
     {
-        std::ostringstream oss;
-        for (char c : input)
+        std::string out;
+        out.reserve(input.size());
+        JsonWriter::AppendEscaped(out, input);
+        return out;
+    }
+
+    inline const char* CommandActionToString(CommandAction action)
+    {
+        switch (action)
         {
-            switch (c)
+        case CommandAction::Pulse:         return "pulse";
+        case CommandAction::Move:          return "move";
+        case CommandAction::Summon:        return "summon";
+        case CommandAction::Attack:        return "attack";
+        case CommandAction::SummonCommand: return "command";
+        case CommandAction::Cast:          return "cast";
+        case CommandAction::Help:          return "help";
+        case CommandAction::Unknown:
+        default:                           return "unknown";
+        }
+    }
+
+    // {"type":<schema type>, ...fields}, or {"type":"none"} for no payload
+    inline void WriteCommandPayloadJson(JsonWriter& json, const CommandPayload& payload)
+    {
+        json.BeginObject();
+        std::visit([&](const auto& value)
             {
-            case '\"': oss << "\\\""; break;
-            case '\\': oss << "\\\\"; break;
-            case '\b': oss << "\\b";  break;
-            case '\f': oss << "\\f";  break;
-            case '\n': oss << "\\n";  break;
-            case '\r': oss << "\\r";  break;
-            case '\t': oss << "\\t";  break;
-            default:
-                if (static_cast<unsigned char>(c) < 0x20)
+                using T = std::decay_t<decltype(value)>;
+                if constexpr (std::is_same_v<T, std::monostate>)
                 {
-                    oss << "\\u"
-                        << std::hex
-                        << std::uppercase
-                        << static_cast<int>(static_cast<unsigned char>(c));
+                    json.Field("type", "none");
                 }
                 else
                 {
-                    oss << c;
+                    json.Field("type", Schema<T>::type);
+                    WriteSchemaFieldsJson(json, value);
                 }
-                break;
-            }
-        }
-        return oss.str();
+            }, payload);
+        json.EndObject();
     }
 
-    inline std::string CommandActionToString(CommandAction action)
+    // One byte of CommandPayload alternative index, then the schema fields
+    inline void WriteCommandPayloadBinary(std::string& out, const CommandPayload& payload)
     {
-        switch (action)
-        {
-        case CommandAction::Pulse:  return "pulse";
-        case CommandAction::Move:   return "move";
-        case CommandAction::Summon: return "summon";
-        case CommandAction::Unknown:
-        default:                    return "unknown";
-        }
+        out += static_cast<char>(payload.index());
+        std::visit([&](const auto& value)
+            {
+                using T = std::decay_t<decltype(value)>;
+                if constexpr (!std::is_same_v<T, std::monostate>)
+                    WriteSchemaBinary(out, value);
+            }, payload);
     }
 
-    inline std::string CommandResultToJson(const CommandResult& result)
+    namespace Detail
     {
-        std::ostringstream oss;
-        oss << "{";
-
-        oss << "\"success\":" << (result.success ? "true" : "false") << ",";
-        oss << "\"action\":\"" << CommandActionToString(result.action) << "\",";
-
-        oss << "\"gameOver\":" << (result.gameOver ? "true" : "false") << ",";
-
-        oss << "\"description\":\"" << EscapeJsonString(result.description) << "\",";
-
-        oss << "\"args\":{";
-        bool firstArg = true;
-        for (const auto& [key, value] : result.args)
+        template <std::size_t I = 0>
+        bool ReadPayloadAlternative(SchemaReader& reader, std::size_t index, CommandPayload& payload)
         {
-            if (!firstArg) oss << ",";
-            firstArg = false;
-            oss << "\"" << EscapeJsonString(key) << "\":";
-            if (std::holds_alternative<int>(value))
+            if constexpr (I < std::variant_size_v<CommandPayload>)
             {
-                oss << std::get<int>(value);
+                if (index != I)
+                    return ReadPayloadAlternative<I + 1>(reader, index, payload);
+                using T = std::variant_alternative_t<I, CommandPayload>;
+                T value{};
+                if constexpr (!std::is_same_v<T, std::monostate>)
+                {
+                    if (!reader.Read(value))
+                        return false;
+                }
+                payload = std::move(value);
+                return true;
             }
             else
             {
-                oss << "\"" << EscapeJsonString(std::get<std::string>(value)) << "\"";
+                return false;
             }
         }
-        oss << "},";
+    }
 
-        oss << "\"payload\":{";
-        bool hasPayload = false;
+    inline bool ReadCommandPayloadBinary(SchemaReader& reader, CommandPayload& payload)
+    {
+        std::uint64_t index = 0;
+        if (!reader.ReadVarint(index))
+            return false;
+        return Detail::ReadPayloadAlternative(reader, static_cast<std::size_t>(index), payload);
+    }
 
-        if (std::holds_alternative<PulseResult>(result.payload))
+    // The parsed arguments as a JSON object, under the keys clients already read
+    inline void WriteCommandArgsJson(JsonWriter& json, const TypedCommand& command)
+    {
+        json.BeginObject();
+        if (const auto* pulse = std::get_if<PulseCmd>(&command))
         {
-            const auto& p = std::get<PulseResult>(result.payload);
-            oss << "\"type\":\"pulse\","
-                << "\"detectedHostileCount\":" << p.detectedHostileCount << ","
-                << "\"detectedFriendlyCount\":" << p.detectedFriendlyCount;
-            hasPayload = true;
+            json.Field("radius", pulse->radius);
         }
-        else if (std::holds_alternative<MoveResult>(result.payload))
+        else if (const auto* move = std::get_if<MoveCmd>(&command))
         {
-            const auto& m = std::get<MoveResult>(result.payload);
-            oss << "\"type\":\"move\","
-                << "\"oldX\":" << m.oldX << ","
-                << "\"oldY\":" << m.oldY << ","
-                << "\"newX\":" << m.newX << ","
-                << "\"newY\":" << m.newY;
-            hasPayload = true;
+            json.Field("direction", move->direction.word.View());
         }
-        else if (std::holds_alternative<SummonResult>(result.payload))
+        else if (const auto* summon = std::get_if<SummonCmd>(&command))
         {
-            const auto& s = std::get<SummonResult>(result.payload);
-            oss << "\"type\":\"summon\","
-                << "\"entityId\":" << s.summonedEntity.id << ","
-                << "\"x\":" << s.summonedEntity.x << ","
-                << "\"y\":" << s.summonedEntity.y << ","
-                << "\"faction\":" << static_cast<int>(s.summonedEntity.faction) << ","
-                << "\"hp\":" << s.summonedEntity.hp << ","
-                << "\"maxHp\":" << s.summonedEntity.maxHp << ","
-                << "\"attackDamage\":" << s.summonedEntity.attackDamage;
-            hasPayload = true;
+            json.Field("creature", summon->creature.View());
         }
-
-        if (!hasPayload)
+        else if (const auto* attack = std::get_if<AttackCmd>(&command))
+        {
+            json.Field("direction", attack->direction.word.View());
+        }
+        else if (const auto* order = std::get_if<SummonOrderCmd>(&command))
         {
-            oss << "\"type\":\"none\"";
+            json.Field("target", order->target.View());
+            json.Field("order", order->orderWord.View());
+            json.Field("direction", order->direction.word.View());
         }
+        else if (const auto* cast = std::get_if<CastCmd>(&command))
+        {
+            json.Field("element", cast->element.View());
+            json.Field("direction", cast->direction.word.View());
+            if (cast->shape != AreaShape::Single)
+            {
+                json.Field("shape", SpellArea::ShapeToString(cast->shape));
+                json.Field("size", cast->size);
+            }
+        }
+        json.EndObject();
+    }
+
+    // Appends the result to `out`. Servers keep one buffer per thread and clear
+    // it between responses, so steady-state serialization does not allocate.
+    inline void WriteCommandResultJson(std::string& out, const CommandResult& result)
+    {
+        JsonWriter json(out);
+        json.BeginObject();
+        json.Field("success", result.success);
+        json.Field("action", CommandActionToString(result.action));
+        json.Field("gameOver", result.gameOver);
+        json.Field("description", result.description);
 
-        oss << "}";
-        oss << "}";
+        json.Key("args");
+        WriteCommandArgsJson(json, result.command);
 
-        return oss.str();
+        json.Key("payload");
+        WriteCommandPayloadJson(json, result.payload);
+
+        json.EndObject();
+    }
+
+    inline std::string CommandResultToJson(const CommandResult& result)
+    {
+        std::string out;
+        out.reserve(256 + result.description.size());
+        WriteCommandResultJson(out, result);
+        return out;
     }
 }
\ No newline at end of file
@@ -26,5 +26,8 @@ namespace NecroCore
 		EntityState aiState = EntityState::Idle;
 		int guardX = 0;
 		int guardY = 0;
+
+		// Elite hostiles plan their moves with HostilePlanner instead of chasing greedily
+		bool elite = false;
 	};
 }
\ No newline at end of file
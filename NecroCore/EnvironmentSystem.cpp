@@ -2,10 +2,16 @@
 #include "Game.h"
 #include "Map.h"
 #include "Entity.h"
+#include "Log.h"
+#include "TileSimulation.h"
+#include "TimingWheel.h"
+#include "WorldEvent.h"
+#include "Messages.h"
 
 #include <iostream>
-#include <sstream>
 #include <vector>
+#include <algorithm>
+#include <cstdlib>
 
 namespace NecroCore
 {
@@ -15,32 +21,19 @@ namespace NecroCore
         Player& player = game.GetPlayer();
         Map& map = game.GetMap();
 
-        std::ostringstream oss;
-        oss << result.description;
+        // Messages render straight onto the turn's description
+        std::string& out = result.description;
 
-        bool firstAppend = result.description.empty();
+        bool firstAppend = out.empty();
         auto appendSeparator = [&]()
             {
                 if (!firstAppend)
                 {
-                    oss << "\n";
+                    out += '\n';
                 }
                 firstAppend = false;
             };
 
-        auto formatEntityMessage = [&](const char* tmpl, const std::string& entityName) -> std::string
-            {
-                if (!tmpl) return {};
-                std::string msg = tmpl;
-                const std::string placeholder = "{entity}";
-                const auto pos = msg.find(placeholder);
-                if (pos != std::string::npos)
-                {
-                    msg.replace(pos, placeholder.size(), entityName);
-                }
-                return msg;
-            };
-
         auto effectFromTile = [&](Actor& actor, StatusEffect status)
             {
                 if (map.GetTileState(actor.x, actor.y) == status && actor.status != status)
@@ -51,109 +44,149 @@ namespace NecroCore
 
         auto tickStatuses = [&](Actor& actor, bool isPlayer)
             {
-                std::vector<StatusEffect> toProcess;
-                toProcess.reserve(actor.statusDurations.size());
-                for (auto& kv : actor.statusDurations)
-                {
-                    toProcess.push_back(kv.first);
-                }
-
-                for (StatusEffect status : toProcess)
+                // The mask is copied up front, so clearing a status mid-walk is safe
+                ForEachStatusIndex(actor.status, [&](std::size_t index)
                 {
-                    auto it = actor.statusDurations.find(status);
-                    if (it == actor.statusDurations.end())
-                        continue;
-
-                    int& duration = it->second;
+                    const StatusEffect status = StatusEffectFromIndex(index);
+                    int& duration = actor.statusDurations[index];
                     if (duration <= 0)
                     {
                         actor.ClearStatus(status);
-                        continue;
+                        return;
                     }
 
-                    auto descOpt = GetStatusDescriptor(status);
-                    if (!descOpt)
-                    {
-                        --duration;
-                        if (duration <= 0)
-                            actor.ClearStatus(status);
-                        continue;
-                    }
-
-                    const StatusDescriptor& desc = *descOpt;
+                    const StatusDescriptor& desc = kStatusTable[index];
 
                     if (desc.damagePerTurn > 0 && actor.IsAlive())
                     {
                         actor.ApplyDamage(desc.damagePerTurn);
+                        if (!isPlayer)
+                            game.GetActivation().Wake(actor.id);
                     }
 
-                    if (isPlayer)
+                    const MessageArgs args{ actor.name };
+                    appendSeparator();
+                    if (actor.IsAlive())
                     {
-                        appendSeparator();
-                        if (actor.IsAlive())
-                        {
-                            oss << desc.playerTickMessage;
-                        }
-                        else
-                        {
-                            oss << desc.playerDeathMessage;
-                        }
+                        Messages::Append(out, StatusMessageId(index, isPlayer ? StatusMessage::PlayerTick : StatusMessage::EntityTick), args);
                     }
                     else
                     {
-                        appendSeparator();
-                        if (actor.IsAlive())
-                        {
-                            oss << formatEntityMessage(desc.entityTickMessage, actor.name);
-                        }
-                        else
-                        {
-                            oss << formatEntityMessage(desc.entityDeathMessage, actor.name);
-                        }
+                        Messages::Append(out, StatusMessageId(index, isPlayer ? StatusMessage::PlayerDeath : StatusMessage::EntityDeath), args);
                     }
 
                     --duration;
                     if (duration <= 0)
                     {
-                        if (isPlayer)
-                        {
-                            appendSeparator();
-                            oss << desc.playerEndMessage;
-                        }
-                        else
-                        {
-                            appendSeparator();
-                            oss << formatEntityMessage(desc.entityEndMessage, actor.name);
-                        }
+                        appendSeparator();
+                        Messages::Append(out, StatusMessageId(index, isPlayer ? StatusMessage::PlayerEnd : StatusMessage::EntityEnd), args);
                         actor.ClearStatus(status);
                     }
+                });
+            };
+
+        auto applyWorldEvent = [&](const WorldEvent& event)
+            {
+                switch (event.kind)
+                {
+                case WorldEventKind::Explosion:
+                {
+                    appendSeparator();
+                    Messages::Append(out, Message::Explosion);
+                    auto inBlast = [&](const Actor& actor)
+                        {
+                            return actor.IsAlive() &&
+                                std::max(std::abs(actor.x - event.x), std::abs(actor.y - event.y)) <= event.radius;
+                        };
+                    if (inBlast(player))
+                    {
+                        player.ApplyDamage(event.damage);
+                        appendSeparator();
+                        Messages::Append(out, Message::ExplosionHitsPlayer);
+                    }
+                    for (Entity& entity : entities)
+                    {
+                        if (!inBlast(entity))
+                            continue;
+                        entity.ApplyDamage(event.damage);
+                        appendSeparator();
+                        Messages::Append(out, Message::ExplosionHitsEntity, { entity.name });
+                    }
+                    game.GetActivation().EmitNoise(event.x, event.y, event.radius + ActivationSystem::CombatNoiseRadius);
+                    TileSimulation::Ignite(map, event.x, event.y, static_cast<std::uint8_t>(std::clamp(event.radius + 1, 1, 0xFE)));
+                    break;
+                }
+                case WorldEventKind::RearmTrap:
+                    if (map.GetTile(event.x, event.y) == TileType::Floor)
+                    {
+                        game.SpawnTrapAt(event.x, event.y, event.effect);
+                        appendSeparator();
+                        Messages::Append(out, Message::TrapRearms);
+                    }
+                    break;
                 }
             };
 
-        // Player tile/tick effects
+        // Tile effects first; anything that gains a status gets a tick this pass
         StatusEffect playerTileEffect = map.GetTileState(player.x, player.y);
         effectFromTile(player, playerTileEffect);
+        game.MarkStatusActive(player);
 
-        tickStatuses(player, true);
-        if (!player.IsAlive() && !result.gameOver)
-        {
-            result.gameOver = true;
-        }
-
-        // Entity tile/tick effects
+        // Entity tile effects: a byte load per entity, no allocation
         for (Entity& entity : entities)
         {
             if (!entity.IsAlive()) continue;
 
             StatusEffect entityTileEffect = map.GetTileState(entity.x, entity.y);
+            if (entityTileEffect == StatusEffect::Normal) continue;
 
-            std::cout << "[Env] Entity " << entity.name << " at (" << entity.x << "," << entity.y
-                << ") tile status: " << (int)entityTileEffect << "\n";
+            NECRO_TRACE("[Env] Entity " << entity.name << " at (" << entity.x << "," << entity.y
+                << ") tile status: " << (int)entityTileEffect << "\n");
             effectFromTile(entity, entityTileEffect);
+            game.MarkStatusActive(entity);
+        }
+
+        // Only timers that are due come out of the wheel: the player's tick (id 0)
+        // first, then entity ticks by id, then world events
+        thread_local std::vector<TimerEvent> due;
+        due.clear();
+        game.AdvanceTimers(due);
+
+        auto cursor = entities.begin();
+        for (const TimerEvent& timer : due)
+        {
+            if (timer.kind == TimerKind::WorldEvent)
+            {
+                WorldEvent event;
+                if (game.TakeWorldEvent(timer.id, event))
+                {
+                    applyWorldEvent(event);
+                }
+                continue;
+            }
 
-            tickStatuses(entity, false);
-		}
+            if (timer.id == player.id)
+            {
+                tickStatuses(player, true);
+                game.MarkStatusActive(player);
+                continue;
+            }
+
+            cursor = std::lower_bound(cursor, entities.end(), timer.id,
+                [](const Entity& e, int value) { return e.id < value; });
+            if (cursor == entities.end() || cursor->id != timer.id || !cursor->IsAlive())
+                continue;
+
+            tickStatuses(*cursor, false);
+            if (cursor->IsAlive())
+            {
+                game.MarkStatusActive(*cursor);
+            }
+        }
 
-        result.description = oss.str();
+        if (!player.IsAlive() && !result.gameOver)
+        {
+            result.gameOver = true;
+        }
     }
 }
\ No newline at end of file
@@ -2,6 +2,10 @@
 #include "Game.h" 
 #include "Map.h" 
 #include "Status.h"
+#include "SpellArea.h"
+#include "TileSimulation.h"
+
+#include <vector>
 
 namespace NecroCore 
 {
@@ -9,6 +13,7 @@ namespace NecroCore
     {
     public:
         const char* GetName() const override { return "fire"; }
+        StatusEffect GetElement() const override { return StatusEffect::OnFire; }
         CastResult Cast(Game& game, int tx, int ty, const std::string& direction) const override
         {
             CastResult result{};
@@ -44,11 +49,51 @@ namespace NecroCore
 
             return result;
         }
+
+        CastResult CastArea(Game& game, const AreaHit& hit, const std::string& direction) const override
+        {
+            CastResult result{};
+            Map& map = game.GetMap();
+
+            // Hearths in the area are lit; loose fire goes down on floors and doors
+            thread_local std::vector<Map::TileStateEdit> edits;
+            edits.clear();
+            for (const AreaTile& tile : hit.tiles)
+            {
+                Map::TileStateEdit edit{};
+                if (map.IsFireplace(tile.x, tile.y))
+                {
+                    if (!HasStatus(map.GetTileState(tile.x, tile.y), StatusEffect::OnFire))
+                        edits.push_back({ tile.x, tile.y, StatusEffect::OnFire, 0 });
+                }
+                else if (TileSimulation::PlanIgnite(map, tile.x, tile.y, TileSimulation::TrapFireIntensity, edit))
+                {
+                    edits.push_back(edit);
+                }
+            }
+            map.SetTileStates(edits);
+            result.tilesAffected = static_cast<int>(edits.size());
+
+            MessageArgs args;
+            args.direction = direction;
+            args.count = result.tilesAffected;
+            Messages::Append(result.description, SpellArea::MessageFor(Message::FireLine, hit.shape), args);
+
+            for (Actor* actor : hit.actors)
+            {
+                actor->AddStatus(StatusEffect::OnFire);
+                game.MarkStatusActive(*actor);
+                ++result.actorsAffected;
+
+                result.description += '\n';
+                if (actor == &game.GetPlayer())
+                    Messages::Append(result.description, Message::AreaIgnitesPlayer);
+                else
+                    Messages::Append(result.description, Message::AreaIgnitesEntity, { actor->name });
+            }
+            return result;
+        }
     };
 
-    const ISpell& GetFireSpell()
-    {
-        static FireSpell instance;
-        return instance;
-    }
+    NECRO_REGISTER_SPELL(FireSpell);
 }
\ No newline at end of file
@@ -7,22 +7,18 @@
 #include "HostileAISystem.h"
 #include "SummonsAISystem.h"
 #include "EnvironmentSystem.h"
+#include "TileSimulation.h"
 #include "Spell.h"
+#include "Log.h"
+#include "Hash.h"
+#include "Messages.h"
 
 #include <iostream>
+#include <algorithm>
 #include <sstream>
 #include <cstdlib>
 #include <cmath>
 
-inline static std::string StepsPhrase(int distance)
-{
-	if (distance <= 1)
-		return "right next to you";
-	if (distance == 2)
-		return "1 step away";
-	return std::to_string(distance) + " steps away";
-}
-
 inline static int Distance(int x1, int y1, int x2, int y2)
 {
 	return std::max(std::abs(x1 - x2), std::abs(y1 - y2));
@@ -30,16 +26,43 @@ inline static int Distance(int x1, int y1, int x2, int y2)
 
 namespace NecroCore
 {
-	Game::Game(const std::string& playerName, const std::string& mapName)
+	Game::Game(const std::string& playerName, const std::string& mapName, std::uint64_t seed)
 		: m_PlayerName(playerName)
+		, m_Random(seed)
 	{
 		m_Player.name = playerName;
 		InitializeMap(mapName);
 	}
+	Game::Game(const std::string& playerName, const std::string& mapName)
+		: Game(playerName, mapName, Random::DefaultSeed)
+	{
+	}
 	Game::Game(const std::string& playerName)
 		: Game(playerName, "test_box")
 	{
 	}
+	Game::Game(const Game& source, ForkTag)
+		: m_PlayerName(source.m_PlayerName)
+		, m_MapName(source.m_MapName)
+		, m_Player(source.m_Player)
+		, m_Entities(source.m_Entities)
+		, m_NextEntityId(source.m_NextEntityId)
+		, m_Map(source.m_Map)
+		, m_Random(source.m_Random)
+		, m_Journal(0)
+		, m_PlannerConfig(source.m_PlannerConfig)
+		, m_Turn(source.m_Turn)
+		, m_WorldEvents(source.m_WorldEvents)
+		, m_NextWorldEventId(source.m_NextWorldEventId)
+	{
+		// A fork taken mid-turn copies the source's tile log, but has no journal to empty it
+		m_Map.SetChangeTracking(false);
+		m_Map.ClearTileChanges();
+	}
+	Game Game::Fork() const
+	{
+		return Game(*this, ForkTag{});
+	}
 	const std::string& Game::GetPlayerName() const
 	{
 		return m_PlayerName;
@@ -53,14 +76,14 @@ namespace NecroCore
 		int newX = oldX + dx;
 		int newY = oldY + dy;
 
-		std::cout << "[MovePlayer] from (" << oldX << "," << oldY
-			<< ") to (" << newX << "," << newY << ")\n";
+		NECRO_TRACE("[MovePlayer] from (" << oldX << "," << oldY
+			<< ") to (" << newX << "," << newY << ")\n");
 
 		bool walkable = m_Map.IsWalkable(newX, newY);
 		bool free = IsTileFree(newX, newY);
-		std::cout << "[MovePlayer] IsWalkable(" << newX << "," << newY
+		NECRO_TRACE("[MovePlayer] IsWalkable(" << newX << "," << newY
 			<< ") = " << (walkable ? "true" : "false")
-			<< ", IsTileFree = " << (free ? "true" : "false") << "\n";
+			<< ", IsTileFree = " << (free ? "true" : "false") << "\n");
 
 		MoveResult result{};
 		result.oldX = oldX;
@@ -90,14 +113,14 @@ namespace NecroCore
 		int newX = oldX + dx;
 		int newY = oldY + dy;
 
-		std::cout << "[MoveEntity] from (" << oldX << "," << oldY
-			<< ") to (" << newX << "," << newY << ")\n";
+		NECRO_TRACE("[MoveEntity] from (" << oldX << "," << oldY
+			<< ") to (" << newX << "," << newY << ")\n");
 
 		bool walkable = m_Map.IsWalkable(newX, newY);
 		bool free = IsTileFree(newX, newY);
-		std::cout << "[MoveEntity] IsWalkable(" << newX << "," << newY
+		NECRO_TRACE("[MoveEntity] IsWalkable(" << newX << "," << newY
 			<< ") = " << (walkable ? "true" : "false")
-			<< ", IsTileFree = " << (free ? "true" : "false") << "\n";
+			<< ", IsTileFree = " << (free ? "true" : "false") << "\n");
 
 		MoveResult result{};
 		result.oldX = oldX;
@@ -129,7 +152,7 @@ namespace NecroCore
 		return nullptr;
 	}
 
-	Entity* Game::GetEntityByName(const std::string& name)
+	Entity* Game::GetEntityByName(std::string_view name)
 	{
 		for (Entity& entity : m_Entities)
 		{
@@ -192,13 +215,11 @@ namespace NecroCore
 				result.description += " ";
 			}
 
-			const int dist = Distance(playerX, playerY, tx, ty);
-
-			result.description += "\nThere is a door ";
-			result.description += StepsPhrase(dist);
-			result.description += " to the ";
-			result.description += dirName;
-			result.description += ".";
+			MessageArgs args;
+			args.direction = dirName;
+			args.distance = Distance(playerX, playerY, tx, ty);
+			result.description += '\n';
+			Messages::Append(result.description, Message::PulseDoor, args);
 		}
 
 		for (const auto& pos : reachable)
@@ -216,13 +237,11 @@ namespace NecroCore
 			if (!HasStatus(m_Map.GetTileState(tx, ty), StatusEffect::OnFire))
 				continue;
 
-			const int dist = Distance(playerX, playerY, tx, ty);
-
-			result.description += "\nYou feel gentle warmth and hear a soft crackling ";
-			result.description += StepsPhrase(dist);
-			result.description += " to the ";
-			result.description += dirName;
-			result.description += ".";
+			MessageArgs args;
+			args.direction = dirName;
+			args.distance = Distance(playerX, playerY, tx, ty);
+			result.description += '\n';
+			Messages::Append(result.description, Message::PulseHearth, args);
 		}
 
 
@@ -238,29 +257,23 @@ namespace NecroCore
 			if (!dirName)
 				continue;
 
-			result.description += "\nYou sense ";
-
+			Message line = Message::PulsePresence;
 			if (entity.faction == Faction::Hostile)
 			{
-				result.description += "a hostile presence ";
+				line = Message::PulseHostile;
 				result.detectedHostileCount += 1;
 			}
 			else if (entity.faction == Faction::Friendly)
 			{
-				result.description += "a friendly presence ";
+				line = Message::PulseFriendly;
 				result.detectedFriendlyCount += 1;
 			}
-			else
-			{
-				result.description += "a presence ";
-			}
-
-			const int dist = Distance(playerX, playerY, entity.x, entity.y);
 
-			result.description += StepsPhrase(dist);
-			result.description += " to the ";
-			result.description += dirName;
-			result.description += ".";
+			MessageArgs args;
+			args.direction = dirName;
+			args.distance = Distance(playerX, playerY, entity.x, entity.y);
+			result.description += '\n';
+			Messages::Append(result.description, line, args);
 		}
 
 
@@ -278,66 +291,97 @@ namespace NecroCore
 
 			StatusEffect trapEffect = m_Map.GetTileState(tx, ty);
 
-			result.description += "\nYou sense ";
-
+			Message line = Message::PulseTrap;
 			if (HasStatus(trapEffect, StatusEffect::OnFire))
 			{
-				result.description += "a fire trap ";
-				result.detectedTrapCount += 1;
+				line = Message::PulseFireTrap;
 			}
 			else if (HasStatus(trapEffect, StatusEffect::Poisoned))
 			{
-				result.description += "a poison trap ";
-				result.detectedTrapCount += 1;
+				line = Message::PulsePoisonTrap;
 			}
-			else
-			{
-				result.description += "a trap ";
-				result.detectedTrapCount += 1;
-			}
-
-			const int dist = Distance(playerX, playerY, tx, ty);
+			result.detectedTrapCount += 1;
 
-			result.description += StepsPhrase(dist);
-			result.description += " to the ";
-			result.description += dirName;
-			result.description += ".";
+			MessageArgs args;
+			args.direction = dirName;
+			args.distance = Distance(playerX, playerY, tx, ty);
+			result.description += '\n';
+			Messages::Append(result.description, line, args);
 		}
 		return result;
 	}
 	CastResult Game::CastSpell(const std::string& element, const std::string& direction)
+	{
+		return CastSpell(element, direction, AreaShape::Single, SpellArea::DefaultSize);
+	}
+	CastResult Game::CastSpell(const std::string& element, const std::string& direction, AreaShape shape, int size)
 	{
 		CastResult result{};
 
-		int dx = 0;
-		int dy = 0;
-		int tx = 0;
-		int ty = 0;
-
-		if (direction == "self")
+		int directionIndex = DirectionArg::Unknown;
+		if (shape == AreaShape::Radius)
+		{
+			directionIndex = 0;
+		}
+		else if (shape == AreaShape::Single && direction == "self")
 		{
-			tx = m_Player.x;
-			ty = m_Player.y;
+			directionIndex = DirectionArg::Self;
 		}
 		else
 		{
-			if (!m_Map.DirectionFromString(direction, dx, dy))
+			for (std::size_t i = 0; i < std::size(Map::dirs); ++i)
 			{
-				return result;
+				if (direction == Map::dirs[i].name)
+					directionIndex = static_cast<int>(i);
 			}
-
-			tx = m_Player.x + dx;
-			ty = m_Player.y + dy;
 		}
-		std::cout << "[CastSpell] Casting " << element << " towards " << direction
-			<< " (target tile: " << tx << "," << ty << ")\n";
-		const ISpell* spell = FindSpellByName(element);
+		if (directionIndex == DirectionArg::Unknown)
+		{
+			return result;
+		}
+
+		const ISpell* spell = SpellRegistry::Find(element);
 		if (spell == nullptr)
 		{
-			result.description = "You cast a spell of " + element + " towards " + direction + ", but nothing happens.";
+			MessageArgs args;
+			args.element = element;
+			args.direction = direction;
+			Messages::Append(result.description, Message::CastFizzles, args);
 			return result;
 		}
-		return spell->Cast(*this, tx, ty, direction);
+		return CastResolved(*spell, directionIndex, shape, size);
+	}
+	CastResult Game::CastResolved(const ISpell& spell, int directionIndex, AreaShape shape, int size)
+	{
+		const std::string direction = directionIndex == DirectionArg::Self ? "self"
+			: shape == AreaShape::Radius ? "around"
+			: Map::dirs[directionIndex].name;
+
+		if (shape == AreaShape::Single)
+		{
+			int tx = m_Player.x;
+			int ty = m_Player.y;
+			if (directionIndex != DirectionArg::Self)
+			{
+				tx += Map::dirs[directionIndex].dx;
+				ty += Map::dirs[directionIndex].dy;
+			}
+			NECRO_TRACE("[CastSpell] Casting " << spell.GetName() << " towards " << direction
+				<< " (target tile: " << tx << "," << ty << ")\n");
+			m_Activation.EmitNoise(tx, ty, ActivationSystem::SpellNoiseRadius);
+			return spell.Cast(*this, tx, ty, direction);
+		}
+
+		NECRO_TRACE("[CastSpell] Casting " << SpellArea::ShapeToString(shape) << " of " << spell.GetName()
+			<< " towards " << direction << " (size " << size << ")\n");
+
+		thread_local AreaHit hit;
+		hit.shape = shape;
+		SpellArea::Resolve(m_Map, shape, directionIndex, size, m_Player.x, m_Player.y, hit.tiles);
+		SpellArea::FindActors(*this, hit.tiles, hit.actors);
+
+		m_Activation.EmitNoise(m_Player.x, m_Player.y, ActivationSystem::SpellNoiseRadius + size);
+		return spell.CastArea(*this, hit, direction);
 	}
 	void Game::SpawnHostileAt(int x, int y)
 	{
@@ -355,6 +399,26 @@ namespace NecroCore
 		hostileEntity.name = "Skeleton";
 		hostileEntity.attackDamage = 1;
 		m_Entities.push_back(hostileEntity);
+		m_Activation.Invalidate();
+	}
+	void Game::SpawnEliteHostileAt(int x, int y)
+	{
+		if (!m_Map.IsWalkable(x, y)) return;
+
+		Entity hostileEntity;
+		hostileEntity.id = m_NextEntityId++;
+		hostileEntity.faction = Faction::Hostile;
+		hostileEntity.x = x;
+		hostileEntity.y = y;
+		hostileEntity.aggroRange = 7;
+		hostileEntity.aiState = EntityState::Attack;
+		hostileEntity.hp = 15;
+		hostileEntity.maxHp = 15;
+		hostileEntity.name = "Skeleton Champion";
+		hostileEntity.attackDamage = 2;
+		hostileEntity.elite = true;
+		m_Entities.push_back(hostileEntity);
+		m_Activation.Invalidate();
 	}
 	void Game::SpawnHostileWithStatsForTest(int x, int y, int hp, int attackDamage, std::string name)
 	{
@@ -371,6 +435,7 @@ namespace NecroCore
 		hostileEntity.attackDamage = attackDamage;
 		hostileEntity.aiState = EntityState::Attack;
 		m_Entities.push_back(hostileEntity);
+		m_Activation.Invalidate();
 	}
 	void Game::SpawnFriendlyWithStatsForTest(int x, int y, int hp, int attackDamage, std::string name)
 	{
@@ -469,12 +534,8 @@ namespace NecroCore
 		result.summonedEntity.id = 0;
 		return result;
 	}
-	void Game::InitializeMap(const std::string& mapName)
+	bool Game::GetMapLayout(const std::string& mapName, std::vector<std::string>& map, int& spawnX, int& spawnY)
 	{
-		std::vector<std::string> map;
-		int spawnX = 0;
-		int spawnY = 0;
-
 		if (mapName == "test_box")
 		{
 			map = {
@@ -546,11 +607,31 @@ namespace NecroCore
 			spawnY = 15;
 		}
 		else
+		{
+			return false;
+		}
+		return true;
+	}
+	bool Game::IsKnownMap(const std::string& mapName)
+	{
+		std::vector<std::string> map;
+		int spawnX = 0;
+		int spawnY = 0;
+		return GetMapLayout(mapName, map, spawnX, spawnY);
+	}
+	void Game::InitializeMap(const std::string& mapName)
+	{
+		std::vector<std::string> map;
+		int spawnX = 0;
+		int spawnY = 0;
+
+		if (!GetMapLayout(mapName, map, spawnX, spawnY))
 		{
 			std::cerr << "[InitializeMap] Unknown map: " << mapName << "\n";
 			std::exit(EXIT_FAILURE);
 		}
 
+		m_MapName = mapName;
 		m_Map.LoadFromAscii(map);
 		m_Map.spawnX = spawnX;
 		m_Map.spawnY = spawnY;
@@ -565,9 +646,13 @@ namespace NecroCore
 				if (row[static_cast<std::size_t>(x)] == 'o')
 				{
 					SpawnHostileAt(x, y);
+				}
+				else if (row[static_cast<std::size_t>(x)] == 'O')
+				{
+					SpawnEliteHostileAt(x, y);
 				} else if(row[static_cast<std::size_t>(x)] == 't')
 				{
-					StatusEffect randomEffect = (std::rand() % 2 == 0) ? StatusEffect::OnFire : StatusEffect::Poisoned;
+					StatusEffect randomEffect = m_Random.NextBool() ? StatusEffect::OnFire : StatusEffect::Poisoned;
 					SpawnTrapAt(x, y, randomEffect);
 				}
 				else if (row[static_cast<std::size_t>(x)] == 'f')
@@ -609,10 +694,42 @@ namespace NecroCore
 	}
 	CommandResult Game::ApplyTurn(const std::string& command)
 	{
+		return RunTurn(command, TurnBudget::Unlimited());
+	}
+	CommandResult Game::ApplyTurn(const std::string& command, std::chrono::microseconds budget)
+	{
+		return RunTurn(command, TurnBudget::StartingNow(budget));
+	}
+	CommandResult Game::ReplayTurn(const std::string& command, const std::vector<int>& deferredHostiles)
+	{
+		return RunTurn(command, TurnBudget::Replaying(deferredHostiles));
+	}
+	CommandResult Game::RunTurn(const std::string& command, const TurnBudget& budget)
+	{
+		const TurnClock::time_point turnStart = TurnClock::now();
+		TurnClock::time_point systemStart = turnStart;
+		m_LastTurnStats = TurnStats{};
+		m_LastTurnStats.budgeted = budget.IsLimited();
+
+		auto finishSystem = [&](TurnSystem system)
+			{
+				const TurnClock::time_point now = TurnClock::now();
+				m_LastTurnStats.Get(system).elapsed = std::chrono::duration_cast<std::chrono::microseconds>(now - systemStart);
+				m_LastTurnStats.total = std::chrono::duration_cast<std::chrono::microseconds>(now - turnStart);
+				systemStart = now;
+			};
+
+		m_Journal.BeginTurn(*this);
+
 		CommandResult playerResult = ApplyCommand(command);
+		m_LastTurnStats.Get(TurnSystem::Command).processed = 1;
+		finishSystem(TurnSystem::Command);
 
 		if (!playerResult.success)
 		{
+			m_Journal.EndTurn(*this, false);
+			if (m_Recording)
+				m_ReplayLog.AppendTurn(command, ComputeStateHash(), m_LastTurnStats.deferredHostiles);
 			return playerResult;
 		}
 		static SummonsAISystem summonsSystem;
@@ -620,42 +737,219 @@ namespace NecroCore
 		static EnvironmentSystem envSystem;
 
 		summonsSystem.ProcessSummonedTurn(*this, playerResult);
-		hostileSystem.ProcessHostileTurn(*this, playerResult);
+		m_LastTurnStats.Get(TurnSystem::Summons).processed = static_cast<int>(std::count_if(m_Entities.begin(), m_Entities.end(),
+			[](const Entity& e) { return e.faction == Faction::Friendly; }));
+		finishSystem(TurnSystem::Summons);
+
+		hostileSystem.ProcessHostileTurn(*this, playerResult, budget, m_LastTurnStats.Get(TurnSystem::Hostiles), m_LastTurnStats.deferredHostiles);
+		finishSystem(TurnSystem::Hostiles);
+
 		envSystem.ApplyTurn(*this, playerResult);
+		m_LastTurnStats.Get(TurnSystem::Environment).processed = static_cast<int>(m_Entities.size()) + 1;
+		finishSystem(TurnSystem::Environment);
+
+		// Counted in map blocks rather than entities
+		m_LastTurnStats.Get(TurnSystem::Tiles).processed = TileSimulation::Step(m_Map).blocksStepped;
+		finishSystem(TurnSystem::Tiles);
+
+		m_LastTurnStats.overBudget = budget.IsExpired();
+
+		m_Journal.EndTurn(*this, true);
+		if (m_Recording)
+			m_ReplayLog.AppendTurn(command, ComputeStateHash(), m_LastTurnStats.deferredHostiles);
 
 		return playerResult;
 	}
-	static std::string TrapMessageForActor(const Actor& actor, StatusEffect effect)
+	void Game::StartRecording()
+	{
+		m_ReplayLog.Reset(m_PlayerName, m_MapName, m_Random.GetSeed());
+		m_Recording = true;
+	}
+	void Game::ResumeRecording(ReplayLog log)
+	{
+		m_ReplayLog = std::move(log);
+		m_Recording = true;
+	}
+	static std::uint64_t HashActor(std::uint64_t h, const Actor& actor)
+	{
+		h = HashCombine(h, static_cast<std::uint64_t>(actor.id));
+		h = HashCombine(h, (static_cast<std::uint64_t>(static_cast<std::uint32_t>(actor.x)) << 32) | static_cast<std::uint32_t>(actor.y));
+		h = HashCombine(h, (static_cast<std::uint64_t>(static_cast<std::uint32_t>(actor.hp)) << 32) | static_cast<std::uint32_t>(actor.maxHp));
+		h = HashCombine(h, static_cast<std::uint64_t>(actor.attackDamage));
+		h = HashCombine(h, static_cast<std::uint64_t>(actor.status));
+
+		// Folded order-independently, so hashes match those of older replay logs
+		std::uint64_t durations = 0;
+		ForEachStatusIndex(actor.status, [&](std::size_t index)
+			{
+				const std::uint64_t effect = static_cast<StatusMask>(StatusEffectFromIndex(index));
+				durations += HashMix((effect << 32) | static_cast<std::uint32_t>(actor.statusDurations[index]));
+			});
+		return HashCombine(h, durations);
+	}
+	std::uint64_t Game::ComputeStateHash() const
+	{
+		std::uint64_t h = m_Map.ComputeHash(0);
+		h = HashActor(h, m_Player);
+		for (const Entity& entity : m_Entities)
+		{
+			h = HashActor(h, entity);
+			h = HashCombine(h, (static_cast<std::uint64_t>(entity.elite) << 16) | (static_cast<std::uint64_t>(entity.faction) << 8) | static_cast<std::uint64_t>(entity.aiState));
+			h = HashCombine(h, static_cast<std::uint64_t>(entity.aggroRange));
+			h = HashCombine(h, (static_cast<std::uint64_t>(static_cast<std::uint32_t>(entity.guardX)) << 32) | static_cast<std::uint32_t>(entity.guardY));
+		}
+		h = HashCombine(h, static_cast<std::uint64_t>(m_NextEntityId));
+		// Folded only when present (and relative to now), so hashes without pending events are unchanged
+		for (const WorldEvent& event : m_WorldEvents)
+		{
+			h = HashCombine(h, (static_cast<std::uint64_t>(event.kind) << 56) | (static_cast<std::uint64_t>(static_cast<StatusMask>(event.effect)) << 48) | (event.dueTurn - m_Turn));
+			h = HashCombine(h, (static_cast<std::uint64_t>(static_cast<std::uint32_t>(event.x)) << 32) | static_cast<std::uint32_t>(event.y));
+			h = HashCombine(h, (static_cast<std::uint64_t>(static_cast<std::uint32_t>(event.radius)) << 32) | static_cast<std::uint32_t>(event.damage));
+		}
+		for (std::uint64_t word : m_Random.GetState())
+		{
+			h = HashCombine(h, word);
+		}
+		return h;
+	}
+	int Game::Undo(int turns)
+	{
+		int undone = 0;
+		while (undone < turns && m_Journal.UndoLast(*this))
+		{
+			++undone;
+		}
+		if (undone > 0)
+		{
+			m_Activation.Invalidate();
+			m_TimersValid = false;
+		}
+		if (m_Recording && undone > 0)
+			m_ReplayLog.AppendUndo(undone, ComputeStateHash());
+		return undone;
+	}
+	static Message TrapMessageForEffect(StatusEffect effect)
 	{
 		switch (effect)
 		{
 		case StatusEffect::OnFire:
-			return "A hidden fire trap erupts beneath " + actor.name + "!";
+			return Message::TrapFire;
 		case StatusEffect::Poisoned:
-			return "A hidden poison trap is sprung beneath " + actor.name + "!";
+			return Message::TrapPoison;
 		default:
-			return "A hidden trap is triggered beneath " + actor.name + "!";
+			return Message::TrapOther;
 		}
 	}
 
-	std::string Game::HandleTrapOnActor(Actor& actor)
+	bool Game::HandleTrapOnActor(Actor& actor, std::string& out)
 	{
 		const int x = actor.x;
 		const int y = actor.y;
 
 		if (!m_Map.IsTrap(x, y))
-			return {};
+			return false;
 
 		StatusEffect trapEffect = m_Map.GetTileState(x, y);
 
 		if (trapEffect != StatusEffect::Normal)
 		{
 			actor.AddStatus(trapEffect);
+			MarkStatusActive(actor);
 		}
 
 		m_Map.convertTile(x, y, TileType::Floor);
 		m_Map.SetTileState(x, y, StatusEffect::Normal);
+		// A sprung fire trap leaves the floor burning; TileSimulation spreads it from there
+		if (HasStatus(trapEffect, StatusEffect::OnFire))
+		{
+			TileSimulation::Ignite(m_Map, x, y, TileSimulation::TrapFireIntensity);
+		}
+
+		out += '\n';
+		Messages::Append(out, TrapMessageForEffect(trapEffect), { actor.name });
+		return true;
+	}
+	void Game::EnsureTimers()
+	{
+		if (m_TimersValid)
+			return;
+
+		m_Timers.Reset(m_Turn);
+		m_TickScheduled.assign(static_cast<std::size_t>(std::max(m_NextEntityId, 1)), 0);
+		m_TimersValid = true;
+
+		MarkStatusActive(m_Player);
+		for (const Entity& entity : m_Entities)
+		{
+			MarkStatusActive(entity);
+		}
+		for (const WorldEvent& event : m_WorldEvents)
+		{
+			m_Timers.Schedule({ event.dueTurn, TimerKind::WorldEvent, event.id });
+		}
+	}
+	void Game::MarkStatusActive(const Actor& actor)
+	{
+		if (!m_TimersValid || actor.id < 0 || actor.status == StatusEffect::Normal)
+			return;
+
+		const std::size_t slot = static_cast<std::size_t>(actor.id);
+		if (slot >= m_TickScheduled.size())
+		{
+			m_TickScheduled.resize(slot + 1, 0);
+		}
+		if (m_TickScheduled[slot])
+			return;
+		m_TickScheduled[slot] = 1;
+		m_Timers.Schedule({ m_Turn + 1, TimerKind::StatusTick, actor.id });
+	}
+	void Game::AdvanceTimers(std::vector<TimerEvent>& due)
+	{
+		EnsureTimers();
+		++m_Turn;
+		m_Timers.Advance(m_Turn, due);
 
-		return TrapMessageForActor(actor, trapEffect);
+		std::sort(due.begin(), due.end(), [](const TimerEvent& a, const TimerEvent& b)
+			{
+				return a.kind != b.kind ? a.kind < b.kind : a.id < b.id;
+			});
+		for (const TimerEvent& event : due)
+		{
+			if (event.kind == TimerKind::StatusTick)
+			{
+				m_TickScheduled[static_cast<std::size_t>(event.id)] = 0;
+			}
+		}
+	}
+	std::size_t Game::GetPendingTimerCount()
+	{
+		EnsureTimers();
+		return m_Timers.GetCount();
+	}
+	int Game::ScheduleWorldEvent(WorldEvent event, int delayTurns)
+	{
+		m_Journal.NoteWorldEvents(*this);
+
+		event.id = m_NextWorldEventId++;
+		event.dueTurn = m_Turn + static_cast<std::uint64_t>(std::max(delayTurns, 1));
+		m_WorldEvents.push_back(event);
+		if (m_TimersValid)
+		{
+			m_Timers.Schedule({ event.dueTurn, TimerKind::WorldEvent, event.id });
+		}
+		return event.id;
+	}
+	bool Game::TakeWorldEvent(int id, WorldEvent& event)
+	{
+		// Ids are handed out in increasing order, so the list stays sorted by id
+		auto it = std::lower_bound(m_WorldEvents.begin(), m_WorldEvents.end(), id,
+			[](const WorldEvent& e, int value) { return e.id < value; });
+		if (it == m_WorldEvents.end() || it->id != id)
+			return false;
+
+		m_Journal.NoteWorldEvents(*this);
+		event = *it;
+		m_WorldEvents.erase(it);
+		return true;
 	}
 };
\ No newline at end of file
@@ -1,8 +1,10 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <functional>
+#include <cstdint>
 #include "Entity.h"
 #include "Command.h"
 #include "Player.h"
@@ -10,16 +12,33 @@
 #include "MoveResult.h"
 #include "SummonResult.h"
 #include "Map.h"
+#include "Random.h"
+#include "TurnJournal.h"
+#include "ReplayLog.h"
+#include "HostilePlanner.h"
+#include "ActivationSystem.h"
+#include "TurnBudget.h"
+#include "TimingWheel.h"
+#include "WorldEvent.h"
+#include "SpellArea.h"
 
 namespace NecroCore
 {
 	class Game
 	{
 	public:
+		Game(const std::string& playerName, const std::string& mapName, std::uint64_t seed);
 		Game(const std::string& playerName, const std::string& mapName);
 		Game(const std::string& playerName);
 
+		// Cheap speculative copy for lookahead: map layers are shared copy-on-write,
+		// and the fork has no undo journal or replay recording.
+		Game Fork() const;
+
 		const std::string& GetPlayerName() const;
+		const std::string& GetMapName() const { return m_MapName; }
+
+		static bool IsKnownMap(const std::string& mapName);
 
 		std::string GetCurrentDescription() const;
 
@@ -27,15 +46,45 @@ namespace NecroCore
 		PulseResult Pulse(int radius) const;
 
 		CastResult CastSpell(const std::string& element, const std::string& direction);
+		// Line and cone casts start next to the player and run towards `direction`;
+		// radius casts surround the player and ignore it. Single is the plain cast.
+		CastResult CastSpell(const std::string& element, const std::string& direction, AreaShape shape, int size);
 
 		CommandResult ApplyCommand(const std::string& command);
 		CommandResult ParseCommand(const std::string& command);
 		CommandResult ExecuteCommand(const CommandResult& command);
 		CommandResult ApplyTurn(const std::string& command);
+		// Hostile AI that does not fit in `budget` is deferred to the next turn.
+		// Which hostiles that was depends on timing; the turn stats list them.
+		CommandResult ApplyTurn(const std::string& command, std::chrono::microseconds budget);
+		// Repeats a budgeted turn, deferring the hostiles its turn stats listed.
+		CommandResult ReplayTurn(const std::string& command, const std::vector<int>& deferredHostiles);
+		const TurnStats& GetLastTurnStats() const { return m_LastTurnStats; }
+
+		// Rewinds up to `turns` recorded turns and returns how many were undone.
+		int Undo(int turns = 1);
+		const TurnJournal& GetJournal() const { return m_Journal; }
+
+		// Records every ApplyTurn command with the resulting state hash, starting
+		// from the current state. Call on a freshly created game to get a full replay.
+		void StartRecording();
+		void StopRecording() { m_Recording = false; }
+		// Continues a log recorded up to the current state, e.g. after restoring a snapshot.
+		void ResumeRecording(ReplayLog log);
+		bool IsRecording() const { return m_Recording; }
+		const ReplayLog& GetReplayLog() const { return m_ReplayLog; }
+
+		std::uint64_t ComputeStateHash() const;
+
+		PlannerConfig& GetPlannerConfig() { return m_PlannerConfig; }
+		ActivationSystem& GetActivation() { return m_Activation; }
+		const ActivationSystem& GetActivation() const { return m_Activation; }
+		const PlannerConfig& GetPlannerConfig() const { return m_PlannerConfig; }
 
 		void SpawnHostile();
 		void SpawnHostileAt(int x, int y);
 		void SpawnHostileWithStatsForTest(int x, int y, int hp, int attackDamage, std::string name);
+		void SpawnEliteHostileAt(int x, int y);
 		void SpawnFriendly();
 		void SpawnFriendlyAt(int x, int y);
 		void SpawnFriendlyWithStatsForTest(int x, int y, int hp, int attackDamage, std::string name);
@@ -56,24 +105,77 @@ namespace NecroCore
 		Player& GetPlayer() { return m_Player; }
 
 		Entity* GetEntityById(int id);
-		Entity* GetEntityByName(const std::string& name);
+		Entity* GetEntityByName(std::string_view name);
 
 		const Map& GetMap() const { return m_Map; }
 		Map& GetMap() { return m_Map; }
 
+		Random& GetRandom() { return m_Random; }
+		std::uint64_t GetSeed() const { return m_Random.GetSeed(); }
+
 		bool IsTileFree(int x, int y) const;
 
-		std::string HandleTrapOnActor(Actor& actor);
+		// Springs the trap under `actor`, if any, appending a line about it to `out`.
+		bool HandleTrapOnActor(Actor& actor, std::string& out);
+
+		// Environment passes run so far. Timers and world events are due on these turns.
+		std::uint64_t GetTurn() const { return m_Turn; }
+
+		// Runs `event` in the environment pass `delayTurns` passes from now (at
+		// least the next one). Returns the event id.
+		int ScheduleWorldEvent(WorldEvent event, int delayTurns);
+		const std::vector<WorldEvent>& GetWorldEvents() const { return m_WorldEvents; }
+		// Removes a pending world event, handing it to the caller; false if it is gone.
+		bool TakeWorldEvent(int id, WorldEvent& event);
+
+		// Statuses tick from the timing wheel rather than by polling every actor;
+		// call MarkStatusActive after giving an actor a status so its next tick is
+		// scheduled. Scheduling an actor that already has a tick pending is a no-op.
+		void MarkStatusActive(const Actor& actor);
+		// Starts the next environment pass: bumps the turn and collects every timer
+		// due by it, status ticks first (player, then entities by id), then world
+		// events by id.
+		void AdvanceTimers(std::vector<TimerEvent>& due);
+		std::size_t GetPendingTimerCount();
 
 	private:
+		struct ForkTag {};
+		Game(const Game& source, ForkTag);
+
+		friend class GameSnapshot;
+		friend class TurnJournal;
+
 		std::string m_PlayerName;
+		std::string m_MapName;
 		Player m_Player;
 		std::vector<Entity> m_Entities;
 		int m_NextEntityId = 1;
 		
 
 		Map m_Map;
-
+		Random m_Random;
+		TurnJournal m_Journal;
+		ReplayLog m_ReplayLog;
+		bool m_Recording = false;
+		PlannerConfig m_PlannerConfig;
+		// Derived from the entity list; rebuilt lazily, so forks and loads start fresh
+		ActivationSystem m_Activation;
+		TurnStats m_LastTurnStats;
+		std::uint64_t m_Turn = 0;
+		std::vector<WorldEvent> m_WorldEvents;
+		int m_NextWorldEventId = 1;
+		// Derived from actor statuses and m_WorldEvents; rebuilt lazily like m_Activation
+		TimingWheel m_Timers;
+		std::vector<std::uint8_t> m_TickScheduled;
+		bool m_TimersValid = false;
+
+		void EnsureTimers();
+
+		CommandResult RunTurn(const std::string& command, const TurnBudget& budget);
+		// `directionIndex` indexes Map::dirs, or is DirectionArg::Self
+		CastResult CastResolved(const ISpell& spell, int directionIndex, AreaShape shape, int size);
+
+		static bool GetMapLayout(const std::string& mapName, std::vector<std::string>& map, int& spawnX, int& spawnY);
 		void InitializeMap(const std::string& mapName);
 	};
 };
\ No newline at end of file
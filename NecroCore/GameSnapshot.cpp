@@ -0,0 +1,590 @@
+#include "GameSnapshot.h"
+#include "Game.h"
+#include "Map.h"
+#include "Entity.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <type_traits>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace NecroCore
+{
+	static_assert(std::endian::native == std::endian::little,
+		"GameSnapshot records are written in host order and assume a little-endian host");
+
+	namespace
+	{
+		constexpr std::size_t kMaxDurations = 8;
+		constexpr std::uint8_t kEntityFlagElite = 1 << 0;
+
+		struct SnapshotHeader
+		{
+			std::uint32_t magic;
+			std::uint16_t version;
+			std::uint16_t reserved;
+			std::uint32_t totalSize;
+			std::int32_t width;
+			std::int32_t height;
+			std::int32_t spawnX;
+			std::int32_t spawnY;
+			std::int32_t nextEntityId;
+			std::uint32_t entityCount;
+			std::uint32_t playerNameLength;
+			std::uint64_t seed;
+			std::uint64_t rngState[4];
+		};
+
+		struct ActorRecord
+		{
+			std::int32_t id;
+			std::int32_t x;
+			std::int32_t y;
+			std::int32_t hp;
+			std::int32_t maxHp;
+			std::int32_t attackDamage;
+			std::uint8_t status;
+			std::uint8_t durationCount;
+			std::uint16_t reserved;
+			std::uint32_t nameLength;
+			std::uint8_t durationEffects[kMaxDurations];
+			std::int32_t durations[kMaxDurations];
+		};
+
+		// Actor records before version 4, with 16-bit name lengths
+		struct ActorRecordV3
+		{
+			std::int32_t id;
+			std::int32_t x;
+			std::int32_t y;
+			std::int32_t hp;
+			std::int32_t maxHp;
+			std::int32_t attackDamage;
+			std::uint8_t status;
+			std::uint8_t durationCount;
+			std::uint16_t nameLength;
+			std::uint8_t durationEffects[kMaxDurations];
+			std::int32_t durations[kMaxDurations];
+		};
+
+		template <typename ActorLayout>
+		struct BasicEntityRecord
+		{
+			ActorLayout actor;
+			std::uint8_t faction;
+			std::uint8_t aiState;
+			std::uint8_t flags;
+			std::uint8_t reserved;
+			std::int32_t aggroRange;
+			std::int32_t guardX;
+			std::int32_t guardY;
+		};
+
+		using EntityRecord = BasicEntityRecord<ActorRecord>;
+		using EntityRecordV3 = BasicEntityRecord<ActorRecordV3>;
+
+		struct TimerTrailer
+		{
+			std::uint64_t turn;
+			std::int32_t nextWorldEventId;
+			std::uint32_t worldEventCount;
+		};
+
+		struct WorldEventRecord
+		{
+			std::int32_t id;
+			std::uint8_t kind;
+			std::uint8_t effect;
+			std::uint16_t reserved;
+			std::int32_t x;
+			std::int32_t y;
+			std::int32_t radius;
+			std::int32_t damage;
+			std::uint64_t dueTurn;
+		};
+
+		static_assert(std::is_trivially_copyable_v<SnapshotHeader>);
+		static_assert(std::is_trivially_copyable_v<TimerTrailer>);
+		static_assert(std::is_trivially_copyable_v<WorldEventRecord>);
+		static_assert(std::is_trivially_copyable_v<ActorRecord>);
+		static_assert(std::is_trivially_copyable_v<EntityRecord>);
+		static_assert(std::is_trivially_copyable_v<EntityRecordV3>);
+
+		class Writer
+		{
+		public:
+			explicit Writer(std::uint8_t* out) : m_Out(out) {}
+
+			template <typename T>
+			void Put(const T& value)
+			{
+				std::memcpy(m_Out + m_Offset, &value, sizeof(T));
+				m_Offset += sizeof(T);
+			}
+
+			void PutBytes(const void* data, std::size_t size)
+			{
+				if (size > 0)
+					std::memcpy(m_Out + m_Offset, data, size);
+				m_Offset += size;
+			}
+
+			std::uint8_t* Reserve(std::size_t size)
+			{
+				std::uint8_t* at = m_Out + m_Offset;
+				m_Offset += size;
+				return at;
+			}
+
+			std::size_t GetOffset() const { return m_Offset; }
+
+		private:
+			std::uint8_t* m_Out;
+			std::size_t m_Offset = 0;
+		};
+
+		class Reader
+		{
+		public:
+			Reader(const std::uint8_t* data, std::size_t size) : m_Data(data), m_Size(size) {}
+
+			template <typename T>
+			bool Get(T& value)
+			{
+				if (m_Size - m_Offset < sizeof(T))
+					return false;
+				std::memcpy(&value, m_Data + m_Offset, sizeof(T));
+				m_Offset += sizeof(T);
+				return true;
+			}
+
+			const std::uint8_t* Take(std::size_t size)
+			{
+				if (m_Size - m_Offset < size)
+					return nullptr;
+				const std::uint8_t* at = m_Data + m_Offset;
+				m_Offset += size;
+				return at;
+			}
+
+			std::size_t GetOffset() const { return m_Offset; }
+
+			// Reads an actor or entity record in the layout of the image's version
+			bool GetActor(std::uint16_t version, ActorRecord& record)
+			{
+				if (version >= 4)
+					return Get(record);
+				ActorRecordV3 old{};
+				if (!Get(old))
+					return false;
+				record = Widen(old);
+				return true;
+			}
+
+			bool GetEntity(std::uint16_t version, EntityRecord& record)
+			{
+				if (version >= 4)
+					return Get(record);
+				EntityRecordV3 old{};
+				if (!Get(old))
+					return false;
+				record.actor = Widen(old.actor);
+				record.faction = old.faction;
+				record.aiState = old.aiState;
+				record.flags = old.flags;
+				record.aggroRange = old.aggroRange;
+				record.guardX = old.guardX;
+				record.guardY = old.guardY;
+				return true;
+			}
+
+		private:
+			static ActorRecord Widen(const ActorRecordV3& old)
+			{
+				ActorRecord record{};
+				record.id = old.id;
+				record.x = old.x;
+				record.y = old.y;
+				record.hp = old.hp;
+				record.maxHp = old.maxHp;
+				record.attackDamage = old.attackDamage;
+				record.status = old.status;
+				record.durationCount = old.durationCount;
+				record.nameLength = old.nameLength;
+				std::copy(std::begin(old.durationEffects), std::end(old.durationEffects), record.durationEffects);
+				std::copy(std::begin(old.durations), std::end(old.durations), record.durations);
+				return record;
+			}
+
+			const std::uint8_t* m_Data;
+			std::size_t m_Size;
+			std::size_t m_Offset = 0;
+		};
+
+		ActorRecord MakeActorRecord(const Actor& actor)
+		{
+			ActorRecord record{};
+			record.id = actor.id;
+			record.x = actor.x;
+			record.y = actor.y;
+			record.hp = actor.hp;
+			record.maxHp = actor.maxHp;
+			record.attackDamage = actor.attackDamage;
+			record.status = static_cast<std::uint8_t>(actor.status);
+			record.nameLength = static_cast<std::uint32_t>(actor.name.size());
+
+			ForEachStatusIndex(actor.status, [&](std::size_t index)
+				{
+					if (record.durationCount >= kMaxDurations)
+						return;
+					record.durationEffects[record.durationCount] = static_cast<std::uint8_t>(StatusEffectFromIndex(index));
+					record.durations[record.durationCount] = actor.statusDurations[index];
+					++record.durationCount;
+				});
+			return record;
+		}
+
+		void ApplyActorRecord(Actor& actor, const ActorRecord& record, const std::uint8_t* name)
+		{
+			actor.id = record.id;
+			actor.x = record.x;
+			actor.y = record.y;
+			actor.hp = record.hp;
+			actor.maxHp = record.maxHp;
+			actor.attackDamage = record.attackDamage;
+			actor.status = static_cast<StatusEffect>(record.status);
+			actor.name.assign(reinterpret_cast<const char*>(name), record.nameLength);
+
+			actor.statusDurations.fill(0);
+			for (std::uint8_t i = 0; i < record.durationCount; ++i)
+			{
+				const std::size_t index = StatusIndex(static_cast<StatusEffect>(record.durationEffects[i]));
+				if (index < StatusEffectCount)
+					actor.statusDurations[index] = record.durations[i];
+			}
+		}
+
+		static_assert(sizeof(StatusMask) == 1, "Actor records store status masks in one byte; bump Version when widening StatusEffect");
+
+		bool ActorRecordValid(const ActorRecord& record)
+		{
+			return record.durationCount <= kMaxDurations;
+		}
+	}
+
+	std::size_t GameSnapshot::GetSize(const Game& game)
+	{
+		const Map& map = game.m_Map;
+		const std::size_t tileCount = static_cast<std::size_t>(map.m_Width) * map.m_Height;
+
+		std::size_t size = sizeof(SnapshotHeader);
+		size += game.m_PlayerName.size();
+		size += tileCount * 3;
+		size += sizeof(ActorRecord) + game.m_Player.name.size();
+		for (const Entity& entity : game.m_Entities)
+		{
+			size += sizeof(EntityRecord) + entity.name.size();
+		}
+		size += sizeof(TimerTrailer) + game.m_WorldEvents.size() * sizeof(WorldEventRecord);
+		return size;
+	}
+
+	std::size_t GameSnapshot::Write(const Game& game, std::uint8_t* buffer, std::size_t capacity)
+	{
+		const std::size_t totalSize = GetSize(game);
+		if (buffer == nullptr || capacity < totalSize)
+			return 0;
+
+		const Map& map = game.m_Map;
+		const std::size_t tileCount = static_cast<std::size_t>(map.m_Width) * map.m_Height;
+
+		SnapshotHeader header{};
+		header.magic = Magic;
+		header.version = Version;
+		header.totalSize = static_cast<std::uint32_t>(totalSize);
+		header.width = map.m_Width;
+		header.height = map.m_Height;
+		header.spawnX = map.spawnX;
+		header.spawnY = map.spawnY;
+		header.nextEntityId = game.m_NextEntityId;
+		header.entityCount = static_cast<std::uint32_t>(game.m_Entities.size());
+		header.playerNameLength = static_cast<std::uint32_t>(game.m_PlayerName.size());
+		header.seed = game.m_Random.GetSeed();
+		const Random::State& rngState = game.m_Random.GetState();
+		for (std::size_t i = 0; i < rngState.size(); ++i)
+		{
+			header.rngState[i] = rngState[i];
+		}
+
+		Writer writer(buffer);
+		writer.Put(header);
+		writer.PutBytes(game.m_PlayerName.data(), game.m_PlayerName.size());
+
+		std::uint8_t* tiles = writer.Reserve(tileCount);
+		for (std::size_t i = 0; i < tileCount; ++i)
+		{
+			tiles[i] = static_cast<std::uint8_t>((*map.m_Tiles)[i]);
+		}
+		std::uint8_t* states = writer.Reserve(tileCount);
+		for (std::size_t i = 0; i < tileCount; ++i)
+		{
+			states[i] = static_cast<std::uint8_t>((*map.m_TileStates)[i]);
+		}
+		writer.PutBytes(map.m_TileLevels->data(), tileCount);
+
+		writer.Put(MakeActorRecord(game.m_Player));
+		writer.PutBytes(game.m_Player.name.data(), game.m_Player.name.size());
+
+		for (const Entity& entity : game.m_Entities)
+		{
+			EntityRecord record{};
+			record.actor = MakeActorRecord(entity);
+			record.faction = static_cast<std::uint8_t>(entity.faction);
+			record.aiState = static_cast<std::uint8_t>(entity.aiState);
+			record.flags = entity.elite ? kEntityFlagElite : 0;
+			record.aggroRange = entity.aggroRange;
+			record.guardX = entity.guardX;
+			record.guardY = entity.guardY;
+
+			writer.Put(record);
+			writer.PutBytes(entity.name.data(), entity.name.size());
+		}
+
+		TimerTrailer trailer{};
+		trailer.turn = game.m_Turn;
+		trailer.nextWorldEventId = game.m_NextWorldEventId;
+		trailer.worldEventCount = static_cast<std::uint32_t>(game.m_WorldEvents.size());
+		writer.Put(trailer);
+		for (const WorldEvent& event : game.m_WorldEvents)
+		{
+			WorldEventRecord record{};
+			record.id = event.id;
+			record.kind = static_cast<std::uint8_t>(event.kind);
+			record.effect = static_cast<std::uint8_t>(event.effect);
+			record.x = event.x;
+			record.y = event.y;
+			record.radius = event.radius;
+			record.damage = event.damage;
+			record.dueTurn = event.dueTurn;
+			writer.Put(record);
+		}
+
+		return writer.GetOffset();
+	}
+
+	std::vector<std::uint8_t> GameSnapshot::Save(const Game& game)
+	{
+		std::vector<std::uint8_t> buffer(GetSize(game));
+		Write(game, buffer.data(), buffer.size());
+		return buffer;
+	}
+
+	bool GameSnapshot::Load(Game& game, const std::uint8_t* data, std::size_t size)
+	{
+		if (data == nullptr)
+			return false;
+
+		// First pass: validate every length against the buffer before mutating the game
+		Reader reader(data, size);
+		SnapshotHeader header{};
+		if (!reader.Get(header))
+			return false;
+		if (header.magic != Magic || header.version < 1 || header.version > Version)
+			return false;
+		if (header.totalSize > size || header.width < 0 || header.height < 0)
+			return false;
+
+		const std::size_t tileCount = static_cast<std::size_t>(header.width) * static_cast<std::size_t>(header.height);
+		const std::uint8_t* playerName = reader.Take(header.playerNameLength);
+		const std::uint8_t* tiles = reader.Take(tileCount);
+		const std::uint8_t* states = reader.Take(tileCount);
+		const std::uint8_t* levels = header.version >= 2 ? reader.Take(tileCount) : nullptr;
+		if (!playerName || !tiles || !states || (header.version >= 2 && !levels))
+			return false;
+
+		ActorRecord playerRecord{};
+		if (!reader.GetActor(header.version, playerRecord) || !ActorRecordValid(playerRecord))
+			return false;
+		const std::uint8_t* playerActorName = reader.Take(playerRecord.nameLength);
+		if (!playerActorName)
+			return false;
+
+		const std::size_t entitiesOffset = reader.GetOffset();
+		for (std::uint32_t i = 0; i < header.entityCount; ++i)
+		{
+			EntityRecord record{};
+			if (!reader.GetEntity(header.version, record) || !ActorRecordValid(record.actor))
+				return false;
+			if (!reader.Take(record.actor.nameLength))
+				return false;
+		}
+
+		TimerTrailer trailer{};
+		const std::size_t worldEventsOffset = reader.GetOffset() + sizeof(TimerTrailer);
+		if (header.version >= 3)
+		{
+			if (!reader.Get(trailer))
+				return false;
+			if (!reader.Take(static_cast<std::size_t>(trailer.worldEventCount) * sizeof(WorldEventRecord)))
+				return false;
+		}
+		if (reader.GetOffset() != header.totalSize)
+			return false;
+
+		// Second pass: apply
+		Map& map = game.m_Map;
+		map.m_Width = header.width;
+		map.m_Height = header.height;
+		map.spawnX = header.spawnX;
+		map.spawnY = header.spawnY;
+		auto mapTiles = std::make_shared<std::vector<TileType>>(tileCount);
+		auto mapStates = std::make_shared<std::vector<StatusEffect>>(tileCount);
+		for (std::size_t i = 0; i < tileCount; ++i)
+		{
+			(*mapTiles)[i] = static_cast<TileType>(tiles[i]);
+			(*mapStates)[i] = static_cast<StatusEffect>(states[i]);
+		}
+		map.m_Tiles = std::move(mapTiles);
+		map.m_TileStates = std::move(mapStates);
+		map.m_TileLevels = levels
+			? std::make_shared<std::vector<std::uint8_t>>(levels, levels + tileCount)
+			: std::make_shared<std::vector<std::uint8_t>>(tileCount, std::uint8_t{ 0 });
+		map.MarkAllBlocksDirty();
+
+		game.m_PlayerName.assign(reinterpret_cast<const char*>(playerName), header.playerNameLength);
+		ApplyActorRecord(game.m_Player, playerRecord, playerActorName);
+
+		game.m_NextEntityId = header.nextEntityId;
+
+		Random::State rngState{};
+		for (std::size_t i = 0; i < rngState.size(); ++i)
+		{
+			rngState[i] = header.rngState[i];
+		}
+		game.m_Random.Seed(header.seed);
+		game.m_Random.SetState(rngState);
+
+		game.m_Journal.Clear();
+		game.m_Activation.Invalidate();
+		game.m_TimersValid = false;
+
+		Reader entityReader(data + entitiesOffset, header.totalSize - entitiesOffset);
+		game.m_Entities.resize(header.entityCount);
+		for (Entity& entity : game.m_Entities)
+		{
+			EntityRecord record{};
+			entityReader.GetEntity(header.version, record);
+			const std::uint8_t* name = entityReader.Take(record.actor.nameLength);
+
+			ApplyActorRecord(entity, record.actor, name);
+			entity.faction = static_cast<Faction>(record.faction);
+			entity.aiState = static_cast<EntityState>(record.aiState);
+			entity.elite = (record.flags & kEntityFlagElite) != 0;
+			entity.aggroRange = record.aggroRange;
+			entity.guardX = record.guardX;
+			entity.guardY = record.guardY;
+		}
+
+		game.m_Turn = trailer.turn;
+		game.m_NextWorldEventId = header.version >= 3 ? trailer.nextWorldEventId : 1;
+		game.m_WorldEvents.resize(trailer.worldEventCount);
+		Reader eventReader(data + worldEventsOffset, header.totalSize - std::min<std::size_t>(worldEventsOffset, header.totalSize));
+		for (WorldEvent& event : game.m_WorldEvents)
+		{
+			WorldEventRecord record{};
+			eventReader.Get(record);
+			event.id = record.id;
+			event.kind = static_cast<WorldEventKind>(record.kind);
+			event.effect = static_cast<StatusEffect>(record.effect);
+			event.x = record.x;
+			event.y = record.y;
+			event.radius = record.radius;
+			event.damage = record.damage;
+			event.dueTurn = record.dueTurn;
+		}
+
+		return true;
+	}
+
+	bool GameSnapshot::SaveToFile(const Game& game, const std::string& path)
+	{
+		const std::vector<std::uint8_t> buffer = Save(game);
+
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		if (!out)
+		{
+			std::cerr << "[GameSnapshot] Cannot open " << path << " for writing\n";
+			return false;
+		}
+		out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+		return static_cast<bool>(out);
+	}
+
+	bool GameSnapshot::LoadFromFile(Game& game, const std::string& path)
+	{
+#ifdef _WIN32
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER fileSize{};
+		if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping == nullptr)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		bool loaded = false;
+		if (view != nullptr)
+		{
+			loaded = Load(game, static_cast<const std::uint8_t*>(view), static_cast<std::size_t>(fileSize.QuadPart));
+			UnmapViewOfFile(view);
+		}
+		CloseHandle(mapping);
+		CloseHandle(file);
+		return loaded;
+#else
+		const int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd < 0)
+			return false;
+
+		struct stat info{};
+		if (::fstat(fd, &info) != 0 || info.st_size <= 0)
+		{
+			::close(fd);
+			return false;
+		}
+
+		const std::size_t size = static_cast<std::size_t>(info.st_size);
+		void* view = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		::close(fd);
+		if (view == MAP_FAILED)
+			return false;
+
+		const bool loaded = Load(game, static_cast<const std::uint8_t*>(view), size);
+		::munmap(view, size);
+		return loaded;
+#endif
+	}
+}
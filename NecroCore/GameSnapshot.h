@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace NecroCore
+{
+	class Game;
+
+	// Versioned binary image of a Game: map tiles, states and levels, player, entities
+	// (with status durations), the next entity id, the random generator state, and
+	// the turn counter with pending world events.
+	// Records are fixed-width little-endian and read with memcpy, so a snapshot
+	// can be restored straight out of a memory-mapped file.
+	class GameSnapshot
+	{
+	public:
+		static constexpr std::uint32_t Magic = 0x4E534E42; // "BNSN"
+		// Version 2 added the tile level layer; version 1 images load with all levels at 0.
+		// Version 3 added the turn counter and world events; older images load with neither.
+		// Version 4 widened actor name lengths to 32 bits.
+		static constexpr std::uint16_t Version = 4;
+
+		static std::size_t GetSize(const Game& game);
+
+		// Returns the number of bytes written, or 0 if capacity is too small.
+		static std::size_t Write(const Game& game, std::uint8_t* buffer, std::size_t capacity);
+		static std::vector<std::uint8_t> Save(const Game& game);
+
+		// Validates the whole image before touching the game; on failure the game is left unchanged.
+		static bool Load(Game& game, const std::uint8_t* data, std::size_t size);
+
+		static bool SaveToFile(const Game& game, const std::string& path);
+		static bool LoadFromFile(Game& game, const std::string& path);
+	};
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace NecroCore
+{
+	// Small non-cryptographic hashing helpers used for per-turn state hashes.
+
+	inline std::uint64_t HashMix(std::uint64_t value)
+	{
+		value ^= value >> 30;
+		value *= 0xBF58476D1CE4E5B9ull;
+		value ^= value >> 27;
+		value *= 0x94D049BB133111EBull;
+		value ^= value >> 31;
+		return value;
+	}
+
+	inline std::uint64_t HashCombine(std::uint64_t seed, std::uint64_t value)
+	{
+		return HashMix(seed ^ (value + 0x9E3779B97F4A7C15ull + (seed << 6) + (seed >> 2)));
+	}
+
+	inline std::uint64_t HashBytes(std::uint64_t seed, const void* data, std::size_t size)
+	{
+		const auto* bytes = static_cast<const unsigned char*>(data);
+		std::uint64_t h = HashCombine(seed, size);
+
+		while (size >= 8)
+		{
+			std::uint64_t word;
+			std::memcpy(&word, bytes, 8);
+			h = HashCombine(h, word);
+			bytes += 8;
+			size -= 8;
+		}
+
+		if (size > 0)
+		{
+			std::uint64_t tail = 0;
+			std::memcpy(&tail, bytes, size);
+			h = HashCombine(h, tail);
+		}
+		return h;
+	}
+}
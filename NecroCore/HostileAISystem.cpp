@@ -2,8 +2,14 @@
 #include "Game.h"
 #include "Entity.h"
 #include "Pathfinding.h"
+#include "HostilePlanner.h"
+#include "ActivationSystem.h"
+#include "Log.h"
+#include "Messages.h"
 
-#include <sstream>
+#include <vector>
+#include <utility>
+#include <algorithm>
 #include <limits>
 #include <cmath>
 #include <iostream>
@@ -12,21 +18,17 @@ namespace NecroCore
 {
 	void HostileAISystem::ProcessHostileTurn(Game& game, CommandResult& result)
 	{
-		std::ostringstream oss;
-		oss << result.description;
-
-		bool firstAppend = true;
+		SystemTiming timing;
+		std::vector<int> deferred;
+		ProcessHostileTurn(game, result, TurnBudget::Unlimited(), timing, deferred);
+	}
+	void HostileAISystem::ProcessHostileTurn(Game& game, CommandResult& result, const TurnBudget& budget, SystemTiming& timing, std::vector<int>& deferred)
+	{
+		// Messages render straight onto the turn's description
+		std::string& out = result.description;
 		auto appendSeparator = [&]()
 			{
-				if (firstAppend)
-				{
-					oss << "\n";
-					firstAppend = false;
-				}
-				else
-				{
-					oss << "\n";
-				}
+				out += '\n';
 			};
 
 		auto& m_Entities = game.GetEntities();
@@ -35,19 +37,81 @@ namespace NecroCore
 
 		bool anyHostileActed = false;
 		bool playerDiedThisTurn = false;
-		std::cout << "[ProcessHostileTurn] Processing " << m_Entities.size() << " entities.\n";
-		for (Entity& entity : m_Entities)
+
+		ActivationSystem& activation = game.GetActivation();
+		activation.BeginHostileTurn(game);
+
+		NECRO_TRACE("[ProcessHostileTurn] Processing " << activation.GetActiveCount() << " of " << m_Entities.size() << " entities.\n");
+
+		// Scratch schedule reused across turns; systems are shared between games on one thread
+		thread_local std::vector<Entity*> schedule;
+		schedule.clear();
+
+		// Active ids ascend like the entity list, so one forward search finds them all
+		auto cursor = m_Entities.begin();
+		for (int id : activation.GetActiveHostiles())
 		{
-			if (entity.faction != Faction::Hostile)
+			cursor = std::lower_bound(cursor, m_Entities.end(), id,
+				[](const Entity& e, int value) { return e.id < value; });
+			if (cursor == m_Entities.end())
+			{
+				break;
+			}
+			if (cursor->id != id || cursor->faction != Faction::Hostile)
+			{
+				continue;
+			}
+			schedule.push_back(&*cursor);
+		}
+
+		// Hostiles always act in id order, so a turn that defers nothing matches an unbudgeted one.
+		// Priority only picks who is deferred: the last stretch of the budget is kept for urgent
+		// hostiles, those next to the player or far ones that waited long enough, since each
+		// deferred turn counts as a few tiles closer.
+		auto isUrgent = [&](const Entity& entity)
+			{
+				const int priority = std::abs(entity.x - m_Player.x) + std::abs(entity.y - m_Player.y) -
+					HostileAISystem::DeferralAging * activation.GetDeferredTurns(entity.id);
+				return priority <= HostileAISystem::UrgentPriority;
+			};
+
+		for (Entity* scheduled : schedule)
+		{
+			Entity& entity = *scheduled;
+			const int id = entity.id;
+
+			if (budget.IsReplayDeferred(id) || budget.IsExpired() || (budget.IsNearlyExpired() && !isUrgent(entity)))
 			{
+				activation.ReportDeferred(id);
+				deferred.push_back(id);
+				++timing.deferred;
 				continue;
 			}
+			++timing.processed;
 
 			switch (entity.aiState)
 			{
 			case EntityState::Attack:
 			{
-				HandleHostileAttackAI(game, entity, oss, anyHostileActed, playerDiedThisTurn, appendSeparator);
+				bool acted = false;
+				if (entity.elite)
+				{
+					bool outOfTime = false;
+					acted = HandleEliteHostileAI(game, entity, budget, out, anyHostileActed, playerDiedThisTurn, appendSeparator, outOfTime);
+					if (outOfTime)
+					{
+						--timing.processed;
+						activation.ReportDeferred(id);
+						deferred.push_back(id);
+						++timing.deferred;
+						break;
+					}
+				}
+				else
+				{
+					acted = HandleHostileAttackAI(game, entity, out, anyHostileActed, playerDiedThisTurn, appendSeparator);
+				}
+				activation.ReportActivity(id, acted);
 				break;
 			}
 			case EntityState::FollowPlayer:
@@ -77,19 +141,19 @@ namespace NecroCore
 			m_Entities.end()
 		);
 
+		activation.EndHostileTurn(game);
+
 		// TODO - Random death message variations
 		if (playerDiedThisTurn)
 		{
 			appendSeparator();
-			oss << "You collapse as the last of your strength drains away.";
+			Messages::Append(out, Message::PlayerCollapses);
 			result.gameOver = true;
 		}
 
-		std::cout << "[ProcessHostileTurn] Final description: " << oss.str() << "\n";
-
-		result.description = oss.str();
+		NECRO_TRACE("[ProcessHostileTurn] Final description: " << out << "\n");
 	}
-	bool HostileAISystem::HandleHostileAttackAI(Game& game, Entity& entity, std::ostringstream& oss, bool& anyHostileActed, bool& playerDiedThisTurn, const std::function<void()>& appendSeparator)
+	bool HostileAISystem::HandleHostileAttackAI(Game& game, Entity& entity, std::string& out, bool& anyHostileActed, bool& playerDiedThisTurn, const std::function<void()>& appendSeparator)
 	{
 		auto& m_Entities = game.GetEntities();
 		Player& m_Player = game.GetPlayer();
@@ -97,21 +161,24 @@ namespace NecroCore
 
 
 		const int distanceToPlayer = std::abs(entity.x - m_Player.x) + std::abs(entity.y - m_Player.y);
-		const int distanceToClosestSummoned = [&]() {
-			int bestDistance = std::numeric_limits<int>::max();
-			for (const Entity& other : m_Entities)
+
+		// Live summons were gathered once for the whole hostile pass
+		int distanceToClosestSummoned = std::numeric_limits<int>::max();
+		Entity* closestSummoned = nullptr;
+		for (const ActivationSystem::Target& target : game.GetActivation().GetTargets())
+		{
+			if (target.entityIndex < 0)
+				continue;
+			Entity& other = m_Entities[static_cast<std::size_t>(target.entityIndex)];
+			if (other.hp <= 0)
+				continue;
+			const int dist = std::abs(other.x - entity.x) + std::abs(other.y - entity.y);
+			if (dist < distanceToClosestSummoned)
 			{
-				if (other.faction != Faction::Friendly || other.hp <= 0)
-					continue;
-				const int dist = std::abs(other.x - entity.x) + std::abs(other.y - entity.y);
-				if (dist < bestDistance)
-				{
-					bestDistance = dist;
-				}
+				distanceToClosestSummoned = dist;
+				closestSummoned = &other;
 			}
-
-			return bestDistance;
-			}();
+		}
 		int targetX = m_Player.x;
 		int targetY = m_Player.y;
 		Entity* targetEntity = nullptr;
@@ -123,24 +190,9 @@ namespace NecroCore
 
 		if (distanceToClosestSummoned < distanceToPlayer)
 		{
-			int bestDistance = std::numeric_limits<int>::max();
-			for (Entity& other : m_Entities)
-			{
-				if (other.faction != Faction::Friendly || other.hp <= 0)
-					continue;
-				const int dist = std::abs(other.x - entity.x) + std::abs(other.y - entity.y);
-				if (dist < bestDistance)
-				{
-					bestDistance = dist;
-					targetEntity = &other;
-				}
-			}
-
-			if (targetEntity)
-			{
-				targetX = targetEntity->x;
-				targetY = targetEntity->y;
-			}
+			targetEntity = closestSummoned;
+			targetX = targetEntity->x;
+			targetY = targetEntity->y;
 		}
 
 		const bool adjacentToPlayer = Entity::IsAdjacent(entity.x, entity.y, m_Player.x, m_Player.y);
@@ -152,14 +204,8 @@ namespace NecroCore
 			anyHostileActed = true;
 
 			targetEntity->ApplyDamage(entity.attackDamage);
-			if (!targetEntity->IsAlive()) {
-				appendSeparator();
-				oss << "A hostile slays your summoned ally (" << targetEntity->name << ").";
-			}
-			else {
-				appendSeparator();
-				oss << "A hostile lashes out at your summoned ally (" << targetEntity->name << ").";
-			}
+			appendSeparator();
+			Messages::Append(out, targetEntity->IsAlive() ? Message::HostileHitsAlly : Message::HostileSlaysAlly, { targetEntity->name });
 			return true;
 		}
 		else if (adjacentToPlayer && !playerDiedThisTurn)
@@ -172,16 +218,14 @@ namespace NecroCore
 				if (!m_Player.IsAlive()) playerDiedThisTurn = true;
 			}
 
-			std::string direction;
-
-			const char* dirName = Map::DirectionNameFromPoints(m_Player.x, m_Player.y, entity.x, entity.y);
-			if (dirName)
+			MessageArgs args;
+			if (const char* dirName = Map::DirectionNameFromPoints(m_Player.x, m_Player.y, entity.x, entity.y))
 			{
-				direction = dirName;
+				args.direction = dirName;
 			}
 
 			appendSeparator();
-			oss << "A hostile claws at you from the " << direction << ".";
+			Messages::Append(out, Message::HostileClaws, args);
 			return true;
 		}
 		int dx = 0, dy = 0;
@@ -198,27 +242,115 @@ namespace NecroCore
 
 		if (m_Map.IsWalkable(targetMoveX, targetMoveY) && game.IsTileFree(targetMoveX, targetMoveY) && !playerDiedThisTurn)
 		{
-			appendSeparator();
-			oss << "A hostile shuffles closer from the ";
-			std::string direction;
-			const char* dirName = Map::DirectionNameFromPoints(m_Player.x, m_Player.y, entity.x, entity.y);
-			if (dirName)
+			MessageArgs args;
+			if (const char* dirName = Map::DirectionNameFromPoints(m_Player.x, m_Player.y, entity.x, entity.y))
 			{
-				oss << dirName;
+				args.direction = dirName;
 			}
-			oss << ".";
+			appendSeparator();
+			Messages::Append(out, Message::HostileShuffles, args);
 
 			entity.x = targetMoveX;
 			entity.y = targetMoveY;
 			anyHostileActed = true;
-			const std::string trapMsg = game.HandleTrapOnActor(entity);
-			if (!trapMsg.empty())
+			game.HandleTrapOnActor(entity, out);
+
+			return true;
+		}
+		return false;
+	}
+	bool HostileAISystem::HandleEliteHostileAI(Game& game, Entity& entity, const TurnBudget& budget, std::string& out, bool& anyHostileActed, bool& playerDiedThisTurn, const std::function<void()>& appendSeparator, bool& outOfTime)
+	{
+		auto& m_Entities = game.GetEntities();
+		Player& m_Player = game.GetPlayer();
+		Map& m_Map = game.GetMap();
+
+		if (playerDiedThisTurn)
+			return false;
+
+		// Elites stay dormant until something is in reach, like regular hostiles,
+		// so the planner only runs for the ones that matter this turn.
+		bool anyTargetInRange = m_Player.IsAlive() &&
+			std::abs(entity.x - m_Player.x) + std::abs(entity.y - m_Player.y) <= entity.aggroRange;
+		for (const ActivationSystem::Target& target : game.GetActivation().GetTargets())
+		{
+			if (anyTargetInRange)
+				break;
+			if (target.entityIndex >= 0 && m_Entities[static_cast<std::size_t>(target.entityIndex)].hp > 0 &&
+				std::abs(target.x - entity.x) + std::abs(target.y - entity.y) <= entity.aggroRange)
 			{
-				oss << "\n" << trapMsg;
+				anyTargetInRange = true;
 			}
+		}
+		if (!anyTargetInRange)
+			return false;
+
+		// Unbudgeted turns and replays always finish the search, so they are
+		// deterministic. Under a budget the search never outlives it, and one cut
+		// short defers the elite instead of acting on a partial tree.
+		PlannerConfig config = game.GetPlannerConfig();
+		config.timeBudget = budget.IsLimited() ? std::min(config.timeBudget, budget.GetRemaining()) : std::chrono::microseconds::max();
 
+		// The seed is only taken from the game once the plan is used, so a deferral
+		// leaves the random stream as a replay that skips this elite would
+		Random peek = game.GetRandom();
+		const PlannedAction plan = HostilePlanner::Plan(game, entity, config, peek.NextU64());
+		if (!plan.complete)
+		{
+			outOfTime = true;
+			return false;
+		}
+		game.GetRandom().NextU64();
+		if (plan.dx == 0 && plan.dy == 0)
+			return false;
+
+		const int targetX = entity.x + plan.dx;
+		const int targetY = entity.y + plan.dy;
+
+		if (m_Player.IsAlive() && m_Player.x == targetX && m_Player.y == targetY)
+		{
+			anyHostileActed = true;
+			m_Player.ApplyDamage(entity.attackDamage);
+			if (!m_Player.IsAlive()) playerDiedThisTurn = true;
+
+			MessageArgs args;
+			if (const char* dirName = Map::DirectionNameFromPoints(m_Player.x, m_Player.y, entity.x, entity.y))
+			{
+				args.direction = dirName;
+			}
+			appendSeparator();
+			Messages::Append(out, Message::HostileClaws, args);
 			return true;
 		}
-		return false;
+
+		for (Entity& other : m_Entities)
+		{
+			if (other.faction != Faction::Friendly || other.hp <= 0 || other.x != targetX || other.y != targetY)
+				continue;
+
+			anyHostileActed = true;
+			other.ApplyDamage(entity.attackDamage);
+			appendSeparator();
+			Messages::Append(out, other.IsAlive() ? Message::HostileHitsAlly : Message::HostileSlaysAlly, { other.name });
+			return true;
+		}
+
+		if (!m_Map.IsWalkable(targetX, targetY) || !game.IsTileFree(targetX, targetY))
+			return false;
+
+		entity.x = targetX;
+		entity.y = targetY;
+		anyHostileActed = true;
+
+		MessageArgs args;
+		if (const char* dirName = Map::DirectionNameFromPoints(m_Player.x, m_Player.y, entity.x, entity.y))
+		{
+			args.direction = dirName;
+		}
+		appendSeparator();
+		Messages::Append(out, Message::HostileShuffles, args);
+
+		game.HandleTrapOnActor(entity, out);
+		return true;
 	}
 }
\ No newline at end of file
@@ -1,9 +1,11 @@
 #pragma once
 
 #include "Entity.h"
+#include "TurnBudget.h"
 
-#include <ostream>
+#include <string>
 #include <functional>
+#include <vector>
 
 namespace NecroCore
 {
@@ -13,14 +15,30 @@ namespace NecroCore
 	class HostileAISystem
 	{
 	public:
+		// Tiles of distance a deferred hostile gains in priority for each turn it waited
+		static constexpr int DeferralAging = 4;
+		// Hostiles at or under this priority may use the reserved end of the budget
+		static constexpr int UrgentPriority = 1;
+
 		void ProcessHostileTurn(Game& game, CommandResult& result);
+		// Stops updating hostiles once the budget expires; the rest wait for the next turn.
+		void ProcessHostileTurn(Game& game, CommandResult& result, const TurnBudget& budget, SystemTiming& timing, std::vector<int>& deferred);
 
 	private:
 		bool HandleHostileAttackAI(Game& game,
 			Entity& entity,
-			std::ostringstream& oss,
+			std::string& out,
 			bool& anyHostileActed,
 			bool& playerDiedThisTurn,
 			const std::function<void()>& appendSeparator);
+
+		bool HandleEliteHostileAI(Game& game,
+			Entity& entity,
+			const TurnBudget& budget,
+			std::string& out,
+			bool& anyHostileActed,
+			bool& playerDiedThisTurn,
+			const std::function<void()>& appendSeparator,
+			bool& outOfTime);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,696 @@
+#include "HostilePlanner.h"
+#include "Game.h"
+#include "Entity.h"
+#include "Map.h"
+#include "Random.h"
+#include "Status.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace NecroCore
+{
+	namespace
+	{
+		constexpr int kMaxSimActors = 32;
+		constexpr int kMaxConsumedTraps = 16;
+		constexpr int kActionCount = 9; // Map::dirs plus standing still
+		constexpr int kStayAction = 8;
+		constexpr int kMaxNodes = 1 << 14;
+		constexpr int kMaxDepth = 16;
+		constexpr float kExploration = 1.4f;
+
+		enum class SimSide : std::uint8_t
+		{
+			Player,
+			Summon,
+			Hostile
+		};
+
+		struct SimActor
+		{
+			std::int16_t x;
+			std::int16_t y;
+			std::int16_t hp;
+			std::int16_t attack;
+			std::int16_t aggro;
+			SimSide side;
+			std::uint8_t fireTurns;
+			std::uint8_t poisonTurns;
+		};
+
+		// Plain data so a rollout starts from a memcpy of the root.
+		struct SimState
+		{
+			std::array<SimActor, kMaxSimActors> actors;
+			std::array<std::int32_t, kMaxConsumedTraps> consumedTraps;
+			int count;
+			int elite;
+			int consumedCount;
+			int damageToPlayer;
+			int damageToSummons;
+			int summonsKilled;
+			int eliteDamageTaken;
+			bool playerDead;
+			bool eliteDead;
+		};
+
+		struct SimContext
+		{
+			const Map* map;
+			int fireDamage;
+			int fireDuration;
+			int poisonDamage;
+			int poisonDuration;
+		};
+
+		struct Node
+		{
+			float totalReward;
+			int visits;
+			std::array<std::int32_t, kActionCount> children;
+		};
+
+		struct ThreadResult
+		{
+			std::array<int, kActionCount> visits{};
+			std::array<float, kActionCount> reward{};
+			int iterations = 0;
+		};
+
+		int Sign(int v)
+		{
+			return (v > 0) - (v < 0);
+		}
+
+		int Manhattan(const SimActor& a, const SimActor& b)
+		{
+			return std::abs(a.x - b.x) + std::abs(a.y - b.y);
+		}
+
+		bool Alive(const SimActor& a)
+		{
+			return a.hp > 0;
+		}
+
+		bool IsTrapActive(const SimContext& ctx, const SimState& s, int x, int y)
+		{
+			if (!ctx.map->IsTrap(x, y))
+				return false;
+			const std::int32_t index = y * ctx.map->GetWidth() + x;
+			for (int i = 0; i < s.consumedCount; ++i)
+			{
+				if (s.consumedTraps[static_cast<std::size_t>(i)] == index)
+					return false;
+			}
+			return true;
+		}
+
+		bool IsHazard(const SimContext& ctx, const SimState& s, int x, int y)
+		{
+			return IsTrapActive(ctx, s, x, y) || HasStatus(ctx.map->GetTileState(x, y), StatusEffect::OnFire);
+		}
+
+		int OccupantAt(const SimState& s, int x, int y)
+		{
+			for (int i = 0; i < s.count; ++i)
+			{
+				const SimActor& a = s.actors[static_cast<std::size_t>(i)];
+				if (Alive(a) && a.x == x && a.y == y)
+					return i;
+			}
+			return -1;
+		}
+
+		void Damage(SimState& s, int target, int amount)
+		{
+			SimActor& t = s.actors[static_cast<std::size_t>(target)];
+			if (!Alive(t) || amount <= 0)
+				return;
+			const int dealt = std::min<int>(amount, t.hp);
+			t.hp = static_cast<std::int16_t>(t.hp - dealt);
+
+			if (target == s.elite)
+			{
+				s.eliteDamageTaken += dealt;
+				s.eliteDead = !Alive(t);
+			}
+			else if (t.side == SimSide::Player)
+			{
+				s.damageToPlayer += dealt;
+				s.playerDead = !Alive(t);
+			}
+			else if (t.side == SimSide::Summon)
+			{
+				s.damageToSummons += dealt;
+				if (!Alive(t))
+					++s.summonsKilled;
+			}
+		}
+
+		void EnterTile(const SimContext& ctx, SimState& s, int index)
+		{
+			SimActor& a = s.actors[static_cast<std::size_t>(index)];
+			if (!IsTrapActive(ctx, s, a.x, a.y))
+				return;
+
+			const StatusEffect trap = ctx.map->GetTileState(a.x, a.y);
+			if (HasStatus(trap, StatusEffect::OnFire))
+				a.fireTurns = static_cast<std::uint8_t>(ctx.fireDuration);
+			if (HasStatus(trap, StatusEffect::Poisoned))
+				a.poisonTurns = static_cast<std::uint8_t>(ctx.poisonDuration);
+
+			if (s.consumedCount < kMaxConsumedTraps)
+			{
+				s.consumedTraps[static_cast<std::size_t>(s.consumedCount++)] = a.y * ctx.map->GetWidth() + a.x;
+			}
+		}
+
+		bool TryMove(const SimContext& ctx, SimState& s, int index, int dx, int dy)
+		{
+			if (dx == 0 && dy == 0)
+				return false;
+			SimActor& a = s.actors[static_cast<std::size_t>(index)];
+			const int nx = a.x + dx;
+			const int ny = a.y + dy;
+			if (!ctx.map->IsWalkable(nx, ny) || OccupantAt(s, nx, ny) >= 0)
+				return false;
+			a.x = static_cast<std::int16_t>(nx);
+			a.y = static_cast<std::int16_t>(ny);
+			EnterTile(ctx, s, index);
+			return true;
+		}
+
+		void StepTowards(const SimContext& ctx, SimState& s, int index, int tx, int ty)
+		{
+			const SimActor& a = s.actors[static_cast<std::size_t>(index)];
+			const int dx = Sign(tx - a.x);
+			const int dy = Sign(ty - a.y);
+			if (TryMove(ctx, s, index, dx, dy))
+				return;
+			if (dx != 0 && TryMove(ctx, s, index, dx, 0))
+				return;
+			if (dy != 0)
+				TryMove(ctx, s, index, 0, dy);
+		}
+
+		// Nearest living actor on the opposing side within aggro range, or -1.
+		int NearestTarget(const SimState& s, int index)
+		{
+			const SimActor& a = s.actors[static_cast<std::size_t>(index)];
+			int best = -1;
+			int bestDistance = a.aggro + 1;
+			for (int i = 0; i < s.count; ++i)
+			{
+				const SimActor& o = s.actors[static_cast<std::size_t>(i)];
+				if (!Alive(o) || i == index)
+					continue;
+				const bool opposing = (a.side == SimSide::Hostile) != (o.side == SimSide::Hostile);
+				if (!opposing)
+					continue;
+				const int d = Manhattan(a, o);
+				if (d < bestDistance)
+				{
+					bestDistance = d;
+					best = i;
+				}
+			}
+			return best;
+		}
+
+		void ChaseOrStrike(const SimContext& ctx, SimState& s, int index)
+		{
+			const int target = NearestTarget(s, index);
+			if (target < 0)
+				return;
+			const SimActor& a = s.actors[static_cast<std::size_t>(index)];
+			const SimActor& t = s.actors[static_cast<std::size_t>(target)];
+			if (Actor::IsAdjacent(a.x, a.y, t.x, t.y))
+			{
+				Damage(s, target, a.attack);
+				return;
+			}
+			StepTowards(ctx, s, index, t.x, t.y);
+		}
+
+		void ApplyEliteAction(const SimContext& ctx, SimState& s, int action)
+		{
+			if (action == kStayAction)
+				return;
+			const SimActor& e = s.actors[static_cast<std::size_t>(s.elite)];
+			const auto& d = Map::dirs[static_cast<std::size_t>(action)];
+			const int occupant = OccupantAt(s, e.x + d.dx, e.y + d.dy);
+			if (occupant >= 0)
+			{
+				if (s.actors[static_cast<std::size_t>(occupant)].side != SimSide::Hostile)
+					Damage(s, occupant, e.attack);
+				return;
+			}
+			TryMove(ctx, s, s.elite, d.dx, d.dy);
+		}
+
+		// Greedy default policy: strike if something is adjacent, otherwise take
+		// the step that closes distance to the nearest target without walking
+		// into a hazard. Some moves are random to keep the search honest.
+		int RolloutEliteAction(const SimContext& ctx, const SimState& s, Random& rng)
+		{
+			if (rng.NextBelow(4) == 0)
+				return static_cast<int>(rng.NextBelow(kActionCount));
+
+			const SimActor& e = s.actors[static_cast<std::size_t>(s.elite)];
+			const int target = NearestTarget(s, s.elite);
+			if (target < 0)
+				return kStayAction;
+			const SimActor& t = s.actors[static_cast<std::size_t>(target)];
+
+			int bestAction = kStayAction;
+			int bestScore = std::max(std::abs(t.x - e.x), std::abs(t.y - e.y)) * 4;
+			for (int a = 0; a < kStayAction; ++a)
+			{
+				const auto& d = Map::dirs[static_cast<std::size_t>(a)];
+				const int nx = e.x + d.dx;
+				const int ny = e.y + d.dy;
+				if (nx == t.x && ny == t.y)
+					return a;
+				if (!ctx.map->IsWalkable(nx, ny) || OccupantAt(s, nx, ny) >= 0)
+					continue;
+				int score = std::max(std::abs(t.x - nx), std::abs(t.y - ny)) * 4;
+				if (IsHazard(ctx, s, nx, ny))
+					score += 6;
+				if (score < bestScore)
+				{
+					bestScore = score;
+					bestAction = a;
+				}
+			}
+			return bestAction;
+		}
+
+		void TickStatuses(const SimContext& ctx, SimState& s)
+		{
+			for (int i = 0; i < s.count; ++i)
+			{
+				SimActor& a = s.actors[static_cast<std::size_t>(i)];
+				if (!Alive(a))
+					continue;
+				if (HasStatus(ctx.map->GetTileState(a.x, a.y), StatusEffect::OnFire) && a.fireTurns == 0)
+					a.fireTurns = static_cast<std::uint8_t>(ctx.fireDuration);
+				if (a.fireTurns > 0)
+				{
+					--a.fireTurns;
+					Damage(s, i, ctx.fireDamage);
+				}
+				if (a.poisonTurns > 0)
+				{
+					--a.poisonTurns;
+					Damage(s, i, ctx.poisonDamage);
+				}
+			}
+		}
+
+		// One game turn in the same order as Game::ApplyTurn: player, summons, hostiles, environment.
+		void StepWorld(const SimContext& ctx, SimState& s, int eliteAction, Random& rng)
+		{
+			SimActor& player = s.actors[0];
+			if (Alive(player))
+			{
+				const SimActor& e = s.actors[static_cast<std::size_t>(s.elite)];
+				if (Actor::IsAdjacent(player.x, player.y, e.x, e.y) && rng.NextBelow(3) == 0)
+				{
+					Damage(s, s.elite, player.attack);
+				}
+				else if (rng.NextBool())
+				{
+					const auto& d = Map::dirs[rng.NextBelow(8)];
+					TryMove(ctx, s, 0, d.dx, d.dy);
+				}
+			}
+
+			for (int i = 1; i < s.count; ++i)
+			{
+				if (s.actors[static_cast<std::size_t>(i)].side == SimSide::Summon && Alive(s.actors[static_cast<std::size_t>(i)]))
+					ChaseOrStrike(ctx, s, i);
+			}
+
+			for (int i = 1; i < s.count; ++i)
+			{
+				const SimActor& a = s.actors[static_cast<std::size_t>(i)];
+				if (a.side != SimSide::Hostile || !Alive(a))
+					continue;
+				if (i == s.elite)
+					ApplyEliteAction(ctx, s, eliteAction);
+				else
+					ChaseOrStrike(ctx, s, i);
+			}
+
+			TickStatuses(ctx, s);
+		}
+
+		bool Finished(const SimState& s)
+		{
+			return s.playerDead || s.eliteDead;
+		}
+
+		// Maps the elite's outcome onto [0, 1] for UCB.
+		float Evaluate(const SimState& s)
+		{
+			float score = 2.0f * static_cast<float>(s.damageToPlayer)
+				+ static_cast<float>(s.damageToSummons)
+				+ 3.0f * static_cast<float>(s.summonsKilled)
+				- 1.5f * static_cast<float>(s.eliteDamageTaken);
+			if (s.playerDead)
+				score += 10.0f;
+			if (s.eliteDead)
+				score -= 8.0f;
+			return 0.5f + 0.5f * std::tanh(score / 10.0f);
+		}
+
+		int NewNode(std::vector<Node>& pool, int& used)
+		{
+			if (used >= kMaxNodes)
+				return -1;
+			Node& node = pool[static_cast<std::size_t>(used)];
+			node.totalReward = 0.0f;
+			node.visits = 0;
+			node.children.fill(-1);
+			return used++;
+		}
+
+		ThreadResult Search(const SimContext& ctx, const SimState& root, const PlannerConfig& config,
+			std::uint64_t seed, std::chrono::steady_clock::time_point deadline, std::vector<Node>& pool)
+		{
+			ThreadResult result;
+			Random rng(seed);
+			int used = 0;
+			const int rootIndex = NewNode(pool, used);
+			const int horizon = std::clamp(config.horizon, 1, kMaxDepth);
+
+			std::array<int, kMaxDepth + 1> path{};
+			SimState state;
+
+			for (int iteration = 0; iteration < config.maxIterationsPerThread; ++iteration)
+			{
+				if ((iteration & 31) == 0 && iteration > 0 && std::chrono::steady_clock::now() >= deadline)
+					break;
+
+				state = root;
+				int node = rootIndex;
+				int pathLength = 0;
+				path[static_cast<std::size_t>(pathLength++)] = node;
+				int depth = 0;
+
+				// Selection and expansion
+				while (depth < horizon && !Finished(state))
+				{
+					Node& current = pool[static_cast<std::size_t>(node)];
+
+					int untried = -1;
+					int untriedSeen = 0;
+					for (int a = 0; a < kActionCount; ++a)
+					{
+						if (current.children[static_cast<std::size_t>(a)] < 0 && rng.NextBelow(static_cast<std::uint32_t>(++untriedSeen)) == 0)
+							untried = a;
+					}
+
+					if (untried >= 0)
+					{
+						const int child = NewNode(pool, used);
+						StepWorld(ctx, state, untried, rng);
+						++depth;
+						if (child >= 0)
+						{
+							pool[static_cast<std::size_t>(node)].children[static_cast<std::size_t>(untried)] = child;
+							path[static_cast<std::size_t>(pathLength++)] = child;
+						}
+						break;
+					}
+
+					const float logVisits = std::log(static_cast<float>(std::max(current.visits, 1)));
+					int bestAction = 0;
+					float bestValue = -1.0f;
+					for (int a = 0; a < kActionCount; ++a)
+					{
+						const Node& child = pool[static_cast<std::size_t>(current.children[static_cast<std::size_t>(a)])];
+						const float mean = child.totalReward / static_cast<float>(std::max(child.visits, 1));
+						const float ucb = mean + kExploration * std::sqrt(logVisits / static_cast<float>(std::max(child.visits, 1)));
+						if (ucb > bestValue)
+						{
+							bestValue = ucb;
+							bestAction = a;
+						}
+					}
+
+					StepWorld(ctx, state, bestAction, rng);
+					++depth;
+					node = current.children[static_cast<std::size_t>(bestAction)];
+					path[static_cast<std::size_t>(pathLength++)] = node;
+				}
+
+				// Rollout
+				while (depth < horizon && !Finished(state))
+				{
+					StepWorld(ctx, state, RolloutEliteAction(ctx, state, rng), rng);
+					++depth;
+				}
+
+				const float reward = Evaluate(state);
+				for (int i = 0; i < pathLength; ++i)
+				{
+					Node& n = pool[static_cast<std::size_t>(path[static_cast<std::size_t>(i)])];
+					n.totalReward += reward;
+					++n.visits;
+				}
+				++result.iterations;
+			}
+
+			const Node& rootNode = pool[static_cast<std::size_t>(rootIndex)];
+			for (int a = 0; a < kActionCount; ++a)
+			{
+				const int child = rootNode.children[static_cast<std::size_t>(a)];
+				if (child < 0)
+					continue;
+				result.visits[static_cast<std::size_t>(a)] = pool[static_cast<std::size_t>(child)].visits;
+				result.reward[static_cast<std::size_t>(a)] = pool[static_cast<std::size_t>(child)].totalReward;
+			}
+			return result;
+		}
+
+		SimActor MakeSimActor(const Actor& actor, SimSide side, int aggro)
+		{
+			SimActor a{};
+			a.x = static_cast<std::int16_t>(actor.x);
+			a.y = static_cast<std::int16_t>(actor.y);
+			a.hp = static_cast<std::int16_t>(actor.hp);
+			a.attack = static_cast<std::int16_t>(actor.attackDamage);
+			a.aggro = static_cast<std::int16_t>(aggro);
+			a.side = side;
+			a.fireTurns = static_cast<std::uint8_t>(std::clamp(actor.GetStatusDuration(StatusEffect::OnFire), 0, 255));
+			a.poisonTurns = static_cast<std::uint8_t>(std::clamp(actor.GetStatusDuration(StatusEffect::Poisoned), 0, 255));
+			return a;
+		}
+
+		// Threads shared by every Plan in the process, each with a node pool
+		// allocated once, so an elite's decision never starts a thread or
+		// allocates a tree. Workers are added up to the most any Plan asked for.
+		class SearchWorkers
+		{
+		public:
+			using Job = std::function<void(int index, std::vector<Node>& pool)>;
+
+			static SearchWorkers& Get()
+			{
+				static SearchWorkers workers;
+				return workers;
+			}
+
+			~SearchWorkers()
+			{
+				{
+					std::lock_guard lock(m_Mutex);
+					m_Stop = true;
+				}
+				m_Wake.notify_all();
+				for (std::thread& thread : m_Threads)
+				{
+					thread.join();
+				}
+			}
+
+			// Runs job 0 on the calling thread and the rest on the workers, and
+			// returns once all `count` have finished.
+			void Run(int count, const Job& job)
+			{
+				struct Batch
+				{
+					std::mutex mutex;
+					std::condition_variable finished;
+					int remaining = 0;
+				} batch;
+				batch.remaining = count - 1;
+
+				std::vector<Node> pool;
+				{
+					std::lock_guard lock(m_Mutex);
+					while (m_Threads.size() < static_cast<std::size_t>(count - 1))
+					{
+						m_Threads.emplace_back([this]() { Work(); });
+					}
+					for (int i = 1; i < count; ++i)
+					{
+						m_Queue.push_back([&job, &batch, i](std::vector<Node>& workerPool)
+							{
+								job(i, workerPool);
+								std::lock_guard lock(batch.mutex);
+								if (--batch.remaining == 0)
+									batch.finished.notify_one();
+							});
+					}
+					// Callers borrow a pool too, so several games can plan at once
+					if (m_CallerPools.empty())
+						m_CallerPools.emplace_back(kMaxNodes);
+					pool = std::move(m_CallerPools.back());
+					m_CallerPools.pop_back();
+				}
+				m_Wake.notify_all();
+
+				job(0, pool);
+
+				std::unique_lock lock(batch.mutex);
+				batch.finished.wait(lock, [&batch]() { return batch.remaining == 0; });
+				lock.unlock();
+
+				std::lock_guard poolLock(m_Mutex);
+				m_CallerPools.push_back(std::move(pool));
+			}
+
+		private:
+			void Work()
+			{
+				std::vector<Node> pool(kMaxNodes);
+				std::unique_lock lock(m_Mutex);
+				while (true)
+				{
+					m_Wake.wait(lock, [this]() { return m_Stop || !m_Queue.empty(); });
+					if (m_Queue.empty())
+						return;
+					std::function<void(std::vector<Node>&)> task = std::move(m_Queue.front());
+					m_Queue.pop_front();
+					lock.unlock();
+					task(pool);
+					lock.lock();
+				}
+			}
+
+			std::mutex m_Mutex;
+			std::condition_variable m_Wake;
+			std::deque<std::function<void(std::vector<Node>&)>> m_Queue;
+			std::vector<std::vector<Node>> m_CallerPools;
+			std::vector<std::thread> m_Threads;
+			bool m_Stop = false;
+		};
+
+		SimState BuildRoot(const Game& game, const Entity& elite, int sensingRadius)
+		{
+			SimState s{};
+			s.actors[0] = MakeSimActor(game.GetPlayer(), SimSide::Player, 0);
+			s.actors[1] = MakeSimActor(elite, SimSide::Hostile, elite.aggroRange);
+			s.elite = 1;
+			s.count = 2;
+
+			// Nearest actors first so the cap drops the least relevant ones
+			std::array<std::pair<int, const Entity*>, 256> nearby{};
+			std::size_t nearbyCount = 0;
+			for (const Entity& e : game.GetEntities())
+			{
+				if (&e == &elite || !e.IsAlive() || e.faction == Faction::Neutral)
+					continue;
+				const int d = std::max(std::abs(e.x - elite.x), std::abs(e.y - elite.y));
+				if (d > sensingRadius || nearbyCount == nearby.size())
+					continue;
+				nearby[nearbyCount++] = { d, &e };
+			}
+			std::sort(nearby.begin(), nearby.begin() + static_cast<std::ptrdiff_t>(nearbyCount),
+				[](const auto& a, const auto& b) { return a.first < b.first || (a.first == b.first && a.second->id < b.second->id); });
+
+			for (std::size_t i = 0; i < nearbyCount && s.count < kMaxSimActors; ++i)
+			{
+				const Entity& e = *nearby[i].second;
+				const SimSide side = e.faction == Faction::Friendly ? SimSide::Summon : SimSide::Hostile;
+				s.actors[static_cast<std::size_t>(s.count++)] = MakeSimActor(e, side, e.aggroRange);
+			}
+			return s;
+		}
+	}
+
+	PlannedAction HostilePlanner::Plan(const Game& game, const Entity& elite, const PlannerConfig& config, std::uint64_t seed)
+	{
+		SimContext ctx{};
+		ctx.map = &game.GetMap();
+		const StatusDescriptor& fire = kStatusTable[StatusIndex(StatusEffect::OnFire)];
+		const StatusDescriptor& poison = kStatusTable[StatusIndex(StatusEffect::Poisoned)];
+		ctx.fireDamage = fire.damagePerTurn;
+		ctx.fireDuration = fire.defaultDuration;
+		ctx.poisonDamage = poison.damagePerTurn;
+		ctx.poisonDuration = poison.defaultDuration;
+
+		const SimState root = BuildRoot(game, elite, config.sensingRadius);
+		const auto now = std::chrono::steady_clock::now();
+		const auto deadline = config.timeBudget >= std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::time_point::max() - now)
+			? std::chrono::steady_clock::time_point::max()
+			: now + config.timeBudget;
+
+		const int threadCount = std::max(1, config.threads);
+		std::vector<ThreadResult> results(static_cast<std::size_t>(threadCount));
+
+		Random seeds(seed);
+		std::vector<std::uint64_t> threadSeeds(static_cast<std::size_t>(threadCount));
+		for (std::uint64_t& s : threadSeeds)
+		{
+			s = seeds.NextU64();
+		}
+
+		SearchWorkers::Get().Run(threadCount, [&](int t, std::vector<Node>& pool)
+			{
+				results[static_cast<std::size_t>(t)] = Search(ctx, root, config, threadSeeds[static_cast<std::size_t>(t)], deadline, pool);
+			});
+
+		std::array<int, kActionCount> visits{};
+		std::array<float, kActionCount> reward{};
+		PlannedAction planned{};
+		planned.complete = true;
+		for (const ThreadResult& r : results)
+		{
+			planned.iterations += r.iterations;
+			planned.complete = planned.complete && r.iterations >= config.maxIterationsPerThread;
+			for (int a = 0; a < kActionCount; ++a)
+			{
+				visits[static_cast<std::size_t>(a)] += r.visits[static_cast<std::size_t>(a)];
+				reward[static_cast<std::size_t>(a)] += r.reward[static_cast<std::size_t>(a)];
+			}
+		}
+
+		int best = kStayAction;
+		for (int a = 0; a < kActionCount; ++a)
+		{
+			if (visits[static_cast<std::size_t>(a)] > visits[static_cast<std::size_t>(best)])
+				best = a;
+		}
+
+		if (best != kStayAction)
+		{
+			planned.dx = Map::dirs[static_cast<std::size_t>(best)].dx;
+			planned.dy = Map::dirs[static_cast<std::size_t>(best)].dy;
+		}
+		if (visits[static_cast<std::size_t>(best)] > 0)
+			planned.expectedValue = reward[static_cast<std::size_t>(best)] / static_cast<float>(visits[static_cast<std::size_t>(best)]);
+		return planned;
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace NecroCore
+{
+	class Game;
+	struct Entity;
+
+	struct PlannerConfig
+	{
+		int threads = 4;
+		int maxIterationsPerThread = 2000;
+		// Safety cap on wall time per decision, only applied under a limited turn
+		// budget. Searches bound by the iteration limit alone are deterministic for
+		// a given seed; one cut short by time reports itself incomplete.
+		std::chrono::microseconds timeBudget{ 25000 };
+		int horizon = 6;
+		int sensingRadius = 8;
+	};
+
+	struct PlannedAction
+	{
+		int dx = 0;
+		int dy = 0;
+		int iterations = 0;
+		float expectedValue = 0.0f;
+		// Every thread ran its full iteration count before the time cap
+		bool complete = false;
+	};
+
+	// Monte Carlo tree search for elite hostiles. Each thread grows its own
+	// open-loop tree over the elite's moves (root parallelism) and simulates the
+	// other actors with cheap greedy policies on a fixed-size state, so rollouts
+	// never allocate. Traps, burning tiles and status damage are modelled.
+	// The search threads and their trees are kept between calls.
+	class HostilePlanner
+	{
+	public:
+		static PlannedAction Plan(const Game& game, const Entity& elite, const PlannerConfig& config, std::uint64_t seed);
+	};
+}
@@ -0,0 +1,417 @@
+#include "JsonRequest.h"
+#include "KeywordTable.h"
+
+#include <cstring>
+
+namespace NecroCore
+{
+	namespace
+	{
+		enum class RequestKey : std::uint8_t
+		{
+			SessionId,
+			Command,
+			PlayerName,
+			MapName,
+			Seed
+		};
+
+		using KeyTable = KeywordTable<RequestKey, 8>;
+		constexpr KeyTable kKeys = KeyTable::Build({
+			{ "sessionId", RequestKey::SessionId },
+			{ "command", RequestKey::Command },
+			{ "playerName", RequestKey::PlayerName },
+			{ "mapName", RequestKey::MapName },
+			{ "seed", RequestKey::Seed },
+		});
+
+		// Longer keys can only be unknown ones, so they are validated but not kept
+		constexpr std::size_t kMaxKeyLength = 16;
+
+		int HexValue(char c)
+		{
+			if (c >= '0' && c <= '9') return c - '0';
+			if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+			if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+			return -1;
+		}
+
+		class JsonCursor
+		{
+		public:
+			explicit JsonCursor(std::string_view text) : m_At(text.data()), m_End(text.data() + text.size()) {}
+
+			bool AtEnd() const { return m_At == m_End; }
+			char Peek() const { return m_At < m_End ? *m_At : '\0'; }
+
+			void SkipSpace()
+			{
+				while (m_At < m_End && (*m_At == ' ' || *m_At == '\t' || *m_At == '\n' || *m_At == '\r'))
+					++m_At;
+			}
+
+			bool Consume(char c)
+			{
+				if (m_At < m_End && *m_At == c)
+				{
+					++m_At;
+					return true;
+				}
+				return false;
+			}
+
+			// Unescapes a string (opening quote already consumed) into out[0, capacity).
+			// With no buffer the string is only validated. `overflow` is set instead of
+			// failing so the caller decides whether a long string matters.
+			JsonRequestError ReadString(char* out, std::size_t capacity, std::size_t& length, bool& overflow)
+			{
+				length = 0;
+				overflow = false;
+				auto append = [&](const char* bytes, std::size_t count)
+					{
+						if (overflow || count > capacity - length)
+						{
+							overflow = true;
+							return;
+						}
+						std::memcpy(out + length, bytes, count);
+						length += count;
+					};
+
+				while (true)
+				{
+					// Copy the clean run up to the next quote, backslash or control byte
+					const char* run = m_At;
+					while (m_At < m_End)
+					{
+						const unsigned char c = static_cast<unsigned char>(*m_At);
+						if (c == '"' || c == '\\' || c < 0x20)
+							break;
+						++m_At;
+					}
+					if (m_At > run)
+						append(run, static_cast<std::size_t>(m_At - run));
+
+					if (m_At == m_End || static_cast<unsigned char>(*m_At) < 0x20)
+						return JsonRequestError::Syntax;
+					if (*m_At++ == '"')
+						return JsonRequestError::None;
+
+					if (m_At == m_End)
+						return JsonRequestError::Syntax;
+					char single;
+					switch (*m_At++)
+					{
+					case '"':  single = '"'; break;
+					case '\\': single = '\\'; break;
+					case '/':  single = '/'; break;
+					case 'b':  single = '\b'; break;
+					case 'f':  single = '\f'; break;
+					case 'n':  single = '\n'; break;
+					case 'r':  single = '\r'; break;
+					case 't':  single = '\t'; break;
+					case 'u':
+					{
+						std::uint32_t code = 0;
+						if (!ReadHex4(code))
+							return JsonRequestError::Syntax;
+						if (code >= 0xDC00 && code <= 0xDFFF)
+							return JsonRequestError::Syntax;
+						if (code >= 0xD800 && code <= 0xDBFF)
+						{
+							// A high surrogate must be followed by its low half
+							std::uint32_t low = 0;
+							if (!Consume('\\') || !Consume('u') || !ReadHex4(low) || low < 0xDC00 || low > 0xDFFF)
+								return JsonRequestError::Syntax;
+							code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+						}
+						char utf8[4];
+						append(utf8, EncodeUtf8(code, utf8));
+						continue;
+					}
+					default:
+						return JsonRequestError::Syntax;
+					}
+					append(&single, 1);
+				}
+			}
+
+			JsonRequestError SkipString()
+			{
+				std::size_t length = 0;
+				bool overflow = false;
+				return ReadString(nullptr, 0, length, overflow);
+			}
+
+			// -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+			JsonRequestError SkipNumber(bool& isUnsignedInteger)
+			{
+				isUnsignedInteger = !Consume('-');
+				if (Consume('0'))
+				{
+					if (IsDigit(Peek()))
+						return JsonRequestError::Syntax;
+				}
+				else if (!SkipDigits())
+				{
+					return JsonRequestError::Syntax;
+				}
+				if (Consume('.'))
+				{
+					isUnsignedInteger = false;
+					if (!SkipDigits())
+						return JsonRequestError::Syntax;
+				}
+				if (Consume('e') || Consume('E'))
+				{
+					isUnsignedInteger = false;
+					if (!Consume('+'))
+						Consume('-');
+					if (!SkipDigits())
+						return JsonRequestError::Syntax;
+				}
+				return JsonRequestError::None;
+			}
+
+			JsonRequestError ReadUint(std::uint64_t& value)
+			{
+				const char* start = m_At;
+				bool isUnsignedInteger = false;
+				if (const JsonRequestError error = SkipNumber(isUnsignedInteger); error != JsonRequestError::None)
+					return error;
+				if (!isUnsignedInteger)
+					return JsonRequestError::WrongType;
+
+				value = 0;
+				for (const char* c = start; c < m_At; ++c)
+				{
+					const std::uint64_t digit = static_cast<std::uint64_t>(*c - '0');
+					if (value > (UINT64_MAX - digit) / 10)
+						return JsonRequestError::WrongType;
+					value = value * 10 + digit;
+				}
+				return JsonRequestError::None;
+			}
+
+			bool ConsumeLiteral(std::string_view literal)
+			{
+				if (static_cast<std::size_t>(m_End - m_At) < literal.size() || std::memcmp(m_At, literal.data(), literal.size()) != 0)
+					return false;
+				m_At += literal.size();
+				return true;
+			}
+
+			JsonRequestError SkipValue(int depth)
+			{
+				if (depth > JsonRequestParser::MaxDepth)
+					return JsonRequestError::TooDeep;
+
+				SkipSpace();
+				switch (Peek())
+				{
+				case '"':
+					++m_At;
+					return SkipString();
+				case '{':
+				case '[':
+				{
+					const char close = *m_At++ == '{' ? '}' : ']';
+					SkipSpace();
+					if (Consume(close))
+						return JsonRequestError::None;
+					do
+					{
+						if (close == '}')
+						{
+							SkipSpace();
+							if (!Consume('"'))
+								return JsonRequestError::Syntax;
+							if (const JsonRequestError error = SkipString(); error != JsonRequestError::None)
+								return error;
+							SkipSpace();
+							if (!Consume(':'))
+								return JsonRequestError::Syntax;
+						}
+						if (const JsonRequestError error = SkipValue(depth + 1); error != JsonRequestError::None)
+							return error;
+						SkipSpace();
+					} while (Consume(','));
+					return Consume(close) ? JsonRequestError::None : JsonRequestError::Syntax;
+				}
+				case 't':
+					return ConsumeLiteral("true") ? JsonRequestError::None : JsonRequestError::Syntax;
+				case 'f':
+					return ConsumeLiteral("false") ? JsonRequestError::None : JsonRequestError::Syntax;
+				case 'n':
+					return ConsumeLiteral("null") ? JsonRequestError::None : JsonRequestError::Syntax;
+				default:
+				{
+					bool isUnsignedInteger = false;
+					return SkipNumber(isUnsignedInteger);
+				}
+				}
+			}
+
+		private:
+			static bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+			bool SkipDigits()
+			{
+				const char* start = m_At;
+				while (m_At < m_End && IsDigit(*m_At))
+					++m_At;
+				return m_At > start;
+			}
+
+			bool ReadHex4(std::uint32_t& code)
+			{
+				if (m_End - m_At < 4)
+					return false;
+				code = 0;
+				for (int i = 0; i < 4; ++i)
+				{
+					const int digit = HexValue(*m_At++);
+					if (digit < 0)
+						return false;
+					code = (code << 4) | static_cast<std::uint32_t>(digit);
+				}
+				return true;
+			}
+
+			static std::size_t EncodeUtf8(std::uint32_t code, char* out)
+			{
+				if (code < 0x80)
+				{
+					out[0] = static_cast<char>(code);
+					return 1;
+				}
+				if (code < 0x800)
+				{
+					out[0] = static_cast<char>(0xC0 | (code >> 6));
+					out[1] = static_cast<char>(0x80 | (code & 0x3F));
+					return 2;
+				}
+				if (code < 0x10000)
+				{
+					out[0] = static_cast<char>(0xE0 | (code >> 12));
+					out[1] = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+					out[2] = static_cast<char>(0x80 | (code & 0x3F));
+					return 3;
+				}
+				out[0] = static_cast<char>(0xF0 | (code >> 18));
+				out[1] = static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+				out[2] = static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+				out[3] = static_cast<char>(0x80 | (code & 0x3F));
+				return 4;
+			}
+
+			const char* m_At;
+			const char* m_End;
+		};
+
+		template <std::size_t Capacity>
+		JsonRequestError ReadField(JsonCursor& cursor, RequestField<Capacity>& field)
+		{
+			if (field.present)
+				return JsonRequestError::DuplicateField;
+			if (cursor.ConsumeLiteral("null"))
+				return JsonRequestError::None;
+			if (!cursor.Consume('"'))
+				return JsonRequestError::WrongType;
+
+			std::size_t length = 0;
+			bool overflow = false;
+			if (const JsonRequestError error = cursor.ReadString(field.text.data(), Capacity, length, overflow); error != JsonRequestError::None)
+				return error;
+			if (overflow)
+				return JsonRequestError::TooLong;
+			field.length = static_cast<std::uint16_t>(length);
+			field.present = true;
+			return JsonRequestError::None;
+		}
+	}
+
+	const char* JsonRequestErrorToString(JsonRequestError error)
+	{
+		switch (error)
+		{
+		case JsonRequestError::None:           return "ok";
+		case JsonRequestError::Syntax:         return "Malformed JSON";
+		case JsonRequestError::NotAnObject:    return "Request body must be a JSON object";
+		case JsonRequestError::WrongType:      return "Field has the wrong type";
+		case JsonRequestError::TooLong:        return "Field is too long";
+		case JsonRequestError::TooDeep:        return "JSON is nested too deeply";
+		case JsonRequestError::DuplicateField: return "Duplicate field";
+		default:                               return "unknown";
+		}
+	}
+
+	JsonRequestError JsonRequestParser::Parse(std::string_view body, JsonRequest& request)
+	{
+		request = JsonRequest{};
+		JsonCursor cursor(body);
+
+		cursor.SkipSpace();
+		if (!cursor.Consume('{'))
+			return cursor.AtEnd() ? JsonRequestError::Syntax : JsonRequestError::NotAnObject;
+
+		cursor.SkipSpace();
+		if (!cursor.Consume('}'))
+		{
+			do
+			{
+				cursor.SkipSpace();
+				if (!cursor.Consume('"'))
+					return JsonRequestError::Syntax;
+
+				char keyBuffer[kMaxKeyLength];
+				std::size_t keyLength = 0;
+				bool keyOverflow = false;
+				if (const JsonRequestError error = cursor.ReadString(keyBuffer, kMaxKeyLength, keyLength, keyOverflow); error != JsonRequestError::None)
+					return error;
+
+				cursor.SkipSpace();
+				if (!cursor.Consume(':'))
+					return JsonRequestError::Syntax;
+				cursor.SkipSpace();
+
+				const RequestKey* key = keyOverflow ? nullptr : kKeys.Find(std::string_view(keyBuffer, keyLength));
+				JsonRequestError error = JsonRequestError::None;
+				if (!key)
+				{
+					error = cursor.SkipValue(1);
+				}
+				else
+				{
+					switch (*key)
+					{
+					case RequestKey::SessionId:  error = ReadField(cursor, request.sessionId); break;
+					case RequestKey::Command:    error = ReadField(cursor, request.command); break;
+					case RequestKey::PlayerName: error = ReadField(cursor, request.playerName); break;
+					case RequestKey::MapName:    error = ReadField(cursor, request.mapName); break;
+					case RequestKey::Seed:
+						if (request.hasSeed)
+							error = JsonRequestError::DuplicateField;
+						else if (cursor.ConsumeLiteral("null"))
+							break;
+						else if (cursor.Peek() != '-' && (cursor.Peek() < '0' || cursor.Peek() > '9'))
+							error = JsonRequestError::WrongType;
+						else if ((error = cursor.ReadUint(request.seed)) == JsonRequestError::None)
+							request.hasSeed = true;
+						break;
+					}
+				}
+				if (error != JsonRequestError::None)
+					return error;
+
+				cursor.SkipSpace();
+			} while (cursor.Consume(','));
+
+			if (!cursor.Consume('}'))
+				return JsonRequestError::Syntax;
+		}
+
+		cursor.SkipSpace();
+		return cursor.AtEnd() ? JsonRequestError::None : JsonRequestError::Syntax;
+	}
+}
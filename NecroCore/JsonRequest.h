@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace NecroCore
+{
+	// A request string decoded into inline storage; anything longer than
+	// Capacity is rejected rather than cut.
+	template <std::size_t Capacity>
+	struct RequestField
+	{
+		std::array<char, Capacity> text{};
+		std::uint16_t length = 0;
+		bool present = false;
+
+		std::string_view View() const { return std::string_view(text.data(), length); }
+		bool Empty() const { return length == 0; }
+	};
+
+	// Every field a client sends to /new-game or /turn. A field that is absent
+	// or null is left not present.
+	struct JsonRequest
+	{
+		RequestField<64> sessionId;
+		RequestField<512> command;
+		RequestField<64> playerName;
+		RequestField<64> mapName;
+		std::uint64_t seed = 0;
+		bool hasSeed = false;
+	};
+
+	enum class JsonRequestError : std::uint8_t
+	{
+		None,
+		Syntax,
+		NotAnObject,
+		WrongType,
+		TooLong,
+		TooDeep,
+		DuplicateField
+	};
+
+	const char* JsonRequestErrorToString(JsonRequestError error);
+
+	// Single pass over the body with no allocation. Known fields are unescaped
+	// straight into the request; unknown fields are validated and skipped. The
+	// first error stops the parse.
+	class JsonRequestParser
+	{
+	public:
+		static constexpr int MaxDepth = 32;
+
+		static JsonRequestError Parse(std::string_view body, JsonRequest& request);
+	};
+}
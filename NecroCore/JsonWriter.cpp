@@ -0,0 +1,240 @@
+#include "JsonWriter.h"
+
+#include <atomic>
+#include <charconv>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NECRO_JSON_SSE2 1
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#define NECRO_JSON_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace NecroCore
+{
+	namespace
+	{
+		std::atomic<bool> g_SimdEnabled{ true };
+
+		constexpr bool NeedsEscape(unsigned char c)
+		{
+			return c == '"' || c == '\\' || c < 0x20;
+		}
+
+		void AppendEscapedChar(std::string& out, unsigned char c)
+		{
+			static constexpr char kHex[] = "0123456789ABCDEF";
+			switch (c)
+			{
+			case '"':  out.append("\\\"", 2); break;
+			case '\\': out.append("\\\\", 2); break;
+			case '\b': out.append("\\b", 2); break;
+			case '\f': out.append("\\f", 2); break;
+			case '\n': out.append("\\n", 2); break;
+			case '\r': out.append("\\r", 2); break;
+			case '\t': out.append("\\t", 2); break;
+			default:
+			{
+				const char unicode[6] = { '\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0xF] };
+				out.append(unicode, sizeof(unicode));
+				break;
+			}
+			}
+		}
+
+		// Length of the clean run at the start of [at, end)
+		std::size_t CleanRunScalar(const char* at, const char* end)
+		{
+			const char* p = at;
+			while (p < end && !NeedsEscape(static_cast<unsigned char>(*p)))
+				++p;
+			return static_cast<std::size_t>(p - at);
+		}
+
+#ifdef NECRO_JSON_SSE2
+		std::size_t CleanRunSse2(const char* at, const char* end)
+		{
+			const __m128i quote = _mm_set1_epi8('"');
+			const __m128i backslash = _mm_set1_epi8('\\');
+			const __m128i control = _mm_set1_epi8(0x1F);
+
+			const char* p = at;
+			while (end - p >= 16)
+			{
+				const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+				// Unsigned v <= 0x1F is max(v, 0x1F) == 0x1F
+				const __m128i hits = _mm_or_si128(
+					_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+					_mm_cmpeq_epi8(_mm_max_epu8(v, control), control));
+				const int mask = _mm_movemask_epi8(hits);
+				if (mask != 0)
+				{
+					int bit = 0;
+					while (((mask >> bit) & 1) == 0)
+						++bit;
+					return static_cast<std::size_t>(p - at) + static_cast<std::size_t>(bit);
+				}
+				p += 16;
+			}
+			return static_cast<std::size_t>(p - at) + CleanRunScalar(p, end);
+		}
+#endif
+
+#ifdef NECRO_JSON_AVX2
+		std::size_t CleanRunAvx2(const char* at, const char* end)
+		{
+			const __m256i quote = _mm256_set1_epi8('"');
+			const __m256i backslash = _mm256_set1_epi8('\\');
+			const __m256i control = _mm256_set1_epi8(0x1F);
+
+			const char* p = at;
+			while (end - p >= 32)
+			{
+				const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+				const __m256i hits = _mm256_or_si256(
+					_mm256_or_si256(_mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, backslash)),
+					_mm256_cmpeq_epi8(_mm256_max_epu8(v, control), control));
+				const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hits));
+				if (mask != 0)
+				{
+					int bit = 0;
+					while (((mask >> bit) & 1u) == 0)
+						++bit;
+					return static_cast<std::size_t>(p - at) + static_cast<std::size_t>(bit);
+				}
+				p += 32;
+			}
+			return static_cast<std::size_t>(p - at) + CleanRunSse2(p, end);
+		}
+#endif
+
+		std::size_t CleanRun(const char* at, const char* end, bool useSimd)
+		{
+#if defined(NECRO_JSON_AVX2)
+			if (useSimd)
+				return CleanRunAvx2(at, end);
+#elif defined(NECRO_JSON_SSE2)
+			if (useSimd)
+				return CleanRunSse2(at, end);
+#endif
+			(void)useSimd;
+			return CleanRunScalar(at, end);
+		}
+
+		template <typename T>
+		void AppendNumber(std::string& out, T value)
+		{
+			char digits[24];
+			const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+			out.append(digits, result.ptr);
+		}
+	}
+
+	void JsonWriter::SetSimdEnabled(bool enabled)
+	{
+		g_SimdEnabled.store(enabled, std::memory_order_relaxed);
+	}
+
+	bool JsonWriter::IsSimdAvailable()
+	{
+#if defined(NECRO_JSON_SSE2) || defined(NECRO_JSON_AVX2)
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	void JsonWriter::AppendEscaped(std::string& out, std::string_view text)
+	{
+		const bool useSimd = IsSimdAvailable() && g_SimdEnabled.load(std::memory_order_relaxed);
+		const char* at = text.data();
+		const char* end = at + text.size();
+		while (at < end)
+		{
+			const std::size_t clean = CleanRun(at, end, useSimd);
+			out.append(at, clean);
+			at += clean;
+			if (at < end)
+			{
+				AppendEscapedChar(out, static_cast<unsigned char>(*at));
+				++at;
+			}
+		}
+	}
+
+	void JsonWriter::Separate()
+	{
+		if (m_AfterKey)
+		{
+			m_AfterKey = false;
+			return;
+		}
+		if (m_Depth == 0)
+			return;
+		const std::uint64_t bit = std::uint64_t{ 1 } << ((m_Depth - 1) & 63);
+		if (m_HasItems & bit)
+			m_Out += ',';
+		m_HasItems |= bit;
+	}
+
+	void JsonWriter::Open(char bracket)
+	{
+		Separate();
+		m_Out += bracket;
+		++m_Depth;
+		m_HasItems &= ~(std::uint64_t{ 1 } << ((m_Depth - 1) & 63));
+	}
+
+	void JsonWriter::Close(char bracket)
+	{
+		m_Out += bracket;
+		if (m_Depth > 0)
+			--m_Depth;
+	}
+
+	void JsonWriter::Key(std::string_view key)
+	{
+		Separate();
+		m_Out += '"';
+		AppendEscaped(m_Out, key);
+		m_Out.append("\":", 2);
+		m_AfterKey = true;
+	}
+
+	void JsonWriter::String(std::string_view value)
+	{
+		Separate();
+		m_Out += '"';
+		AppendEscaped(m_Out, value);
+		m_Out += '"';
+	}
+
+	void JsonWriter::Int(std::int64_t value)
+	{
+		Separate();
+		AppendNumber(m_Out, value);
+	}
+
+	void JsonWriter::Uint(std::uint64_t value)
+	{
+		Separate();
+		AppendNumber(m_Out, value);
+	}
+
+	void JsonWriter::Bool(bool value)
+	{
+		Separate();
+		if (value)
+			m_Out.append("true", 4);
+		else
+			m_Out.append("false", 5);
+	}
+
+	void JsonWriter::Null()
+	{
+		Separate();
+		m_Out.append("null", 4);
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace NecroCore
+{
+	// Appends JSON straight into a caller-owned string, so a buffer that is
+	// cleared and reused between responses stops allocating once it has grown
+	// to the largest response. Commas are placed automatically; the writer does
+	// not otherwise check that calls form valid JSON.
+	class JsonWriter
+	{
+	public:
+		explicit JsonWriter(std::string& out) : m_Out(out) {}
+
+		void BeginObject() { Open('{'); }
+		void EndObject() { Close('}'); }
+		void BeginArray() { Open('['); }
+		void EndArray() { Close(']'); }
+
+		void Key(std::string_view key);
+		void String(std::string_view value);
+		void Int(std::int64_t value);
+		void Uint(std::uint64_t value);
+		void Bool(bool value);
+		void Null();
+
+		void Field(std::string_view key, std::string_view value) { Key(key); String(value); }
+		void Field(std::string_view key, const char* value) { Key(key); String(value); }
+		void Field(std::string_view key, int value) { Key(key); Int(value); }
+		void Field(std::string_view key, std::int64_t value) { Key(key); Int(value); }
+		void Field(std::string_view key, std::uint64_t value) { Key(key); Uint(value); }
+		void Field(std::string_view key, bool value) { Key(key); Bool(value); }
+
+		// Appends `text` with JSON string escaping (no surrounding quotes). Clean
+		// runs are found 16 (SSE2) or 32 (AVX2) bytes at a time and copied whole.
+		static void AppendEscaped(std::string& out, std::string_view text);
+
+		// The scalar path is always available; tests use this to compare the two.
+		static void SetSimdEnabled(bool enabled);
+		static bool IsSimdAvailable();
+
+	private:
+		void Separate();
+		void Open(char bracket);
+		void Close(char bracket);
+
+		std::string& m_Out;
+		// Bit n is set once the container at depth n has an element
+		std::uint64_t m_HasItems = 0;
+		int m_Depth = 0;
+		bool m_AfterKey = false;
+	};
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace NecroCore
+{
+	constexpr std::uint32_t KeywordHash(std::string_view word, std::uint32_t seed)
+	{
+		std::uint32_t h = 2166136261u ^ seed ^ static_cast<std::uint32_t>(word.size());
+		for (char c : word)
+		{
+			h ^= static_cast<unsigned char>(c);
+			h *= 16777619u;
+		}
+		return h ^ (h >> 15);
+	}
+
+	// A fixed keyword set with a collision-free hash, searched for at compile
+	// time. A lookup is one hash over the word and at most one compare.
+	template <typename Value, std::size_t Size>
+	class KeywordTable
+	{
+		static_assert(Size > 0 && (Size & (Size - 1)) == 0, "Size must be a power of two");
+
+	public:
+		struct Entry
+		{
+			std::string_view word;
+			Value value{};
+		};
+
+		template <std::size_t N>
+		static constexpr KeywordTable Build(const Entry (&entries)[N])
+		{
+			static_assert(N <= Size, "More keywords than slots");
+			for (std::uint32_t seed = 0; seed < (1u << 16); ++seed)
+			{
+				KeywordTable table;
+				table.m_Seed = seed;
+				bool collided = false;
+				for (const Entry& entry : entries)
+				{
+					Entry& slot = table.m_Slots[KeywordHash(entry.word, seed) & (Size - 1)];
+					if (!slot.word.empty())
+					{
+						collided = true;
+						break;
+					}
+					slot = entry;
+				}
+				if (!collided)
+					return table;
+			}
+			// Only reached if no seed works, which fails the constant evaluation
+			throw "KeywordTable: no perfect seed, use a larger Size";
+		}
+
+		constexpr const Value* Find(std::string_view word) const
+		{
+			const Entry& slot = m_Slots[KeywordHash(word, m_Seed) & (Size - 1)];
+			return (!slot.word.empty() && slot.word == word) ? &slot.value : nullptr;
+		}
+
+	private:
+		std::array<Entry, Size> m_Slots{};
+		std::uint32_t m_Seed = 0;
+	};
+}
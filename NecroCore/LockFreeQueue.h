@@ -0,0 +1,111 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace NecroCore
+{
+	// Bounded multi-producer, multi-consumer ring of `T` (Vyukov's design).
+	//
+	// Each slot carries a sequence number that says whether it is ready to be
+	// written or read on the current lap, so producers and consumers only ever
+	// race on one counter each and never take a lock. Push fails instead of
+	// blocking when the ring is full. The capacity is rounded up to a power of two.
+	template<typename T>
+	class LockFreeQueue
+	{
+	public:
+		explicit LockFreeQueue(std::size_t capacity)
+		{
+			std::size_t size = 2;
+			while (size < capacity)
+				size <<= 1;
+			m_Mask = size - 1;
+			m_Slots = std::make_unique<Slot[]>(size);
+			for (std::size_t i = 0; i < size; ++i)
+			{
+				m_Slots[i].sequence.store(i, std::memory_order_relaxed);
+			}
+		}
+
+		LockFreeQueue(const LockFreeQueue&) = delete;
+		LockFreeQueue& operator=(const LockFreeQueue&) = delete;
+
+		// On failure `value` is left untouched
+		bool TryPush(T& value)
+		{
+			std::size_t position = m_Tail.load(std::memory_order_relaxed);
+			while (true)
+			{
+				Slot& slot = m_Slots[position & m_Mask];
+				const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+				const std::ptrdiff_t lap = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+				if (lap == 0)
+				{
+					if (m_Tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					{
+						slot.value = std::move(value);
+						slot.sequence.store(position + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (lap < 0)
+				{
+					return false; // Full
+				}
+				else
+				{
+					position = m_Tail.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		bool TryPop(T& value)
+		{
+			std::size_t position = m_Head.load(std::memory_order_relaxed);
+			while (true)
+			{
+				Slot& slot = m_Slots[position & m_Mask];
+				const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+				const std::ptrdiff_t lap = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+				if (lap == 0)
+				{
+					if (m_Head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					{
+						value = std::move(slot.value);
+						slot.value = T();
+						slot.sequence.store(position + m_Mask + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (lap < 0)
+				{
+					return false; // Empty
+				}
+				else
+				{
+					position = m_Head.load(std::memory_order_relaxed);
+				}
+			}
+		}
+
+		std::size_t GetCapacity() const { return m_Mask + 1; }
+
+	private:
+		struct Slot
+		{
+			std::atomic<std::size_t> sequence{ 0 };
+			T value{};
+		};
+
+		std::unique_ptr<Slot[]> m_Slots;
+		std::size_t m_Mask = 0;
+		// Producers and consumers each get their own cache line
+		alignas(64) std::atomic<std::size_t> m_Tail{ 0 };
+		alignas(64) std::atomic<std::size_t> m_Head{ 0 };
+	};
+}
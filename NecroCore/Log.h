@@ -0,0 +1,32 @@
+#pragma once
+
+#include <iostream>
+
+namespace NecroCore
+{
+	// Debug tracing to stdout. On by default; can be silenced per thread, e.g.
+	// while a replay runs at full speed, without affecting other sessions.
+	inline thread_local bool t_TraceEnabled = true;
+
+	inline bool IsTraceEnabled()
+	{
+		return t_TraceEnabled;
+	}
+
+	class ScopedTraceSilence
+	{
+	public:
+		ScopedTraceSilence() : m_Previous(t_TraceEnabled) { t_TraceEnabled = false; }
+		~ScopedTraceSilence() { t_TraceEnabled = m_Previous; }
+
+		ScopedTraceSilence(const ScopedTraceSilence&) = delete;
+		ScopedTraceSilence& operator=(const ScopedTraceSilence&) = delete;
+
+	private:
+		bool m_Previous;
+	};
+}
+
+// Arguments are only evaluated when tracing is enabled for the calling thread.
+#define NECRO_TRACE(expr) \
+	do { if (::NecroCore::IsTraceEnabled()) { std::cout << expr; } } while (0)
@@ -1,5 +1,6 @@
 #include "Map.h"
 #include "Status.h"
+#include "Hash.h"
 
 namespace NecroCore
 {
@@ -10,7 +11,7 @@ namespace NecroCore
 			return TileType::Empty;
 		}
 
-		return m_Tiles[static_cast<std::size_t>(y) * m_Width + x];
+		return (*m_Tiles)[static_cast<std::size_t>(y) * m_Width + x];
 	}
 
 	StatusEffect Map::GetTileState(int x, int y) const
@@ -19,15 +20,50 @@ namespace NecroCore
 		{
 			return StatusEffect::Normal;
 		}
-		return m_TileStates[static_cast<std::size_t>(y) * m_Width + x];
+		return (*m_TileStates)[static_cast<std::size_t>(y) * m_Width + x];
 	}
 	void Map::SetTileState(int x, int y, StatusEffect newState)
+	{
+		SetTileState(x, y, newState, 0);
+	}
+	void Map::SetTileState(int x, int y, StatusEffect newState, std::uint8_t level)
 	{
 		if (x < 0 || y < 0 || x >= m_Width || y >= m_Height)
 		{
 			return;
 		}
-		m_TileStates[static_cast<std::size_t>(y) * m_Width + x] = newState;
+		const std::size_t index = static_cast<std::size_t>(y) * m_Width + x;
+		RecordTileChange(index);
+		MarkDirty(index);
+		MutableTileStates()[index] = newState;
+		if ((*m_TileLevels)[index] != level)
+			MutableTileLevels()[index] = level;
+	}
+	void Map::SetTileStates(const std::vector<TileStateEdit>& edits)
+	{
+		if (edits.empty())
+			return;
+
+		std::vector<StatusEffect>& states = MutableTileStates();
+		std::vector<std::uint8_t>& levels = MutableTileLevels();
+		for (const TileStateEdit& edit : edits)
+		{
+			if (edit.x < 0 || edit.y < 0 || edit.x >= m_Width || edit.y >= m_Height)
+				continue;
+			const std::size_t index = static_cast<std::size_t>(edit.y) * m_Width + edit.x;
+			RecordTileChange(index);
+			MarkDirty(index);
+			states[index] = edit.state;
+			levels[index] = edit.level;
+		}
+	}
+	std::uint8_t Map::GetTileLevel(int x, int y) const
+	{
+		if (x < 0 || y < 0 || x >= m_Width || y >= m_Height)
+		{
+			return 0;
+		}
+		return (*m_TileLevels)[static_cast<std::size_t>(y) * m_Width + x];
 	}
 
 	bool Map::IsWalkable(int x, int y) const
@@ -53,11 +89,16 @@ namespace NecroCore
 		m_Height = static_cast<int>(lines.size());
 		m_Width = m_Height > 0 ? static_cast<int>(lines[0].size()) : 0;
 
-		m_Tiles.clear();
-		m_Tiles.reserve(static_cast<std::size_t>(m_Width) * m_Height);
+		auto tiles = std::make_shared<std::vector<TileType>>();
+		tiles->reserve(static_cast<std::size_t>(m_Width) * m_Height);
+
+		m_TileStates = std::make_shared<std::vector<StatusEffect>>(
+			static_cast<std::size_t>(m_Width) * m_Height, StatusEffect::Normal);
+		m_TileLevels = std::make_shared<std::vector<std::uint8_t>>(
+			static_cast<std::size_t>(m_Width) * m_Height, std::uint8_t{ 0 });
 
-		m_TileStates.clear();
-		m_TileStates.resize(static_cast<std::size_t>(m_Width) * m_Height, StatusEffect::Normal);
+		m_DirtyBlocks.clear();
+		m_BlockDirty.assign(static_cast<std::size_t>(GetBlocksX()) * GetBlocksY(), 0);
 
 		for (int y = 0; y < m_Height; ++y)
 		{
@@ -73,6 +114,7 @@ namespace NecroCore
 				case '.': t = TileType::Floor; break;
 				case '+': t = TileType::Door;  break;
 				case 'o': t = TileType::Floor; break;
+				case 'O': t = TileType::Floor; break;
 				case 'f': t = TileType::Fireplace; break;
 				case 't': t = TileType::Trap; break;
 				case ' ':
@@ -81,9 +123,11 @@ namespace NecroCore
 					break;
 				}
 
-				m_Tiles.push_back(t);
+				tiles->push_back(t);
 			}
 		}
+
+		m_Tiles = std::move(tiles);
 	}
 
 	void Map::convertTile(int x, int y, TileType newType)
@@ -92,7 +136,84 @@ namespace NecroCore
 		{
 			return;
 		}
-		m_Tiles[static_cast<std::size_t>(y) * m_Width + x] = newType;
+		const std::size_t index = static_cast<std::size_t>(y) * m_Width + x;
+		RecordTileChange(index);
+		MarkDirty(index);
+		MutableTiles()[index] = newType;
+	}
+
+	std::vector<TileType>& Map::MutableTiles()
+	{
+		if (m_Tiles.use_count() > 1)
+			m_Tiles = std::make_shared<std::vector<TileType>>(*m_Tiles);
+		return *m_Tiles;
+	}
+
+	std::vector<StatusEffect>& Map::MutableTileStates()
+	{
+		if (m_TileStates.use_count() > 1)
+			m_TileStates = std::make_shared<std::vector<StatusEffect>>(*m_TileStates);
+		return *m_TileStates;
+	}
+
+	std::vector<std::uint8_t>& Map::MutableTileLevels()
+	{
+		if (m_TileLevels.use_count() > 1)
+			m_TileLevels = std::make_shared<std::vector<std::uint8_t>>(*m_TileLevels);
+		return *m_TileLevels;
+	}
+
+	void Map::RecordTileChange(std::size_t index)
+	{
+		if (!m_TrackChanges)
+			return;
+		m_TileChanges.push_back({ static_cast<int>(index), (*m_Tiles)[index], (*m_TileStates)[index], (*m_TileLevels)[index] });
+	}
+
+	void Map::MarkDirty(std::size_t index)
+	{
+		const int x = static_cast<int>(index % static_cast<std::size_t>(m_Width));
+		const int y = static_cast<int>(index / static_cast<std::size_t>(m_Width));
+		const int block = (y / BlockSize) * GetBlocksX() + x / BlockSize;
+		if (static_cast<std::size_t>(block) >= m_BlockDirty.size() || m_BlockDirty[static_cast<std::size_t>(block)])
+			return;
+		m_BlockDirty[static_cast<std::size_t>(block)] = 1;
+		m_DirtyBlocks.push_back(block);
+	}
+
+	void Map::TakeDirtyBlocks(std::vector<int>& out)
+	{
+		out.swap(m_DirtyBlocks);
+		m_DirtyBlocks.clear();
+		for (int block : out)
+		{
+			m_BlockDirty[static_cast<std::size_t>(block)] = 0;
+		}
+	}
+
+	void Map::MarkAllBlocksDirty()
+	{
+		const std::size_t blocks = static_cast<std::size_t>(GetBlocksX()) * GetBlocksY();
+		m_BlockDirty.assign(blocks, 1);
+		m_DirtyBlocks.resize(blocks);
+		for (std::size_t i = 0; i < blocks; ++i)
+		{
+			m_DirtyBlocks[i] = static_cast<int>(i);
+		}
+	}
+
+	void Map::RestoreTile(int index, TileType type, StatusEffect state, std::uint8_t level)
+	{
+		if (!m_Tiles || index < 0 || static_cast<std::size_t>(index) >= m_Tiles->size())
+			return;
+		const std::size_t i = static_cast<std::size_t>(index);
+		MarkDirty(i);
+		if ((*m_Tiles)[i] != type)
+			MutableTiles()[i] = type;
+		if ((*m_TileStates)[i] != state)
+			MutableTileStates()[i] = state;
+		if ((*m_TileLevels)[i] != level)
+			MutableTileLevels()[i] = level;
 	}
 
 	const char* Map::DirectionNameFromDelta(int dx, int dy)
@@ -144,4 +265,23 @@ namespace NecroCore
 		}
 		return false;
 	}
+
+	std::uint64_t Map::ComputeHash(std::uint64_t seed) const
+	{
+		std::uint64_t h = HashCombine(seed, (static_cast<std::uint64_t>(m_Width) << 32) | static_cast<std::uint32_t>(m_Height));
+		if (m_Tiles)
+			h = HashBytes(h, m_Tiles->data(), m_Tiles->size() * sizeof(TileType));
+		if (m_TileStates)
+			h = HashBytes(h, m_TileStates->data(), m_TileStates->size() * sizeof(StatusEffect));
+		// Levels are sparse; folding only the non-zero ones keeps hashes of unsimulated maps unchanged
+		if (m_TileLevels)
+		{
+			for (std::size_t i = 0; i < m_TileLevels->size(); ++i)
+			{
+				if ((*m_TileLevels)[i] != 0)
+					h = HashCombine(h, (static_cast<std::uint64_t>(i) << 8) | (*m_TileLevels)[i]);
+			}
+		}
+		return h;
+	}
 }
\ No newline at end of file
@@ -1,12 +1,14 @@
 #pragma once
 
 #include "Status.h"
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include <string>
 
 namespace NecroCore
 {
-	enum class TileType
+	enum class TileType : std::uint8_t
 	{
 		Empty,
 		Floor,
@@ -16,6 +18,8 @@ namespace NecroCore
 		Fireplace
 	};
 
+	// Tile and state layers are shared between copies of a Map and cloned on
+	// the first write, so copying a Map (e.g. when forking a Game) is O(1).
 	class Map
 	{
 	public:
@@ -28,6 +32,24 @@ namespace NecroCore
 		StatusEffect GetTileState(int x, int y) const;
 		void SetTileState(int x, int y, StatusEffect newState);
 
+		// Per-tile magnitude used by TileSimulation: fire intensity on burning
+		// tiles, water depth on wet ones, ScorchedLevel on burnt-out floor.
+		// Level 0 means the tile is not simulated.
+		static constexpr std::uint8_t ScorchedLevel = 0xFF;
+		std::uint8_t GetTileLevel(int x, int y) const;
+		void SetTileState(int x, int y, StatusEffect newState, std::uint8_t level);
+
+		// Writes many tile states at once, cloning each shared layer at most once.
+		// Edits outside the map are ignored; later edits to a tile win.
+		struct TileStateEdit
+		{
+			int x;
+			int y;
+			StatusEffect state;
+			std::uint8_t level;
+		};
+		void SetTileStates(const std::vector<TileStateEdit>& edits);
+
 		bool IsWalkable(int x, int y) const;
 		bool IsDoor(int x, int y) const { return GetTile(x, y) == TileType::Door; }
 		bool IsTrap(int x, int y) const { return GetTile(x, y) == TileType::Trap; }
@@ -37,6 +59,35 @@ namespace NecroCore
 
 		void convertTile(int x, int y, TileType newType);
 
+		// Tile edits made through convertTile/SetTileState are logged with their
+		// previous values while tracking is on, so a turn can be rewound.
+		struct TileChange
+		{
+			int index;
+			TileType oldType;
+			StatusEffect oldState;
+			std::uint8_t oldLevel;
+		};
+
+		void SetChangeTracking(bool enabled) { m_TrackChanges = enabled; }
+		const std::vector<TileChange>& GetTileChanges() const { return m_TileChanges; }
+		void ClearTileChanges() { m_TileChanges.clear(); }
+		void RestoreTile(int index, TileType type, StatusEffect state, std::uint8_t level);
+
+		// Every tile write marks its block; TileSimulation only steps marked blocks
+		// (and their neighbours), so settled areas cost nothing.
+		static constexpr int BlockSize = 16;
+		int GetBlocksX() const { return (m_Width + BlockSize - 1) / BlockSize; }
+		int GetBlocksY() const { return (m_Height + BlockSize - 1) / BlockSize; }
+		void TakeDirtyBlocks(std::vector<int>& out);
+		void MarkAllBlocksDirty();
+		bool HasDirtyBlocks() const { return !m_DirtyBlocks.empty(); }
+
+		std::uint64_t ComputeHash(std::uint64_t seed) const;
+
+		bool SharesTilesWith(const Map& other) const { return m_Tiles && m_Tiles == other.m_Tiles; }
+		bool SharesTileStatesWith(const Map& other) const { return m_TileStates && m_TileStates == other.m_TileStates; }
+
 		static const char* DirectionNameFromDelta(int dx, int dy);
 		static const char* DirectionNameFromPoints(int fromX, int fromY, int toX, int toY);
 		
@@ -59,9 +110,25 @@ namespace NecroCore
 		};
 
 	private:
+		friend class GameSnapshot;
+		friend class TileSimulation;
+
 		int m_Width = 0;
 		int m_Height = 0;
-		std::vector<TileType> m_Tiles;
-		std::vector<StatusEffect> m_TileStates;
+		std::shared_ptr<std::vector<TileType>> m_Tiles;
+		std::shared_ptr<std::vector<StatusEffect>> m_TileStates;
+		std::shared_ptr<std::vector<std::uint8_t>> m_TileLevels;
+
+		std::vector<int> m_DirtyBlocks;
+		std::vector<std::uint8_t> m_BlockDirty;
+
+		bool m_TrackChanges = false;
+		std::vector<TileChange> m_TileChanges;
+
+		std::vector<TileType>& MutableTiles();
+		std::vector<StatusEffect>& MutableTileStates();
+		std::vector<std::uint8_t>& MutableTileLevels();
+		void RecordTileChange(std::size_t index);
+		void MarkDirty(std::size_t index);
 	};
 }
\ No newline at end of file
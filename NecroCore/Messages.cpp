@@ -0,0 +1,262 @@
+#include "Messages.h"
+
+#include <atomic>
+#include <charconv>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace NecroCore
+{
+	namespace
+	{
+		constexpr std::string_view OrEmpty(const char* text)
+		{
+			return text ? std::string_view(text) : std::string_view();
+		}
+
+		constexpr PhraseTable MakeDefaultPhrases()
+		{
+			PhraseTable table{};
+			auto set = [&](Message id, std::string_view text) { table[static_cast<std::size_t>(id)] = text; };
+
+			set(Message::StepsAdjacent, "right next to you");
+			set(Message::StepsOne, "1 step away");
+			set(Message::StepsMany, "{distance} steps away");
+			set(Message::AllyUnnamed, "Your summoned ally");
+			set(Message::AllyNamed, "Your summoned ally ({entity})");
+
+			set(Message::PulseDoor, "There is a door {steps} to the {direction}.");
+			set(Message::PulseHearth, "You feel gentle warmth and hear a soft crackling {steps} to the {direction}.");
+			set(Message::PulseHostile, "You sense a hostile presence {steps} to the {direction}.");
+			set(Message::PulseFriendly, "You sense a friendly presence {steps} to the {direction}.");
+			set(Message::PulsePresence, "You sense a presence {steps} to the {direction}.");
+			set(Message::PulseFireTrap, "You sense a fire trap {steps} to the {direction}.");
+			set(Message::PulsePoisonTrap, "You sense a poison trap {steps} to the {direction}.");
+			set(Message::PulseTrap, "You sense a trap {steps} to the {direction}.");
+
+			set(Message::TrapFire, "A hidden fire trap erupts beneath {entity}!");
+			set(Message::TrapPoison, "A hidden poison trap is sprung beneath {entity}!");
+			set(Message::TrapOther, "A hidden trap is triggered beneath {entity}!");
+			set(Message::CastFizzles, "You cast a spell of {element} towards {direction}, but nothing happens.");
+
+			set(Message::HostileClaws, "A hostile claws at you from the {direction}.");
+			set(Message::HostileShuffles, "A hostile shuffles closer from the {direction}.");
+			set(Message::HostileSlaysAlly, "A hostile slays your summoned ally ({entity}).");
+			set(Message::HostileHitsAlly, "A hostile lashes out at your summoned ally ({entity}).");
+			set(Message::PlayerCollapses, "You collapse as the last of your strength drains away.");
+
+			set(Message::AllyMoves, "{ally} moves closer to you.");
+			set(Message::AllyReturns, "{ally} returns to its post.");
+			set(Message::AllyNoTargets, "{ally} has no targets.");
+			set(Message::AllyFoeCrumbles, "{ally}'s foe crumbles into dust.");
+			set(Message::AllyStrikes, "{ally} strikes at a foe.");
+			set(Message::AllyStalks, "{ally} stalks a distant foe.");
+
+			set(Message::Explosion, "An explosion tears through the dungeon!");
+			set(Message::ExplosionHitsPlayer, "You are caught in the blast.");
+			set(Message::ExplosionHitsEntity, "A {entity} is caught in the blast.");
+			set(Message::TrapRearms, "Somewhere nearby, something clicks back into place.");
+
+			set(Message::FireLine, "A line of fire streaks {direction}, setting {count} tiles alight.");
+			set(Message::FireCone, "A cone of fire fans out to the {direction}, setting {count} tiles alight.");
+			set(Message::FireRadius, "A ring of fire bursts out around you, setting {count} tiles alight.");
+			set(Message::WaterLine, "A jet of water sweeps {direction}, soaking {count} tiles.");
+			set(Message::WaterCone, "A spray of water fans out to the {direction}, soaking {count} tiles.");
+			set(Message::WaterRadius, "Water crashes down around you, soaking {count} tiles.");
+			set(Message::AreaIgnitesPlayer, "You are caught in your own flames!");
+			set(Message::AreaIgnitesEntity, "A {entity} catches fire.");
+			set(Message::AreaDousesPlayer, "The flames on you hiss out.");
+			set(Message::AreaDousesEntity, "The flames on a {entity} hiss out.");
+
+			for (std::size_t i = 0; i < StatusEffectCount; ++i)
+			{
+				const StatusDescriptor& desc = kStatusTable[i];
+				set(StatusMessageId(i, StatusMessage::PlayerTick), OrEmpty(desc.playerTickMessage));
+				set(StatusMessageId(i, StatusMessage::EntityTick), OrEmpty(desc.entityTickMessage));
+				set(StatusMessageId(i, StatusMessage::PlayerDeath), OrEmpty(desc.playerDeathMessage));
+				set(StatusMessageId(i, StatusMessage::EntityDeath), OrEmpty(desc.entityDeathMessage));
+				set(StatusMessageId(i, StatusMessage::PlayerEnd), OrEmpty(desc.playerEndMessage));
+				set(StatusMessageId(i, StatusMessage::EntityEnd), OrEmpty(desc.entityEndMessage));
+			}
+			return table;
+		}
+
+		constexpr PhraseTable kDefaultPhrases = MakeDefaultPhrases();
+
+		enum class Slot : std::uint8_t
+		{
+			Literal,
+			Entity,
+			Direction,
+			Element,
+			Distance,
+			Count,
+			Steps,
+			Ally
+		};
+
+		constexpr std::pair<std::string_view, Slot> kPlaceholders[] = {
+			{ "entity", Slot::Entity },
+			{ "direction", Slot::Direction },
+			{ "element", Slot::Element },
+			{ "distance", Slot::Distance },
+			{ "count", Slot::Count },
+			{ "steps", Slot::Steps },
+			{ "ally", Slot::Ally },
+		};
+
+		struct Segment
+		{
+			Slot slot;
+			// Literal text, as a range of CompiledPhrases::text
+			std::uint32_t offset;
+			std::uint32_t length;
+		};
+
+		struct CompiledPhrases
+		{
+			std::string text;
+			std::vector<Segment> segments;
+			// First segment and segment count per Message
+			std::array<std::pair<std::uint32_t, std::uint32_t>, MessageCount> ranges{};
+		};
+
+		std::unique_ptr<CompiledPhrases> Compile(const PhraseTable& phrases)
+		{
+			auto compiled = std::make_unique<CompiledPhrases>();
+			for (std::size_t id = 0; id < MessageCount; ++id)
+			{
+				const std::string_view phrase = phrases[id];
+				const std::uint32_t base = static_cast<std::uint32_t>(compiled->text.size());
+				const std::uint32_t first = static_cast<std::uint32_t>(compiled->segments.size());
+				compiled->text.append(phrase);
+
+				std::size_t literalStart = 0;
+				auto flushLiteral = [&](std::size_t end)
+					{
+						if (end > literalStart)
+						{
+							compiled->segments.push_back({ Slot::Literal, base + static_cast<std::uint32_t>(literalStart),
+								static_cast<std::uint32_t>(end - literalStart) });
+						}
+					};
+
+				std::size_t at = 0;
+				while ((at = phrase.find('{', at)) != std::string_view::npos)
+				{
+					const std::size_t close = phrase.find('}', at + 1);
+					if (close == std::string_view::npos)
+						break;
+
+					const std::string_view name = phrase.substr(at + 1, close - at - 1);
+					Slot slot = Slot::Literal;
+					for (const auto& [placeholder, placeholderSlot] : kPlaceholders)
+					{
+						if (placeholder == name)
+							slot = placeholderSlot;
+					}
+					// Unknown names stay in the text as written
+					if (slot == Slot::Literal)
+					{
+						at = close + 1;
+						continue;
+					}
+
+					flushLiteral(at);
+					compiled->segments.push_back({ slot, 0, 0 });
+					literalStart = close + 1;
+					at = close + 1;
+				}
+				flushLiteral(phrase.size());
+
+				compiled->ranges[id] = { first, static_cast<std::uint32_t>(compiled->segments.size()) - first };
+			}
+			return compiled;
+		}
+
+		void Render(const CompiledPhrases& phrases, std::string& out, Message id, const MessageArgs& args, bool nested)
+		{
+			const auto [first, count] = phrases.ranges[static_cast<std::size_t>(id)];
+			for (std::uint32_t i = first; i < first + count; ++i)
+			{
+				const Segment& segment = phrases.segments[i];
+				switch (segment.slot)
+				{
+				case Slot::Literal:
+					out.append(phrases.text, segment.offset, segment.length);
+					break;
+				case Slot::Entity:
+					out.append(args.entity);
+					break;
+				case Slot::Direction:
+					out.append(args.direction);
+					break;
+				case Slot::Element:
+					out.append(args.element);
+					break;
+				case Slot::Distance:
+				case Slot::Count:
+				{
+					char digits[16];
+					const int value = segment.slot == Slot::Distance ? args.distance : args.count;
+					const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+					out.append(digits, result.ptr);
+					break;
+				}
+				case Slot::Steps:
+					// Sub-phrases do not expand sub-phrases, so a table cannot recurse
+					if (!nested)
+					{
+						const Message steps = args.distance <= 1 ? Message::StepsAdjacent
+							: args.distance == 2 ? Message::StepsOne
+							: Message::StepsMany;
+						Render(phrases, out, steps, args, true);
+					}
+					break;
+				case Slot::Ally:
+					if (!nested)
+					{
+						Render(phrases, out, args.entity.empty() ? Message::AllyUnnamed : Message::AllyNamed, args, true);
+					}
+					break;
+				}
+			}
+		}
+
+		std::atomic<const CompiledPhrases*> g_Installed{ nullptr };
+
+		const CompiledPhrases& ActivePhrases()
+		{
+			if (const CompiledPhrases* installed = g_Installed.load(std::memory_order_acquire))
+				return *installed;
+			static const std::unique_ptr<CompiledPhrases> defaults = Compile(kDefaultPhrases);
+			return *defaults;
+		}
+	}
+
+	const PhraseTable& Messages::GetDefaultPhrases()
+	{
+		return kDefaultPhrases;
+	}
+
+	void Messages::SetPhrases(const PhraseTable& phrases)
+	{
+		// Replaced tables are kept, since another thread may still be rendering from one
+		static std::mutex mutex;
+		static std::vector<std::unique_ptr<CompiledPhrases>> tables;
+
+		std::unique_ptr<CompiledPhrases> compiled = Compile(phrases);
+		std::lock_guard<std::mutex> lock(mutex);
+		g_Installed.store(compiled.get(), std::memory_order_release);
+		tables.push_back(std::move(compiled));
+	}
+
+	void Messages::Append(std::string& out, Message id, const MessageArgs& args)
+	{
+		if (static_cast<std::size_t>(id) >= MessageCount)
+			return;
+		Render(ActivePhrases(), out, id, args, false);
+	}
+}
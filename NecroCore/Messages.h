@@ -0,0 +1,120 @@
+#pragma once
+
+#include "Status.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace NecroCore
+{
+	// Every line of turn narration. Status messages follow in blocks of
+	// StatusMessage::Count per kStatusTable row, see StatusMessageId.
+	enum class Message : std::uint16_t
+	{
+		StepsAdjacent,
+		StepsOne,
+		StepsMany,
+		AllyUnnamed,
+		AllyNamed,
+
+		PulseDoor,
+		PulseHearth,
+		PulseHostile,
+		PulseFriendly,
+		PulsePresence,
+		PulseFireTrap,
+		PulsePoisonTrap,
+		PulseTrap,
+
+		TrapFire,
+		TrapPoison,
+		TrapOther,
+		CastFizzles,
+
+		HostileClaws,
+		HostileShuffles,
+		HostileSlaysAlly,
+		HostileHitsAlly,
+		PlayerCollapses,
+
+		AllyMoves,
+		AllyReturns,
+		AllyNoTargets,
+		AllyFoeCrumbles,
+		AllyStrikes,
+		AllyStalks,
+
+		Explosion,
+		ExplosionHitsPlayer,
+		ExplosionHitsEntity,
+		TrapRearms,
+
+		// Area spells, one per AreaShape from Line onwards, see SpellArea::MessageFor
+		FireLine,
+		FireCone,
+		FireRadius,
+		WaterLine,
+		WaterCone,
+		WaterRadius,
+		AreaIgnitesPlayer,
+		AreaIgnitesEntity,
+		AreaDousesPlayer,
+		AreaDousesEntity,
+
+		StatusFirst
+	};
+
+	enum class StatusMessage : std::uint8_t
+	{
+		PlayerTick,
+		EntityTick,
+		PlayerDeath,
+		EntityDeath,
+		PlayerEnd,
+		EntityEnd,
+		Count
+	};
+
+	inline constexpr std::size_t MessageCount =
+		static_cast<std::size_t>(Message::StatusFirst) + StatusEffectCount * static_cast<std::size_t>(StatusMessage::Count);
+
+	inline constexpr Message StatusMessageId(std::size_t statusIndex, StatusMessage kind)
+	{
+		return static_cast<Message>(static_cast<std::size_t>(Message::StatusFirst) +
+			statusIndex * static_cast<std::size_t>(StatusMessage::Count) + static_cast<std::size_t>(kind));
+	}
+
+	// One template per Message. Placeholders: {entity}, {direction}, {element},
+	// {distance}, {count}, plus {steps} and {ally}, which expand to the StepsAdjacent /
+	// StepsOne / StepsMany and AllyUnnamed / AllyNamed phrases of the same table.
+	using PhraseTable = std::array<std::string_view, MessageCount>;
+
+	struct MessageArgs
+	{
+		std::string_view entity{};
+		std::string_view direction{};
+		std::string_view element{};
+		int distance = 0;
+		int count = 0;
+	};
+
+	// Renders narration from templates that are split into literal and
+	// placeholder segments once, when a phrase table is installed. Rendering
+	// appends straight into the caller's buffer and never allocates beyond
+	// growing it.
+	class Messages
+	{
+	public:
+		static const PhraseTable& GetDefaultPhrases();
+
+		// Compiles `phrases` and makes it the table for every game in the process.
+		// The strings are copied, so the table need not outlive the call. Meant for
+		// startup; games already rendering keep a valid, older table until they finish.
+		static void SetPhrases(const PhraseTable& phrases);
+
+		static void Append(std::string& out, Message id, const MessageArgs& args = {});
+	};
+}
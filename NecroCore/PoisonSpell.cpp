@@ -0,0 +1,28 @@
+#include "Spell.h"
+#include "CastResult.h"
+#include "Messages.h"
+#include "Status.h"
+
+namespace NecroCore
+{
+    // Poison is a known element, so casting it is a valid command, but it has no
+    // effect yet and always fizzles.
+    class PoisonSpell : public ISpell
+    {
+    public:
+        const char* GetName() const override { return "poison"; }
+        StatusEffect GetElement() const override { return StatusEffect::Poisoned; }
+
+        CastResult Cast(Game&, int, int, const std::string& direction) const override
+        {
+            CastResult result{};
+            MessageArgs args;
+            args.element = GetName();
+            args.direction = direction;
+            Messages::Append(result.description, Message::CastFizzles, args);
+            return result;
+        }
+    };
+
+    NECRO_REGISTER_SPELL(PoisonSpell);
+}
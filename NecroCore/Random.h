@@ -0,0 +1,93 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace NecroCore
+{
+	// xoshiro256** generator. Every Game owns its own instance, so a session is
+	// fully reproducible from its seed and games never share generator state.
+	class Random
+	{
+	public:
+		static constexpr std::uint64_t DefaultSeed = 0x9E3779B97F4A7C15ull;
+
+		using State = std::array<std::uint64_t, 4>;
+
+		explicit Random(std::uint64_t seed = DefaultSeed)
+		{
+			Seed(seed);
+		}
+
+		void Seed(std::uint64_t seed)
+		{
+			m_Seed = seed;
+
+			// splitmix64 expands the seed so that nearby seeds give unrelated streams
+			std::uint64_t z = seed;
+			for (std::uint64_t& word : m_State)
+			{
+				z += 0x9E3779B97F4A7C15ull;
+				std::uint64_t v = z;
+				v = (v ^ (v >> 30)) * 0xBF58476D1CE4E5B9ull;
+				v = (v ^ (v >> 27)) * 0x94D049BB133111EBull;
+				word = v ^ (v >> 31);
+			}
+		}
+
+		std::uint64_t GetSeed() const { return m_Seed; }
+
+		const State& GetState() const { return m_State; }
+		void SetState(const State& state) { m_State = state; }
+
+		std::uint64_t NextU64()
+		{
+			const std::uint64_t result = Rotl(m_State[1] * 5, 7) * 9;
+			const std::uint64_t t = m_State[1] << 17;
+
+			m_State[2] ^= m_State[0];
+			m_State[3] ^= m_State[1];
+			m_State[1] ^= m_State[2];
+			m_State[0] ^= m_State[3];
+			m_State[2] ^= t;
+			m_State[3] = Rotl(m_State[3], 45);
+
+			return result;
+		}
+
+		std::uint32_t NextU32()
+		{
+			return static_cast<std::uint32_t>(NextU64() >> 32);
+		}
+
+		// Uniform value in [0, bound). Multiply-shift keeps it branch-free; the
+		// bias is below 2^-32 for the small ranges the game uses.
+		std::uint32_t NextBelow(std::uint32_t bound)
+		{
+			return static_cast<std::uint32_t>((static_cast<std::uint64_t>(NextU32()) * bound) >> 32);
+		}
+
+		// Uniform value in [minInclusive, maxInclusive].
+		int NextInt(int minInclusive, int maxInclusive)
+		{
+			if (maxInclusive <= minInclusive)
+				return minInclusive;
+			const std::uint32_t span = static_cast<std::uint32_t>(maxInclusive - minInclusive) + 1u;
+			return minInclusive + static_cast<int>(NextBelow(span));
+		}
+
+		bool NextBool()
+		{
+			return (NextU64() >> 63) != 0;
+		}
+
+	private:
+		static std::uint64_t Rotl(std::uint64_t x, int k)
+		{
+			return (x << k) | (x >> (64 - k));
+		}
+
+		std::uint64_t m_Seed = DefaultSeed;
+		State m_State{};
+	};
+}
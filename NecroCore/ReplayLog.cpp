@@ -0,0 +1,268 @@
+#include "ReplayLog.h"
+#include "Game.h"
+#include "Log.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+namespace NecroCore
+{
+	namespace
+	{
+		// Smallest encoded turn in any version: an undo entry's kind, count and hash
+		constexpr std::size_t kMinTurnBytes = sizeof(std::uint8_t) + sizeof(std::uint16_t) + sizeof(std::uint64_t);
+
+		template <typename T>
+		void Append(std::vector<std::uint8_t>& out, T value)
+		{
+			const std::size_t old = out.size();
+			out.resize(old + sizeof(T));
+			std::memcpy(out.data() + old, &value, sizeof(T));
+		}
+
+		template <typename T>
+		bool Read(const std::uint8_t* data, std::size_t size, std::size_t& offset, T& value)
+		{
+			if (size - offset < sizeof(T))
+				return false;
+			std::memcpy(&value, data + offset, sizeof(T));
+			offset += sizeof(T);
+			return true;
+		}
+
+		// String lengths were 16 bits before version 2
+		bool ReadLength(const std::uint8_t* data, std::size_t size, std::size_t& offset, std::uint16_t version, std::uint32_t& length)
+		{
+			if (version >= 2)
+				return Read(data, size, offset, length);
+			std::uint16_t narrow = 0;
+			if (!Read(data, size, offset, narrow))
+				return false;
+			length = narrow;
+			return true;
+		}
+	}
+
+	void ReplayLog::Reset(const std::string& playerName, const std::string& mapName, std::uint64_t seed)
+	{
+		m_PlayerName = playerName;
+		m_MapName = mapName;
+		m_Seed = seed;
+		m_Commands.clear();
+		m_Deferred.clear();
+		m_Turns.clear();
+	}
+
+	void ReplayLog::AppendTurn(std::string_view command, std::uint64_t stateHash, const std::vector<int>& deferredHostiles)
+	{
+		Turn turn{};
+		turn.commandOffset = static_cast<std::uint32_t>(m_Commands.size());
+		turn.commandLength = static_cast<std::uint32_t>(command.size());
+		turn.deferredOffset = static_cast<std::uint32_t>(m_Deferred.size());
+		turn.deferredCount = static_cast<std::uint32_t>(deferredHostiles.size());
+		turn.stateHash = stateHash;
+		turn.kind = ReplayEntryKind::Command;
+		m_Commands.append(command);
+		m_Deferred.insert(m_Deferred.end(), deferredHostiles.begin(), deferredHostiles.end());
+		m_Turns.push_back(turn);
+	}
+
+	void ReplayLog::AppendUndo(int turns, std::uint64_t stateHash)
+	{
+		Turn turn{};
+		turn.commandOffset = static_cast<std::uint32_t>(m_Commands.size());
+		turn.deferredOffset = static_cast<std::uint32_t>(m_Deferred.size());
+		turn.stateHash = stateHash;
+		turn.kind = ReplayEntryKind::Undo;
+		turn.undoTurns = static_cast<std::uint16_t>(turns);
+		m_Turns.push_back(turn);
+	}
+
+	std::string_view ReplayLog::GetCommand(std::size_t turn) const
+	{
+		const Turn& t = m_Turns[turn];
+		return std::string_view(m_Commands).substr(t.commandOffset, t.commandLength);
+	}
+
+	std::vector<int> ReplayLog::GetDeferredHostiles(std::size_t turn) const
+	{
+		const Turn& t = m_Turns[turn];
+		const auto first = m_Deferred.begin() + t.deferredOffset;
+		return std::vector<int>(first, first + t.deferredCount);
+	}
+
+	std::vector<std::uint8_t> ReplayLog::Serialize() const
+	{
+		std::vector<std::uint8_t> out;
+		out.reserve(32 + m_PlayerName.size() + m_MapName.size() + m_Commands.size() + m_Deferred.size() * sizeof(std::int32_t) +
+			m_Turns.size() * 17);
+
+		Append(out, Magic);
+		Append(out, Version);
+		Append(out, static_cast<std::uint16_t>(0));
+		Append(out, m_Seed);
+		Append(out, static_cast<std::uint32_t>(m_PlayerName.size()));
+		Append(out, static_cast<std::uint32_t>(m_MapName.size()));
+		Append(out, static_cast<std::uint32_t>(m_Turns.size()));
+		out.insert(out.end(), m_PlayerName.begin(), m_PlayerName.end());
+		out.insert(out.end(), m_MapName.begin(), m_MapName.end());
+
+		for (std::size_t i = 0; i < m_Turns.size(); ++i)
+		{
+			Append(out, static_cast<std::uint8_t>(m_Turns[i].kind));
+			if (m_Turns[i].kind == ReplayEntryKind::Undo)
+			{
+				Append(out, m_Turns[i].undoTurns);
+			}
+			else
+			{
+				const std::string_view command = GetCommand(i);
+				Append(out, static_cast<std::uint32_t>(command.size()));
+				out.insert(out.end(), command.begin(), command.end());
+				Append(out, m_Turns[i].deferredCount);
+				for (std::uint32_t d = 0; d < m_Turns[i].deferredCount; ++d)
+				{
+					Append(out, static_cast<std::int32_t>(m_Deferred[m_Turns[i].deferredOffset + d]));
+				}
+			}
+			Append(out, m_Turns[i].stateHash);
+		}
+		return out;
+	}
+
+	bool ReplayLog::Deserialize(const std::uint8_t* data, std::size_t size)
+	{
+		std::size_t offset = 0;
+		std::uint32_t magic = 0;
+		std::uint16_t version = 0;
+		std::uint16_t reserved = 0;
+		std::uint64_t seed = 0;
+		std::uint32_t playerNameLength = 0;
+		std::uint32_t mapNameLength = 0;
+		std::uint32_t turnCount = 0;
+
+		if (!Read(data, size, offset, magic) || magic != Magic)
+			return false;
+		if (!Read(data, size, offset, version) || version < 1 || version > Version)
+			return false;
+		if (!Read(data, size, offset, reserved) || !Read(data, size, offset, seed) ||
+			!ReadLength(data, size, offset, version, playerNameLength) || !ReadLength(data, size, offset, version, mapNameLength) ||
+			!Read(data, size, offset, turnCount))
+		{
+			return false;
+		}
+		if (size - offset < static_cast<std::size_t>(playerNameLength) + mapNameLength)
+			return false;
+
+		Reset(std::string(reinterpret_cast<const char*>(data + offset), playerNameLength),
+			std::string(reinterpret_cast<const char*>(data + offset + playerNameLength), mapNameLength),
+			seed);
+		offset += static_cast<std::size_t>(playerNameLength) + mapNameLength;
+
+		// The count comes from the file; only trust it as far as the bytes left could hold
+		if ((size - offset) / kMinTurnBytes < turnCount)
+			return false;
+		m_Turns.reserve(turnCount);
+		for (std::uint32_t i = 0; i < turnCount; ++i)
+		{
+			std::uint8_t kind = 0;
+			std::uint64_t hash = 0;
+			if (!Read(data, size, offset, kind))
+				return false;
+
+			if (kind == static_cast<std::uint8_t>(ReplayEntryKind::Undo))
+			{
+				std::uint16_t undoTurns = 0;
+				if (!Read(data, size, offset, undoTurns) || !Read(data, size, offset, hash))
+					return false;
+				AppendUndo(undoTurns, hash);
+				continue;
+			}
+			std::uint32_t length = 0;
+			if (kind != static_cast<std::uint8_t>(ReplayEntryKind::Command) || !ReadLength(data, size, offset, version, length) ||
+				size - offset < length)
+				return false;
+
+			const std::string_view command(reinterpret_cast<const char*>(data + offset), length);
+			offset += length;
+
+			std::vector<int> deferred;
+			if (version >= 3)
+			{
+				std::uint32_t deferredCount = 0;
+				if (!Read(data, size, offset, deferredCount) || (size - offset) / sizeof(std::int32_t) < deferredCount)
+					return false;
+				deferred.resize(deferredCount);
+				for (std::uint32_t d = 0; d < deferredCount; ++d)
+				{
+					std::int32_t id = 0;
+					Read(data, size, offset, id);
+					deferred[d] = id;
+				}
+			}
+			if (!Read(data, size, offset, hash))
+				return false;
+			AppendTurn(command, hash, deferred);
+		}
+		return offset == size;
+	}
+
+	bool ReplayLog::SaveToFile(const std::string& path) const
+	{
+		const std::vector<std::uint8_t> bytes = Serialize();
+		std::ofstream out(path, std::ios::binary | std::ios::trunc);
+		if (!out)
+			return false;
+		out.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+		return static_cast<bool>(out);
+	}
+
+	bool ReplayLog::LoadFromFile(const std::string& path)
+	{
+		std::ifstream in(path, std::ios::binary);
+		if (!in)
+			return false;
+		const std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		return Deserialize(bytes.data(), bytes.size());
+	}
+
+	ReplayReport ReplayRunner::Run(const ReplayLog& log, bool stopOnMismatch)
+	{
+		ReplayReport report{};
+		if (!Game::IsKnownMap(log.GetMapName()))
+			return report;
+		report.loaded = true;
+
+		ScopedTraceSilence silence;
+		Game game(log.GetPlayerName(), log.GetMapName(), log.GetSeed());
+
+		std::string command;
+		for (std::size_t turn = 0; turn < log.GetTurnCount(); ++turn)
+		{
+			if (log.GetKind(turn) == ReplayEntryKind::Undo)
+			{
+				game.Undo(log.GetUndoTurns(turn));
+			}
+			else
+			{
+				// Hostiles the live turn deferred stay deferred on replay
+				command.assign(log.GetCommand(turn));
+				game.ReplayTurn(command, log.GetDeferredHostiles(turn));
+			}
+			++report.turnsReplayed;
+
+			const std::uint64_t actual = game.ComputeStateHash();
+			if (actual != log.GetStateHash(turn) && report.matched)
+			{
+				report.matched = false;
+				report.firstMismatchTurn = turn;
+				report.expectedHash = log.GetStateHash(turn);
+				report.actualHash = actual;
+				if (stopOnMismatch)
+					break;
+			}
+		}
+		return report;
+	}
+}
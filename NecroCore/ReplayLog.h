@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace NecroCore
+{
+	enum class ReplayEntryKind : std::uint8_t
+	{
+		Command,
+		Undo
+	};
+
+	// Everything needed to reproduce a session: the seed, map and player name
+	// the Game was created with, and every command passed to ApplyTurn (or Undo
+	// call) together with the state hash observed after it and the hostiles the
+	// turn budget deferred. Commands share one string buffer and deferred ids
+	// one vector.
+	class ReplayLog
+	{
+	public:
+		static constexpr std::uint32_t Magic = 0x4C524E42; // "BNRL"
+		// Version 2 widened name and command lengths to 32 bits, version 3 added
+		// deferred hostiles; older logs still load
+		static constexpr std::uint16_t Version = 3;
+
+		void Reset(const std::string& playerName, const std::string& mapName, std::uint64_t seed);
+		void AppendTurn(std::string_view command, std::uint64_t stateHash, const std::vector<int>& deferredHostiles = {});
+		void AppendUndo(int turns, std::uint64_t stateHash);
+
+		const std::string& GetPlayerName() const { return m_PlayerName; }
+		const std::string& GetMapName() const { return m_MapName; }
+		std::uint64_t GetSeed() const { return m_Seed; }
+
+		std::size_t GetTurnCount() const { return m_Turns.size(); }
+		ReplayEntryKind GetKind(std::size_t turn) const { return m_Turns[turn].kind; }
+		std::string_view GetCommand(std::size_t turn) const;
+		int GetUndoTurns(std::size_t turn) const { return static_cast<int>(m_Turns[turn].undoTurns); }
+		std::uint64_t GetStateHash(std::size_t turn) const { return m_Turns[turn].stateHash; }
+		std::vector<int> GetDeferredHostiles(std::size_t turn) const;
+
+		std::size_t GetMemoryUsage() const
+		{
+			return m_PlayerName.capacity() + m_MapName.capacity() + m_Commands.capacity() + m_Deferred.capacity() * sizeof(int) +
+				m_Turns.capacity() * sizeof(Turn);
+		}
+
+		std::vector<std::uint8_t> Serialize() const;
+		bool Deserialize(const std::uint8_t* data, std::size_t size);
+
+		bool SaveToFile(const std::string& path) const;
+		bool LoadFromFile(const std::string& path);
+
+	private:
+		struct Turn
+		{
+			std::uint32_t commandOffset;
+			std::uint32_t commandLength;
+			std::uint32_t deferredOffset;
+			std::uint32_t deferredCount;
+			std::uint64_t stateHash;
+			ReplayEntryKind kind;
+			std::uint16_t undoTurns;
+		};
+
+		std::string m_PlayerName;
+		std::string m_MapName;
+		std::uint64_t m_Seed = 0;
+		std::string m_Commands;
+		std::vector<int> m_Deferred;
+		std::vector<Turn> m_Turns;
+	};
+
+	struct ReplayReport
+	{
+		bool loaded = false;
+		bool matched = true;
+		std::size_t turnsReplayed = 0;
+		std::size_t firstMismatchTurn = 0;
+		std::uint64_t expectedHash = 0;
+		std::uint64_t actualHash = 0;
+	};
+
+	class ReplayRunner
+	{
+	public:
+		// Replays the log on a fresh Game with tracing silenced and compares the
+		// state hash after every turn against the recorded one.
+		static ReplayReport Run(const ReplayLog& log, bool stopOnMismatch = true);
+	};
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Schema.h"
+#include "Entity.h"
+#include "PulseResult.h"
+#include "MoveResult.h"
+#include "SummonResult.h"
+#include "AttackResult.h"
+#include "SummonCommandResult.h"
+#include "CastResult.h"
+
+namespace NecroCore
+{
+	// Field names are the JSON keys clients read; binary encodings follow the
+	// same order, so append new fields at the end of a list.
+
+	template <>
+	struct Schema<Entity>
+	{
+		static constexpr auto fields = std::make_tuple(
+			SchemaField("entityId", &Entity::id),
+			SchemaField("x", &Entity::x),
+			SchemaField("y", &Entity::y),
+			SchemaField("faction", &Entity::faction),
+			SchemaField("hp", &Entity::hp),
+			SchemaField("maxHp", &Entity::maxHp),
+			SchemaField("attackDamage", &Entity::attackDamage));
+	};
+
+	template <>
+	struct Schema<PulseResult>
+	{
+		static constexpr std::string_view type = "pulse";
+		static constexpr auto fields = std::make_tuple(
+			SchemaField("detectedHostileCount", &PulseResult::detectedHostileCount),
+			SchemaField("detectedFriendlyCount", &PulseResult::detectedFriendlyCount),
+			SchemaField("detectedTrapCount", &PulseResult::detectedTrapCount));
+	};
+
+	template <>
+	struct Schema<MoveResult>
+	{
+		static constexpr std::string_view type = "move";
+		static constexpr auto fields = std::make_tuple(
+			SchemaField("oldX", &MoveResult::oldX),
+			SchemaField("oldY", &MoveResult::oldY),
+			SchemaField("newX", &MoveResult::newX),
+			SchemaField("newY", &MoveResult::newY));
+	};
+
+	template <>
+	struct Schema<SummonResult>
+	{
+		static constexpr std::string_view type = "summon";
+		static constexpr auto fields = std::make_tuple(
+			SchemaInline(&SummonResult::summonedEntity),
+			SchemaField("direction", &SummonResult::summonedDirection));
+	};
+
+	template <>
+	struct Schema<AttackResult>
+	{
+		static constexpr std::string_view type = "attack";
+		static constexpr auto fields = std::make_tuple(
+			SchemaField("hit", &AttackResult::hit),
+			SchemaField("targetEntityId", &AttackResult::targetEntityId),
+			SchemaField("targetX", &AttackResult::targetX),
+			SchemaField("targetY", &AttackResult::targetY),
+			SchemaField("damageDealt", &AttackResult::damageDealt),
+			SchemaField("targetDied", &AttackResult::targetDied));
+	};
+
+	template <>
+	struct Schema<SummonCommandResult>
+	{
+		static constexpr std::string_view type = "command";
+		static constexpr auto fields = std::make_tuple(
+			SchemaField("success", &SummonCommandResult::success),
+			SchemaField("target", &SummonCommandResult::creature),
+			SchemaField("order", &SummonCommandResult::order),
+			SchemaField("alliesOrdered", &SummonCommandResult::alliesOrdered));
+	};
+
+	template <>
+	struct Schema<CastResult>
+	{
+		static constexpr std::string_view type = "cast";
+		static constexpr auto fields = std::make_tuple(
+			SchemaField("tilesAffected", &CastResult::tilesAffected),
+			SchemaField("actorsAffected", &CastResult::actorsAffected));
+	};
+}
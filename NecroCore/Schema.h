@@ -0,0 +1,251 @@
+#pragma once
+
+#include "JsonWriter.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+namespace NecroCore
+{
+	// Compile-time field lists for plain result structs. Specialize Schema<T>
+	// with a `type` name and a `fields` tuple built from SchemaField / SchemaInline;
+	// the writers and reader below walk that tuple, so adding a member to a
+	// result is one line in its schema. Members may be integers, enums, bool,
+	// std::string, or structs that have a schema of their own.
+	template <typename T>
+	struct Schema;
+
+	template <typename Owner, typename Member>
+	struct FieldDef
+	{
+		std::string_view name;
+		Member Owner::* member;
+		// Write the nested struct's fields into the enclosing object
+		bool inlined;
+	};
+
+	template <typename Owner, typename Member>
+	constexpr FieldDef<Owner, Member> SchemaField(std::string_view name, Member Owner::* member)
+	{
+		return { name, member, false };
+	}
+
+	template <typename Owner, typename Member>
+	constexpr FieldDef<Owner, Member> SchemaInline(Member Owner::* member)
+	{
+		return { {}, member, true };
+	}
+
+	template <typename T, typename = void>
+	struct HasSchema : std::false_type {};
+	template <typename T>
+	struct HasSchema<T, std::void_t<decltype(Schema<T>::fields)>> : std::true_type {};
+
+	template <typename T, typename Visitor>
+	constexpr void ForEachSchemaField(Visitor&& visit)
+	{
+		std::apply([&](const auto&... field) { (visit(field), ...); }, Schema<T>::fields);
+	}
+
+	// ---- JSON ----
+
+	template <typename T>
+	void WriteSchemaFieldsJson(JsonWriter& json, const T& value);
+
+	template <typename Member>
+	void WriteSchemaValueJson(JsonWriter& json, const Member& value)
+	{
+		if constexpr (std::is_same_v<Member, bool>)
+			json.Bool(value);
+		else if constexpr (std::is_enum_v<Member>)
+			json.Int(static_cast<std::int64_t>(value));
+		else if constexpr (std::is_integral_v<Member> && std::is_signed_v<Member>)
+			json.Int(value);
+		else if constexpr (std::is_integral_v<Member>)
+			json.Uint(value);
+		else if constexpr (std::is_same_v<Member, std::string>)
+			json.String(value);
+		else
+		{
+			static_assert(HasSchema<Member>::value, "Schema member needs a Schema<> of its own");
+			json.BeginObject();
+			WriteSchemaFieldsJson(json, value);
+			json.EndObject();
+		}
+	}
+
+	template <typename T>
+	void WriteSchemaFieldsJson(JsonWriter& json, const T& value)
+	{
+		ForEachSchemaField<T>([&](const auto& field)
+			{
+				const auto& member = value.*field.member;
+				using Member = std::decay_t<decltype(member)>;
+				if constexpr (HasSchema<Member>::value)
+				{
+					if (field.inlined)
+					{
+						WriteSchemaFieldsJson(json, member);
+						return;
+					}
+				}
+				json.Key(field.name);
+				WriteSchemaValueJson(json, member);
+			});
+	}
+
+	// ---- Binary ----
+	//
+	// Fields in schema order with no names or tags: integers and enums as
+	// LEB128 varints (signed ones zigzagged), bool as one byte, strings as a
+	// varint length and the bytes, nested structs inline.
+
+	inline void WriteVarint(std::string& out, std::uint64_t value)
+	{
+		while (value >= 0x80)
+		{
+			out += static_cast<char>(static_cast<std::uint8_t>(value) | 0x80);
+			value >>= 7;
+		}
+		out += static_cast<char>(value);
+	}
+
+	inline std::uint64_t ZigZag(std::int64_t value)
+	{
+		return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+	}
+
+	inline std::int64_t UnZigZag(std::uint64_t value)
+	{
+		return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+	}
+
+	template <typename T>
+	void WriteSchemaBinary(std::string& out, const T& value);
+
+	template <typename Member>
+	void WriteSchemaValueBinary(std::string& out, const Member& value)
+	{
+		if constexpr (std::is_same_v<Member, bool>)
+			out += static_cast<char>(value ? 1 : 0);
+		else if constexpr (std::is_enum_v<Member>)
+			WriteVarint(out, ZigZag(static_cast<std::int64_t>(value)));
+		else if constexpr (std::is_integral_v<Member> && std::is_signed_v<Member>)
+			WriteVarint(out, ZigZag(value));
+		else if constexpr (std::is_integral_v<Member>)
+			WriteVarint(out, value);
+		else if constexpr (std::is_same_v<Member, std::string>)
+		{
+			WriteVarint(out, value.size());
+			out.append(value);
+		}
+		else
+			WriteSchemaBinary(out, value);
+	}
+
+	template <typename T>
+	void WriteSchemaBinary(std::string& out, const T& value)
+	{
+		ForEachSchemaField<T>([&](const auto& field) { WriteSchemaValueBinary(out, value.*field.member); });
+	}
+
+	// Reads what WriteSchemaBinary wrote. Every read is bounds checked; after a
+	// short or malformed buffer IsValid() is false and the values are unspecified.
+	class SchemaReader
+	{
+	public:
+		explicit SchemaReader(std::string_view bytes) : m_Bytes(bytes) {}
+
+		bool IsValid() const { return m_Valid; }
+		bool AtEnd() const { return m_At == m_Bytes.size(); }
+		std::size_t GetOffset() const { return m_At; }
+
+		bool ReadVarint(std::uint64_t& value)
+		{
+			value = 0;
+			for (int shift = 0; shift < 64; shift += 7)
+			{
+				if (m_At >= m_Bytes.size())
+					return Fail();
+				const std::uint8_t byte = static_cast<std::uint8_t>(m_Bytes[m_At++]);
+				value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+				if ((byte & 0x80) == 0)
+					return true;
+			}
+			return Fail();
+		}
+
+		bool ReadBytes(std::size_t count, std::string_view& out)
+		{
+			if (m_Bytes.size() - m_At < count)
+				return Fail();
+			out = m_Bytes.substr(m_At, count);
+			m_At += count;
+			return true;
+		}
+
+		template <typename T>
+		bool Read(T& value)
+		{
+			ForEachSchemaField<T>([&](const auto& field) { ReadValue(value.*field.member); });
+			return m_Valid;
+		}
+
+		template <typename Member>
+		void ReadValue(Member& value)
+		{
+			if (!m_Valid)
+				return;
+			if constexpr (std::is_same_v<Member, bool>)
+			{
+				std::string_view byte;
+				if (ReadBytes(1, byte))
+					value = byte[0] != 0;
+			}
+			else if constexpr (std::is_enum_v<Member>)
+			{
+				std::uint64_t raw = 0;
+				if (ReadVarint(raw))
+					value = static_cast<Member>(UnZigZag(raw));
+			}
+			else if constexpr (std::is_integral_v<Member>)
+			{
+				std::uint64_t raw = 0;
+				if (ReadVarint(raw))
+				{
+					if constexpr (std::is_signed_v<Member>)
+						value = static_cast<Member>(UnZigZag(raw));
+					else
+						value = static_cast<Member>(raw);
+				}
+			}
+			else if constexpr (std::is_same_v<Member, std::string>)
+			{
+				std::uint64_t length = 0;
+				std::string_view text;
+				if (ReadVarint(length) && ReadBytes(static_cast<std::size_t>(length), text))
+					value.assign(text);
+			}
+			else
+			{
+				Read(value);
+			}
+		}
+
+	private:
+		bool Fail()
+		{
+			m_Valid = false;
+			m_At = m_Bytes.size();
+			return false;
+		}
+
+		std::string_view m_Bytes;
+		std::size_t m_At = 0;
+		bool m_Valid = true;
+	};
+}
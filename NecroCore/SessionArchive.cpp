@@ -0,0 +1,222 @@
+#include "SessionArchive.h"
+
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+
+namespace NecroCore
+{
+	SessionArchive::SessionArchive(std::string path)
+		: m_Path(std::move(path))
+	{
+		if (!OpenTruncated(m_Path))
+			std::cerr << "[SessionArchive] Cannot open " << m_Path << ", archived sessions will be dropped\n";
+	}
+
+	SessionArchive::~SessionArchive() = default;
+
+	bool SessionArchive::OpenTruncated(const std::string& path)
+	{
+		if (m_File.is_open())
+			m_File.close();
+		m_File.open(path, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+		m_FileBytes = 0;
+		m_DeadBytes = 0;
+		return m_File.is_open();
+	}
+
+	bool SessionArchive::AppendRecord(std::fstream& file, std::uint64_t offset, std::string_view sessionId, const std::uint8_t* image, std::uint32_t imageLength)
+	{
+		RecordHeader header{};
+		header.magic = RecordMagic;
+		header.idLength = static_cast<std::uint32_t>(sessionId.size());
+		header.imageLength = imageLength;
+
+		file.clear();
+		file.seekp(static_cast<std::streamoff>(offset));
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(sessionId.data(), static_cast<std::streamsize>(sessionId.size()));
+		file.write(reinterpret_cast<const char*>(image), imageLength);
+		file.flush();
+		return static_cast<bool>(file);
+	}
+
+	void SessionArchive::Forget(std::unordered_map<std::string, Entry, IdHash, std::equal_to<>>::iterator it)
+	{
+		m_DeadBytes += it->second.recordLength;
+		m_Index.erase(it);
+	}
+
+	bool SessionArchive::Put(std::string_view sessionId, const std::vector<std::uint8_t>& image)
+	{
+		std::lock_guard lock(m_Mutex);
+		if (!m_File.is_open() || image.size() > UINT32_MAX)
+			return false;
+
+		const std::uint64_t offset = m_FileBytes;
+		const std::uint32_t imageLength = static_cast<std::uint32_t>(image.size());
+		if (!AppendRecord(m_File, offset, sessionId, image.data(), imageLength))
+		{
+			// Whatever got written is unreferenced; count it as dead and carry on
+			m_File.clear();
+			m_File.seekp(0, std::ios::end);
+			const std::streamoff end = m_File.tellp();
+			if (end > 0 && static_cast<std::uint64_t>(end) > m_FileBytes)
+			{
+				m_DeadBytes += static_cast<std::uint64_t>(end) - m_FileBytes;
+				m_FileBytes = static_cast<std::uint64_t>(end);
+			}
+			return false;
+		}
+
+		Entry entry{};
+		entry.offset = offset;
+		entry.imageLength = imageLength;
+		entry.recordLength = static_cast<std::uint32_t>(sizeof(RecordHeader) + sessionId.size() + imageLength);
+		m_FileBytes += entry.recordLength;
+
+		auto it = m_Index.find(sessionId);
+		if (it != m_Index.end())
+		{
+			m_DeadBytes += it->second.recordLength;
+			it->second = entry;
+		}
+		else
+		{
+			m_Index.emplace(std::string(sessionId), entry);
+		}
+		return true;
+	}
+
+	bool SessionArchive::Take(std::string_view sessionId, std::vector<std::uint8_t>& image)
+	{
+		std::lock_guard lock(m_Mutex);
+		auto it = m_Index.find(sessionId);
+		if (it == m_Index.end())
+			return false;
+
+		const Entry entry = it->second;
+		Forget(it);
+		return ReadRecord(entry, sessionId, image);
+	}
+
+	bool SessionArchive::Read(std::string_view sessionId, std::vector<std::uint8_t>& image)
+	{
+		std::lock_guard lock(m_Mutex);
+		auto it = m_Index.find(sessionId);
+		return it != m_Index.end() && ReadRecord(it->second, sessionId, image);
+	}
+
+	bool SessionArchive::ReadRecord(const Entry& entry, std::string_view sessionId, std::vector<std::uint8_t>& image)
+	{
+		RecordHeader header{};
+		m_File.clear();
+		m_File.seekg(static_cast<std::streamoff>(entry.offset));
+		m_File.read(reinterpret_cast<char*>(&header), sizeof(header));
+		if (!m_File || header.magic != RecordMagic || header.idLength != sessionId.size() || header.imageLength != entry.imageLength)
+			return false;
+
+		m_File.seekg(static_cast<std::streamoff>(header.idLength), std::ios::cur);
+		image.resize(entry.imageLength);
+		m_File.read(reinterpret_cast<char*>(image.data()), static_cast<std::streamsize>(entry.imageLength));
+		return static_cast<bool>(m_File);
+	}
+
+	bool SessionArchive::Erase(std::string_view sessionId)
+	{
+		std::lock_guard lock(m_Mutex);
+		auto it = m_Index.find(sessionId);
+		if (it == m_Index.end())
+			return false;
+		Forget(it);
+		return true;
+	}
+
+	bool SessionArchive::Contains(std::string_view sessionId) const
+	{
+		std::lock_guard lock(m_Mutex);
+		return m_Index.find(sessionId) != m_Index.end();
+	}
+
+	bool SessionArchive::Compact(std::size_t minDeadBytes)
+	{
+		std::lock_guard lock(m_Mutex);
+		if (!m_File.is_open() || m_DeadBytes == 0 || m_DeadBytes < minDeadBytes || m_DeadBytes <= m_FileBytes - m_DeadBytes)
+			return false;
+
+		const std::string temporary = m_Path + ".tmp";
+		std::fstream out(temporary, std::ios::binary | std::ios::in | std::ios::out | std::ios::trunc);
+		if (!out)
+			return false;
+
+		std::unordered_map<std::string, Entry, IdHash, std::equal_to<>> index;
+		index.reserve(m_Index.size());
+		std::vector<std::uint8_t> image;
+		std::uint64_t written = 0;
+		for (const auto& [id, entry] : m_Index)
+		{
+			const std::uint64_t imageOffset = entry.offset + sizeof(RecordHeader) + id.size();
+			image.resize(entry.imageLength);
+			m_File.clear();
+			m_File.seekg(static_cast<std::streamoff>(imageOffset));
+			m_File.read(reinterpret_cast<char*>(image.data()), static_cast<std::streamsize>(entry.imageLength));
+			if (!m_File || !AppendRecord(out, written, id, image.data(), entry.imageLength))
+			{
+				out.close();
+				std::error_code error;
+				std::filesystem::remove(temporary, error);
+				return false;
+			}
+
+			Entry moved = entry;
+			moved.offset = written;
+			written += entry.recordLength;
+			index.emplace(id, moved);
+		}
+		out.close();
+		m_File.close();
+
+		std::error_code error;
+		std::filesystem::rename(temporary, m_Path, error);
+		if (error)
+		{
+			std::cerr << "[SessionArchive] Cannot replace " << m_Path << ": " << error.message() << "\n";
+			std::filesystem::remove(temporary, error);
+			// The old file is intact; keep using it
+			m_File.open(m_Path, std::ios::binary | std::ios::in | std::ios::out);
+			return false;
+		}
+
+		m_File.open(m_Path, std::ios::binary | std::ios::in | std::ios::out);
+		if (!m_File.is_open())
+		{
+			std::cerr << "[SessionArchive] Cannot reopen " << m_Path << " after compacting\n";
+			m_Index.clear();
+			m_FileBytes = 0;
+			m_DeadBytes = 0;
+			return false;
+		}
+		m_Index = std::move(index);
+		m_FileBytes = written;
+		m_DeadBytes = 0;
+		return true;
+	}
+
+	std::size_t SessionArchive::GetCount() const
+	{
+		std::lock_guard lock(m_Mutex);
+		return m_Index.size();
+	}
+
+	std::size_t SessionArchive::GetFileBytes() const
+	{
+		std::lock_guard lock(m_Mutex);
+		return static_cast<std::size_t>(m_FileBytes);
+	}
+
+	std::size_t SessionArchive::GetDeadBytes() const
+	{
+		std::lock_guard lock(m_Mutex);
+		return static_cast<std::size_t>(m_DeadBytes);
+	}
+}
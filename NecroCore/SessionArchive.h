@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace NecroCore
+{
+	// Append-only file of session images, the cold tier of SessionStore.
+	//
+	// Each Put appends a record; the in-memory index points at the latest
+	// record for each id, so replaced and taken records become dead space.
+	// Compact rewrites the file with only the live records once dead space
+	// outweighs them. The file is a cache, not a durable store: it is
+	// truncated on open.
+	class SessionArchive
+	{
+	public:
+		static constexpr std::uint32_t RecordMagic = 0x41534E42; // "BNSA"
+		// Below this much dead space, Compact leaves the file alone
+		static constexpr std::size_t MinCompactBytes = 1 << 20;
+
+		// Check IsOpen; a failed open leaves an archive that refuses every Put.
+		explicit SessionArchive(std::string path);
+		~SessionArchive();
+
+		SessionArchive(const SessionArchive&) = delete;
+		SessionArchive& operator=(const SessionArchive&) = delete;
+
+		bool IsOpen() const { return m_File.is_open(); }
+		const std::string& GetPath() const { return m_Path; }
+
+		bool Put(std::string_view sessionId, const std::vector<std::uint8_t>& image);
+		// Reads the image and drops it from the archive.
+		bool Take(std::string_view sessionId, std::vector<std::uint8_t>& image);
+		// Reads the image and leaves it in place.
+		bool Read(std::string_view sessionId, std::vector<std::uint8_t>& image);
+		bool Erase(std::string_view sessionId);
+		bool Contains(std::string_view sessionId) const;
+
+		// Rewrites the file if dead records take up more than live ones and at
+		// least `minDeadBytes`. Returns true if it did.
+		bool Compact(std::size_t minDeadBytes = MinCompactBytes);
+
+		std::size_t GetCount() const;
+		std::size_t GetFileBytes() const;
+		std::size_t GetDeadBytes() const;
+
+	private:
+		struct RecordHeader
+		{
+			std::uint32_t magic;
+			std::uint32_t idLength;
+			std::uint32_t imageLength;
+		};
+
+		struct Entry
+		{
+			std::uint64_t offset;
+			std::uint32_t imageLength;
+			// Whole record, header and id included
+			std::uint32_t recordLength;
+		};
+
+		struct IdHash
+		{
+			using is_transparent = void;
+			std::size_t operator()(std::string_view id) const { return std::hash<std::string_view>{}(id); }
+		};
+
+		bool OpenTruncated(const std::string& path);
+		bool AppendRecord(std::fstream& file, std::uint64_t offset, std::string_view sessionId, const std::uint8_t* image, std::uint32_t imageLength);
+		// Expects m_Mutex to be held
+		bool ReadRecord(const Entry& entry, std::string_view sessionId, std::vector<std::uint8_t>& image);
+		void Forget(std::unordered_map<std::string, Entry, IdHash, std::equal_to<>>::iterator it);
+
+		std::string m_Path;
+		mutable std::mutex m_Mutex;
+		std::fstream m_File;
+		std::unordered_map<std::string, Entry, IdHash, std::equal_to<>> m_Index;
+		std::uint64_t m_FileBytes = 0;
+		std::uint64_t m_DeadBytes = 0;
+	};
+}
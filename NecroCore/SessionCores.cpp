@@ -0,0 +1,515 @@
+#include "SessionCores.h"
+#include "Game.h"
+#include "Hash.h"
+#include "SessionImage.h"
+
+#include <algorithm>
+#include <future>
+#include <iostream>
+#include <tuple>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace NecroCore
+{
+	namespace
+	{
+		std::int64_t Ticks(SessionClock::time_point time)
+		{
+			return static_cast<std::int64_t>(time.time_since_epoch().count());
+		}
+	}
+
+	Game* SessionCore::Find(std::string_view sessionId)
+	{
+		auto it = m_Sessions.find(sessionId);
+		if (it == m_Sessions.end())
+			return nullptr;
+
+		Session& session = it->second;
+		if (session.tier != SessionTier::Hot && !Promote(sessionId, session))
+		{
+			std::cerr << "[SessionCores] Cannot restore session " << sessionId << "\n";
+			++m_RestoreFailures;
+			RemoveSession(it);
+			return nullptr;
+		}
+		session.lastUsed = Ticks(SessionClock::now());
+		return session.game.get();
+	}
+
+	bool SessionCore::Insert(std::string_view sessionId, std::unique_ptr<Game>&& game)
+	{
+		if (m_Sessions.find(sessionId) != m_Sessions.end())
+			return false;
+		// The key is built with the map's allocator, out of this core's pool
+		auto [it, inserted] = m_Sessions.emplace(std::piecewise_construct, std::forward_as_tuple(sessionId), std::forward_as_tuple());
+		Session& session = it->second;
+		session.game = std::move(game);
+		session.lastUsed = Ticks(SessionClock::now());
+		session.residentBytes = ResidentBytes(session);
+		++m_TierCounts[static_cast<std::size_t>(SessionTier::Hot)];
+		m_Count.store(m_Sessions.size(), std::memory_order_relaxed);
+		return true;
+	}
+
+	bool SessionCore::Erase(std::string_view sessionId)
+	{
+		auto it = m_Sessions.find(sessionId);
+		if (it == m_Sessions.end())
+			return false;
+		RemoveSession(it);
+		return true;
+	}
+
+	void SessionCore::VisitImages(const std::function<void(std::string_view sessionId, const std::vector<std::uint8_t>& image)>& visit)
+	{
+		std::vector<std::uint8_t> image;
+		for (auto& [id, session] : m_Sessions)
+		{
+			switch (session.tier)
+			{
+			case SessionTier::Hot:
+				image = SessionImage::Save(*session.game);
+				break;
+			case SessionTier::Compact:
+				image = session.image;
+				break;
+			case SessionTier::Archived:
+				if (!m_Archive || !m_Archive->Read(id, image))
+				{
+					std::cerr << "[SessionCores] Cannot read archived session " << id << "\n";
+					continue;
+				}
+				break;
+			}
+			visit(id, image);
+		}
+	}
+
+	std::size_t SessionCore::Reap(SessionClock::time_point now)
+	{
+		const std::int64_t nowTicks = Ticks(now);
+		auto idleLongerThan = [nowTicks](const Session& session, std::chrono::seconds limit)
+			{
+				return limit.count() > 0 && nowTicks - session.lastUsed > std::chrono::duration_cast<SessionClock::duration>(limit).count();
+			};
+
+		std::size_t moved = 0;
+		std::size_t residentBytes = 0;
+		for (auto it = m_Sessions.begin(); it != m_Sessions.end();)
+		{
+			Session& session = it->second;
+			if (session.tier != SessionTier::Archived && idleLongerThan(session, m_Config.idleTimeout))
+			{
+				++m_Expired;
+				++moved;
+				if (!EvictSession(it->first, session))
+				{
+					it = RemoveSession(it);
+					continue;
+				}
+			}
+			else if (session.tier == SessionTier::Hot && idleLongerThan(session, m_Config.compactAfter))
+			{
+				CompactSession(session);
+				++moved;
+			}
+			else if (session.tier == SessionTier::Hot)
+			{
+				// Games grow as they are played, so live sizes are re-estimated every pass
+				session.residentBytes = ResidentBytes(session);
+			}
+			residentBytes += session.residentBytes;
+			++it;
+		}
+
+		if (m_MemoryBudget > 0 && residentBytes > m_MemoryBudget)
+		{
+			// Iterators stay valid until their own session is removed, and each is visited once per tier
+			std::pmr::vector<SessionMap::iterator> oldest(&m_Pool);
+			for (auto it = m_Sessions.begin(); it != m_Sessions.end(); ++it)
+			{
+				if (it->second.tier != SessionTier::Archived)
+					oldest.push_back(it);
+			}
+			std::sort(oldest.begin(), oldest.end(), [](SessionMap::iterator a, SessionMap::iterator b)
+				{
+					return a->second.lastUsed < b->second.lastUsed;
+				});
+
+			// Compacting the oldest games is cheap to undo; evicting them only if that is not enough
+			for (SessionTier from : { SessionTier::Hot, SessionTier::Compact })
+			{
+				for (SessionMap::iterator it : oldest)
+				{
+					if (residentBytes <= m_MemoryBudget)
+						break;
+					Session& session = it->second;
+					if (session.tier != from)
+						continue;
+
+					const std::size_t before = session.residentBytes;
+					std::size_t after = 0;
+					if (from == SessionTier::Hot)
+					{
+						CompactSession(session);
+						after = session.residentBytes;
+					}
+					else if (EvictSession(it->first, session))
+					{
+						after = session.residentBytes;
+					}
+					else
+					{
+						RemoveSession(it);
+					}
+					residentBytes = residentBytes + after > before ? residentBytes + after - before : 0;
+					++moved;
+				}
+			}
+		}
+
+		m_ResidentBytes = residentBytes;
+		return moved;
+	}
+
+	bool SessionCore::Promote(std::string_view sessionId, Session& session)
+	{
+		if (session.tier == SessionTier::Archived)
+		{
+			if (!m_Archive || !m_Archive->Take(sessionId, session.image))
+				return false;
+		}
+
+		session.game = SessionImage::Load(session.image.data(), session.image.size());
+		session.image = std::vector<std::uint8_t>();
+		if (!session.game)
+			return false;
+
+		SetTier(session, SessionTier::Hot);
+		session.residentBytes = ResidentBytes(session);
+		++m_Restored;
+		return true;
+	}
+
+	void SessionCore::CompactSession(Session& session)
+	{
+		session.image = SessionImage::Save(*session.game);
+		session.game.reset();
+		SetTier(session, SessionTier::Compact);
+		session.residentBytes = ResidentBytes(session);
+		++m_Compacted;
+	}
+
+	bool SessionCore::EvictSession(std::string_view sessionId, Session& session)
+	{
+		++m_Evicted;
+		if (!m_Archive)
+			return false;
+
+		const std::vector<std::uint8_t> image = session.tier == SessionTier::Hot
+			? SessionImage::Save(*session.game)
+			: std::move(session.image);
+		if (!m_Archive->Put(sessionId, image))
+		{
+			std::cerr << "[SessionCores] Cannot archive session " << sessionId << ", dropping it\n";
+			return false;
+		}
+
+		session.game.reset();
+		session.image = std::vector<std::uint8_t>();
+		SetTier(session, SessionTier::Archived);
+		session.residentBytes = ResidentBytes(session);
+		return true;
+	}
+
+	SessionCore::SessionMap::iterator SessionCore::RemoveSession(SessionMap::iterator it)
+	{
+		if (it->second.tier == SessionTier::Archived && m_Archive)
+			m_Archive->Erase(it->first);
+		--m_TierCounts[static_cast<std::size_t>(it->second.tier)];
+		it = m_Sessions.erase(it);
+		m_Count.store(m_Sessions.size(), std::memory_order_relaxed);
+		return it;
+	}
+
+	void SessionCore::SetTier(Session& session, SessionTier tier)
+	{
+		--m_TierCounts[static_cast<std::size_t>(session.tier)];
+		++m_TierCounts[static_cast<std::size_t>(tier)];
+		session.tier = tier;
+	}
+
+	std::size_t SessionCore::ResidentBytes(const Session& session)
+	{
+		std::size_t bytes = sizeof(Session) + session.image.capacity();
+		if (session.game)
+			bytes += SessionImage::EstimateResidentBytes(*session.game);
+		return bytes;
+	}
+
+	void SessionCore::AddMetrics(SessionStoreMetrics& metrics) const
+	{
+		metrics.hot += m_TierCounts[static_cast<std::size_t>(SessionTier::Hot)].load(std::memory_order_relaxed);
+		metrics.compact += m_TierCounts[static_cast<std::size_t>(SessionTier::Compact)].load(std::memory_order_relaxed);
+		metrics.archived += m_TierCounts[static_cast<std::size_t>(SessionTier::Archived)].load(std::memory_order_relaxed);
+		metrics.residentBytes += m_ResidentBytes.load(std::memory_order_relaxed);
+		metrics.compacted += m_Compacted.load(std::memory_order_relaxed);
+		metrics.evicted += m_Evicted.load(std::memory_order_relaxed);
+		metrics.expired += m_Expired.load(std::memory_order_relaxed);
+		metrics.restored += m_Restored.load(std::memory_order_relaxed);
+		metrics.restoreFailures += m_RestoreFailures.load(std::memory_order_relaxed);
+	}
+
+	std::string& SessionCore::GetScratch()
+	{
+		m_Scratch.clear();
+		return m_Scratch;
+	}
+
+	SessionCores::SessionCores(unsigned coreCount, bool pinThreads, std::size_t queueCapacity, SessionStoreConfig tiers)
+		: m_Config(std::move(tiers)), m_PinThreads(pinThreads)
+	{
+		if (!m_Config.archivePath.empty())
+		{
+			m_Archive = std::make_unique<SessionArchive>(m_Config.archivePath);
+			if (!m_Archive->IsOpen())
+				m_Archive.reset();
+		}
+
+		if (coreCount == 0)
+			coreCount = std::max(1u, std::thread::hardware_concurrency());
+		// Rounded up, so a small budget never turns into none at all
+		const std::size_t memoryBudget = (m_Config.memoryBudget + coreCount - 1) / coreCount;
+		for (unsigned i = 0; i < coreCount; ++i)
+		{
+			m_Cores.push_back(std::make_unique<Core>(i, m_Config, memoryBudget, m_Archive.get(), queueCapacity));
+		}
+	}
+
+	SessionCores::~SessionCores()
+	{
+		Stop();
+	}
+
+	std::size_t SessionCores::CoreIndex(std::string_view sessionId) const
+	{
+		// Seeded apart from SessionStore::ShardIndex so the two never line up by accident
+		return static_cast<std::size_t>(HashBytes(0x434F5245, sessionId.data(), sessionId.size()) % m_Cores.size());
+	}
+
+	void SessionCores::Start()
+	{
+		m_Stop = false;
+		const unsigned cpus = std::max(1u, std::thread::hardware_concurrency());
+		for (std::size_t i = 0; i < m_Cores.size(); ++i)
+		{
+			Core& core = *m_Cores[i];
+			if (!core.thread.joinable())
+				core.thread = std::thread([this, &core, cpu = i % cpus]() { Run(core, cpu); });
+		}
+
+		const bool limited = m_Config.compactAfter.count() > 0 || m_Config.idleTimeout.count() > 0 || m_Config.memoryBudget > 0;
+		std::lock_guard lock(m_ReaperMutex);
+		if (!limited || m_Reaper.joinable())
+			return;
+		m_ReaperStop = false;
+		m_Reaper = std::thread([this]()
+			{
+				std::unique_lock lock(m_ReaperMutex);
+				while (!m_ReaperWake.wait_for(lock, m_Config.reapInterval, [this]() { return m_ReaperStop; }))
+				{
+					lock.unlock();
+					Reap();
+					lock.lock();
+				}
+			});
+	}
+
+	void SessionCores::StopReaper()
+	{
+		std::thread reaper;
+		{
+			std::lock_guard lock(m_ReaperMutex);
+			m_ReaperStop = true;
+			reaper = std::move(m_Reaper);
+		}
+		m_ReaperWake.notify_all();
+		if (reaper.joinable())
+			reaper.join();
+	}
+
+	void SessionCores::Stop()
+	{
+		// The reaper waits on the cores, so it has to go first
+		StopReaper();
+		m_Stop = true;
+		for (auto& core : m_Cores)
+		{
+			core->signal.fetch_add(1, std::memory_order_release);
+			core->signal.notify_one();
+		}
+		for (auto& core : m_Cores)
+		{
+			if (core->thread.joinable())
+				core->thread.join();
+		}
+	}
+
+	void SessionCores::PostTo(std::size_t index, Task task)
+	{
+		Core& core = *m_Cores[index];
+		while (!core.queue.TryPush(task))
+		{
+			std::this_thread::yield();
+		}
+		Wake(core);
+	}
+
+	bool SessionCores::TryPost(std::string_view sessionId, Task& task)
+	{
+		Core& core = *m_Cores[CoreIndex(sessionId)];
+		if (!core.queue.TryPush(task))
+			return false;
+		Wake(core);
+		return true;
+	}
+
+	void SessionCores::PostOrQueue(std::string_view sessionId, Task task)
+	{
+		if (TryPost(sessionId, task))
+			return;
+		Core& core = *m_Cores[CoreIndex(sessionId)];
+		{
+			std::lock_guard lock(core.overflowMutex);
+			core.overflow.push_back(std::move(task));
+			core.hasOverflow.store(true, std::memory_order_release);
+		}
+		Wake(core);
+	}
+
+	void SessionCores::Wake(Core& core)
+	{
+		core.signal.fetch_add(1, std::memory_order_release);
+		core.signal.notify_one();
+	}
+
+	void SessionCores::Adopt(const std::string& sessionId, std::unique_ptr<Game>&& game)
+	{
+		// Tasks have to be copyable, so the game travels in a shared holder
+		auto holder = std::make_shared<std::unique_ptr<Game>>(std::move(game));
+		Post(sessionId, [sessionId, holder](SessionCore& core) { core.Insert(sessionId, std::move(*holder)); });
+	}
+
+	void SessionCores::RunOnEachCore(const Task& task)
+	{
+		for (std::size_t i = 0; i < m_Cores.size(); ++i)
+		{
+			std::promise<void> done;
+			PostTo(i, [&task, &done](SessionCore& core)
+				{
+					task(core);
+					done.set_value();
+				});
+			done.get_future().wait();
+		}
+	}
+
+	std::size_t SessionCores::VisitImages(const std::function<void(std::string_view sessionId, const std::vector<std::uint8_t>& image)>& visit)
+	{
+		std::size_t visited = 0;
+		RunOnEachCore([&](SessionCore& core)
+			{
+				core.VisitImages([&](std::string_view sessionId, const std::vector<std::uint8_t>& image)
+					{
+						visit(sessionId, image);
+						++visited;
+					});
+			});
+		return visited;
+	}
+
+	std::size_t SessionCores::Reap(SessionClock::time_point now)
+	{
+		std::size_t moved = 0;
+		RunOnEachCore([&](SessionCore& core) { moved += core.Reap(now); });
+		if (m_Archive)
+			m_Archive->Compact();
+		return moved;
+	}
+
+	std::size_t SessionCores::Size() const
+	{
+		std::size_t size = 0;
+		for (const auto& core : m_Cores)
+		{
+			size += core->state.GetSessionCount();
+		}
+		return size;
+	}
+
+	SessionStoreMetrics SessionCores::GetMetrics() const
+	{
+		SessionStoreMetrics metrics;
+		for (const auto& core : m_Cores)
+		{
+			core->state.AddMetrics(metrics);
+		}
+		if (m_Archive)
+			metrics.archiveBytes = m_Archive->GetFileBytes();
+		return metrics;
+	}
+
+	void SessionCores::Run(Core& core, std::size_t cpu)
+	{
+#ifdef __linux__
+		if (m_PinThreads)
+		{
+			cpu_set_t set;
+			CPU_ZERO(&set);
+			CPU_SET(cpu, &set);
+			pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+		}
+#else
+		(void)cpu;
+#endif
+
+		Task task;
+		std::vector<Task> overflow;
+		while (true)
+		{
+			// Read before draining, so a post that lands after the drain is never slept through
+			const std::uint32_t seen = core.signal.load(std::memory_order_acquire);
+			bool ran = false;
+			while (core.queue.TryPop(task))
+			{
+				task(core.state);
+				task = nullptr;
+				ran = true;
+			}
+			if (core.hasOverflow.load(std::memory_order_acquire))
+			{
+				{
+					std::lock_guard lock(core.overflowMutex);
+					overflow.swap(core.overflow);
+					core.hasOverflow.store(false, std::memory_order_relaxed);
+				}
+				for (Task& queued : overflow)
+				{
+					queued(core.state);
+				}
+				overflow.clear();
+				ran = true;
+			}
+			if (ran)
+				continue;
+			if (m_Stop.load(std::memory_order_acquire))
+				return;
+			core.signal.wait(seen, std::memory_order_acquire);
+		}
+	}
+}
@@ -0,0 +1,201 @@
+#pragma once
+
+#include "LockFreeQueue.h"
+#include "SessionStore.h"
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace NecroCore
+{
+	class Game;
+
+	// The sessions one core owns, and the memory it uses for them. Only ever
+	// touched from that core's thread, so nothing in here is locked.
+	//
+	// Sessions move down the same tiers as in SessionStore: Reap compacts idle
+	// games into images and archives or drops them later, against this core's
+	// share of the memory budget, and Find brings them straight back.
+	class SessionCore
+	{
+	public:
+		std::size_t GetIndex() const { return m_Index; }
+
+		// Restores a compacted or archived session first. Null if there is no
+		// such session or it could not be restored, which also drops it.
+		Game* Find(std::string_view sessionId);
+		// False if the id is already taken; the game is then left untouched.
+		bool Insert(std::string_view sessionId, std::unique_ptr<Game>&& game);
+		bool Erase(std::string_view sessionId);
+		// Calls `visit` with a SessionImage of every session, whichever tier it is in.
+		void VisitImages(const std::function<void(std::string_view sessionId, const std::vector<std::uint8_t>& image)>& visit);
+
+		// One pass over this core's sessions as of `now`, like SessionStore::Reap;
+		// returns how many moved to a colder tier or were dropped.
+		std::size_t Reap(SessionClock::time_point now);
+
+		// Safe to read from any thread
+		std::size_t GetSessionCount() const { return m_Count.load(std::memory_order_relaxed); }
+
+		// Cleared buffer for encoding responses, reused by every task on this core
+		std::string& GetScratch();
+		// Backs the session index; also for anything else tasks on this core allocate
+		std::pmr::memory_resource& GetAllocator() { return m_Pool; }
+
+	private:
+		friend class SessionCores;
+
+		struct IdHash
+		{
+			using is_transparent = void;
+			std::size_t operator()(std::string_view id) const { return std::hash<std::string_view>{}(id); }
+		};
+
+		struct Session
+		{
+			// The game while Hot, its image while Compact
+			std::unique_ptr<Game> game;
+			std::vector<std::uint8_t> image;
+			SessionTier tier = SessionTier::Hot;
+			// SessionClock ticks of the last Find or Insert
+			std::int64_t lastUsed = 0;
+			std::size_t residentBytes = 0;
+		};
+
+		using SessionMap = std::pmr::unordered_map<std::pmr::string, Session, IdHash, std::equal_to<>>;
+
+		SessionCore(std::size_t index, const SessionStoreConfig& config, std::size_t memoryBudget, SessionArchive* archive)
+			: m_Index(index), m_Config(config), m_MemoryBudget(memoryBudget), m_Archive(archive) {}
+
+		bool Promote(std::string_view sessionId, Session& session);
+		void CompactSession(Session& session);
+		// False if the session could not be archived and has to be dropped
+		bool EvictSession(std::string_view sessionId, Session& session);
+		SessionMap::iterator RemoveSession(SessionMap::iterator it);
+		void SetTier(Session& session, SessionTier tier);
+		static std::size_t ResidentBytes(const Session& session);
+		void AddMetrics(SessionStoreMetrics& metrics) const;
+
+		std::size_t m_Index;
+		const SessionStoreConfig& m_Config;
+		std::size_t m_MemoryBudget;
+		SessionArchive* m_Archive;
+		std::pmr::unsynchronized_pool_resource m_Pool;
+		SessionMap m_Sessions{ &m_Pool };
+		std::string m_Scratch;
+		std::atomic<std::size_t> m_Count{ 0 };
+
+		// Written by this core only; read by SessionCores::GetMetrics
+		std::array<std::atomic<std::size_t>, 3> m_TierCounts{};
+		std::atomic<std::size_t> m_ResidentBytes{ 0 };
+		std::atomic<std::uint64_t> m_Compacted{ 0 };
+		std::atomic<std::uint64_t> m_Evicted{ 0 };
+		std::atomic<std::uint64_t> m_Expired{ 0 };
+		std::atomic<std::uint64_t> m_Restored{ 0 };
+		std::atomic<std::uint64_t> m_RestoreFailures{ 0 };
+	};
+
+	// Shared-nothing alternative to SessionStore: one thread per core, each
+	// pinned to its CPU where the platform allows, owning the sessions whose
+	// id hashes to it. Work for a session is posted to its core through that
+	// core's lock-free queue and runs there, so a game stays in one core's
+	// cache and no session is ever locked. A core with nothing queued sleeps
+	// on an atomic until the next post.
+	//
+	// Tasks must not block: a core waiting on I/O stalls every session it owns.
+	// The one exception is the archive file of the coldest tier, which a core
+	// reads and writes itself when it evicts or restores a session.
+	class SessionCores
+	{
+	public:
+		using Task = std::function<void(SessionCore& core)>;
+
+		static constexpr std::size_t DefaultQueueCapacity = 4096;
+
+		// `coreCount` of zero uses one per hardware thread. `tiers` works as for
+		// SessionStore, with the memory budget split evenly between the cores.
+		explicit SessionCores(unsigned coreCount = 0, bool pinThreads = true, std::size_t queueCapacity = DefaultQueueCapacity,
+			SessionStoreConfig tiers = {});
+		~SessionCores();
+
+		SessionCores(const SessionCores&) = delete;
+		SessionCores& operator=(const SessionCores&) = delete;
+
+		// Also starts a reaper that runs Reap every reap interval, if `tiers` set any limit.
+		void Start();
+		// Runs whatever is still queued, then stops the threads.
+		void Stop();
+
+		std::size_t GetCoreCount() const { return m_Cores.size(); }
+		std::size_t CoreIndex(std::string_view sessionId) const;
+
+		// Safe from any thread; waits for room if the core's queue is full, so a
+		// task must not post back to its own core in bulk.
+		void Post(std::string_view sessionId, Task task) { PostTo(CoreIndex(sessionId), std::move(task)); }
+		void PostTo(std::size_t core, Task task);
+		// Never waits: false if the core's queue is full, leaving `task` alone.
+		bool TryPost(std::string_view sessionId, Task& task);
+		// Never waits either: a task that finds the queue full goes on the core's
+		// overflow list instead, which it runs after its queue. For threads that
+		// must not stall, such as the log's flusher or another core.
+		void PostOrQueue(std::string_view sessionId, Task task);
+		// Hands a game to the core that owns `sessionId`, e.g. during recovery.
+		void Adopt(const std::string& sessionId, std::unique_ptr<Game>&& game);
+
+		// Runs `task` on each core in turn, waiting for each. The cores must be
+		// running and the caller must not be one of them.
+		void RunOnEachCore(const Task& task);
+		// Same contract as SessionStore::VisitImages, one core paused at a time.
+		std::size_t VisitImages(const std::function<void(std::string_view sessionId, const std::vector<std::uint8_t>& image)>& visit);
+
+		// Reaps every core in turn, waiting for each; same contract as RunOnEachCore.
+		std::size_t Reap(SessionClock::time_point now = SessionClock::now());
+
+		std::size_t Size() const;
+		SessionStoreMetrics GetMetrics() const;
+
+	private:
+		struct alignas(64) Core
+		{
+			Core(std::size_t index, const SessionStoreConfig& tiers, std::size_t memoryBudget, SessionArchive* archive, std::size_t queueCapacity)
+				: state(index, tiers, memoryBudget, archive), queue(queueCapacity) {}
+
+			SessionCore state;
+			LockFreeQueue<Task> queue;
+			// Tasks that did not fit in the queue, rarely used
+			std::mutex overflowMutex;
+			std::vector<Task> overflow;
+			std::atomic<bool> hasOverflow{ false };
+			// Bumped on every post; the thread sleeps on it when the queue is empty
+			std::atomic<std::uint32_t> signal{ 0 };
+			std::thread thread;
+		};
+
+		void Run(Core& core, std::size_t cpu);
+		static void Wake(Core& core);
+		void StopReaper();
+
+		SessionStoreConfig m_Config;
+		std::unique_ptr<SessionArchive> m_Archive;
+		std::vector<std::unique_ptr<Core>> m_Cores;
+		bool m_PinThreads;
+		std::atomic<bool> m_Stop{ false };
+
+		std::mutex m_ReaperMutex;
+		std::condition_variable m_ReaperWake;
+		bool m_ReaperStop = false;
+		std::thread m_Reaper;
+	};
+}
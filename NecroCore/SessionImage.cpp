@@ -0,0 +1,129 @@
+#include "SessionImage.h"
+#include "Game.h"
+#include "GameSnapshot.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace NecroCore
+{
+	namespace
+	{
+		constexpr std::uint16_t kFlagRecording = 1 << 0;
+
+		struct ImageHeader
+		{
+			std::uint32_t magic;
+			std::uint16_t version;
+			std::uint16_t flags;
+			std::uint32_t mapNameLength;
+			std::uint32_t snapshotSize;
+			std::uint32_t replaySize;
+		};
+	}
+
+	std::vector<std::uint8_t> SessionImage::Save(const Game& game)
+	{
+		const std::string& mapName = game.GetMapName();
+		const std::vector<std::uint8_t> replay = game.IsRecording() ? game.GetReplayLog().Serialize() : std::vector<std::uint8_t>();
+
+		ImageHeader header{};
+		header.magic = Magic;
+		header.version = Version;
+		header.flags = game.IsRecording() ? kFlagRecording : 0;
+		header.mapNameLength = static_cast<std::uint32_t>(mapName.size());
+		header.snapshotSize = static_cast<std::uint32_t>(GameSnapshot::GetSize(game));
+		header.replaySize = static_cast<std::uint32_t>(replay.size());
+
+		std::vector<std::uint8_t> image(sizeof(header) + mapName.size() + header.snapshotSize + replay.size());
+		std::uint8_t* out = image.data();
+		std::memcpy(out, &header, sizeof(header));
+		out += sizeof(header);
+		std::memcpy(out, mapName.data(), mapName.size());
+		out += mapName.size();
+		GameSnapshot::Write(game, out, header.snapshotSize);
+		out += header.snapshotSize;
+		if (!replay.empty())
+			std::memcpy(out, replay.data(), replay.size());
+		return image;
+	}
+
+	std::unique_ptr<Game> SessionImage::Load(const std::uint8_t* data, std::size_t size)
+	{
+		ImageHeader header{};
+		if (data == nullptr || size < sizeof(header))
+			return nullptr;
+		std::memcpy(&header, data, sizeof(header));
+		if (header.magic != Magic || header.version != Version)
+			return nullptr;
+		const std::size_t expected = sizeof(header) + static_cast<std::size_t>(header.mapNameLength) + header.snapshotSize + header.replaySize;
+		if (size != expected)
+			return nullptr;
+
+		const std::uint8_t* at = data + sizeof(header);
+		const std::string mapName(reinterpret_cast<const char*>(at), header.mapNameLength);
+		at += header.mapNameLength;
+		if (!Game::IsKnownMap(mapName))
+			return nullptr;
+
+		// The snapshot overwrites the player name, map layers and generator state
+		auto game = std::make_unique<Game>(std::string(), mapName, 0);
+		if (!GameSnapshot::Load(*game, at, header.snapshotSize))
+			return nullptr;
+		at += header.snapshotSize;
+
+		if ((header.flags & kFlagRecording) != 0)
+		{
+			ReplayLog log;
+			if (!log.Deserialize(at, header.replaySize))
+				return nullptr;
+			game->ResumeRecording(std::move(log));
+		}
+		return game;
+	}
+
+	bool SessionImage::SaveToFile(const Game& game, const std::string& path)
+	{
+		const std::vector<std::uint8_t> image = Save(game);
+		const std::string temporary = path + ".tmp";
+		{
+			std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+			if (!out)
+			{
+				std::cerr << "[SessionImage] Cannot open " << temporary << " for writing\n";
+				return false;
+			}
+			out.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+			if (!out)
+				return false;
+		}
+
+		std::error_code error;
+		std::filesystem::rename(temporary, path, error);
+		if (error)
+		{
+			std::cerr << "[SessionImage] Cannot move " << temporary << " into place: " << error.message() << "\n";
+			std::filesystem::remove(temporary, error);
+			return false;
+		}
+		return true;
+	}
+
+	std::unique_ptr<Game> SessionImage::LoadFromFile(const std::string& path)
+	{
+		std::ifstream in(path, std::ios::binary);
+		if (!in)
+			return nullptr;
+		const std::vector<std::uint8_t> image((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+		return Load(image.data(), image.size());
+	}
+
+	std::size_t SessionImage::EstimateResidentBytes(const Game& game)
+	{
+		// The snapshot is a dense copy of the state; live containers add roughly as much again
+		return sizeof(Game) + 2 * GameSnapshot::GetSize(game) + game.GetReplayLog().GetMemoryUsage();
+	}
+}
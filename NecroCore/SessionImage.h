@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace NecroCore
+{
+	class Game;
+
+	// Everything needed to bring a session back as a live Game: the map name,
+	// a GameSnapshot image and, for games that record, the replay log so
+	// /session-log keeps working after a round trip. The undo journal is not
+	// kept; a restored game starts with nothing to undo.
+	class SessionImage
+	{
+	public:
+		static constexpr std::uint32_t Magic = 0x53534E42; // "BNSS"
+		static constexpr std::uint16_t Version = 1;
+
+		static std::vector<std::uint8_t> Save(const Game& game);
+		// Null if the image is truncated, corrupt or names an unknown map.
+		static std::unique_ptr<Game> Load(const std::uint8_t* data, std::size_t size);
+
+		// Written to a temporary file and renamed into place, so a crash never
+		// leaves a half-written image at `path`.
+		static bool SaveToFile(const Game& game, const std::string& path);
+		static std::unique_ptr<Game> LoadFromFile(const std::string& path);
+
+		// Rough resident size of a live game, used for memory budgets.
+		static std::size_t EstimateResidentBytes(const Game& game);
+	};
+}
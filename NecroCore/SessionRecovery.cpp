@@ -0,0 +1,313 @@
+#include "SessionRecovery.h"
+#include "Game.h"
+#include "Hash.h"
+#include "Log.h"
+#include "SessionImage.h"
+#include "SessionStore.h"
+#include "WriteAheadLog.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace NecroCore
+{
+	namespace
+	{
+		struct SnapshotHeader
+		{
+			std::uint32_t magic;
+			std::uint16_t version;
+			std::uint16_t reserved;
+			// First log segment not covered by the images
+			std::uint32_t walStart;
+			std::uint32_t count;
+		};
+
+		struct SnapshotRecord
+		{
+			std::uint32_t idLength;
+			std::uint32_t imageLength;
+			std::uint32_t checksum;
+		};
+
+		std::uint32_t RecordChecksum(std::string_view id, const std::uint8_t* image, std::size_t imageLength)
+		{
+			return static_cast<std::uint32_t>(HashBytes(HashBytes(0x534E50, id.data(), id.size()), image, imageLength));
+		}
+
+		template<typename T>
+		void AppendPod(std::vector<std::uint8_t>& out, const T& value)
+		{
+			const auto* bytes = reinterpret_cast<const std::uint8_t*>(&value);
+			out.insert(out.end(), bytes, bytes + sizeof(T));
+		}
+
+		struct PendingSession
+		{
+			std::string id;
+			std::vector<std::uint8_t> image;
+			bool hasImage = false;
+			bool hasCreate = false;
+			WalRecord create;
+			std::vector<WalRecord> turns;
+		};
+
+		// Loads the images; false leaves `walStart` at 0 so every segment left is replayed
+		bool ReadSnapshot(const std::string& path, std::unordered_map<std::string, PendingSession>& sessions, std::uint32_t& walStart)
+		{
+			walStart = 0;
+			std::ifstream in(path, std::ios::binary);
+			if (!in)
+				return true; // Never checkpointed
+			const std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+			SnapshotHeader header{};
+			if (bytes.size() < sizeof(header))
+				return false;
+			std::memcpy(&header, bytes.data(), sizeof(header));
+			if (header.magic != SessionRecovery::SnapshotMagic || header.version != SessionRecovery::SnapshotVersion)
+				return false;
+
+			std::size_t at = sizeof(header);
+			for (std::uint32_t i = 0; i < header.count; ++i)
+			{
+				SnapshotRecord record{};
+				if (bytes.size() - at < sizeof(record))
+					return false;
+				std::memcpy(&record, bytes.data() + at, sizeof(record));
+				at += sizeof(record);
+				if (bytes.size() - at < std::size_t{ record.idLength } + record.imageLength)
+					return false;
+
+				const std::string_view id(reinterpret_cast<const char*>(bytes.data() + at), record.idLength);
+				const std::uint8_t* image = bytes.data() + at + record.idLength;
+				at += std::size_t{ record.idLength } + record.imageLength;
+				if (RecordChecksum(id, image, record.imageLength) != record.checksum)
+					return false;
+
+				PendingSession& session = sessions[std::string(id)];
+				session.image.assign(image, image + record.imageLength);
+				session.hasImage = true;
+			}
+			walStart = header.walStart;
+			return at == bytes.size();
+		}
+	}
+
+	std::string SessionRecovery::SnapshotPath(const std::string& directory)
+	{
+		return (std::filesystem::path(directory) / "snapshot.bin").string();
+	}
+
+	long long SessionRecovery::Checkpoint(WriteAheadLog& log, SessionStore& store)
+	{
+		return Checkpoint(log, [&store](const ImageVisitor& visit) { return store.VisitImages(visit); });
+	}
+
+	long long SessionRecovery::Checkpoint(WriteAheadLog& log, const ImageSource& images)
+	{
+		// Turns are logged while their game is still held, so every turn logged
+		// before the rotation is already in the game the images below are taken from
+		const std::uint32_t walStart = log.Rotate();
+
+		std::vector<std::uint8_t> bytes(sizeof(SnapshotHeader));
+		std::uint32_t count = 0;
+		images([&](std::string_view sessionId, const std::vector<std::uint8_t>& image)
+			{
+				SnapshotRecord record{};
+				record.idLength = static_cast<std::uint32_t>(sessionId.size());
+				record.imageLength = static_cast<std::uint32_t>(image.size());
+				record.checksum = RecordChecksum(sessionId, image.data(), image.size());
+				AppendPod(bytes, record);
+				bytes.insert(bytes.end(), sessionId.begin(), sessionId.end());
+				bytes.insert(bytes.end(), image.begin(), image.end());
+				++count;
+			});
+
+		SnapshotHeader header{};
+		header.magic = SnapshotMagic;
+		header.version = SnapshotVersion;
+		header.walStart = walStart;
+		header.count = count;
+		std::memcpy(bytes.data(), &header, sizeof(header));
+
+		if (!WriteAheadLog::WriteFileDurably(SnapshotPath(log.GetDirectory()), bytes))
+		{
+			std::cerr << "[SessionRecovery] Cannot write snapshot in " << log.GetDirectory() << "\n";
+			return -1;
+		}
+		log.RemoveSegmentsBefore(walStart);
+		return count;
+	}
+
+	SessionRecoveryReport SessionRecovery::Recover(const std::string& directory, SessionStore& store, unsigned threads)
+	{
+		return Recover(directory, [&store](const std::string& sessionId, std::unique_ptr<Game>&& game)
+			{
+				return store.Insert(sessionId, std::move(game));
+			}, threads);
+	}
+
+	SessionRecoveryReport SessionRecovery::Recover(const std::string& directory, const SessionSink& insert, unsigned threads)
+	{
+		const auto start = std::chrono::steady_clock::now();
+		SessionRecoveryReport report;
+
+		std::unordered_map<std::string, PendingSession> sessions;
+		std::uint32_t walStart = 0;
+		if (!ReadSnapshot(SnapshotPath(directory), sessions, walStart))
+		{
+			std::cerr << "[SessionRecovery] Snapshot in " << directory << " is damaged, ignoring it\n";
+			sessions.clear();
+			walStart = 0;
+			report.damagedLog = true;
+		}
+		report.fromSnapshot = sessions.size();
+
+		for (std::uint32_t segment : WriteAheadLog::ListSegments(directory))
+		{
+			if (segment < walStart)
+				continue;
+			const bool intact = WriteAheadLog::ReadSegment(WriteAheadLog::SegmentPath(directory, segment), [&](WalRecord&& record)
+				{
+					PendingSession& session = sessions[record.sessionId];
+					if (record.type == WalRecordType::Create)
+					{
+						session.hasCreate = true;
+						session.create = std::move(record);
+					}
+					else
+					{
+						session.turns.push_back(std::move(record));
+					}
+				});
+			if (!intact)
+			{
+				std::cerr << "[SessionRecovery] Segment " << segment << " ends in a damaged record\n";
+				report.damagedLog = true;
+			}
+		}
+
+		std::vector<PendingSession*> work;
+		work.reserve(sessions.size());
+		for (auto& [id, session] : sessions)
+		{
+			session.id = id;
+			work.push_back(&session);
+		}
+
+		std::atomic<std::size_t> next{ 0 };
+		std::atomic<std::size_t> created{ 0 };
+		std::atomic<std::size_t> replayed{ 0 };
+		std::atomic<std::size_t> skipped{ 0 };
+		std::atomic<std::size_t> diverged{ 0 };
+		std::atomic<std::size_t> orphaned{ 0 };
+		std::atomic<std::size_t> failed{ 0 };
+
+		auto worker = [&]()
+			{
+				// Replays would otherwise trace every turn from every thread
+				ScopedTraceSilence silence;
+				for (std::size_t index = next++; index < work.size(); index = next++)
+				{
+					PendingSession& pending = *work[index];
+					std::unique_ptr<Game> game;
+					if (pending.hasImage)
+					{
+						game = SessionImage::Load(pending.image.data(), pending.image.size());
+					}
+					else if (pending.hasCreate && Game::IsKnownMap(pending.create.mapName))
+					{
+						game = std::make_unique<Game>(pending.create.playerName, pending.create.mapName, pending.create.seed);
+						game->StartRecording();
+						++created;
+					}
+
+					if (!game || !game->IsRecording())
+					{
+						if (pending.hasImage || pending.hasCreate)
+							++failed;
+						orphaned += pending.turns.size();
+						continue;
+					}
+
+					// Segments are read in order, but a turn can be logged just after a
+					// rotation while an older one is still in the previous segment
+					std::stable_sort(pending.turns.begin(), pending.turns.end(), [](const WalRecord& a, const WalRecord& b)
+						{
+							return a.sequence < b.sequence;
+						});
+
+					bool sameState = true;
+					for (std::size_t i = 0; i < pending.turns.size() && sameState; ++i)
+					{
+						const WalRecord& turn = pending.turns[i];
+						const std::uint64_t count = game->GetReplayLog().GetTurnCount();
+						if (turn.sequence < count)
+						{
+							++skipped;
+							continue;
+						}
+						if (turn.sequence > count)
+						{
+							// A turn went missing; anything after it would not replay the same
+							orphaned += pending.turns.size() - i;
+							break;
+						}
+						// Same hostiles deferred as when the turn was live
+						game->ReplayTurn(turn.command, turn.deferredHostiles);
+						++replayed;
+						if (game->GetReplayLog().GetStateHash(count) != turn.stateHash)
+						{
+							++diverged;
+							sameState = false;
+						}
+					}
+
+					pending.image = std::vector<std::uint8_t>();
+					// A session that replayed into a different state is not the one the player had
+					if (!sameState)
+					{
+						std::cerr << "[SessionRecovery] Session " << pending.id << " diverged from its log\n";
+						++failed;
+					}
+					else if (!insert(pending.id, std::move(game)))
+					{
+						++failed;
+					}
+				}
+			};
+
+		if (threads == 0)
+			threads = std::max(1u, std::thread::hardware_concurrency());
+		threads = static_cast<unsigned>(std::min<std::size_t>(threads, std::max<std::size_t>(1, work.size())));
+
+		std::vector<std::thread> pool;
+		for (unsigned i = 1; i < threads; ++i)
+		{
+			pool.emplace_back(worker);
+		}
+		worker();
+		for (std::thread& thread : pool)
+		{
+			thread.join();
+		}
+
+		report.created = created;
+		report.turnsReplayed = replayed;
+		report.turnsSkipped = skipped;
+		report.turnsDiverged = diverged;
+		report.turnsOrphaned = orphaned;
+		report.failedSessions = failed;
+		report.elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+		return report;
+	}
+}
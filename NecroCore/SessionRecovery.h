@@ -0,0 +1,69 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace NecroCore
+{
+	class Game;
+	class SessionStore;
+	class WriteAheadLog;
+
+	struct SessionRecoveryReport
+	{
+		std::size_t fromSnapshot = 0;
+		std::size_t created = 0;
+		std::size_t turnsReplayed = 0;
+		// Already in the snapshot image
+		std::size_t turnsSkipped = 0;
+		// Replayed turns whose state hash differs from the one logged; their
+		// sessions are dropped and counted as failed
+		std::size_t turnsDiverged = 0;
+		// Turns for sessions with no image and no create record, or after a gap
+		std::size_t turnsOrphaned = 0;
+		std::size_t failedSessions = 0;
+		// A segment ended in a torn or corrupt record; everything after it was dropped
+		bool damagedLog = false;
+		std::chrono::microseconds elapsed{ 0 };
+	};
+
+	// Crash recovery for a SessionStore backed by a WriteAheadLog.
+	//
+	// A checkpoint rotates the log, writes an image of every session to a
+	// snapshot file in the log directory and then deletes the segments older
+	// than the rotation: each turn is either in an image or in a newer segment.
+	// Recovery loads the snapshot, reads the newer segments and replays each
+	// session's turns on worker threads, so startup time is bounded by the
+	// turns since the last checkpoint rather than by the history of every game.
+	//
+	// Sessions must record (Game::StartRecording): the replay log's turn count
+	// is how recovery tells turns that are already in an image from new ones.
+	class SessionRecovery
+	{
+	public:
+		static constexpr std::uint32_t SnapshotMagic = 0x50434E42; // "BNCP"
+		static constexpr std::uint16_t SnapshotVersion = 1;
+
+		using ImageVisitor = std::function<void(std::string_view sessionId, const std::vector<std::uint8_t>& image)>;
+		// Calls the visitor for every session, like SessionStore::VisitImages
+		using ImageSource = std::function<std::size_t(const ImageVisitor& visit)>;
+		// Takes ownership of a recovered game; called from several threads at once
+		using SessionSink = std::function<bool(const std::string& sessionId, std::unique_ptr<Game>&& game)>;
+
+		static std::string SnapshotPath(const std::string& directory);
+
+		// Returns how many sessions the snapshot holds, or -1 if it could not be written.
+		static long long Checkpoint(WriteAheadLog& log, SessionStore& store);
+		static long long Checkpoint(WriteAheadLog& log, const ImageSource& images);
+
+		// Call before opening the log for writing. `threads` of zero uses one per core.
+		static SessionRecoveryReport Recover(const std::string& directory, SessionStore& store, unsigned threads = 0);
+		static SessionRecoveryReport Recover(const std::string& directory, const SessionSink& insert, unsigned threads = 0);
+	};
+}
@@ -0,0 +1,406 @@
+#include "SessionStore.h"
+#include "Hash.h"
+#include "SessionImage.h"
+
+#include <algorithm>
+#include <iostream>
+
+namespace NecroCore
+{
+	namespace
+	{
+		std::int64_t Ticks(SessionClock::time_point time)
+		{
+			return static_cast<std::int64_t>(time.time_since_epoch().count());
+		}
+	}
+
+	SessionStore::SessionStore(SessionStoreConfig config)
+		: m_Config(std::move(config))
+	{
+		if (!m_Config.archivePath.empty())
+		{
+			m_Archive = std::make_unique<SessionArchive>(m_Config.archivePath);
+			if (!m_Archive->IsOpen())
+				m_Archive.reset();
+		}
+	}
+
+	SessionStore::~SessionStore()
+	{
+		StopReaper();
+	}
+
+	std::size_t SessionStore::ShardIndex(std::string_view sessionId)
+	{
+		return static_cast<std::size_t>(HashBytes(0, sessionId.data(), sessionId.size()) % ShardCount);
+	}
+
+	bool SessionStore::Insert(const std::string& sessionId, std::unique_ptr<Game>&& game)
+	{
+		auto session = std::make_shared<Session>();
+		session->lastUsed = Ticks(SessionClock::now());
+		Shard& shard = ShardFor(sessionId);
+
+		std::unique_lock lock(shard.mutex);
+		auto [it, inserted] = shard.sessions.try_emplace(sessionId, std::move(session));
+		if (inserted)
+			it->second->game = std::move(game);
+		return inserted;
+	}
+
+	SessionStore::Lease SessionStore::Acquire(std::string_view sessionId)
+	{
+		while (true)
+		{
+			std::shared_ptr<Session> session;
+			{
+				const Shard& shard = ShardFor(sessionId);
+				std::shared_lock lock(shard.mutex);
+				auto it = shard.sessions.find(sessionId);
+				if (it == shard.sessions.end())
+					return Lease();
+				session = it->second;
+			}
+
+			// The shard lock is released first, so a slow turn never holds up the shard
+			std::unique_lock lock(session->mutex);
+			if (session->removed)
+				continue; // Dropped while we waited for it; look again
+
+			if (session->tier != SessionTier::Hot && !Promote(sessionId, *session))
+			{
+				std::cerr << "[SessionStore] Cannot restore session " << sessionId << "\n";
+				++m_RestoreFailures;
+				RemoveSession(sessionId, session);
+				return Lease();
+			}
+
+			session->lastUsed = Ticks(SessionClock::now());
+			return Lease(std::move(session), std::move(lock));
+		}
+	}
+
+	bool SessionStore::Promote(std::string_view sessionId, Session& session)
+	{
+		if (session.tier == SessionTier::Archived)
+		{
+			if (!m_Archive || !m_Archive->Take(sessionId, session.image))
+				return false;
+		}
+
+		session.game = SessionImage::Load(session.image.data(), session.image.size());
+		session.image.clear();
+		session.image.shrink_to_fit();
+		if (!session.game)
+			return false;
+
+		session.tier = SessionTier::Hot;
+		session.residentBytes = ResidentBytes(session);
+		++m_Restored;
+		return true;
+	}
+
+	void SessionStore::CompactSession(Session& session)
+	{
+		session.image = SessionImage::Save(*session.game);
+		session.game.reset();
+		session.tier = SessionTier::Compact;
+		session.residentBytes = ResidentBytes(session);
+		++m_Compacted;
+	}
+
+	void SessionStore::EvictSession(std::string_view sessionId, const std::shared_ptr<Session>& session)
+	{
+		if (m_Archive)
+		{
+			const std::vector<std::uint8_t> image = session->tier == SessionTier::Hot
+				? SessionImage::Save(*session->game)
+				: std::move(session->image);
+			if (m_Archive->Put(sessionId, image))
+			{
+				// Erased while we were writing it out
+				if (session->removed)
+					m_Archive->Erase(sessionId);
+
+				session->game.reset();
+				session->image = std::vector<std::uint8_t>();
+				session->tier = SessionTier::Archived;
+				session->residentBytes = ResidentBytes(*session);
+				++m_Evicted;
+				return;
+			}
+			std::cerr << "[SessionStore] Cannot archive session " << sessionId << ", dropping it\n";
+		}
+
+		RemoveSession(sessionId, session);
+		++m_Evicted;
+	}
+
+	void SessionStore::RemoveSession(std::string_view sessionId, const std::shared_ptr<Session>& session)
+	{
+		{
+			Shard& shard = ShardFor(sessionId);
+			std::unique_lock lock(shard.mutex);
+			auto it = shard.sessions.find(sessionId);
+			if (it != shard.sessions.end() && it->second == session)
+				shard.sessions.erase(it);
+		}
+		if (session->tier == SessionTier::Archived && m_Archive)
+			m_Archive->Erase(sessionId);
+
+		// Waiters see the removed flag and look the id up again
+		session->removed = true;
+		session->game.reset();
+		session->image = std::vector<std::uint8_t>();
+	}
+
+	std::size_t SessionStore::ResidentBytes(const Session& session)
+	{
+		std::size_t bytes = sizeof(Session) + session.image.capacity();
+		if (session.game)
+			bytes += SessionImage::EstimateResidentBytes(*session.game);
+		return bytes;
+	}
+
+	bool SessionStore::Contains(std::string_view sessionId) const
+	{
+		const Shard& shard = ShardFor(sessionId);
+		std::shared_lock lock(shard.mutex);
+		return shard.sessions.find(sessionId) != shard.sessions.end();
+	}
+
+	bool SessionStore::Erase(std::string_view sessionId)
+	{
+		std::shared_ptr<Session> session;
+		{
+			Shard& shard = ShardFor(sessionId);
+			std::unique_lock lock(shard.mutex);
+			auto it = shard.sessions.find(sessionId);
+			if (it == shard.sessions.end())
+				return false;
+			session = std::move(it->second);
+			shard.sessions.erase(it);
+		}
+
+		// Does not wait for the session's lock, so a lease holder can erase its own
+		// session; the game itself goes away with the last lease
+		session->removed = true;
+		if (m_Archive)
+			m_Archive->Erase(sessionId);
+		return true;
+	}
+
+	std::size_t SessionStore::Size() const
+	{
+		std::size_t size = 0;
+		for (const Shard& shard : m_Shards)
+		{
+			std::shared_lock lock(shard.mutex);
+			size += shard.sessions.size();
+		}
+		return size;
+	}
+
+	std::size_t SessionStore::Reap(SessionClock::time_point now)
+	{
+		std::vector<Candidate> candidates;
+		for (const Shard& shard : m_Shards)
+		{
+			std::shared_lock lock(shard.mutex);
+			for (const auto& [id, session] : shard.sessions)
+			{
+				candidates.push_back({ id, session, session->lastUsed.load() });
+			}
+		}
+
+		const std::int64_t nowTicks = Ticks(now);
+		auto idleLongerThan = [nowTicks](const Candidate& candidate, std::chrono::seconds limit)
+			{
+				return limit.count() > 0 && nowTicks - candidate.lastUsed > std::chrono::duration_cast<SessionClock::duration>(limit).count();
+			};
+
+		// Busy, gone, or used since the scan: leave it for the next pass
+		auto tryLock = [](const Candidate& candidate)
+			{
+				std::unique_lock lock(candidate.session->mutex, std::try_to_lock);
+				if (lock && (candidate.session->removed || candidate.session->lastUsed != candidate.lastUsed))
+					lock.unlock();
+				return lock;
+			};
+
+		std::size_t moved = 0;
+		std::size_t residentBytes = 0;
+		std::size_t kept = 0;
+		for (std::size_t i = 0; i < candidates.size(); ++i)
+		{
+			Candidate& candidate = candidates[i];
+			Session& session = *candidate.session;
+			if (std::unique_lock lock = tryLock(candidate))
+			{
+				if (session.tier != SessionTier::Archived && idleLongerThan(candidate, m_Config.idleTimeout))
+				{
+					EvictSession(candidate.id, candidate.session);
+					++m_Expired;
+					++moved;
+				}
+				else if (session.tier == SessionTier::Hot && idleLongerThan(candidate, m_Config.compactAfter))
+				{
+					CompactSession(session);
+					++moved;
+				}
+				else if (session.tier == SessionTier::Hot)
+				{
+					// Games grow as they are played, so live sizes are re-estimated every pass
+					session.residentBytes = ResidentBytes(session);
+				}
+				if (session.removed)
+					continue;
+			}
+
+			residentBytes += session.residentBytes;
+			if (kept != i)
+				candidates[kept] = std::move(candidate);
+			++kept;
+		}
+		candidates.resize(kept);
+
+		if (m_Config.memoryBudget > 0 && residentBytes > m_Config.memoryBudget)
+		{
+			std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b)
+				{
+					return a.lastUsed < b.lastUsed;
+				});
+
+			// Compacting the oldest games is cheap to undo; evicting them only if that is not enough
+			for (SessionTier from : { SessionTier::Hot, SessionTier::Compact })
+			{
+				for (const Candidate& candidate : candidates)
+				{
+					if (residentBytes <= m_Config.memoryBudget)
+						break;
+					std::unique_lock lock = tryLock(candidate);
+					if (!lock || candidate.session->tier != from)
+						continue;
+
+					const std::size_t before = candidate.session->residentBytes;
+					if (from == SessionTier::Hot)
+						CompactSession(*candidate.session);
+					else
+						EvictSession(candidate.id, candidate.session);
+					const std::size_t after = candidate.session->removed ? 0 : candidate.session->residentBytes.load();
+					residentBytes = residentBytes + after > before ? residentBytes + after - before : 0;
+					++moved;
+				}
+			}
+		}
+
+		if (m_Archive)
+			m_Archive->Compact();
+
+		m_ResidentBytes = residentBytes;
+		return moved;
+	}
+
+	void SessionStore::StartReaper()
+	{
+		std::lock_guard lock(m_ReaperMutex);
+		if (m_Reaper.joinable())
+			return;
+		m_ReaperStop = false;
+		m_Reaper = std::thread([this]()
+			{
+				std::unique_lock lock(m_ReaperMutex);
+				while (!m_ReaperWake.wait_for(lock, m_Config.reapInterval, [this]() { return m_ReaperStop; }))
+				{
+					lock.unlock();
+					Reap();
+					lock.lock();
+				}
+			});
+	}
+
+	void SessionStore::StopReaper()
+	{
+		std::thread reaper;
+		{
+			std::lock_guard lock(m_ReaperMutex);
+			m_ReaperStop = true;
+			reaper = std::move(m_Reaper);
+		}
+		m_ReaperWake.notify_all();
+		if (reaper.joinable())
+			reaper.join();
+	}
+
+	std::size_t SessionStore::VisitImages(const std::function<void(std::string_view sessionId, const std::vector<std::uint8_t>& image)>& visit)
+	{
+		std::vector<Candidate> sessions;
+		for (const Shard& shard : m_Shards)
+		{
+			std::shared_lock lock(shard.mutex);
+			for (const auto& [id, session] : shard.sessions)
+			{
+				sessions.push_back({ id, session, 0 });
+			}
+		}
+
+		std::size_t visited = 0;
+		std::vector<std::uint8_t> image;
+		for (const Candidate& candidate : sessions)
+		{
+			Session& session = *candidate.session;
+			std::unique_lock lock(session.mutex);
+			if (session.removed)
+				continue;
+
+			switch (session.tier.load())
+			{
+			case SessionTier::Hot:
+				image = SessionImage::Save(*session.game);
+				break;
+			case SessionTier::Compact:
+				image = session.image;
+				break;
+			case SessionTier::Archived:
+				if (!m_Archive || !m_Archive->Read(candidate.id, image))
+				{
+					std::cerr << "[SessionStore] Cannot read archived session " << candidate.id << "\n";
+					continue;
+				}
+				break;
+			}
+			lock.unlock();
+
+			visit(candidate.id, image);
+			++visited;
+		}
+		return visited;
+	}
+
+	SessionStoreMetrics SessionStore::GetMetrics() const
+	{
+		SessionStoreMetrics metrics;
+		for (const Shard& shard : m_Shards)
+		{
+			std::shared_lock lock(shard.mutex);
+			for (const auto& [id, session] : shard.sessions)
+			{
+				switch (session->tier.load())
+				{
+				case SessionTier::Hot:      ++metrics.hot; break;
+				case SessionTier::Compact:  ++metrics.compact; break;
+				case SessionTier::Archived: ++metrics.archived; break;
+				}
+			}
+		}
+		metrics.residentBytes = m_ResidentBytes;
+		metrics.archiveBytes = m_Archive ? m_Archive->GetFileBytes() : 0;
+		metrics.compacted = m_Compacted;
+		metrics.evicted = m_Evicted;
+		metrics.expired = m_Expired;
+		metrics.restored = m_Restored;
+		metrics.restoreFailures = m_RestoreFailures;
+		return metrics;
+	}
+}
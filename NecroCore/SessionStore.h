@@ -0,0 +1,203 @@
+#pragma once
+
+#include "Game.h"
+#include "SessionArchive.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace NecroCore
+{
+	using SessionClock = std::chrono::steady_clock;
+
+	// Where a session's game currently lives
+	enum class SessionTier : std::uint8_t
+	{
+		// A live Game object
+		Hot,
+		// A SessionImage blob in memory
+		Compact,
+		// A SessionImage record in the SessionArchive file
+		Archived
+	};
+
+	struct SessionStoreConfig
+	{
+		// Sessions left alone this long are compacted into an in-memory image;
+		// zero keeps them live.
+		std::chrono::seconds compactAfter{ 0 };
+		// Sessions left alone this long leave memory: archived if there is an
+		// archive, dropped otherwise. Zero keeps them forever.
+		std::chrono::seconds idleTimeout{ 0 };
+		// Once sessions are estimated above this many bytes, the least recently
+		// used are compacted and then evicted until they fit; zero means no cap.
+		std::size_t memoryBudget = 0;
+		// Append-only file for evicted sessions; empty drops them instead.
+		std::string archivePath;
+		std::chrono::milliseconds reapInterval{ 1000 };
+	};
+
+	struct SessionStoreMetrics
+	{
+		std::size_t hot = 0;
+		std::size_t compact = 0;
+		std::size_t archived = 0;
+		// Estimated by the last reap
+		std::size_t residentBytes = 0;
+		std::size_t archiveBytes = 0;
+		std::uint64_t compacted = 0;
+		// Archived or dropped
+		std::uint64_t evicted = 0;
+		std::uint64_t expired = 0;
+		// Brought back to a live Game from either colder tier
+		std::uint64_t restored = 0;
+		std::uint64_t restoreFailures = 0;
+	};
+
+	// Games keyed by session id, safe to use from many request threads.
+	//
+	// Ids are hashed onto ShardCount shards, each with its own reader/writer
+	// lock that is only held for the map lookup or insert, so creating a
+	// session never blocks lookups in other shards. Each session also has a
+	// mutex that a Lease holds for as long as the caller works on the game:
+	// turns for one game run one at a time, different games run in parallel.
+	//
+	// Idle sessions move down the tiers (live Game, in-memory image, archive
+	// file) and Acquire brings them straight back to a live Game. Reap does
+	// the moving; it only try-locks sessions, so it skips games that are in
+	// use rather than waiting on them. StartReaper runs it on a background
+	// thread.
+	class SessionStore
+	{
+		struct Session
+		{
+			std::mutex mutex;
+			// Guarded by mutex: the game while Hot, its image while Compact
+			std::unique_ptr<Game> game;
+			std::vector<std::uint8_t> image;
+			// Set once the id no longer maps to this session
+			std::atomic<bool> removed{ false };
+			// Written under mutex; read without it for metrics
+			std::atomic<SessionTier> tier{ SessionTier::Hot };
+			// SessionClock ticks of the last Acquire
+			std::atomic<std::int64_t> lastUsed{ 0 };
+			std::atomic<std::size_t> residentBytes{ 0 };
+		};
+
+	public:
+		static constexpr std::size_t ShardCount = 64;
+
+		// Exclusive access to one game. The session stays alive while leased,
+		// even if it is erased from the store meanwhile.
+		class Lease
+		{
+		public:
+			Lease() = default;
+
+			explicit operator bool() const { return m_Session != nullptr; }
+			Game& operator*() const { return *m_Session->game; }
+			Game* operator->() const { return m_Session->game.get(); }
+			Game* Get() const { return m_Session ? m_Session->game.get() : nullptr; }
+
+		private:
+			friend class SessionStore;
+			Lease(std::shared_ptr<Session> session, std::unique_lock<std::mutex>&& lock)
+				: m_Session(std::move(session)), m_Lock(std::move(lock)) {}
+
+			std::shared_ptr<Session> m_Session;
+			std::unique_lock<std::mutex> m_Lock;
+		};
+
+		explicit SessionStore(SessionStoreConfig config = {});
+		~SessionStore();
+
+		SessionStore(const SessionStore&) = delete;
+		SessionStore& operator=(const SessionStore&) = delete;
+
+		// False if the id is already taken; the game is then left untouched.
+		bool Insert(const std::string& sessionId, std::unique_ptr<Game>&& game);
+		// An empty lease if there is no such session. Blocks while another
+		// thread holds a lease on the same session. Compacted and archived
+		// sessions are restored to a live Game first.
+		Lease Acquire(std::string_view sessionId);
+		bool Contains(std::string_view sessionId) const;
+		bool Erase(std::string_view sessionId);
+
+		// Sessions in every tier
+		std::size_t Size() const;
+		static std::size_t ShardIndex(std::string_view sessionId);
+
+		// One pass over every session as of `now`; returns how many sessions
+		// moved to a colder tier or were dropped.
+		std::size_t Reap(SessionClock::time_point now = SessionClock::now());
+		void StartReaper();
+		void StopReaper();
+
+		SessionStoreMetrics GetMetrics() const;
+
+		// Calls `visit` with a SessionImage of every session, whichever tier it
+		// is in, taking each session's lock in turn. A session in use is waited
+		// for, so every turn that finished before the call is in its image.
+		// Returns how many sessions were visited.
+		std::size_t VisitImages(const std::function<void(std::string_view sessionId, const std::vector<std::uint8_t>& image)>& visit);
+
+	private:
+		struct IdHash
+		{
+			using is_transparent = void;
+			std::size_t operator()(std::string_view id) const { return std::hash<std::string_view>{}(id); }
+		};
+
+		struct alignas(64) Shard
+		{
+			mutable std::shared_mutex mutex;
+			std::unordered_map<std::string, std::shared_ptr<Session>, IdHash, std::equal_to<>> sessions;
+		};
+
+		struct Candidate
+		{
+			std::string id;
+			std::shared_ptr<Session> session;
+			std::int64_t lastUsed;
+		};
+
+		Shard& ShardFor(std::string_view sessionId) { return m_Shards[ShardIndex(sessionId)]; }
+		const Shard& ShardFor(std::string_view sessionId) const { return m_Shards[ShardIndex(sessionId)]; }
+
+		// All of these expect the session's mutex to be held
+		bool Promote(std::string_view sessionId, Session& session);
+		void CompactSession(Session& session);
+		void EvictSession(std::string_view sessionId, const std::shared_ptr<Session>& session);
+		void RemoveSession(std::string_view sessionId, const std::shared_ptr<Session>& session);
+		static std::size_t ResidentBytes(const Session& session);
+
+		SessionStoreConfig m_Config;
+		std::unique_ptr<SessionArchive> m_Archive;
+		std::array<Shard, ShardCount> m_Shards;
+
+		std::atomic<std::uint64_t> m_Compacted{ 0 };
+		std::atomic<std::uint64_t> m_Evicted{ 0 };
+		std::atomic<std::uint64_t> m_Expired{ 0 };
+		std::atomic<std::uint64_t> m_Restored{ 0 };
+		std::atomic<std::uint64_t> m_RestoreFailures{ 0 };
+		std::atomic<std::size_t> m_ResidentBytes{ 0 };
+
+		std::mutex m_ReaperMutex;
+		std::condition_variable m_ReaperWake;
+		bool m_ReaperStop = false;
+		std::thread m_Reaper;
+	};
+}
@@ -1,14 +1,157 @@
 #include "Spell.h"
+#include "CastResult.h"
+#include "Hash.h"
+#include "Messages.h"
+
+#include <algorithm>
+#include <bit>
 
 namespace NecroCore
 {
-    const ISpell& GetWaterSpell();
-    const ISpell& GetFireSpell();
+    // A static library only links the objects something refers to, so every
+    // registered spell is named here once.
+    extern const int g_SpellAnchor_FireSpell;
+    extern const int g_SpellAnchor_WaterSpell;
+    extern const int g_SpellAnchor_PoisonSpell;
+
+    extern const int* const g_SpellAnchors[];
+    const int* const g_SpellAnchors[] = {
+        &g_SpellAnchor_FireSpell,
+        &g_SpellAnchor_WaterSpell,
+        &g_SpellAnchor_PoisonSpell,
+    };
+
+    namespace
+    {
+        struct RegistryState
+        {
+            std::vector<const ISpell*> spells;
+            // Open table of size mask + 1 in which no two names share a slot
+            std::vector<const ISpell*> slots;
+            std::uint64_t seed = 0;
+            std::size_t mask = 0;
+            std::string elementList;
+        };
+
+        RegistryState& State()
+        {
+            static RegistryState state;
+            return state;
+        }
+
+        std::size_t SlotOf(std::string_view name, std::uint64_t seed, std::size_t mask)
+        {
+            return static_cast<std::size_t>(HashBytes(seed, name.data(), name.size())) & mask;
+        }
+
+        // Rebuilds the help list and the collision-free slots from the sorted spells
+        void BuildIndex(RegistryState& state)
+        {
+            state.elementList.clear();
+            for (const ISpell* s : state.spells)
+            {
+                if (!state.elementList.empty())
+                    state.elementList += '|';
+                state.elementList += s->GetName();
+            }
+
+            std::size_t size = std::bit_ceil(std::max<std::size_t>(state.spells.size() * 2, 2));
+            for (;;)
+            {
+                // A handful of seeds nearly always finds a perfect one at load factor 1/2
+                for (std::uint64_t seed = 0; seed < 64; ++seed)
+                {
+                    state.slots.assign(size, nullptr);
+                    bool collided = false;
+                    for (const ISpell* spell : state.spells)
+                    {
+                        const ISpell*& slot = state.slots[SlotOf(spell->GetName(), seed, size - 1)];
+                        if (slot)
+                        {
+                            collided = true;
+                            break;
+                        }
+                        slot = spell;
+                    }
+                    if (!collided)
+                    {
+                        state.seed = seed;
+                        state.mask = size - 1;
+                        return;
+                    }
+                }
+                size *= 2;
+            }
+        }
+    }
+
+    void SpellRegistry::Register(const ISpell& spell)
+    {
+        RegistryState& state = State();
+        const std::string_view name = spell.GetName();
+        auto it = std::lower_bound(state.spells.begin(), state.spells.end(), name,
+            [](const ISpell* s, std::string_view value) { return std::string_view(s->GetName()) < value; });
+        if (it != state.spells.end() && (*it)->GetName() == name)
+        {
+            // A later registration under the same name replaces the earlier one
+            *it = &spell;
+        }
+        else
+        {
+            state.spells.insert(it, &spell);
+        }
+        BuildIndex(state);
+    }
+
+    void SpellRegistry::Unregister(std::string_view name)
+    {
+        RegistryState& state = State();
+        auto it = std::lower_bound(state.spells.begin(), state.spells.end(), name,
+            [](const ISpell* s, std::string_view value) { return std::string_view(s->GetName()) < value; });
+        if (it == state.spells.end() || (*it)->GetName() != name)
+            return;
+        state.spells.erase(it);
+        BuildIndex(state);
+    }
+
+    const ISpell* SpellRegistry::Find(std::string_view name)
+    {
+        const RegistryState& state = State();
+        if (state.slots.empty())
+            return nullptr;
+        const ISpell* spell = state.slots[SlotOf(name, state.seed, state.mask)];
+        return (spell && spell->GetName() == name) ? spell : nullptr;
+    }
+
+    const std::vector<const ISpell*>& SpellRegistry::GetSpells()
+    {
+        return State().spells;
+    }
+
+    const std::string& SpellRegistry::GetElementList()
+    {
+        return State().elementList;
+    }
+
+    CastResult ISpell::CastArea(Game&, const AreaHit&, const std::string& direction) const
+    {
+        CastResult result{};
+        MessageArgs args;
+        args.element = GetName();
+        args.direction = direction;
+        Messages::Append(result.description, Message::CastFizzles, args);
+        return result;
+    }
 
     const ISpell* FindSpellByName(const std::string& name)
     {
-        if (name == "water") return &GetWaterSpell();
-        if (name == "fire")  return &GetFireSpell();
-        return nullptr;
+        return SpellRegistry::Find(name);
+    }
+
+    std::optional<StatusEffect> StatusEffectFromSpell(std::string_view spellName)
+    {
+        if (const ISpell* spell = SpellRegistry::Find(spellName))
+            return spell->GetElement();
+        return std::nullopt;
     }
-}
\ No newline at end of file
+}
@@ -1,10 +1,17 @@
 #pragma once
 
+#include "Status.h"
+
+#include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
+
 namespace NecroCore {
 
     class Game; 
     struct CastResult;
+    struct AreaHit;
 
     class ISpell
     {
@@ -12,9 +19,49 @@ namespace NecroCore {
         virtual ~ISpell() = default;
 
         virtual const char* GetName() const = 0;
+        // The status effect this spell's element stands for
+        virtual StatusEffect GetElement() const = 0;
 
         virtual CastResult Cast(Game& game, int tx, int ty, const std::string& direction) const = 0;
+        // Line, cone and radius casts; `hit` is already resolved against walls.
+        // Spells without an area form fizzle.
+        virtual CastResult CastArea(Game& game, const AreaHit& hit, const std::string& direction) const;
+    };
+
+    // Every castable spell, keyed by name. Spells join during static
+    // initialization through NECRO_REGISTER_SPELL, and each registration
+    // rebuilds a collision-free hash over the names. A lookup is then one hash
+    // and one string compare, however many spells there are. Registering
+    // after games have started is not thread-safe.
+    class SpellRegistry
+    {
+    public:
+        static void Register(const ISpell& spell);
+        // Removes the spell registered under name, if any
+        static void Unregister(std::string_view name);
+        static const ISpell* Find(std::string_view name);
+
+        // Registered spells sorted by name
+        static const std::vector<const ISpell*>& GetSpells();
+        // Spell names sorted and joined with '|', for help text
+        static const std::string& GetElementList();
+
+        template <typename SpellType>
+        static int RegisterStatic()
+        {
+            static const SpellType instance;
+            Register(instance);
+            return 0;
+        }
     };
 
     const ISpell* FindSpellByName(const std::string& name);
-}
\ No newline at end of file
+    std::optional<StatusEffect> StatusEffectFromSpell(std::string_view spellName);
+}
+
+// Registers SpellType (default-constructible, in namespace NecroCore) at static
+// initialization. Also add the spell to the anchor list in Spell.cpp, which
+// keeps the linker from dropping the spell's object file from the static library.
+#define NECRO_REGISTER_SPELL(SpellType) \
+    extern const int g_SpellAnchor_##SpellType; \
+    const int g_SpellAnchor_##SpellType = ::NecroCore::SpellRegistry::RegisterStatic<SpellType>()
@@ -0,0 +1,229 @@
+#include "SpellArea.h"
+#include "Game.h"
+#include "Map.h"
+#include "Entity.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+
+namespace NecroCore
+{
+	namespace
+	{
+		constexpr int DirectionCount = static_cast<int>(std::size(Map::dirs));
+		constexpr int ShapeCount = static_cast<int>(AreaShape::Radius) + 1;
+
+		bool InShape(AreaShape shape, int ox, int oy, int dx, int dy, int size)
+		{
+			const int reach = std::max(std::abs(ox), std::abs(oy));
+			if (reach == 0 || reach > size)
+				return false;
+
+			switch (shape)
+			{
+			case AreaShape::Line:
+				return ox == dx * reach && oy == dy * reach;
+			case AreaShape::Cone:
+			{
+				// Within 45 degrees either side of the direction
+				const long long dot = static_cast<long long>(ox) * dx + static_cast<long long>(oy) * dy;
+				const long long lengths = static_cast<long long>(ox * ox + oy * oy) * (dx * dx + dy * dy);
+				return dot > 0 && 2 * dot * dot >= lengths;
+			}
+			case AreaShape::Radius:
+				return ox * ox + oy * oy <= size * size + size;
+			default:
+				return false;
+			}
+		}
+
+		int RoundedStep(int value, int reach)
+		{
+			// value * (reach - 1) / reach, rounded half away from zero
+			const int numerator = 2 * value * (reach - 1);
+			const int bias = value < 0 ? -reach : reach;
+			return (numerator + bias) / (2 * reach);
+		}
+
+		std::vector<SpellArea::Offset> BuildStencil(AreaShape shape, int dx, int dy, int size)
+		{
+			std::vector<SpellArea::Offset> stencil;
+			for (int oy = -size; oy <= size; ++oy)
+			{
+				for (int ox = -size; ox <= size; ++ox)
+				{
+					if (InShape(shape, ox, oy, dx, dy, size))
+						stencil.push_back({ static_cast<std::int8_t>(ox), static_cast<std::int8_t>(oy), -1 });
+				}
+			}
+
+			auto reachOf = [](const SpellArea::Offset& o) { return std::max(std::abs(o.dx), std::abs(o.dy)); };
+			std::stable_sort(stencil.begin(), stencil.end(),
+				[&](const SpellArea::Offset& a, const SpellArea::Offset& b) { return reachOf(a) < reachOf(b); });
+
+			for (SpellArea::Offset& offset : stencil)
+			{
+				const int reach = reachOf(offset);
+				if (reach <= 1)
+					continue;
+
+				// The stencil member one ring in that lies closest to the ray back to the caster
+				const int px = RoundedStep(offset.dx, reach);
+				const int py = RoundedStep(offset.dy, reach);
+				int best = -1;
+				int bestDistance = 0;
+				for (std::size_t i = 0; i < stencil.size() && reachOf(stencil[i]) < reach; ++i)
+				{
+					if (reachOf(stencil[i]) != reach - 1)
+						continue;
+					const int ex = stencil[i].dx - px;
+					const int ey = stencil[i].dy - py;
+					const int distance = ex * ex + ey * ey;
+					if (best < 0 || distance < bestDistance)
+					{
+						best = static_cast<int>(i);
+						bestDistance = distance;
+					}
+				}
+				offset.parent = static_cast<std::int16_t>(best);
+			}
+			return stencil;
+		}
+
+		struct StencilTable
+		{
+			// [shape][direction][size - 1]; Radius and Single only fill direction 0
+			std::array<std::array<std::array<std::vector<SpellArea::Offset>, SpellArea::MaxSize>, DirectionCount>, ShapeCount> stencils;
+
+			StencilTable()
+			{
+				for (int size = 1; size <= SpellArea::MaxSize; ++size)
+				{
+					for (int d = 0; d < DirectionCount; ++d)
+					{
+						stencils[static_cast<int>(AreaShape::Line)][d][size - 1] = BuildStencil(AreaShape::Line, Map::dirs[d].dx, Map::dirs[d].dy, size);
+						stencils[static_cast<int>(AreaShape::Cone)][d][size - 1] = BuildStencil(AreaShape::Cone, Map::dirs[d].dx, Map::dirs[d].dy, size);
+					}
+					stencils[static_cast<int>(AreaShape::Radius)][0][size - 1] = BuildStencil(AreaShape::Radius, 0, 0, size);
+				}
+			}
+		};
+
+		const StencilTable& Stencils()
+		{
+			static const StencilTable table;
+			return table;
+		}
+
+		bool BlocksArea(TileType tile)
+		{
+			return tile == TileType::Wall || tile == TileType::Empty;
+		}
+
+		constexpr std::pair<std::string_view, AreaShape> kShapeNames[] = {
+			{ "single", AreaShape::Single },
+			{ "line", AreaShape::Line },
+			{ "cone", AreaShape::Cone },
+			{ "radius", AreaShape::Radius },
+		};
+	}
+
+	const std::vector<SpellArea::Offset>& SpellArea::GetStencil(AreaShape shape, int direction, int size)
+	{
+		static const std::vector<Offset> empty;
+		if (shape == AreaShape::Single)
+			return empty;
+
+		size = std::clamp(size, 1, MaxSize);
+		direction = shape == AreaShape::Radius ? 0 : direction;
+		if (direction < 0 || direction >= DirectionCount)
+			return empty;
+		return Stencils().stencils[static_cast<int>(shape)][direction][size - 1];
+	}
+
+	void SpellArea::Resolve(const Map& map, AreaShape shape, int direction, int size, int originX, int originY, std::vector<AreaTile>& out)
+	{
+		out.clear();
+		const std::vector<Offset>& stencil = GetStencil(shape, direction, size);
+
+		thread_local std::vector<std::uint8_t> open;
+		open.assign(stencil.size(), 0);
+		for (std::size_t i = 0; i < stencil.size(); ++i)
+		{
+			const Offset& offset = stencil[i];
+			if (offset.parent >= 0 && !open[static_cast<std::size_t>(offset.parent)])
+				continue;
+
+			const int x = originX + offset.dx;
+			const int y = originY + offset.dy;
+			if (BlocksArea(map.GetTile(x, y)))
+				continue;
+
+			open[i] = 1;
+			out.push_back({ x, y });
+		}
+	}
+
+	void SpellArea::FindActors(Game& game, const std::vector<AreaTile>& tiles, std::vector<Actor*>& out)
+	{
+		out.clear();
+		if (tiles.empty())
+			return;
+
+		int minX = tiles.front().x;
+		int maxX = minX;
+		int minY = tiles.front().y;
+		int maxY = minY;
+		for (const AreaTile& tile : tiles)
+		{
+			minX = std::min(minX, tile.x);
+			maxX = std::max(maxX, tile.x);
+			minY = std::min(minY, tile.y);
+			maxY = std::max(maxY, tile.y);
+		}
+		const int width = maxX - minX + 1;
+
+		thread_local std::vector<std::uint8_t> occupied;
+		occupied.assign(static_cast<std::size_t>(width) * (maxY - minY + 1), 0);
+		for (const AreaTile& tile : tiles)
+		{
+			occupied[static_cast<std::size_t>(tile.y - minY) * width + (tile.x - minX)] = 1;
+		}
+
+		auto inArea = [&](const Actor& actor)
+			{
+				return actor.IsAlive() && actor.x >= minX && actor.x <= maxX && actor.y >= minY && actor.y <= maxY &&
+					occupied[static_cast<std::size_t>(actor.y - minY) * width + (actor.x - minX)];
+			};
+
+		Player& player = game.GetPlayer();
+		if (inArea(player))
+			out.push_back(&player);
+		for (Entity& entity : game.GetEntities())
+		{
+			if (inArea(entity))
+				out.push_back(&entity);
+		}
+	}
+
+	std::optional<AreaShape> SpellArea::ShapeFromString(std::string_view name)
+	{
+		for (const auto& [shapeName, shape] : kShapeNames)
+		{
+			if (shapeName == name)
+				return shape;
+		}
+		return std::nullopt;
+	}
+
+	const char* SpellArea::ShapeToString(AreaShape shape)
+	{
+		for (const auto& [shapeName, value] : kShapeNames)
+		{
+			if (value == shape)
+				return shapeName.data();
+		}
+		return "single";
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Messages.h"
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace NecroCore
+{
+	class Game;
+	class Map;
+	struct Actor;
+
+	enum class AreaShape : std::uint8_t
+	{
+		Single,
+		Line,
+		Cone,
+		Radius
+	};
+
+	struct AreaTile
+	{
+		int x;
+		int y;
+	};
+
+	// What an area spell reaches: the tiles in the order they were reached, and
+	// the live actors standing on them (the player first, then entities by id).
+	struct AreaHit
+	{
+		AreaShape shape = AreaShape::Single;
+		std::vector<AreaTile> tiles;
+		std::vector<Actor*> actors;
+	};
+
+	// Offset stencils for area spells, precomputed once for every shape,
+	// direction (index into Map::dirs) and size. Offsets are relative to the
+	// caster and ordered by distance. Each one names its parent, the previous
+	// offset on the ray from the caster, so walls shadow whatever lies behind
+	// them without tracing rays at cast time.
+	class SpellArea
+	{
+	public:
+		static constexpr int MaxSize = 10;
+		static constexpr int DefaultSize = 3;
+
+		struct Offset
+		{
+			std::int8_t dx;
+			std::int8_t dy;
+			// Index of the parent offset in the same stencil, or -1 next to the caster
+			std::int16_t parent;
+		};
+
+		// Line and Cone need a direction; Radius ignores it. Size is clamped to [1, MaxSize].
+		static const std::vector<Offset>& GetStencil(AreaShape shape, int direction, int size);
+
+		// Tiles of the stencil placed at (originX, originY) that the area reaches.
+		// Walls and empty space stop it; anything walkable is hit and lets it through.
+		static void Resolve(const Map& map, AreaShape shape, int direction, int size, int originX, int originY, std::vector<AreaTile>& out);
+
+		// Live actors standing on `tiles`, found through an occupancy grid over
+		// the tiles' bounding box rather than by testing each actor against each tile.
+		static void FindActors(Game& game, const std::vector<AreaTile>& tiles, std::vector<Actor*>& out);
+
+		static std::optional<AreaShape> ShapeFromString(std::string_view name);
+		static const char* ShapeToString(AreaShape shape);
+
+		// The shape's message in a block laid out Line, Cone, Radius from `lineMessage`
+		static Message MessageFor(Message lineMessage, AreaShape shape)
+		{
+			const int offset = shape == AreaShape::Single ? 0 : static_cast<int>(shape) - static_cast<int>(AreaShape::Line);
+			return static_cast<Message>(static_cast<int>(lineMessage) + offset);
+		}
+	};
+}
@@ -1,8 +1,13 @@
 #pragma once
 
+#include <bit>
+#include <cstddef>
 #include <cstdint>
+#include <iterator>
+#include <limits>
 #include <optional>
 #include <string>
+#include <type_traits>
 
 namespace NecroCore
 {
@@ -14,26 +19,29 @@ namespace NecroCore
 		Wet = 1 << 2,
     };
 
-    inline StatusEffect operator|(StatusEffect a, StatusEffect b)
+    using StatusMask = std::underlying_type_t<StatusEffect>;
+
+    inline constexpr StatusEffect operator|(StatusEffect a, StatusEffect b)
     {
         return static_cast<StatusEffect>(
-            static_cast<std::uint8_t>(a) | static_cast<std::uint8_t>(b));
+            static_cast<StatusMask>(a) | static_cast<StatusMask>(b));
     }
 
-    inline StatusEffect& operator|=(StatusEffect& a, StatusEffect b)
+    inline constexpr StatusEffect& operator|=(StatusEffect& a, StatusEffect b)
     {
         a = a | b;
         return a;
     }
 
-    inline bool HasStatus(StatusEffect value, StatusEffect flag)
+    inline constexpr bool HasStatus(StatusEffect value, StatusEffect flag)
     {
-        return (static_cast<std::uint8_t>(value) &
-            static_cast<std::uint8_t>(flag)) != 0;
+        return (static_cast<StatusMask>(value) &
+            static_cast<StatusMask>(flag)) != 0;
     }
 
     struct StatusDescriptor
     {
+        StatusEffect effect;
         const char* playerTickMessage;
         const char* entityTickMessage;
         const char* playerDeathMessage;
@@ -44,57 +52,94 @@ namespace NecroCore
         int defaultDuration;
     };
 
-    inline std::optional<StatusEffect> StatusEffectFromSpell(const std::string& spellName)
+    // One row per StatusEffect bit, in bit order. Adding an effect (or widening
+    // StatusEffect's underlying type) only needs a new enumerator and a row here.
+    inline constexpr StatusDescriptor kStatusTable[] = {
+        {
+            StatusEffect::OnFire,
+            "Flames bite at your legs, heat searing your skin.",
+            "A {entity} writhes in fire.",
+			"You finally sink into the blaze, vision drowning in red.",
+			"A {entity} is consumed by the flames.",
+            "The flames around you die out.",
+            "The flames consuming the {entity} die out.",
+            1,
+            3
+        },
+        {
+            StatusEffect::Poisoned,
+            "The poison courses through your veins, burning with acidic pain.",
+			"A {entity} coughs violently, poisoned.",
+			"The poison overwhelms you, and you collapse to the ground.",
+            "A {entity} succumbs to the poison and collapses.",
+            "The poison's grip on you loosens, and you feel relief.",
+            "The {entity} looks healthier as the poison wears off.",
+            2,
+            3
+		},
+        {
+            StatusEffect::Wet,
+            "Water drips from your soaked clothes, chilling you to the bone.",
+            "A {entity} is drenched, water pooling around it.",
+            "You shiver as the water saps your strength.",
+            "A {entity} struggles to move through the water.",
+            "The water drips away, leaving you feeling warm.",
+            "The {entity} shakes off the water, regaining its composure.",
+            1,
+            2
+        },
+    };
+
+    inline constexpr std::size_t StatusEffectCount = std::size(kStatusTable);
+
+    static_assert(StatusEffectCount <= std::numeric_limits<StatusMask>::digits,
+        "StatusEffect's underlying type is too narrow for the status table");
+
+    constexpr bool StatusTableInBitOrder()
+    {
+        for (std::size_t i = 0; i < StatusEffectCount; ++i)
+        {
+            if (static_cast<StatusMask>(kStatusTable[i].effect) != (StatusMask{ 1 } << i))
+                return false;
+        }
+        return true;
+    }
+    static_assert(StatusTableInBitOrder(), "kStatusTable rows must follow StatusEffect bit order");
+
+    inline constexpr StatusEffect StatusEffectFromIndex(std::size_t index)
     {
-        if (spellName == "fire")
-            return StatusEffect::OnFire;
-        if (spellName == "poison")
-            return StatusEffect::Poisoned;
-        if (spellName == "water")
-			return StatusEffect::Wet;
+        return static_cast<StatusEffect>(StatusMask{ 1 } << index);
+    }
 
-        return std::nullopt;
+    // Bit position of a single-flag status, or StatusEffectCount if it is not exactly one known flag.
+    inline constexpr std::size_t StatusIndex(StatusEffect status)
+    {
+        const StatusMask mask = static_cast<StatusMask>(status);
+        if (!std::has_single_bit(mask))
+            return StatusEffectCount;
+        const std::size_t index = static_cast<std::size_t>(std::countr_zero(mask));
+        return index < StatusEffectCount ? index : StatusEffectCount;
     }
 
-    inline std::optional<StatusDescriptor> GetStatusDescriptor(StatusEffect status)
+    // Calls fn(index) for every status bit set in mask, lowest bit first.
+    template <typename Fn>
+    inline void ForEachStatusIndex(StatusEffect mask, Fn&& fn)
     {
-        switch (status)
+        StatusMask bits = static_cast<StatusMask>(static_cast<StatusMask>(mask) &
+            ((StatusEffectCount >= std::numeric_limits<StatusMask>::digits)
+                ? std::numeric_limits<StatusMask>::max()
+                : static_cast<StatusMask>((StatusMask{ 1 } << StatusEffectCount) - 1)));
+        while (bits != 0)
         {
-        case StatusEffect::OnFire:
-            return StatusDescriptor{
-                "Flames bite at your legs, heat searing your skin.",
-                "A {entity} writhes in fire.",
-				"You finally sink into the blaze, vision drowning in red.",
-				"A {entity} is consumed by the flames.",
-                "The flames around you die out.",
-                "The flames consuming the {entity} die out.",
-                1,
-                3
-            };
-        case StatusEffect::Poisoned:
-            return StatusDescriptor{
-                "The poison courses through your veins, burning with acidic pain.",
-				"A {entity} coughs violently, poisoned.",
-				"The poison overwhelms you, and you collapse to the ground.",
-                "A {entity} succumbs to the poison and collapses.",
-                "The poison's grip on you loosens, and you feel relief.",
-                "The {entity} looks healthier as the poison wears off.",
-                2,
-                3
-			};
-        case StatusEffect::Wet:
-            return StatusDescriptor{
-                "Water drips from your soaked clothes, chilling you to the bone.",
-                "A {entity} is drenched, water pooling around it.",
-                "You shiver as the water saps your strength.",
-                "A {entity} struggles to move through the water.",
-                "The water drips away, leaving you feeling warm.",
-                "The {entity} shakes off the water, regaining its composure.",
-                1,
-                2
-            };
-        default:
-            return std::nullopt;
+            const std::size_t index = static_cast<std::size_t>(std::countr_zero(bits));
+            bits = static_cast<StatusMask>(bits & (bits - 1));
+            fn(index);
         }
     }
+
+    inline constexpr const StatusDescriptor* GetStatusDescriptor(StatusEffect status)
+    {
+        const std::size_t index = StatusIndex(status);
+        return index < StatusEffectCount ? &kStatusTable[index] : nullptr;
+    }
 }
\ No newline at end of file
@@ -12,6 +12,10 @@ namespace NecroCore
 
 		std::string description;
 
+		// The order given ("follow", "guard", "attack", "move") and how many allies took it
+		std::string order;
+		int alliesOrdered = 0;
+
 		SummonResult summonResult;
 	};
 }
\ No newline at end of file
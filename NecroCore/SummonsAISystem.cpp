@@ -2,8 +2,9 @@
 #include "Game.h"
 #include "Entity.h"
 #include "Pathfinding.h"
+#include "Log.h"
+#include "Messages.h"
 
-#include <sstream>
 #include <limits>
 #include <cmath>
 #include <iostream>
@@ -12,21 +13,11 @@ namespace NecroCore
 {
 	void SummonsAISystem::ProcessSummonedTurn(Game& game, CommandResult& result)
 	{
-		std::ostringstream oss;
-		oss << result.description;
-
-		bool firstAppend = true;
+		// Messages render straight onto the turn's description
+		std::string& out = result.description;
 		auto appendSeparator = [&]()
 			{
-				if (firstAppend)
-				{
-					oss << "\n";
-					firstAppend = false;
-				}
-				else
-				{
-					oss << "\n";
-				}
+				out += '\n';
 			};
 
 		auto& m_Entities = game.GetEntities();
@@ -40,7 +31,8 @@ namespace NecroCore
 				continue;
 			}
 
-			const std::string allyName = entity.name.empty() ? "Your summoned ally" : ("Your summoned ally (" + entity.name + ")");
+			// {ally} picks the named or unnamed phrase from this
+			const MessageArgs ally{ entity.name };
 
 			switch (entity.aiState)
 			{
@@ -70,7 +62,7 @@ namespace NecroCore
 					entity.x = targetX;
 					entity.y = targetY;
 					appendSeparator();
-					oss << allyName << " moves closer to you.";
+					Messages::Append(out, Message::AllyMoves, ally);
 				}
 				break;
 			}
@@ -97,25 +89,25 @@ namespace NecroCore
 						entity.x = targetX;
 						entity.y = targetY;
 						appendSeparator();
-						oss << allyName << " returns to its post.";
+						Messages::Append(out, Message::AllyReturns, ally);
 					}
 				}
 				else
 				{
-					HandleSummonedAttackAI(game, entity, oss, appendSeparator);
+					HandleSummonedAttackAI(game, entity, out, appendSeparator);
 				}
 				break;
 			}
 			case EntityState::Attack:
 			{
-				HandleSummonedAttackAI(game, entity, oss, appendSeparator);
+				HandleSummonedAttackAI(game, entity, out, appendSeparator);
 				break;
 			}
 			default:
 				break;
 			}
 		}
-		std::cout << "[ProcessSummonedTurn] Final description: " << oss.str() << "\n";
+		NECRO_TRACE("[ProcessSummonedTurn] Final description: " << out << "\n");
 
 		m_Entities.erase(
 			std::remove_if(
@@ -127,12 +119,10 @@ namespace NecroCore
 				}),
 			m_Entities.end()
 		);
-
-		result.description = oss.str();
 	}
 	bool SummonsAISystem::HandleSummonedAttackAI(Game& game,
 		Entity& entity,
-		std::ostringstream& oss,
+		std::string& out,
 		const std::function<void()>& appendSeparator)
 	{
 		auto& m_Entities = game.GetEntities();
@@ -142,7 +132,7 @@ namespace NecroCore
 		Entity* closestHostile = nullptr;
 		int bestDistance = std::numeric_limits<int>::max();
 
-		const std::string allyName = entity.name.empty() ? "Your summoned ally" : ("Your summoned ally (" + entity.name + ")");
+		const MessageArgs ally{ entity.name };
 
 		for (Entity& other : m_Entities)
 		{
@@ -160,23 +150,25 @@ namespace NecroCore
 		if (!closestHostile || bestDistance > entity.aggroRange)
 		{
 			appendSeparator();
-			oss << allyName << " has no targets.";
+			Messages::Append(out, Message::AllyNoTargets, ally);
 			return false;
 		}
 
 		if (Entity::IsAdjacent(entity.x, entity.y, closestHostile->x, closestHostile->y))
 		{
 			closestHostile->ApplyDamage(entity.attackDamage);
+			game.GetActivation().Wake(closestHostile->id);
+			game.GetActivation().EmitNoise(closestHostile->x, closestHostile->y, ActivationSystem::CombatNoiseRadius);
 
 			if (!closestHostile->IsAlive())
 			{
 				appendSeparator();
-				oss << allyName << "'s foe crumbles into dust.";
+				Messages::Append(out, Message::AllyFoeCrumbles, ally);
 			}
 			else
 			{
 				appendSeparator();
-				oss << allyName << " strikes at a foe.";
+				Messages::Append(out, Message::AllyStrikes, ally);
 			}
 			return true;
 		}
@@ -200,10 +192,10 @@ namespace NecroCore
 			entity.x = targetX;
 			entity.y = targetY;
 			appendSeparator();
-			oss << allyName << " stalks a distant foe.";
-			std::cout << "[ProcessSummonedTurn] Summoned ally " << entity.id << " moves to ("
+			Messages::Append(out, Message::AllyStalks, ally);
+			NECRO_TRACE("[ProcessSummonedTurn] Summoned ally " << entity.id << " moves to ("
 				<< entity.x << "," << entity.y << ") while targeting hostile "
-				<< closestHostile->id << " at (" << closestHostile->x << "," << closestHostile->y << ")\n";
+				<< closestHostile->id << " at (" << closestHostile->x << "," << closestHostile->y << ")\n");
 			return true;
 		}
 
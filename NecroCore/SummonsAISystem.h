@@ -1,7 +1,7 @@
 #pragma once
 
 #include "Entity.h"
-#include <ostream>
+#include <string>
 #include <functional>
 
 namespace NecroCore
@@ -17,7 +17,7 @@ namespace NecroCore
 	private:
 		bool HandleSummonedAttackAI(Game& game,
 			Entity& entity,
-			std::ostringstream& oss,
+			std::string& out,
 			const std::function<void()>& appendSeparator);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,315 @@
+#include "TileSimulation.h"
+#include "Map.h"
+#include "Status.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NECRO_TILESIM_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace NecroCore
+{
+	namespace
+	{
+		constexpr int B = Map::BlockSize;
+		// One tile of halo on every side, so neighbour reads never leave the block
+		constexpr int P = B + 2;
+
+		static_assert(B == 16, "The SSE2 path steps one 16-tile block row per register");
+
+		struct BlockPlanes
+		{
+			alignas(16) std::array<std::uint8_t, P * P> fire;
+			alignas(16) std::array<std::uint8_t, P * P> water;
+			alignas(16) std::array<std::uint8_t, P * P> ignitable;
+			alignas(16) std::array<std::uint8_t, P * P> flowable;
+		};
+
+		struct BlockResult
+		{
+			int block;
+			alignas(16) std::array<std::uint8_t, B * B> fire;
+			alignas(16) std::array<std::uint8_t, B * B> water;
+		};
+
+		std::atomic<bool> g_SimdEnabled{ true };
+
+		constexpr StatusMask kFireBit = static_cast<StatusMask>(StatusEffect::OnFire);
+		constexpr StatusMask kWetBit = static_cast<StatusMask>(StatusEffect::Wet);
+
+		bool CanHoldElements(TileType tile)
+		{
+			return tile == TileType::Floor || tile == TileType::Door;
+		}
+
+		std::uint8_t SatDec(std::uint8_t v)
+		{
+			return v > 0 ? static_cast<std::uint8_t>(v - 1) : 0;
+		}
+
+		void StepBlockScalar(const BlockPlanes& p, BlockResult& r)
+		{
+			for (int cy = 0; cy < B; ++cy)
+			{
+				for (int cx = 0; cx < B; ++cx)
+				{
+					const int c = (cy + 1) * P + (cx + 1);
+					const std::uint8_t f = p.fire[c];
+					const std::uint8_t w = p.water[c];
+					const std::uint8_t mf = std::max({ p.fire[c - P], p.fire[c + P], p.fire[c - 1], p.fire[c + 1] });
+					const std::uint8_t mw = std::max({ p.water[c - P], p.water[c + P], p.water[c - 1], p.water[c + 1] });
+
+					const std::uint8_t wn = std::max(w, static_cast<std::uint8_t>(SatDec(mw) & p.flowable[c]));
+					std::uint8_t fn = f > 0 ? SatDec(f) : static_cast<std::uint8_t>(SatDec(mf) & p.ignitable[c]);
+					if (wn > 0)
+						fn = 0;
+
+					r.fire[cy * B + cx] = fn;
+					r.water[cy * B + cx] = wn;
+				}
+			}
+		}
+
+#ifdef NECRO_TILESIM_SSE2
+		void StepBlockSse2(const BlockPlanes& p, BlockResult& r)
+		{
+			const __m128i zero = _mm_setzero_si128();
+			const __m128i one = _mm_set1_epi8(1);
+
+			for (int cy = 0; cy < B; ++cy)
+			{
+				const int row = (cy + 1) * P;
+				auto load = [](const std::uint8_t* at) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(at)); };
+
+				const __m128i f = load(&p.fire[row + 1]);
+				const __m128i mf = _mm_max_epu8(
+					_mm_max_epu8(load(&p.fire[row - P + 1]), load(&p.fire[row + P + 1])),
+					_mm_max_epu8(load(&p.fire[row]), load(&p.fire[row + 2])));
+
+				const __m128i w = load(&p.water[row + 1]);
+				const __m128i mw = _mm_max_epu8(
+					_mm_max_epu8(load(&p.water[row - P + 1]), load(&p.water[row + P + 1])),
+					_mm_max_epu8(load(&p.water[row]), load(&p.water[row + 2])));
+
+				const __m128i wn = _mm_max_epu8(w, _mm_and_si128(_mm_subs_epu8(mw, one), load(&p.flowable[row + 1])));
+
+				const __m128i notBurning = _mm_cmpeq_epi8(f, zero);
+				const __m128i spread = _mm_and_si128(_mm_subs_epu8(mf, one), load(&p.ignitable[row + 1]));
+				__m128i fn = _mm_or_si128(_mm_andnot_si128(notBurning, _mm_subs_epu8(f, one)), _mm_and_si128(notBurning, spread));
+				// Water wins: any wet lane drops its fire
+				fn = _mm_and_si128(fn, _mm_cmpeq_epi8(wn, zero));
+
+				_mm_store_si128(reinterpret_cast<__m128i*>(&r.fire[cy * B]), fn);
+				_mm_store_si128(reinterpret_cast<__m128i*>(&r.water[cy * B]), wn);
+			}
+		}
+#endif
+
+		thread_local std::vector<int> t_Dirty;
+		thread_local std::vector<int> t_Blocks;
+		thread_local std::vector<std::uint8_t> t_Seen;
+		thread_local std::vector<BlockResult> t_Results;
+		thread_local BlockPlanes t_Planes;
+	}
+
+	void TileSimulation::SetSimdEnabled(bool enabled)
+	{
+		g_SimdEnabled.store(enabled, std::memory_order_relaxed);
+	}
+
+	bool TileSimulation::IsSimdAvailable()
+	{
+#ifdef NECRO_TILESIM_SSE2
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	bool TileSimulation::PlanIgnite(const Map& map, int x, int y, std::uint8_t intensity, Map::TileStateEdit& out)
+	{
+		if (intensity == 0 || intensity == Map::ScorchedLevel || !CanHoldElements(map.GetTile(x, y)))
+			return false;
+
+		const StatusMask state = static_cast<StatusMask>(map.GetTileState(x, y));
+		const std::uint8_t level = map.GetTileLevel(x, y);
+		if ((state & kWetBit) != 0 || level == Map::ScorchedLevel)
+			return false;
+
+		const std::uint8_t current = (state & kFireBit) != 0 ? level : 0;
+		out = { x, y, static_cast<StatusEffect>(state | kFireBit), std::max(current, intensity) };
+		return true;
+	}
+
+	bool TileSimulation::PlanFlood(const Map& map, int x, int y, std::uint8_t depth, Map::TileStateEdit& out)
+	{
+		if (depth == 0 || depth == Map::ScorchedLevel || !CanHoldElements(map.GetTile(x, y)))
+			return false;
+
+		const StatusMask state = static_cast<StatusMask>(map.GetTileState(x, y));
+		const std::uint8_t current = (state & kWetBit) != 0 ? map.GetTileLevel(x, y) : 0;
+		const StatusMask wet = static_cast<StatusMask>((state & ~kFireBit) | kWetBit);
+		out = { x, y, static_cast<StatusEffect>(wet), std::max(current, depth) };
+		return true;
+	}
+
+	bool TileSimulation::Ignite(Map& map, int x, int y, std::uint8_t intensity)
+	{
+		Map::TileStateEdit edit{};
+		if (!PlanIgnite(map, x, y, intensity, edit))
+			return false;
+		map.SetTileState(x, y, edit.state, edit.level);
+		return true;
+	}
+
+	bool TileSimulation::Flood(Map& map, int x, int y, std::uint8_t depth)
+	{
+		Map::TileStateEdit edit{};
+		if (!PlanFlood(map, x, y, depth, edit))
+			return false;
+		map.SetTileState(x, y, edit.state, edit.level);
+		return true;
+	}
+
+	TileSimulation::StepStats TileSimulation::Step(Map& map)
+	{
+		StepStats stats;
+		if (!map.HasDirtyBlocks() || !map.m_Tiles)
+			return stats;
+
+		const int blocksX = map.GetBlocksX();
+		const int blocksY = map.GetBlocksY();
+		const int width = map.m_Width;
+		const int height = map.m_Height;
+
+		map.TakeDirtyBlocks(t_Dirty);
+
+		// A change on a block edge can spread into the next block, so step the halo too
+		t_Seen.assign(static_cast<std::size_t>(blocksX) * blocksY, 0);
+		t_Blocks.clear();
+		for (int block : t_Dirty)
+		{
+			const int bx = block % blocksX;
+			const int by = block / blocksX;
+			for (int ny = std::max(0, by - 1); ny <= std::min(blocksY - 1, by + 1); ++ny)
+			{
+				for (int nx = std::max(0, bx - 1); nx <= std::min(blocksX - 1, bx + 1); ++nx)
+				{
+					const int n = ny * blocksX + nx;
+					if (!t_Seen[static_cast<std::size_t>(n)])
+					{
+						t_Seen[static_cast<std::size_t>(n)] = 1;
+						t_Blocks.push_back(n);
+					}
+				}
+			}
+		}
+		std::sort(t_Blocks.begin(), t_Blocks.end());
+
+		const TileType* tiles = map.m_Tiles->data();
+		const StatusEffect* states = map.m_TileStates->data();
+		const std::uint8_t* levels = map.m_TileLevels->data();
+		const bool useSimd = IsSimdAvailable() && g_SimdEnabled.load(std::memory_order_relaxed);
+
+		// Front buffer: every block reads the map as it was; nothing is written until all are stepped
+		t_Results.resize(t_Blocks.size());
+		for (std::size_t i = 0; i < t_Blocks.size(); ++i)
+		{
+			const int block = t_Blocks[i];
+			const int originX = (block % blocksX) * B - 1;
+			const int originY = (block / blocksX) * B - 1;
+
+			BlockPlanes& p = t_Planes;
+			for (int py = 0; py < P; ++py)
+			{
+				const int y = originY + py;
+				for (int px = 0; px < P; ++px)
+				{
+					const int x = originX + px;
+					const int c = py * P + px;
+					if (x < 0 || y < 0 || x >= width || y >= height ||
+						!CanHoldElements(tiles[static_cast<std::size_t>(y) * width + x]))
+					{
+						p.fire[c] = 0;
+						p.water[c] = 0;
+						p.ignitable[c] = 0;
+						p.flowable[c] = 0;
+						continue;
+					}
+
+					const std::size_t index = static_cast<std::size_t>(y) * width + x;
+					const StatusMask state = static_cast<StatusMask>(states[index]);
+					const std::uint8_t level = levels[index] == Map::ScorchedLevel ? 0 : levels[index];
+					p.fire[c] = (state & kFireBit) != 0 ? level : 0;
+					p.water[c] = (state & kWetBit) != 0 ? level : 0;
+					p.ignitable[c] = (state == 0 && levels[index] == 0) ? 0xFF : 0;
+					p.flowable[c] = 0xFF;
+				}
+			}
+
+			BlockResult& r = t_Results[i];
+			r.block = block;
+#ifdef NECRO_TILESIM_SSE2
+			if (useSimd)
+				StepBlockSse2(p, r);
+			else
+				StepBlockScalar(p, r);
+#else
+			(void)useSimd;
+			StepBlockScalar(p, r);
+#endif
+		}
+
+		// Back buffer: write only the tiles whose fire or water changed
+		for (const BlockResult& r : t_Results)
+		{
+			const int baseX = (r.block % blocksX) * B;
+			const int baseY = (r.block / blocksX) * B;
+			for (int cy = 0; cy < B && baseY + cy < height; ++cy)
+			{
+				for (int cx = 0; cx < B && baseX + cx < width; ++cx)
+				{
+					const int x = baseX + cx;
+					const int y = baseY + cy;
+					const std::size_t index = static_cast<std::size_t>(y) * width + x;
+					if (!CanHoldElements(tiles[index]))
+						continue;
+
+					const StatusMask state = static_cast<StatusMask>((*map.m_TileStates)[index]);
+					const std::uint8_t level = (*map.m_TileLevels)[index] == Map::ScorchedLevel ? 0 : (*map.m_TileLevels)[index];
+					const std::uint8_t oldFire = (state & kFireBit) != 0 ? level : 0;
+					const std::uint8_t oldWater = (state & kWetBit) != 0 ? level : 0;
+					const std::uint8_t newFire = r.fire[cy * B + cx];
+					const std::uint8_t newWater = r.water[cy * B + cx];
+
+					if (newWater != oldWater)
+					{
+						map.SetTileState(x, y, static_cast<StatusEffect>((state & ~kFireBit) | kWetBit), newWater);
+					}
+					else if (newFire != oldFire)
+					{
+						if (newFire > 0)
+							map.SetTileState(x, y, static_cast<StatusEffect>(state | kFireBit), newFire);
+						else
+							map.SetTileState(x, y, static_cast<StatusEffect>(state & ~kFireBit), Map::ScorchedLevel);
+					}
+					else
+					{
+						continue;
+					}
+					++stats.tilesChanged;
+				}
+			}
+		}
+
+		stats.blocksStepped = static_cast<int>(t_Blocks.size());
+		NECRO_TRACE("[TileSimulation] Stepped " << stats.blocksStepped << " blocks, " << stats.tilesChanged << " tiles changed.\n");
+		return stats;
+	}
+}
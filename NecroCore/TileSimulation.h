@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Map.h"
+
+#include <cstdint>
+
+namespace NecroCore
+{
+	// Double-buffered cellular automaton over Map tile states, run once per turn
+	// after the environment system.
+	//
+	// Fire: a burning floor or door tile loses one intensity per step and
+	// ignites its orthogonal neighbours at one less than its own intensity, so
+	// a fire of intensity N reaches N - 1 tiles out before it burns out. Burnt
+	// tiles are scorched and never catch again.
+	// Water: each wet tile raises its orthogonal neighbours to one less than its
+	// own depth, so a splash pools into a shallow puddle, and it puts out any
+	// fire it reaches.
+	//
+	// Fireplaces, traps and tiles whose level is 0 are left alone, so hearths
+	// and hand-placed states stay static. Only the map blocks that changed last
+	// step (plus their neighbours) are stepped; each 16-tile block row is one
+	// SSE2 register where available.
+	class TileSimulation
+	{
+	public:
+		static constexpr std::uint8_t TrapFireIntensity = 3;
+		static constexpr std::uint8_t SplashDepth = 2;
+
+		struct StepStats
+		{
+			int blocksStepped = 0;
+			int tilesChanged = 0;
+		};
+
+		static StepStats Step(Map& map);
+
+		// Lights loose fire on a floor or door tile; false if the tile cannot burn.
+		static bool Ignite(Map& map, int x, int y, std::uint8_t intensity);
+		// Pours water onto a floor or door tile, putting out any fire there.
+		static bool Flood(Map& map, int x, int y, std::uint8_t depth);
+
+		// What Ignite / Flood would write, without writing it, so callers touching
+		// many tiles can apply them together with Map::SetTileStates.
+		static bool PlanIgnite(const Map& map, int x, int y, std::uint8_t intensity, Map::TileStateEdit& out);
+		static bool PlanFlood(const Map& map, int x, int y, std::uint8_t depth, Map::TileStateEdit& out);
+
+		// The scalar path is always available; tests use this to compare the two.
+		static void SetSimdEnabled(bool enabled);
+		static bool IsSimdAvailable();
+	};
+}
@@ -0,0 +1,85 @@
+#include "TimingWheel.h"
+
+namespace NecroCore
+{
+	void TimingWheel::Reset(std::uint64_t now)
+	{
+		for (auto& level : m_Levels)
+		{
+			for (std::vector<TimerEvent>& slot : level)
+			{
+				slot.clear();
+			}
+		}
+		m_Overflow.clear();
+		m_Ready.clear();
+		m_Now = now;
+		m_Count = 0;
+	}
+
+	void TimingWheel::Schedule(const TimerEvent& event)
+	{
+		++m_Count;
+		if (event.due <= m_Now)
+		{
+			m_Ready.push_back(event);
+			return;
+		}
+		Place(event);
+	}
+
+	void TimingWheel::Place(const TimerEvent& event)
+	{
+		// The lowest level whose span still holds both now and the due turn
+		for (int level = 0; level < LevelCount; ++level)
+		{
+			const int shift = SlotBits * (level + 1);
+			if ((event.due >> shift) == (m_Now >> shift))
+			{
+				Slot(level, event.due).push_back(event);
+				return;
+			}
+		}
+		m_Overflow.push_back(event);
+	}
+
+	void TimingWheel::Cascade(std::vector<TimerEvent>& slot)
+	{
+		m_Scratch.swap(slot);
+		for (const TimerEvent& event : m_Scratch)
+		{
+			Place(event);
+		}
+		m_Scratch.clear();
+	}
+
+	void TimingWheel::Advance(std::uint64_t turn, std::vector<TimerEvent>& due)
+	{
+		m_Count -= m_Ready.size();
+		due.insert(due.end(), m_Ready.begin(), m_Ready.end());
+		m_Ready.clear();
+
+		while (m_Now < turn)
+		{
+			++m_Now;
+
+			// Higher levels roll over first, so their timers land in the slots below before those are read
+			if ((m_Now & ((std::uint64_t{ 1 } << (SlotBits * LevelCount)) - 1)) == 0)
+			{
+				Cascade(m_Overflow);
+			}
+			for (int level = LevelCount - 1; level >= 1; --level)
+			{
+				if ((m_Now & ((std::uint64_t{ 1 } << (SlotBits * level)) - 1)) == 0)
+				{
+					Cascade(Slot(level, m_Now));
+				}
+			}
+
+			std::vector<TimerEvent>& slot = Slot(0, m_Now);
+			m_Count -= slot.size();
+			due.insert(due.end(), slot.begin(), slot.end());
+			slot.clear();
+		}
+	}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace NecroCore
+{
+	enum class TimerKind : std::uint8_t
+	{
+		// One status pass for an actor: damage, messages and expiry of every status it carries
+		StatusTick,
+		WorldEvent
+	};
+
+	struct TimerEvent
+	{
+		std::uint64_t due = 0;
+		TimerKind kind = TimerKind::StatusTick;
+		// Actor id (0 is the player) for status ticks, world event id otherwise
+		int id = 0;
+	};
+
+	// Turn-indexed hierarchical timing wheel. Four levels of 64 slots cover the
+	// next 2^24 turns, and timers further out wait in an overflow list. Scheduling
+	// is constant time; advancing a turn empties one level-0 slot, and every 64th
+	// turn cascades one slot of the level above down into it.
+	class TimingWheel
+	{
+	public:
+		static constexpr int SlotBits = 6;
+		static constexpr std::size_t SlotCount = std::size_t{ 1 } << SlotBits;
+		static constexpr int LevelCount = 4;
+
+		// Drops every timer and makes `now` the last turn already advanced to.
+		void Reset(std::uint64_t now);
+		// Timers due at or before the current turn come out of the next Advance.
+		void Schedule(const TimerEvent& event);
+		// Moves to `turn` and appends every timer due by then to `due`, in no particular order.
+		void Advance(std::uint64_t turn, std::vector<TimerEvent>& due);
+
+		std::uint64_t GetNow() const { return m_Now; }
+		std::size_t GetCount() const { return m_Count; }
+
+	private:
+		void Place(const TimerEvent& event);
+		void Cascade(std::vector<TimerEvent>& slot);
+		std::vector<TimerEvent>& Slot(int level, std::uint64_t turn)
+		{
+			return m_Levels[static_cast<std::size_t>(level)][static_cast<std::size_t>((turn >> (SlotBits * level)) & (SlotCount - 1))];
+		}
+
+		std::array<std::array<std::vector<TimerEvent>, SlotCount>, LevelCount> m_Levels;
+		std::vector<TimerEvent> m_Overflow;
+		std::vector<TimerEvent> m_Ready;
+		std::vector<TimerEvent> m_Scratch;
+		std::uint64_t m_Now = 0;
+		std::size_t m_Count = 0;
+	};
+}
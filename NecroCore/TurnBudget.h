@@ -0,0 +1,106 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+
+namespace NecroCore
+{
+	using TurnClock = std::chrono::steady_clock;
+
+	// Wall-clock allowance for one ApplyTurn. An unlimited budget never expires,
+	// which keeps turns deterministic; a limited one lets the hostile pass defer
+	// work to the next turn once the deadline has passed.
+	class TurnBudget
+	{
+	public:
+		static TurnBudget Unlimited() { return TurnBudget(); }
+		static TurnBudget StartingNow(std::chrono::microseconds allowance)
+		{
+			TurnBudget budget;
+			budget.m_Limited = true;
+			budget.m_Deadline = TurnClock::now() + allowance;
+			budget.m_Reserve = budget.m_Deadline - allowance / ReserveDivisor;
+			return budget;
+		}
+		// Never expires but defers exactly `deferredHostiles` (sorted ids), repeating
+		// the schedule of a limited turn. The vector must outlive the budget.
+		static TurnBudget Replaying(const std::vector<int>& deferredHostiles)
+		{
+			TurnBudget budget;
+			budget.m_Replayed = &deferredHostiles;
+			return budget;
+		}
+
+		// The last quarter of the allowance is held back for work that cannot wait
+		static constexpr int ReserveDivisor = 4;
+
+		bool IsLimited() const { return m_Limited; }
+		bool IsExpired() const { return m_Limited && TurnClock::now() >= m_Deadline; }
+		bool IsNearlyExpired() const { return m_Limited && TurnClock::now() >= m_Reserve; }
+		bool IsReplayDeferred(int entityId) const
+		{
+			return m_Replayed && std::binary_search(m_Replayed->begin(), m_Replayed->end(), entityId);
+		}
+
+		std::chrono::microseconds GetRemaining() const
+		{
+			if (!m_Limited)
+				return std::chrono::microseconds::max();
+			const auto left = std::chrono::duration_cast<std::chrono::microseconds>(m_Deadline - TurnClock::now());
+			return left.count() > 0 ? left : std::chrono::microseconds(0);
+		}
+
+	private:
+		bool m_Limited = false;
+		TurnClock::time_point m_Deadline{};
+		TurnClock::time_point m_Reserve{};
+		const std::vector<int>* m_Replayed = nullptr;
+	};
+
+	enum class TurnSystem
+	{
+		Command,
+		Summons,
+		Hostiles,
+		Environment,
+		Tiles,
+		Count
+	};
+
+	inline const char* TurnSystemToString(TurnSystem system)
+	{
+		switch (system)
+		{
+		case TurnSystem::Command:     return "command";
+		case TurnSystem::Summons:     return "summons";
+		case TurnSystem::Hostiles:    return "hostiles";
+		case TurnSystem::Environment: return "environment";
+		case TurnSystem::Tiles:       return "tiles";
+		default:                      return "unknown";
+		}
+	}
+
+	struct SystemTiming
+	{
+		// Entities the system updated this turn, and how many it pushed to the next one
+		int processed = 0;
+		int deferred = 0;
+		std::chrono::microseconds elapsed{ 0 };
+	};
+
+	struct TurnStats
+	{
+		std::array<SystemTiming, static_cast<std::size_t>(TurnSystem::Count)> systems{};
+		std::chrono::microseconds total{ 0 };
+		bool budgeted = false;
+		bool overBudget = false;
+		// Ids of the hostiles deferred, ascending; Game::ReplayTurn repeats them
+		std::vector<int> deferredHostiles;
+
+		SystemTiming& Get(TurnSystem system) { return systems[static_cast<std::size_t>(system)]; }
+		const SystemTiming& Get(TurnSystem system) const { return systems[static_cast<std::size_t>(system)]; }
+	};
+}
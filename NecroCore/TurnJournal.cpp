@@ -0,0 +1,231 @@
+#include "TurnJournal.h"
+#include "Game.h"
+
+#include <algorithm>
+
+namespace NecroCore
+{
+	TurnJournal::TurnJournal(std::size_t capacity)
+		: m_Records(capacity)
+	{
+	}
+
+	void TurnJournal::Clear()
+	{
+		m_Head = 0;
+		m_Depth = 0;
+		m_InTurn = false;
+		m_WorldEventsNoted = false;
+	}
+
+	TurnJournal::ActorFields TurnJournal::CaptureFields(const Actor& actor)
+	{
+		ActorFields fields;
+		fields.x = actor.x;
+		fields.y = actor.y;
+		fields.hp = actor.hp;
+		fields.maxHp = actor.maxHp;
+		fields.status = actor.status;
+		fields.durations = actor.statusDurations;
+		return fields;
+	}
+
+	TurnJournal::ActorFields TurnJournal::CaptureFields(const Entity& entity)
+	{
+		ActorFields fields = CaptureFields(static_cast<const Actor&>(entity));
+		fields.aiState = entity.aiState;
+		fields.guardX = entity.guardX;
+		fields.guardY = entity.guardY;
+		return fields;
+	}
+
+	bool TurnJournal::SameFields(const ActorFields& a, const ActorFields& b)
+	{
+		if (a.x != b.x || a.y != b.y || a.hp != b.hp || a.maxHp != b.maxHp ||
+			a.status != b.status || a.aiState != b.aiState ||
+			a.guardX != b.guardX || a.guardY != b.guardY)
+		{
+			return false;
+		}
+		return a.durations == b.durations;
+	}
+
+	void TurnJournal::RestoreFields(Actor& actor, const ActorFields& fields)
+	{
+		actor.x = fields.x;
+		actor.y = fields.y;
+		actor.hp = fields.hp;
+		actor.maxHp = fields.maxHp;
+		actor.status = fields.status;
+		actor.statusDurations = fields.durations;
+	}
+
+	void TurnJournal::RestoreFields(Entity& entity, const ActorFields& fields)
+	{
+		RestoreFields(static_cast<Actor&>(entity), fields);
+		entity.aiState = fields.aiState;
+		entity.guardX = fields.guardX;
+		entity.guardY = fields.guardY;
+	}
+
+	void TurnJournal::BeginTurn(Game& game)
+	{
+		if (!IsEnabled())
+			return;
+
+		const std::vector<Entity>& entities = game.GetEntities();
+		m_Before.assign(entities.begin(), entities.end());
+		m_PlayerBefore = CaptureFields(game.GetPlayer());
+		m_RngBefore = game.GetRandom().GetState();
+		m_NextEntityIdBefore = game.m_NextEntityId;
+		m_TurnBefore = game.m_Turn;
+		m_NextWorldEventIdBefore = game.m_NextWorldEventId;
+		m_WorldEventsNoted = false;
+
+		Map& map = game.GetMap();
+		map.ClearTileChanges();
+		map.SetChangeTracking(true);
+		m_InTurn = true;
+	}
+
+	void TurnJournal::NoteWorldEvents(const Game& game)
+	{
+		if (!m_InTurn || m_WorldEventsNoted)
+			return;
+		m_WorldEventsBefore = game.m_WorldEvents;
+		m_WorldEventsNoted = true;
+	}
+
+	void TurnJournal::EndTurn(Game& game, bool countAsTurn)
+	{
+		if (!m_InTurn)
+			return;
+		m_InTurn = false;
+
+		Map& map = game.GetMap();
+		map.SetChangeTracking(false);
+
+		TurnRecord& record = m_Records[m_Head];
+		record.tiles.assign(map.GetTileChanges().begin(), map.GetTileChanges().end());
+		map.ClearTileChanges();
+		record.actors.clear();
+		record.spawnedIds.clear();
+		record.deaths.clear();
+
+		record.playerBefore = m_PlayerBefore;
+		record.playerChanged = !SameFields(m_PlayerBefore, CaptureFields(game.GetPlayer()));
+		record.rngBefore = m_RngBefore;
+		record.nextEntityIdBefore = m_NextEntityIdBefore;
+		record.turnBefore = m_TurnBefore;
+		record.nextWorldEventIdBefore = m_NextWorldEventIdBefore;
+		record.worldEventsChanged = m_WorldEventsNoted;
+		if (m_WorldEventsNoted)
+		{
+			record.worldEventsBefore.swap(m_WorldEventsBefore);
+			m_WorldEventsNoted = false;
+		}
+
+		// Entities are only ever appended with increasing ids and erased in place,
+		// so both lists are ordered by id and a single merge finds every change.
+		const std::vector<Entity>& after = game.GetEntities();
+		std::size_t i = 0;
+		std::size_t j = 0;
+		while (i < m_Before.size() || j < after.size())
+		{
+			if (j == after.size() || (i < m_Before.size() && m_Before[i].id < after[j].id))
+			{
+				record.deaths.push_back({ i, m_Before[i] });
+				++i;
+			}
+			else if (i == m_Before.size() || m_Before[i].id > after[j].id)
+			{
+				record.spawnedIds.push_back(after[j].id);
+				++j;
+			}
+			else
+			{
+				const ActorFields before = CaptureFields(m_Before[i]);
+				if (!SameFields(before, CaptureFields(after[j])))
+				{
+					record.actors.push_back({ after[j].id, before });
+				}
+				++i;
+				++j;
+			}
+		}
+
+		const bool changedAnything = !record.tiles.empty() || !record.actors.empty() ||
+			!record.spawnedIds.empty() || !record.deaths.empty() || record.playerChanged ||
+			record.rngBefore != game.GetRandom().GetState() ||
+			record.nextEntityIdBefore != game.m_NextEntityId ||
+			record.turnBefore != game.m_Turn || record.worldEventsChanged;
+
+		if (!countAsTurn && !changedAnything)
+			return;
+
+		m_Head = (m_Head + 1) % m_Records.size();
+		m_Depth = std::min(m_Depth + 1, m_Records.size());
+	}
+
+	bool TurnJournal::UndoLast(Game& game)
+	{
+		if (m_Depth == 0)
+			return false;
+
+		m_Head = (m_Head + m_Records.size() - 1) % m_Records.size();
+		--m_Depth;
+		const TurnRecord& record = m_Records[m_Head];
+
+		std::vector<Entity>& entities = game.GetEntities();
+
+		if (!record.spawnedIds.empty())
+		{
+			entities.erase(
+				std::remove_if(
+					entities.begin(),
+					entities.end(),
+					[&](const Entity& e)
+					{
+						return std::find(record.spawnedIds.begin(), record.spawnedIds.end(), e.id) != record.spawnedIds.end();
+					}),
+				entities.end());
+		}
+
+		for (const ActorChange& change : record.actors)
+		{
+			auto it = std::lower_bound(entities.begin(), entities.end(), change.id,
+				[](const Entity& e, int id) { return e.id < id; });
+			if (it != entities.end() && it->id == change.id)
+			{
+				RestoreFields(*it, change.before);
+			}
+		}
+
+		for (const Death& death : record.deaths)
+		{
+			const std::size_t at = std::min(death.index, entities.size());
+			entities.insert(entities.begin() + static_cast<std::ptrdiff_t>(at), death.entity);
+		}
+
+		Map& map = game.GetMap();
+		for (auto it = record.tiles.rbegin(); it != record.tiles.rend(); ++it)
+		{
+			map.RestoreTile(it->index, it->oldType, it->oldState, it->oldLevel);
+		}
+
+		if (record.playerChanged)
+		{
+			RestoreFields(game.GetPlayer(), record.playerBefore);
+		}
+
+		game.GetRandom().SetState(record.rngBefore);
+		game.m_NextEntityId = record.nextEntityIdBefore;
+		game.m_Turn = record.turnBefore;
+		game.m_NextWorldEventId = record.nextWorldEventIdBefore;
+		if (record.worldEventsChanged)
+		{
+			game.m_WorldEvents = record.worldEventsBefore;
+		}
+		return true;
+	}
+}
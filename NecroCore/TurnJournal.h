@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Entity.h"
+#include "Map.h"
+#include "Random.h"
+#include "Status.h"
+#include "WorldEvent.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace NecroCore
+{
+	class Game;
+
+	// Per-turn delta journal kept in a fixed ring of turn records. A record
+	// holds only what the turn changed: tile edits (through Map's change log),
+	// the previous fields of actors that moved, took damage or changed status
+	// or AI state, entities that were spawned or died, and the pending world
+	// events when the turn scheduled or fired any. Rewinding a turn
+	// costs time proportional to those changes.
+	class TurnJournal
+	{
+	public:
+		static constexpr std::size_t DefaultCapacity = 64;
+
+		// A capacity of 0 disables journaling entirely (used by forked games).
+		explicit TurnJournal(std::size_t capacity = DefaultCapacity);
+
+		void BeginTurn(Game& game);
+		void EndTurn(Game& game, bool countAsTurn);
+
+		// Rewinds the most recent recorded turn. Returns false when nothing is left.
+		bool UndoLast(Game& game);
+
+		std::size_t GetDepth() const { return m_Depth; }
+		std::size_t GetCapacity() const { return m_Records.size(); }
+		bool IsEnabled() const { return !m_Records.empty(); }
+		// Call before changing the game's world event list; the first call in a turn keeps a copy.
+		void NoteWorldEvents(const Game& game);
+		void Clear();
+
+	private:
+		struct ActorFields
+		{
+			int x = 0;
+			int y = 0;
+			int hp = 0;
+			int maxHp = 0;
+			StatusEffect status = StatusEffect::Normal;
+			EntityState aiState = EntityState::Idle;
+			int guardX = 0;
+			int guardY = 0;
+			std::array<int, StatusEffectCount> durations{};
+		};
+
+		struct ActorChange
+		{
+			int id;
+			ActorFields before;
+		};
+
+		struct Death
+		{
+			std::size_t index;
+			Entity entity;
+		};
+
+		struct TurnRecord
+		{
+			std::vector<Map::TileChange> tiles;
+			std::vector<ActorChange> actors;
+			std::vector<int> spawnedIds;
+			std::vector<Death> deaths;
+			bool playerChanged = false;
+			ActorFields playerBefore;
+			Random::State rngBefore{};
+			int nextEntityIdBefore = 1;
+			std::uint64_t turnBefore = 0;
+			bool worldEventsChanged = false;
+			std::vector<WorldEvent> worldEventsBefore;
+			int nextWorldEventIdBefore = 1;
+		};
+
+		static ActorFields CaptureFields(const Actor& actor);
+		static ActorFields CaptureFields(const Entity& entity);
+		static bool SameFields(const ActorFields& a, const ActorFields& b);
+		static void RestoreFields(Actor& actor, const ActorFields& fields);
+		static void RestoreFields(Entity& entity, const ActorFields& fields);
+
+		std::vector<TurnRecord> m_Records;
+		std::size_t m_Head = 0;
+		std::size_t m_Depth = 0;
+
+		bool m_InTurn = false;
+		std::vector<Entity> m_Before;
+		ActorFields m_PlayerBefore;
+		Random::State m_RngBefore{};
+		int m_NextEntityIdBefore = 1;
+		std::uint64_t m_TurnBefore = 0;
+		bool m_WorldEventsNoted = false;
+		std::vector<WorldEvent> m_WorldEventsBefore;
+		int m_NextWorldEventIdBefore = 1;
+	};
+}
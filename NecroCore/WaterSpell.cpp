@@ -4,8 +4,12 @@
 #include "Status.h"
 #include "Actor.h"
 #include "Entity.h"
+#include "Log.h"
+#include "TileSimulation.h"
+#include "SpellArea.h"
 
 #include <iostream>
+#include <vector>
 
 namespace NecroCore
 {
@@ -13,14 +17,13 @@ namespace NecroCore
     {
     public:
         const char* GetName() const override { return "water"; }
+        StatusEffect GetElement() const override { return StatusEffect::Wet; }
 
         CastResult Cast(Game& game, int tx, int ty, const std::string& direction) const override
         {
             CastResult result{};
 
             Map& map = game.GetMap();
-            auto& entities = game.GetEntities();
-            Player& player = game.GetPlayer();
 
             bool didAnything = false;
 
@@ -32,32 +35,29 @@ namespace NecroCore
                 {
                     map.convertTile(tx, ty, TileType::Floor);
                 }
+                // What douses loose fire pools on the floor (fireplaces just go out)
+                TileSimulation::Flood(map, tx, ty, TileSimulation::SplashDepth);
                 didAnything = true;
             }
 
-            for (Entity& e : entities)
-            {
-                if (e.x == tx && e.y == ty && e.IsAlive() &&
-                    HasStatus(e.status, StatusEffect::OnFire))
-                {
-                    e.ClearStatus(StatusEffect::OnFire);
-                    didAnything = true;
-                }
-            }
-
             if (map.IsFireplace(tx, ty))
             {
                 map.SetTileState(tx, ty, StatusEffect::Normal);
                 didAnything = true;
             }
 
-            if (player.x == tx && player.y == ty &&
-                player.IsAlive() &&
-                HasStatus(player.status, StatusEffect::OnFire))
+            thread_local std::vector<AreaTile> target;
+            thread_local std::vector<Actor*> actors;
+            target.assign(1, { tx, ty });
+            SpellArea::FindActors(game, target, actors);
+            for (Actor* actor : actors)
             {
-                std::cout << "[CastSpell] Water spell extinguishes fire on player.\n";
-                player.ClearStatus(StatusEffect::OnFire);
-                didAnything = true;
+                if (HasStatus(actor->status, StatusEffect::OnFire))
+                {
+                    NECRO_TRACE("[CastSpell] Water spell extinguishes fire on " << actor->name << ".\n");
+                    actor->ClearStatus(StatusEffect::OnFire);
+                    didAnything = true;
+                }
             }
 
             if (didAnything)
@@ -71,11 +71,52 @@ namespace NecroCore
 
             return result;
         }
+
+        CastResult CastArea(Game& game, const AreaHit& hit, const std::string& direction) const override
+        {
+            CastResult result{};
+            Map& map = game.GetMap();
+
+            // Hearths go out; floors and doors take a puddle, which also drowns loose fire
+            thread_local std::vector<Map::TileStateEdit> edits;
+            edits.clear();
+            for (const AreaTile& tile : hit.tiles)
+            {
+                Map::TileStateEdit edit{};
+                if (map.IsFireplace(tile.x, tile.y))
+                {
+                    if (HasStatus(map.GetTileState(tile.x, tile.y), StatusEffect::OnFire))
+                        edits.push_back({ tile.x, tile.y, StatusEffect::Normal, 0 });
+                }
+                else if (TileSimulation::PlanFlood(map, tile.x, tile.y, TileSimulation::SplashDepth, edit))
+                {
+                    edits.push_back(edit);
+                }
+            }
+            map.SetTileStates(edits);
+            result.tilesAffected = static_cast<int>(edits.size());
+
+            MessageArgs args;
+            args.direction = direction;
+            args.count = result.tilesAffected;
+            Messages::Append(result.description, SpellArea::MessageFor(Message::WaterLine, hit.shape), args);
+
+            for (Actor* actor : hit.actors)
+            {
+                if (!HasStatus(actor->status, StatusEffect::OnFire))
+                    continue;
+                actor->ClearStatus(StatusEffect::OnFire);
+                ++result.actorsAffected;
+
+                result.description += '\n';
+                if (actor == &game.GetPlayer())
+                    Messages::Append(result.description, Message::AreaDousesPlayer);
+                else
+                    Messages::Append(result.description, Message::AreaDousesEntity, { actor->name });
+            }
+            return result;
+        }
     };
 
-    const ISpell& GetWaterSpell()
-    {
-        static WaterSpell instance;
-        return instance;
-    }
+    NECRO_REGISTER_SPELL(WaterSpell);
 }
\ No newline at end of file
@@ -0,0 +1,479 @@
+#include "WireProtocol.h"
+#include "CommandParser.h"
+#include "CommandSerialization.h"
+#include "Map.h"
+#include "Schema.h"
+
+#include <unordered_map>
+#include <vector>
+
+namespace NecroCore
+{
+	namespace
+	{
+		constexpr char kMagic0 = 'N';
+		constexpr char kMagic1 = 'W';
+		constexpr std::size_t kMaxStringTable = 1024;
+
+		constexpr const char* kOrderNames[] = { nullptr, "follow", "guard", "attack", "move" };
+
+		void WriteHeader(std::string& out, WireProtocol::MessageType type)
+		{
+			out += kMagic0;
+			out += kMagic1;
+			out += static_cast<char>(WireProtocol::Version);
+			out += static_cast<char>(type);
+		}
+
+		bool ReadHeader(SchemaReader& reader, WireProtocol::MessageType type)
+		{
+			std::string_view header;
+			return reader.ReadBytes(4, header) && header[0] == kMagic0 && header[1] == kMagic1 &&
+				static_cast<std::uint8_t>(header[2]) == WireProtocol::Version &&
+				static_cast<std::uint8_t>(header[3]) == static_cast<std::uint8_t>(type);
+		}
+
+		void WriteString(std::string& out, std::string_view text)
+		{
+			WriteVarint(out, text.size());
+			out.append(text);
+		}
+
+		bool ReadString(SchemaReader& reader, std::string_view& text)
+		{
+			std::uint64_t length = 0;
+			return reader.ReadVarint(length) && reader.ReadBytes(static_cast<std::size_t>(length), text);
+		}
+
+		bool ReadByte(SchemaReader& reader, std::uint8_t& value)
+		{
+			std::string_view byte;
+			if (!reader.ReadBytes(1, byte))
+				return false;
+			value = static_cast<std::uint8_t>(byte[0]);
+			return true;
+		}
+
+		// A word the text parser will read back as exactly one token
+		bool IsWord(std::string_view word)
+		{
+			if (word.empty() || word.size() > CommandWord::Capacity)
+				return false;
+			for (char c : word)
+			{
+				if (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f')
+					return false;
+			}
+			return true;
+		}
+
+		bool WriteDirection(std::string& out, std::string_view word, bool allowSelf)
+		{
+			const int index = CommandKeywords::FindDirection(word);
+			if (index == DirectionArg::Self && allowSelf)
+			{
+				out += static_cast<char>(WireProtocol::DirectionSelf);
+				return true;
+			}
+			if (index < 0)
+				return false;
+			out += static_cast<char>(index);
+			return true;
+		}
+
+		bool AppendDirection(std::string& text, std::uint8_t direction, bool allowSelf)
+		{
+			text += ' ';
+			if (direction == WireProtocol::DirectionSelf && allowSelf)
+			{
+				text += "self";
+				return true;
+			}
+			if (direction >= std::size(Map::dirs))
+				return false;
+			text += Map::dirs[direction].name;
+			return true;
+		}
+
+		void AppendInt(std::string& text, std::int64_t value)
+		{
+			text += ' ';
+			text += std::to_string(value);
+		}
+	}
+
+	bool WireProtocol::IsWireContentType(std::string_view contentType)
+	{
+		// Ignore parameters such as "; charset=..."
+		const std::size_t end = contentType.find(';');
+		std::string_view type = contentType.substr(0, end);
+		while (!type.empty() && type.back() == ' ')
+			type.remove_suffix(1);
+		return type == ContentType;
+	}
+
+	bool WireProtocol::EncodeCommand(std::string& out, std::string_view text)
+	{
+		const std::size_t start = out.size();
+		auto fail = [&]()
+			{
+				out.resize(start);
+				return false;
+			};
+
+		CommandTokenizer tokens(text);
+		std::string_view word;
+		if (!tokens.Next(word))
+			return fail();
+		const std::optional<CommandVerb> verb = CommandKeywords::FindVerb(word);
+		if (!verb)
+			return fail();
+
+		switch (*verb)
+		{
+		case CommandVerb::Wait:
+			out += static_cast<char>(Opcode::Wait);
+			return true;
+		case CommandVerb::Help:
+			out += static_cast<char>(Opcode::Help);
+			return true;
+		case CommandVerb::Pulse:
+		{
+			int radius = 5;
+			if (!tokens.NextInt(radius))
+				radius = 5;
+			out += static_cast<char>(Opcode::Pulse);
+			WriteVarint(out, ZigZag(radius));
+			return true;
+		}
+		case CommandVerb::Move:
+		case CommandVerb::Attack:
+			out += static_cast<char>(*verb == CommandVerb::Move ? Opcode::Move : Opcode::Attack);
+			if (!tokens.Next(word) || !WriteDirection(out, word, false))
+				return fail();
+			return true;
+		case CommandVerb::Cast:
+		{
+			std::string_view element;
+			std::string_view direction;
+			if (!tokens.Next(element) || !IsWord(element) || !tokens.Next(direction))
+				return fail();
+
+			AreaShape shape = AreaShape::Single;
+			int size = SpellArea::DefaultSize;
+			if (const std::optional<AreaShape> areaShape = CommandKeywords::FindShape(direction))
+			{
+				shape = *areaShape;
+				if (shape != AreaShape::Radius && !tokens.Next(direction))
+					return fail();
+				if (!tokens.NextInt(size))
+					size = SpellArea::DefaultSize;
+			}
+
+			out += static_cast<char>(Opcode::Cast);
+			WriteString(out, element);
+			out += static_cast<char>(shape);
+			if (shape == AreaShape::Radius)
+				out += static_cast<char>(DirectionNone);
+			else if (!WriteDirection(out, direction, shape == AreaShape::Single))
+				return fail();
+			WriteVarint(out, ZigZag(size));
+			return true;
+		}
+		case CommandVerb::Summon:
+			if (!tokens.Next(word) || !IsWord(word))
+				return fail();
+			out += static_cast<char>(Opcode::Summon);
+			WriteString(out, word);
+			return true;
+		case CommandVerb::Command:
+		{
+			std::string_view target;
+			std::string_view order;
+			if (!tokens.Next(target) || !IsWord(target) || !tokens.Next(order))
+				return fail();
+			const SummonOrder summonOrder = CommandKeywords::FindOrder(order);
+			if (summonOrder == SummonOrder::Unknown)
+				return fail();
+
+			out += static_cast<char>(Opcode::Order);
+			WriteString(out, target);
+			out += static_cast<char>(summonOrder);
+			if (summonOrder != SummonOrder::Move)
+			{
+				out += static_cast<char>(DirectionNone);
+				return true;
+			}
+			if (!tokens.Next(word) || !WriteDirection(out, word, false))
+				return fail();
+			return true;
+		}
+		}
+		return fail();
+	}
+
+	bool WireProtocol::DecodeCommand(SchemaReader& reader, std::string& text)
+	{
+		text.clear();
+		std::uint8_t opcode = 0;
+		if (!ReadByte(reader, opcode))
+			return false;
+
+		switch (static_cast<Opcode>(opcode))
+		{
+		case Opcode::Wait:
+			text = "wait";
+			return true;
+		case Opcode::Help:
+			text = "help";
+			return true;
+		case Opcode::Pulse:
+		{
+			std::uint64_t radius = 0;
+			if (!reader.ReadVarint(radius))
+				return false;
+			text = "pulse";
+			AppendInt(text, UnZigZag(radius));
+			return true;
+		}
+		case Opcode::Move:
+		case Opcode::Attack:
+		{
+			std::uint8_t direction = 0;
+			if (!ReadByte(reader, direction))
+				return false;
+			text = static_cast<Opcode>(opcode) == Opcode::Move ? "move" : "attack";
+			return AppendDirection(text, direction, false);
+		}
+		case Opcode::Cast:
+		{
+			std::string_view element;
+			std::uint8_t shape = 0;
+			std::uint8_t direction = 0;
+			std::uint64_t size = 0;
+			if (!ReadString(reader, element) || !IsWord(element) || !ReadByte(reader, shape) ||
+				!ReadByte(reader, direction) || !reader.ReadVarint(size) ||
+				shape > static_cast<std::uint8_t>(AreaShape::Radius))
+				return false;
+
+			const AreaShape areaShape = static_cast<AreaShape>(shape);
+			text = "cast ";
+			text.append(element);
+			if (areaShape == AreaShape::Single)
+				return AppendDirection(text, direction, true);
+
+			text += ' ';
+			text += SpellArea::ShapeToString(areaShape);
+			if (areaShape != AreaShape::Radius && !AppendDirection(text, direction, false))
+				return false;
+			AppendInt(text, UnZigZag(size));
+			return true;
+		}
+		case Opcode::Summon:
+		{
+			std::string_view creature;
+			if (!ReadString(reader, creature) || !IsWord(creature))
+				return false;
+			text = "summon ";
+			text.append(creature);
+			return true;
+		}
+		case Opcode::Order:
+		{
+			std::string_view target;
+			std::uint8_t order = 0;
+			std::uint8_t direction = 0;
+			if (!ReadString(reader, target) || !IsWord(target) || !ReadByte(reader, order) || !ReadByte(reader, direction) ||
+				order == static_cast<std::uint8_t>(SummonOrder::Unknown) || order >= std::size(kOrderNames))
+				return false;
+
+			text = "command ";
+			text.append(target);
+			text += ' ';
+			text += kOrderNames[order];
+			if (static_cast<SummonOrder>(order) == SummonOrder::Move)
+				return AppendDirection(text, direction, false);
+			return true;
+		}
+		}
+		return false;
+	}
+
+	void WireProtocol::EncodeNewGameRequest(std::string& out, const NewGameRequest& request)
+	{
+		WriteHeader(out, MessageType::NewGameRequest);
+		WriteString(out, request.playerName);
+		WriteString(out, request.mapName);
+		out += static_cast<char>(request.hasSeed ? 1 : 0);
+		if (request.hasSeed)
+			WriteVarint(out, request.seed);
+	}
+
+	bool WireProtocol::DecodeNewGameRequest(std::string_view bytes, NewGameRequest& request)
+	{
+		SchemaReader reader(bytes);
+		std::string_view playerName;
+		std::string_view mapName;
+		std::uint8_t hasSeed = 0;
+		if (!ReadHeader(reader, MessageType::NewGameRequest) || !ReadString(reader, playerName) || playerName.size() > MaxNameLength ||
+			!ReadString(reader, mapName) || mapName.size() > MaxNameLength || !ReadByte(reader, hasSeed) || hasSeed > 1)
+			return false;
+
+		request.playerName.assign(playerName);
+		request.mapName.assign(mapName);
+		request.hasSeed = hasSeed != 0;
+		request.seed = 0;
+		if (request.hasSeed && !reader.ReadVarint(request.seed))
+			return false;
+		return reader.AtEnd();
+	}
+
+	bool WireProtocol::EncodeTurnRequest(std::string& out, std::string_view sessionId, std::string_view command)
+	{
+		const std::size_t start = out.size();
+		WriteHeader(out, MessageType::TurnRequest);
+		WriteString(out, sessionId);
+		if (!EncodeCommand(out, command))
+		{
+			out.resize(start);
+			return false;
+		}
+		return true;
+	}
+
+	bool WireProtocol::DecodeTurnRequest(std::string_view bytes, TurnRequest& request)
+	{
+		SchemaReader reader(bytes);
+		std::string_view sessionId;
+		if (!ReadHeader(reader, MessageType::TurnRequest) || !ReadString(reader, sessionId) || sessionId.size() > MaxSessionIdLength)
+			return false;
+		request.sessionId.assign(sessionId);
+		return DecodeCommand(reader, request.command) && request.command.size() <= MaxCommandLength && reader.AtEnd();
+	}
+
+	void WireProtocol::EncodeNewGameResponse(std::string& out, std::string_view sessionId, std::uint64_t seed)
+	{
+		WriteHeader(out, MessageType::NewGameResponse);
+		WriteString(out, sessionId);
+		WriteVarint(out, seed);
+	}
+
+	bool WireProtocol::DecodeNewGameResponse(std::string_view bytes, NewGameResponse& response)
+	{
+		SchemaReader reader(bytes);
+		std::string_view sessionId;
+		if (!ReadHeader(reader, MessageType::NewGameResponse) || !ReadString(reader, sessionId) ||
+			!reader.ReadVarint(response.seed))
+			return false;
+		response.sessionId.assign(sessionId);
+		return reader.AtEnd();
+	}
+
+	void WireProtocol::EncodeTurnResponse(std::string& out, const CommandResult& result)
+	{
+		WriteHeader(out, MessageType::TurnResponse);
+		out += static_cast<char>((result.success ? 1 : 0) | (result.gameOver ? 2 : 0));
+		out += static_cast<char>(result.action);
+
+		// Narration lines, each distinct line stored once
+		thread_local std::vector<std::string_view> table;
+		thread_local std::unordered_map<std::string_view, std::uint32_t> tableIndex;
+		thread_local std::vector<std::uint32_t> lines;
+		table.clear();
+		tableIndex.clear();
+		lines.clear();
+		const std::string_view description = result.description;
+		std::size_t at = 0;
+		while (!description.empty() && at <= description.size())
+		{
+			std::size_t end = description.find('\n', at);
+			if (end == std::string_view::npos)
+				end = description.size();
+			const std::string_view line = description.substr(at, end - at);
+
+			const auto found = tableIndex.find(line);
+			const std::uint32_t index = found != tableIndex.end() ? found->second : static_cast<std::uint32_t>(table.size());
+			if (index == table.size() && table.size() == kMaxStringTable - 1)
+			{
+				// The decoder's cap: the rest goes out as one entry, newlines and all
+				table.push_back(description.substr(at));
+				lines.push_back(index);
+				break;
+			}
+			if (index == table.size())
+			{
+				table.push_back(line);
+				tableIndex.emplace(line, index);
+			}
+			lines.push_back(index);
+			at = end + 1;
+		}
+
+		WriteVarint(out, table.size());
+		for (std::string_view entry : table)
+			WriteString(out, entry);
+		WriteVarint(out, lines.size());
+		for (std::uint32_t index : lines)
+			WriteVarint(out, index);
+
+		WriteCommandPayloadBinary(out, result.payload);
+	}
+
+	bool WireProtocol::DecodeTurnResponse(std::string_view bytes, TurnResponse& response)
+	{
+		SchemaReader reader(bytes);
+		std::uint8_t flags = 0;
+		std::uint8_t action = 0;
+		if (!ReadHeader(reader, MessageType::TurnResponse) || !ReadByte(reader, flags) || !ReadByte(reader, action) ||
+			action > static_cast<std::uint8_t>(CommandAction::Help))
+			return false;
+		response.success = (flags & 1) != 0;
+		response.gameOver = (flags & 2) != 0;
+		response.action = static_cast<CommandAction>(action);
+
+		std::uint64_t tableSize = 0;
+		if (!reader.ReadVarint(tableSize) || tableSize > kMaxStringTable)
+			return false;
+		std::vector<std::string_view> table(static_cast<std::size_t>(tableSize));
+		for (std::string_view& entry : table)
+		{
+			if (!ReadString(reader, entry))
+				return false;
+		}
+
+		std::uint64_t lineCount = 0;
+		if (!reader.ReadVarint(lineCount))
+			return false;
+		response.description.clear();
+		for (std::uint64_t i = 0; i < lineCount; ++i)
+		{
+			std::uint64_t index = 0;
+			if (!reader.ReadVarint(index) || index >= table.size())
+				return false;
+			if (i > 0)
+				response.description += '\n';
+			response.description.append(table[static_cast<std::size_t>(index)]);
+		}
+
+		return ReadCommandPayloadBinary(reader, response.payload) && reader.AtEnd();
+	}
+
+	void WireProtocol::EncodeError(std::string& out, int status, std::string_view message)
+	{
+		WriteHeader(out, MessageType::Error);
+		WriteVarint(out, static_cast<std::uint64_t>(status));
+		WriteString(out, message);
+	}
+
+	bool WireProtocol::DecodeError(std::string_view bytes, ErrorResponse& response)
+	{
+		SchemaReader reader(bytes);
+		std::uint64_t status = 0;
+		std::string_view message;
+		if (!ReadHeader(reader, MessageType::Error) || !reader.ReadVarint(status) || !ReadString(reader, message))
+			return false;
+		response.status = static_cast<int>(status);
+		response.message.assign(message);
+		return reader.AtEnd();
+	}
+}
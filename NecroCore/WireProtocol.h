@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Command.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace NecroCore
+{
+	class SchemaReader;
+
+	// Compact binary encoding of the /new-game and /turn exchanges, used instead
+	// of JSON when a request is sent with Content-Type WireProtocol::ContentType.
+	//
+	// Every message starts with 'N' 'W', the version and a MessageType byte.
+	// Integers are LEB128 varints (zigzag when signed) and strings a varint
+	// length and the bytes, as in Schema.h. Commands travel as an opcode with
+	// enum arguments. Turn results carry their narration as a table of unique
+	// lines plus the line order, followed by the schema-encoded payload.
+	class WireProtocol
+	{
+	public:
+		static constexpr std::string_view ContentType = "application/x-necro-wire";
+		static constexpr std::uint8_t Version = 1;
+
+		enum class MessageType : std::uint8_t
+		{
+			NewGameRequest = 0x01,
+			TurnRequest = 0x02,
+			NewGameResponse = 0x81,
+			TurnResponse = 0x82,
+			Error = 0xFF
+		};
+
+		enum class Opcode : std::uint8_t
+		{
+			Wait,
+			Help,
+			Pulse,
+			Move,
+			Attack,
+			Cast,
+			Summon,
+			Order
+		};
+
+		// Direction bytes are indices into Map::dirs, or one of these
+		static constexpr std::uint8_t DirectionSelf = 0xFE;
+		static constexpr std::uint8_t DirectionNone = 0xFF;
+
+		// Longest strings a request may carry, the same as for JSON (JsonRequest)
+		static constexpr std::size_t MaxSessionIdLength = 64;
+		static constexpr std::size_t MaxNameLength = 64;
+		static constexpr std::size_t MaxCommandLength = 512;
+
+		struct NewGameRequest
+		{
+			std::string playerName;
+			std::string mapName;
+			bool hasSeed = false;
+			std::uint64_t seed = 0;
+		};
+
+		struct TurnRequest
+		{
+			std::string sessionId;
+			// Canonical command text, as the game and replay log take it
+			std::string command;
+		};
+
+		struct NewGameResponse
+		{
+			std::string sessionId;
+			std::uint64_t seed = 0;
+		};
+
+		struct TurnResponse
+		{
+			bool success = false;
+			bool gameOver = false;
+			CommandAction action = CommandAction::Unknown;
+			std::string description;
+			CommandPayload payload;
+		};
+
+		struct ErrorResponse
+		{
+			int status = 0;
+			std::string message;
+		};
+
+		static bool IsWireContentType(std::string_view contentType);
+
+		// Commands the text parser would reject for an unknown verb, direction,
+		// shape or order cannot be encoded and return false.
+		static bool EncodeCommand(std::string& out, std::string_view text);
+		static bool DecodeCommand(SchemaReader& reader, std::string& text);
+
+		// Encoders append to `out`; decoders reject anything malformed, truncated,
+		// followed by trailing bytes or with a string over its cap above.
+		static void EncodeNewGameRequest(std::string& out, const NewGameRequest& request);
+		static bool DecodeNewGameRequest(std::string_view bytes, NewGameRequest& request);
+		static bool EncodeTurnRequest(std::string& out, std::string_view sessionId, std::string_view command);
+		static bool DecodeTurnRequest(std::string_view bytes, TurnRequest& request);
+
+		static void EncodeNewGameResponse(std::string& out, std::string_view sessionId, std::uint64_t seed);
+		static bool DecodeNewGameResponse(std::string_view bytes, NewGameResponse& response);
+		static void EncodeTurnResponse(std::string& out, const CommandResult& result);
+		static bool DecodeTurnResponse(std::string_view bytes, TurnResponse& response);
+		static void EncodeError(std::string& out, int status, std::string_view message);
+		static bool DecodeError(std::string_view bytes, ErrorResponse& response);
+	};
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Status.h"
+
+#include <cstdint>
+
+namespace NecroCore
+{
+	enum class WorldEventKind : std::uint8_t
+	{
+		Explosion,
+		RearmTrap
+	};
+
+	// Something scheduled to happen on the map during a later environment pass.
+	struct WorldEvent
+	{
+		int id = 0;
+		std::uint64_t dueTurn = 0;
+		WorldEventKind kind = WorldEventKind::Explosion;
+		int x = 0;
+		int y = 0;
+		// Explosion: blast radius and the damage dealt to every actor inside it
+		int radius = 0;
+		int damage = 0;
+		// RearmTrap: the effect the trap springs
+		StatusEffect effect = StatusEffect::Normal;
+
+		static WorldEvent Explosion(int x, int y, int radius, int damage)
+		{
+			WorldEvent event;
+			event.kind = WorldEventKind::Explosion;
+			event.x = x;
+			event.y = y;
+			event.radius = radius;
+			event.damage = damage;
+			return event;
+		}
+
+		static WorldEvent RearmTrap(int x, int y, StatusEffect effect)
+		{
+			WorldEvent event;
+			event.kind = WorldEventKind::RearmTrap;
+			event.x = x;
+			event.y = y;
+			event.effect = effect;
+			return event;
+		}
+	};
+}
@@ -0,0 +1,527 @@
+#include "WriteAheadLog.h"
+#include "Hash.h"
+#include "Schema.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <limits>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace NecroCore
+{
+	namespace
+	{
+		struct RecordHeader
+		{
+			std::uint32_t length;
+			std::uint32_t checksum;
+		};
+
+		std::uint32_t Checksum(const void* data, std::size_t size)
+		{
+			return static_cast<std::uint32_t>(HashBytes(0x57414C, data, size));
+		}
+
+		int OpenForAppend(const std::string& path)
+		{
+#ifdef _WIN32
+			return _open(path.c_str(), _O_WRONLY | _O_CREAT | _O_APPEND | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+			return ::open(path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+#endif
+		}
+
+		bool WriteAll(int file, const char* data, std::size_t size)
+		{
+			while (size > 0)
+			{
+#ifdef _WIN32
+				const int chunk = static_cast<int>(std::min<std::size_t>(size, 1u << 30));
+				const int written = _write(file, data, static_cast<unsigned int>(chunk));
+#else
+				const ssize_t written = ::write(file, data, size);
+#endif
+				if (written <= 0)
+					return false;
+				data += written;
+				size -= static_cast<std::size_t>(written);
+			}
+			return true;
+		}
+
+		bool SyncFile(int file)
+		{
+#ifdef _WIN32
+			return _commit(file) == 0;
+#elif defined(__APPLE__)
+			return ::fsync(file) == 0;
+#else
+			return ::fdatasync(file) == 0;
+#endif
+		}
+
+		void CloseFile(int file)
+		{
+#ifdef _WIN32
+			_close(file);
+#else
+			::close(file);
+#endif
+		}
+
+		// Makes a rename or a new file in `directory` itself durable
+		void SyncDirectory(const std::string& directory)
+		{
+#ifndef _WIN32
+			const int dir = ::open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+			if (dir >= 0)
+			{
+				::fsync(dir);
+				::close(dir);
+			}
+#else
+			(void)directory;
+#endif
+		}
+
+		void WriteString(std::string& out, std::string_view text)
+		{
+			WriteVarint(out, text.size());
+			out.append(text);
+		}
+
+		bool ReadString(SchemaReader& reader, std::string& text)
+		{
+			std::uint64_t length = 0;
+			std::string_view bytes;
+			if (!reader.ReadVarint(length) || !reader.ReadBytes(static_cast<std::size_t>(length), bytes))
+				return false;
+			text.assign(bytes);
+			return true;
+		}
+	}
+
+	WriteAheadLog::WriteAheadLog(std::string directory, std::chrono::microseconds flushInterval)
+		: m_Directory(std::move(directory))
+		, m_FlushInterval(flushInterval)
+	{
+	}
+
+	WriteAheadLog::~WriteAheadLog()
+	{
+		Close();
+	}
+
+	std::string WriteAheadLog::SegmentPath(const std::string& directory, std::uint32_t segment)
+	{
+		char name[32];
+		std::snprintf(name, sizeof(name), "wal-%08u.log", segment);
+		return (std::filesystem::path(directory) / name).string();
+	}
+
+	std::vector<std::uint32_t> WriteAheadLog::ListSegments(const std::string& directory)
+	{
+		std::vector<std::uint32_t> segments;
+		std::error_code error;
+		for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+		{
+			const std::string name = entry.path().filename().string();
+			unsigned int segment = 0;
+			char tail = 0;
+			if (name.size() == 16 && std::sscanf(name.c_str(), "wal-%8u.lo%c", &segment, &tail) == 2 && tail == 'g')
+				segments.push_back(segment);
+		}
+		std::sort(segments.begin(), segments.end());
+		return segments;
+	}
+
+	bool WriteAheadLog::OpenSegment(std::uint32_t segment)
+	{
+		const int file = OpenForAppend(SegmentPath(m_Directory, segment));
+		if (file < 0)
+		{
+			std::cerr << "[WriteAheadLog] Cannot open segment " << SegmentPath(m_Directory, segment) << "\n";
+			return false;
+		}
+		SyncDirectory(m_Directory);
+		if (m_File >= 0)
+			CloseFile(m_File);
+		m_File = file;
+		m_Segment = segment;
+		return true;
+	}
+
+	bool WriteAheadLog::Open()
+	{
+		std::error_code error;
+		std::filesystem::create_directories(m_Directory, error);
+		const std::vector<std::uint32_t> segments = ListSegments(m_Directory);
+		{
+			std::lock_guard fileLock(m_FileMutex);
+			if (!OpenSegment(segments.empty() ? 1 : segments.back() + 1))
+				return false;
+		}
+
+		std::lock_guard lock(m_Mutex);
+		m_Stop = false;
+		m_Failed = false;
+		m_Open = true;
+		m_Flusher = std::thread([this]() { FlushLoop(); });
+		return true;
+	}
+
+	void WriteAheadLog::Close()
+	{
+		{
+			std::lock_guard lock(m_Mutex);
+			if (!m_Open)
+				return;
+			m_Stop = true;
+		}
+		m_Pending.notify_all();
+		if (m_Flusher.joinable())
+			m_Flusher.join();
+
+		std::lock_guard fileLock(m_FileMutex);
+		if (m_File >= 0)
+		{
+			CloseFile(m_File);
+			m_File = -1;
+		}
+		std::vector<DurableCallback> ready;
+		{
+			std::lock_guard lock(m_Mutex);
+			m_Open = false;
+			m_Durable.notify_all();
+			ready = TakeReadyCallbacks();
+		}
+		RunCallbacks(ready);
+	}
+
+	bool WriteAheadLog::IsOpen() const
+	{
+		std::lock_guard lock(m_Mutex);
+		return m_Open && !m_Failed;
+	}
+
+	std::uint64_t WriteAheadLog::Append(const std::string& payload)
+	{
+		RecordHeader header{};
+		header.length = static_cast<std::uint32_t>(payload.size());
+		header.checksum = Checksum(payload.data(), payload.size());
+
+		std::uint64_t lsn = 0;
+		bool wake = false;
+		{
+			std::lock_guard lock(m_Mutex);
+			wake = m_Buffer.empty();
+			m_Buffer.append(reinterpret_cast<const char*>(&header), sizeof(header));
+			m_Buffer.append(payload);
+			lsn = m_NextLsn++;
+		}
+		if (wake)
+			m_Pending.notify_one();
+		return lsn;
+	}
+
+	std::uint64_t WriteAheadLog::AppendCreate(std::string_view sessionId, std::string_view playerName, std::string_view mapName, std::uint64_t seed)
+	{
+		thread_local std::string payload;
+		payload.clear();
+		payload += static_cast<char>(WalRecordType::Create);
+		WriteString(payload, sessionId);
+		WriteString(payload, playerName);
+		WriteString(payload, mapName);
+		WriteVarint(payload, seed);
+		return Append(payload);
+	}
+
+	std::uint64_t WriteAheadLog::AppendTurn(std::string_view sessionId, std::uint64_t sequence, std::string_view command, std::uint64_t stateHash,
+		const std::vector<int>& deferredHostiles)
+	{
+		thread_local std::string payload;
+		payload.clear();
+		payload += static_cast<char>(WalRecordType::Turn);
+		WriteString(payload, sessionId);
+		WriteVarint(payload, sequence);
+		WriteString(payload, command);
+		WriteVarint(payload, deferredHostiles.size());
+		for (int id : deferredHostiles)
+			WriteVarint(payload, static_cast<std::uint64_t>(id));
+		payload.append(reinterpret_cast<const char*>(&stateHash), sizeof(stateHash));
+		return Append(payload);
+	}
+
+	bool WriteAheadLog::WaitDurable(std::uint64_t lsn)
+	{
+		std::unique_lock lock(m_Mutex);
+		m_Durable.wait(lock, [&]() { return m_DurableLsn >= lsn || m_Failed || !m_Open; });
+		return m_DurableLsn >= lsn;
+	}
+
+	bool WriteAheadLog::WriteAndSync(const std::string& bytes)
+	{
+		if (m_File < 0 || !WriteAll(m_File, bytes.data(), bytes.size()) || !SyncFile(m_File))
+		{
+			std::cerr << "[WriteAheadLog] Write to segment " << m_Segment << " failed\n";
+			return false;
+		}
+		return true;
+	}
+
+	void WriteAheadLog::FlushLoop()
+	{
+		std::string batch;
+		std::unique_lock lock(m_Mutex);
+		while (true)
+		{
+			m_Pending.wait(lock, [&]() { return !m_Buffer.empty() || m_Stop; });
+			if (m_Buffer.empty() && m_Stop)
+				return;
+
+			// Let other sessions join this sync
+			if (!m_Stop && m_FlushInterval.count() > 0)
+				m_Pending.wait_for(lock, m_FlushInterval, [&]() { return m_Stop; });
+
+			// Take the file first so batches reach it in LSN order, even with a Rotate racing us
+			lock.unlock();
+			std::unique_lock fileLock(m_FileMutex);
+			lock.lock();
+			if (m_Buffer.empty())
+				continue;
+			batch.clear();
+			batch.swap(m_Buffer);
+			const std::uint64_t lastLsn = m_NextLsn - 1;
+			lock.unlock();
+
+			const bool written = WriteAndSync(batch);
+			fileLock.unlock();
+
+			lock.lock();
+			if (written)
+			{
+				m_DurableLsn = std::max(m_DurableLsn, lastLsn);
+				++m_Syncs;
+			}
+			else
+			{
+				m_Failed = true;
+			}
+			m_Durable.notify_all();
+
+			std::vector<DurableCallback> ready = TakeReadyCallbacks();
+			if (!ready.empty())
+			{
+				lock.unlock();
+				RunCallbacks(ready);
+				lock.lock();
+			}
+		}
+	}
+
+	std::uint32_t WriteAheadLog::Rotate()
+	{
+		std::vector<DurableCallback> ready;
+		const std::uint32_t segment = RotateLocked(ready);
+		RunCallbacks(ready);
+		return segment;
+	}
+
+	std::uint32_t WriteAheadLog::RotateLocked(std::vector<DurableCallback>& ready)
+	{
+		std::lock_guard fileLock(m_FileMutex);
+
+		std::string batch;
+		std::uint64_t lastLsn = 0;
+		{
+			std::lock_guard lock(m_Mutex);
+			batch.swap(m_Buffer);
+			lastLsn = m_NextLsn - 1;
+		}
+
+		const bool written = batch.empty() || WriteAndSync(batch);
+		const std::uint32_t next = m_Segment + 1;
+		const bool opened = OpenSegment(next);
+
+		std::lock_guard lock(m_Mutex);
+		if (written && opened)
+		{
+			// The flusher writes under the file lock too, so everything older is already durable
+			m_DurableLsn = std::max(m_DurableLsn, lastLsn);
+			if (!batch.empty())
+				++m_Syncs;
+		}
+		else
+		{
+			m_Failed = true;
+		}
+		m_Durable.notify_all();
+		ready = TakeReadyCallbacks();
+		return m_Segment;
+	}
+
+	void WriteAheadLog::WhenDurable(std::uint64_t lsn, std::function<void(bool durable)> callback)
+	{
+		{
+			std::lock_guard lock(m_Mutex);
+			if (m_DurableLsn < lsn && m_Open && !m_Failed)
+			{
+				m_Callbacks.push_back({ lsn, std::move(callback) });
+				return;
+			}
+		}
+		callback(GetDurableLsn() >= lsn);
+	}
+
+	std::vector<WriteAheadLog::DurableCallback> WriteAheadLog::TakeReadyCallbacks()
+	{
+		std::vector<DurableCallback> ready;
+		const bool giveUp = m_Failed || !m_Open;
+		std::size_t kept = 0;
+		for (std::size_t i = 0; i < m_Callbacks.size(); ++i)
+		{
+			if (giveUp || m_Callbacks[i].lsn <= m_DurableLsn)
+			{
+				ready.push_back(std::move(m_Callbacks[i]));
+				continue;
+			}
+			if (kept != i)
+				m_Callbacks[kept] = std::move(m_Callbacks[i]);
+			++kept;
+		}
+		m_Callbacks.resize(kept);
+		for (DurableCallback& entry : ready)
+		{
+			entry.durable = entry.lsn <= m_DurableLsn;
+		}
+		return ready;
+	}
+
+	void WriteAheadLog::RunCallbacks(std::vector<DurableCallback>& ready)
+	{
+		for (DurableCallback& entry : ready)
+		{
+			entry.callback(entry.durable);
+		}
+	}
+
+	void WriteAheadLog::RemoveSegmentsBefore(std::uint32_t segment)
+	{
+		for (std::uint32_t existing : ListSegments(m_Directory))
+		{
+			if (existing >= segment)
+				break;
+			std::error_code error;
+			std::filesystem::remove(SegmentPath(m_Directory, existing), error);
+		}
+		SyncDirectory(m_Directory);
+	}
+
+	std::uint64_t WriteAheadLog::GetDurableLsn() const
+	{
+		std::lock_guard lock(m_Mutex);
+		return m_DurableLsn;
+	}
+
+	std::uint64_t WriteAheadLog::GetSyncCount() const
+	{
+		std::lock_guard lock(m_Mutex);
+		return m_Syncs;
+	}
+
+	bool WriteAheadLog::ReadSegment(const std::string& path, const std::function<void(WalRecord&&)>& visit)
+	{
+		std::ifstream in(path, std::ios::binary);
+		if (!in)
+			return false;
+		const std::string bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+		std::size_t at = 0;
+		while (at < bytes.size())
+		{
+			RecordHeader header{};
+			if (bytes.size() - at < sizeof(header))
+				return false;
+			std::memcpy(&header, bytes.data() + at, sizeof(header));
+			at += sizeof(header);
+			if (bytes.size() - at < header.length || Checksum(bytes.data() + at, header.length) != header.checksum)
+				return false;
+
+			SchemaReader reader(std::string_view(bytes).substr(at, header.length));
+			at += header.length;
+
+			WalRecord record;
+			std::string_view type;
+			if (!reader.ReadBytes(1, type) || !ReadString(reader, record.sessionId))
+				return false;
+			record.type = static_cast<WalRecordType>(type[0]);
+			bool parsed = false;
+			switch (record.type)
+			{
+			case WalRecordType::Create:
+				parsed = ReadString(reader, record.playerName) && ReadString(reader, record.mapName) && reader.ReadVarint(record.seed);
+				break;
+			case WalRecordType::Turn:
+			{
+				std::string_view hash;
+				std::uint64_t deferredCount = 0;
+				parsed = reader.ReadVarint(record.sequence) && ReadString(reader, record.command) && reader.ReadVarint(deferredCount) &&
+					deferredCount <= header.length;
+				for (std::uint64_t i = 0; parsed && i < deferredCount; ++i)
+				{
+					std::uint64_t id = 0;
+					parsed = reader.ReadVarint(id) && id <= static_cast<std::uint64_t>(std::numeric_limits<int>::max());
+					if (parsed)
+						record.deferredHostiles.push_back(static_cast<int>(id));
+				}
+				parsed = parsed && reader.ReadBytes(sizeof(record.stateHash), hash);
+				if (parsed)
+					std::memcpy(&record.stateHash, hash.data(), sizeof(record.stateHash));
+				break;
+			}
+			}
+			if (!parsed || !reader.AtEnd())
+				return false;
+			visit(std::move(record));
+		}
+		return true;
+	}
+
+	bool WriteAheadLog::WriteFileDurably(const std::string& path, const std::vector<std::uint8_t>& bytes)
+	{
+		const std::string temporary = path + ".tmp";
+#ifdef _WIN32
+		const int file = _open(temporary.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+		const int file = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+#endif
+		if (file < 0)
+			return false;
+		const bool written = WriteAll(file, reinterpret_cast<const char*>(bytes.data()), bytes.size()) && SyncFile(file);
+		CloseFile(file);
+
+		std::error_code error;
+		if (written)
+			std::filesystem::rename(temporary, path, error);
+		if (!written || error)
+		{
+			std::filesystem::remove(temporary, error);
+			return false;
+		}
+		SyncDirectory(std::filesystem::path(path).parent_path().string());
+		return true;
+	}
+}
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace NecroCore
+{
+	enum class WalRecordType : std::uint8_t
+	{
+		// A new session: player name, map name and seed
+		Create = 1,
+		// A command passed to ApplyTurn, with the session's turn count before it
+		Turn = 2
+	};
+
+	struct WalRecord
+	{
+		WalRecordType type = WalRecordType::Turn;
+		std::string sessionId;
+		// Create
+		std::string playerName;
+		std::string mapName;
+		std::uint64_t seed = 0;
+		// Turn
+		std::uint64_t sequence = 0;
+		std::string command;
+		// Game::ComputeStateHash after the turn, to spot replays that went differently
+		std::uint64_t stateHash = 0;
+		// Hostiles the turn budget deferred (TurnStats::deferredHostiles)
+		std::vector<int> deferredHostiles;
+	};
+
+	// Write-ahead log of session creations and turns, split into numbered
+	// segment files in one directory.
+	//
+	// Appends only copy the record into a memory buffer and return its log
+	// sequence number. A flusher thread gathers everything appended within
+	// one flush interval, writes it with a single write and a single fsync,
+	// and then wakes every caller waiting on WaitDurable for those records -
+	// so many sessions share each disk sync.
+	//
+	// Each record is a length, a checksum and the payload, so a torn write at
+	// the end of a segment is detected and ignored on recovery.
+	class WriteAheadLog
+	{
+	public:
+		explicit WriteAheadLog(std::string directory, std::chrono::microseconds flushInterval = std::chrono::milliseconds(2));
+		~WriteAheadLog();
+
+		WriteAheadLog(const WriteAheadLog&) = delete;
+		WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+		// Starts a new segment after any existing ones and the flusher thread.
+		bool Open();
+		// Flushes what is pending and stops the flusher.
+		void Close();
+		bool IsOpen() const;
+
+		std::uint64_t AppendCreate(std::string_view sessionId, std::string_view playerName, std::string_view mapName, std::uint64_t seed);
+		std::uint64_t AppendTurn(std::string_view sessionId, std::uint64_t sequence, std::string_view command, std::uint64_t stateHash,
+			const std::vector<int>& deferredHostiles = {});
+		// Blocks until the record is on disk. False if the log failed or is closed.
+		bool WaitDurable(std::uint64_t lsn);
+		// Calls `callback` once the record is on disk (true) or the log has failed
+		// or closed (false), from the flusher thread or right away. For callers
+		// that must not block, such as a core that owns sessions.
+		void WhenDurable(std::uint64_t lsn, std::function<void(bool durable)> callback);
+
+		// Makes everything appended so far durable and starts a new segment,
+		// returning its number. Records appended afterwards never land in an
+		// older segment.
+		std::uint32_t Rotate();
+		void RemoveSegmentsBefore(std::uint32_t segment);
+
+		std::uint64_t GetDurableLsn() const;
+		std::uint64_t GetSyncCount() const;
+		const std::string& GetDirectory() const { return m_Directory; }
+
+		// Segment numbers present in `directory`, ascending
+		static std::vector<std::uint32_t> ListSegments(const std::string& directory);
+		static std::string SegmentPath(const std::string& directory, std::uint32_t segment);
+		// Calls `visit` for every intact record, stopping at the first torn or
+		// corrupt one. Returns false if the segment could not be read or ended
+		// in a damaged record.
+		static bool ReadSegment(const std::string& path, const std::function<void(WalRecord&&)>& visit);
+
+		// Writes `bytes` to `path` via a synced temporary file and a rename.
+		static bool WriteFileDurably(const std::string& path, const std::vector<std::uint8_t>& bytes);
+
+	private:
+		struct DurableCallback
+		{
+			std::uint64_t lsn;
+			std::function<void(bool)> callback;
+			bool durable = false;
+		};
+
+		std::uint64_t Append(const std::string& payload);
+		std::uint32_t RotateLocked(std::vector<DurableCallback>& ready);
+		// Expects m_Mutex to be held
+		std::vector<DurableCallback> TakeReadyCallbacks();
+		static void RunCallbacks(std::vector<DurableCallback>& ready);
+		void FlushLoop();
+		// Expects m_FileMutex to be held
+		bool WriteAndSync(const std::string& bytes);
+		bool OpenSegment(std::uint32_t segment);
+
+		std::string m_Directory;
+		std::chrono::microseconds m_FlushInterval;
+
+		// Guards the pending buffer and sequence numbers
+		mutable std::mutex m_Mutex;
+		std::condition_variable m_Pending;
+		std::condition_variable m_Durable;
+		std::string m_Buffer;
+		std::uint64_t m_NextLsn = 1;
+		std::uint64_t m_DurableLsn = 0;
+		std::uint64_t m_Syncs = 0;
+		bool m_Stop = false;
+		bool m_Failed = false;
+		bool m_Open = false;
+		std::vector<DurableCallback> m_Callbacks;
+
+		// Guards the segment file itself
+		std::mutex m_FileMutex;
+		int m_File = -1;
+		std::uint32_t m_Segment = 0;
+
+		std::thread m_Flusher;
+	};
+}